@@ -111,6 +111,12 @@ void AsyncRpc::SendRpc() {
   TRACE_TO(trace_, "SendRpc() called.");
 
   retained_self_ = shared_from_this();
+  if (tablet_split_) {
+    // The retry delay passed, so the ops are sent to the tablets the tablet was split into.
+    batcher_->RetryOpsAfterTabletSplit(ops_);
+    retained_self_.reset();
+    return;
+  }
   tablet_invoker_.Execute(std::string());
 }
 
@@ -128,12 +134,23 @@ const YBTable* AsyncRpc::table() const {
 
 void AsyncRpc::SendRpcCb(const Status& status) {
   Status new_status = status;
-  if (tablet_invoker_.Done(&new_status)) {
-    ProcessResponseFromTserver(new_status);
-    batcher_->RemoveInFlightOpsAfterFlushing(ops_, new_status, PropagatedHybridTime());
-    batcher_->CheckForFinishedFlush();
-    retained_self_.reset();
+  if (tablet_split_) {
+    // The retry after the split was not started, e.g. because the deadline has passed.
+    Failed(new_status);
+  } else if (!tablet_invoker_.Done(&new_status)) {
+    return;
+  } else if (ErrorCode(response_error()) == tserver::TabletServerErrorPB::TABLET_SPLIT) {
+    // None of the ops was applied, so they are sent to the tablets the tablet was split into.
+    // The master could still be registering those tablets, so the ops are retried with the
+    // backoff of this RPC instead of looking them up right away.
+    tablet_split_ = true;
+    mutable_retrier()->DelayedRetry(this, new_status);
+    return;
   }
+  ProcessResponseFromTserver(new_status);
+  batcher_->RemoveInFlightOpsAfterFlushing(ops_, new_status, PropagatedHybridTime());
+  batcher_->CheckForFinishedFlush();
+  retained_self_.reset();
 }
 
 void AsyncRpc::Failed(const Status& status) {
@@ -438,6 +455,14 @@ ReadRpc::ReadRpc(
         if (ql_op->read_time().read.is_valid()) {
           ql_op->read_time().AddToPB(&req_);
         }
+        // All ops of the batch are read at the same time, so the tightest staleness bound wins.
+        if (yb_consistency_level == YBConsistencyLevel::CONSISTENT_PREFIX &&
+            ql_op->max_staleness().Initialized()) {
+          uint64_t staleness_us = std::max<int64_t>(ql_op->max_staleness().ToMicroseconds(), 0);
+          if (!req_.has_max_staleness_us() || staleness_us < req_.max_staleness_us()) {
+            req_.set_max_staleness_us(staleness_us);
+          }
+        }
         break;
       }
       case YBOperation::Type::REDIS_WRITE: FALLTHROUGH_INTENDED;
@@ -105,6 +105,9 @@ class AsyncRpc : public rpc::Rpc, public TabletRpc {
   MonoTime start_;
   std::shared_ptr<AsyncRpcMetrics> async_rpc_metrics_;
   rpc::RpcCommandPtr retained_self_;
+
+  // The tablet has been split, so the next retry of this RPC sends its ops to the new tablets.
+  bool tablet_split_ = false;
 };
 
 template <class Req, class Resp>
@@ -512,6 +512,34 @@ void Batcher::RemoveInFlightOpsAfterFlushing(
   }
 }
 
+void Batcher::RetryOpsAfterTabletSplit(const InFlightOps& ops) {
+  MonoTime deadline;
+  {
+    std::lock_guard<simple_spinlock> l(lock_);
+    deadline = deadline_;
+    for (auto& op : ops) {
+      std::lock_guard<simple_spinlock> l2(op->lock_);
+      op->state = InFlightOpState::kLookingUpTablet;
+      ++outstanding_lookups_;
+    }
+  }
+
+  for (auto& op : ops) {
+    VLOG(3) << "Looking up tablet after split for " << op->yb_op->ToString();
+    if (op->yb_op->tablet()) {
+      // The op explicitly targets the split tablet, so it cannot be redirected.
+      TabletLookupFinished(op, STATUS(IllegalState, "Tablet has been split",
+                                      op->yb_op->tablet()->tablet_id()));
+      continue;
+    }
+    // The split tablet was marked stale, so the lookup fetches the new tablets from the master.
+    op->tablet = nullptr;
+    client_->data_->meta_cache_->LookupTabletByKey(
+        op->yb_op->table(), op->partition_key, deadline, &op->tablet,
+        Bind(&Batcher::TabletLookupFinished, this, op));
+  }
+}
+
 void Batcher::ProcessRpcStatus(const AsyncRpc &rpc, const Status &s) {
   // TODO: there is a potential race here -- if the Batcher gets destructed while
   // RPCs are in-flight, then accessing state_ will crash. We probably need to keep
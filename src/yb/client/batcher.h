@@ -155,6 +155,10 @@ class Batcher : public RefCountedThreadSafe<Batcher> {
   void RemoveInFlightOpsAfterFlushing(
       const InFlightOps& ops, const Status& status, HybridTime propagated_hybrid_time);
 
+  // Looks up the tablets of ops that were rejected because their tablet has been split, and sends
+  // them again. The ops stay in the in-flight set.
+  void RetryOpsAfterTabletSplit(const InFlightOps& ops);
+
     // Return true if the batch has been aborted, and any in-flight ops should stop
   // processing wherever they are.
   bool IsAbortedUnlocked() const;
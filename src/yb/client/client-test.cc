@@ -96,6 +96,7 @@ DECLARE_int32(tablet_server_svc_queue_length);
 DEFINE_int32(test_scan_num_rows, 1000, "Number of rows to insert and scan");
 
 METRIC_DECLARE_counter(rpcs_queue_overflow);
+METRIC_DECLARE_histogram(handler_latency_yb_master_MasterService_GetTableLocations);
 
 using namespace std::literals; // NOLINT
 using namespace std::placeholders;
@@ -1367,6 +1368,27 @@ TEST_F(ClientTest, TestAsyncFlushResponseAfterSessionDropped) {
   ASSERT_TRUE(s.Wait().ok());
 }
 
+TEST_F(ClientTest, TestAutoFlushBackground) {
+  const int kNumRows = 1000;
+  auto session = client_->NewSession();
+  ASSERT_OK(session->SetFlushMode(YBSession::AUTO_FLUSH_BACKGROUND));
+  // A small buffer makes Apply wait for batches in flight.
+  ASSERT_OK(session->SetMutationBufferSpace(4096));
+  session->SetTimeout(10s);
+  for (int i = 0; i < kNumRows; i++) {
+    ASSERT_OK(session->Apply(BuildTestRow(client_table_, i)));
+  }
+  FlushSessionOrDie(session);
+  ASSERT_FALSE(session->HasPendingOperations());
+  ASSERT_EQ(kNumRows, CountRowsFromClient(client_table_));
+
+  // A row that is not flushed explicitly is flushed after the linger time.
+  ASSERT_OK(session->Apply(BuildTestRow(client_table_, kNumRows)));
+  ASSERT_OK(WaitFor([this] { return CountRowsFromClient(client_table_) == kNumRows + 1; },
+                    10s, "Row flushed in background"));
+  ASSERT_EQ(0, session->CountPendingErrors());
+}
+
 TEST_F(ClientTest, TestSessionClose) {
   auto session = CreateSession();
   ASSERT_OK(ApplyInsertToSession(session.get(), client_table_, 1, 1, "row"));
@@ -2146,6 +2168,148 @@ TEST_F(ClientTest, TestMasterLookupPermits) {
             client_->data_->meta_cache_->master_lookup_sem_.GetValue());
 }
 
+TEST_F(ClientTest, TestMetaCachePrefetch) {
+  // A new client has no tablet locations cached.
+  shared_ptr<YBClient> client;
+  ASSERT_OK(YBClientBuilder()
+                .add_master_server_addr(ToString(cluster_->mini_master()->bound_rpc_addr()))
+                .Build(&client));
+  TableHandle table;
+  ASSERT_OK(table.Open(kTableName, client.get()));
+
+  google::protobuf::RepeatedPtrField<master::TabletLocationsPB> tablets;
+  ASSERT_OK(client_->GetTablets(kTableName, kNumTablets, &tablets));
+  ASSERT_EQ(kNumTablets, tablets.size());
+
+  // Looking up a key of the last tablet fetches the locations of all the tablets of the table.
+  const auto& last_tablet = tablets.Get(tablets.size() - 1);
+  Synchronizer sync;
+  scoped_refptr<internal::RemoteTablet> rt;
+  client->data_->meta_cache_->LookupTabletByKey(
+      table.get(), last_tablet.partition().partition_key_start(), MonoTime::Max(), &rt,
+      sync.AsStatusCallback());
+  ASSERT_OK(sync.Wait());
+  ASSERT_EQ(last_tablet.tablet_id(), rt->tablet_id());
+
+  for (const auto& tablet : tablets) {
+    auto cached = client->data_->meta_cache_->LookupTabletByKeyFastPath(
+        table.get(), tablet.partition().partition_key_start());
+    ASSERT_TRUE(cached != nullptr) << tablet.ShortDebugString();
+    ASSERT_EQ(tablet.tablet_id(), cached->tablet_id());
+  }
+}
+
+class MetaCacheLookupTest : public ClientTest {
+ protected:
+  void SetUp() override {
+    ClientTest::SetUp();
+    // A new client has no tablet locations cached.
+    ASSERT_OK(YBClientBuilder()
+                  .add_master_server_addr(ToString(cluster_->mini_master()->bound_rpc_addr()))
+                  .Build(&cold_client_));
+    ASSERT_OK(table_.Open(kTableName, cold_client_.get()));
+    ASSERT_OK(client_->GetTablets(kTableName, kNumTablets, &tablets_));
+    ASSERT_EQ(kNumTablets, tablets_.size());
+  }
+
+  internal::MetaCache* meta_cache() {
+    return cold_client_->data_->meta_cache_.get();
+  }
+
+  // Starts a lookup of the tablet of the given key, that is done when 'sync' is.
+  void StartLookup(const std::string& partition_key, MonoDelta timeout, Synchronizer* sync,
+                   scoped_refptr<internal::RemoteTablet>* remote_tablet) {
+    meta_cache()->LookupTabletByKey(
+        table_.get(), partition_key, MonoTime::Now() + timeout, remote_tablet,
+        sync->AsStatusCallback());
+  }
+
+  scoped_refptr<internal::RemoteTablet> CachedTablet(const std::string& partition_key) {
+    return meta_cache()->LookupTabletByKeyFastPath(table_.get(), partition_key);
+  }
+
+  int64_t NumMasterLookups() {
+    return METRIC_handler_latency_yb_master_MasterService_GetTableLocations.Instantiate(
+        cluster_->mini_master()->master()->metric_entity())->TotalCount();
+  }
+
+  shared_ptr<YBClient> cold_client_;
+  TableHandle table_;
+  google::protobuf::RepeatedPtrField<master::TabletLocationsPB> tablets_;
+};
+
+// A lookup waiting for a lookup in flight fails at its own deadline.
+TEST_F(MetaCacheLookupTest, WaiterDeadline) {
+  google::FlagSaver saver;
+  FLAGS_master_inject_latency_on_tablet_lookups_ms = 1000;
+
+  Synchronizer sync1, sync2;
+  scoped_refptr<internal::RemoteTablet> rt1, rt2;
+  StartLookup(tablets_.Get(0).partition().partition_key_start(), 10s, &sync1, &rt1);
+  auto start = MonoTime::Now();
+  StartLookup(tablets_.Get(1).partition().partition_key_start(), 100ms, &sync2, &rt2);
+  auto status = sync2.Wait();
+  ASSERT_TRUE(status.IsTimedOut()) << status;
+  ASSERT_LT(MonoTime::Now() - start, MonoDelta::FromMilliseconds(900));
+
+  ASSERT_OK(sync1.Wait());
+  ASSERT_EQ(tablets_.Get(0).tablet_id(), rt1->tablet_id());
+}
+
+// A lookup waiting for a lookup in flight that fails is retried on its own.
+TEST_F(MetaCacheLookupTest, WaiterRetriedOnFailure) {
+  google::FlagSaver saver;
+  FLAGS_master_inject_latency_on_tablet_lookups_ms = 500;
+
+  Synchronizer sync1, sync2;
+  scoped_refptr<internal::RemoteTablet> rt1, rt2;
+  // The first lookup times out, and fails the lookup of the table it started.
+  StartLookup(tablets_.Get(0).partition().partition_key_start(), 200ms, &sync1, &rt1);
+  StartLookup(tablets_.Get(1).partition().partition_key_start(), 10s, &sync2, &rt2);
+  auto status = sync1.Wait();
+  ASSERT_TRUE(status.IsTimedOut()) << status;
+
+  ASSERT_OK(sync2.Wait());
+  ASSERT_EQ(tablets_.Get(1).tablet_id(), rt2->tablet_id());
+}
+
+// Lookups are coalesced only for the same partition.
+TEST_F(MetaCacheLookupTest, CoalesceSamePartition) {
+  google::FlagSaver saver;
+
+  {
+    Synchronizer sync;
+    scoped_refptr<internal::RemoteTablet> rt;
+    StartLookup(tablets_.Get(1).partition().partition_key_start(), 10s, &sync, &rt);
+    ASSERT_OK(sync.Wait());
+  }
+  // The locations are known, but have to be looked up again.
+  std::vector<scoped_refptr<internal::RemoteTablet>> cached;
+  for (const auto& tablet : tablets_) {
+    cached.push_back(CachedTablet(tablet.partition().partition_key_start()));
+    ASSERT_TRUE(cached.back() != nullptr);
+    cached.back()->MarkStale();
+  }
+
+  FLAGS_master_inject_latency_on_tablet_lookups_ms = 200;
+  constexpr int kLookupsPerKey = 3;
+  const std::vector<std::string> keys = {
+      tablets_.Get(0).partition().partition_key_start(),
+      tablets_.Get(1).partition().partition_key_start()};
+  auto initial_lookups = NumMasterLookups();
+  std::vector<Synchronizer> syncs(keys.size() * kLookupsPerKey);
+  std::vector<scoped_refptr<internal::RemoteTablet>> tablets(syncs.size());
+  for (size_t i = 0; i != syncs.size(); ++i) {
+    StartLookup(keys[i % keys.size()], 10s, &syncs[i], &tablets[i]);
+  }
+  for (size_t i = 0; i != syncs.size(); ++i) {
+    ASSERT_OK(syncs[i].Wait());
+    ASSERT_EQ(tablets_.Get(i % keys.size()).tablet_id(), tablets[i]->tablet_id());
+  }
+  // One master lookup per partition.
+  ASSERT_EQ(initial_lookups + keys.size(), NumMasterLookups());
+}
+
 // Define callback for deadlock simulation, as well as various helper methods.
 namespace {
 class DLSCallback : public YBStatusCallback {
@@ -1317,6 +1317,10 @@ Status YBSession::SetFlushMode(FlushMode m) {
   return data_->SetFlushMode(m);
 }
 
+Status YBSession::SetMutationBufferSpace(size_t size) {
+  return data_->SetMutationBufferSpace(size);
+}
+
 void YBSession::SetTimeout(MonoDelta timeout) {
   data_->SetTimeout(timeout);
 }
@@ -453,6 +453,7 @@ class YBClient : public std::enable_shared_from_this<YBClient> {
   friend class internal::AsyncRpc;
   friend class internal::TabletInvoker;
   friend class PlacementInfoTest;
+  friend class MetaCacheLookupTest;
 
   FRIEND_TEST(ClientTest, TestGetTabletServerBlacklist);
   FRIEND_TEST(ClientTest, TestMasterDown);
@@ -866,15 +867,15 @@ class YBSession : public std::enable_shared_from_this<YBSession> {
     // the same session. If there is not sufficient buffer space, then Apply()
     // may block for buffer space to be available.
     //
+    // Buffered writes are flushed once they fill their share of the mutation buffer space (see
+    // --client_max_background_flushes), or after --client_background_flush_linger_ms, so that
+    // several batches could be in flight at a time.
+    //
     // Because writes are applied in the background, any errors will be stored
     // in a session-local buffer. Call CountPendingErrors() or GetPendingErrors()
     // to retrieve them.
     // TODO: provide an API for the user to specify a callback to do their own
     // error reporting.
-    // TODO: specify which threads the background activity runs on (probably the
-    // messenger IO threads?)
-    //
-    // NOTE: This is not implemented yet, see KUDU-456.
     //
     // The Flush() call can be used to block until the buffer is empty.
     AUTO_FLUSH_BACKGROUND,
@@ -901,7 +902,7 @@ class YBSession : public std::enable_shared_from_this<YBSession> {
   //   if the buffer space is exhausted, then write calls will block until there
   //   is space available in the buffer.
   // MANUAL_FLUSH:
-  //   if the buffer space is exhausted, then write calls will return an error.
+  //   this has no effect yet, the size of a batch is only limited by the RPC size limit.
   CHECKED_STATUS SetMutationBufferSpace(size_t size) WARN_UNUSED_RESULT;
 
   // Set the timeout for writes made in this session.
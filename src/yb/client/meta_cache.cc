@@ -30,6 +30,7 @@
 // under the License.
 //
 
+#include <algorithm>
 #include <mutex>
 
 #include <boost/bind.hpp>
@@ -49,14 +50,21 @@
 #include "yb/rpc/messenger.h"
 #include "yb/rpc/rpc.h"
 #include "yb/tserver/tserver_service.proxy.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/net/dns_resolver.h"
 #include "yb/util/net/net_util.h"
+#include "yb/util/status_callback.h"
 
 using std::string;
 using std::map;
 using std::shared_ptr;
 using strings::Substitute;
 
+DEFINE_int32(meta_cache_prefetch_max_locations, 1000,
+             "Maximum number of tablet locations fetched from the master by the single lookup that "
+             "fills the cache of a table the client has no location of yet.");
+TAG_FLAG(meta_cache_prefetch_max_locations, advanced);
+
 namespace yb {
 
 using consensus::RaftPeerPB;
@@ -389,6 +397,9 @@ class LookupRpc : public Rpc {
   virtual RemoteTabletPtr FastLookup() = 0;
   virtual void DoSendRpc() = 0;
 
+  // Called once the lookup is done, with its final status, right before the user callback.
+  virtual void Finished(const Status& status) {}
+
   void NewLeaderMasterDeterminedCb(const Status& status);
 
   // Pointer back to the tablet cache. Populated with location information
@@ -440,6 +451,7 @@ void LookupRpc::SendRpc() {
     if (remote_tablet_) {
       *remote_tablet_ = result;
     }
+    Finished(Status::OK());
     user_cb_.Run(Status::OK());
     meta_cache_->rpcs_.Unregister(&retained_self_);
     return;
@@ -550,10 +562,13 @@ void LookupRpc::DoSendRpcCb(const Status& status,
   auto retained_self = meta_cache_->rpcs_.Unregister(&retained_self_);
 
   if (new_status.ok()) {
-    Notify(Status::OK(), apply_functor());
+    auto result = apply_functor();
+    Finished(Status::OK());
+    Notify(Status::OK(), result);
   } else {
     new_status = new_status.CloneAndPrepend(Substitute("$0 failed", ToString()));
     LOG(WARNING) << new_status.ToString();
+    Finished(new_status);
     Notify(new_status);
   }
 }
@@ -591,7 +606,13 @@ RemoteTabletPtr MetaCache::ProcessTabletLocations(
       remote = new RemoteTablet(tablet_id, partition);
 
       CHECK(tablets_by_id_.emplace(tablet_id, remote).second);
-      CHECK(tablets_by_key.emplace(partition.partition_key_start(), remote).second);
+      auto emplace_result = tablets_by_key.emplace(partition.partition_key_start(), remote);
+      if (!emplace_result.second) {
+        // The tablet cached for this key was replaced by a new one, e.g. when it was split.
+        VLOG(1) << "Tablet " << emplace_result.first->second->tablet_id() << " replaced by "
+                << tablet_id;
+        emplace_result.first->second = remote;
+      }
     }
     remote->Refresh(ts_cache_, loc.replicas());
 
@@ -657,10 +678,14 @@ class LookupByKeyRpc : public LookupRpc {
                  string partition_key,
                  scoped_refptr<RemoteTablet>* remote_tablet,
                  const MonoTime& deadline,
-                 const shared_ptr<Messenger>& messenger)
+                 const shared_ptr<Messenger>& messenger,
+                 std::shared_ptr<MetaCache::InFlightLookup> in_flight_lookup,
+                 int max_returned_locations = 0)
       : LookupRpc(meta_cache, std::move(user_cb), remote_tablet, deadline, messenger),
         table_(table),
-        partition_key_(std::move(partition_key)) {}
+        partition_key_(std::move(partition_key)),
+        in_flight_lookup_(std::move(in_flight_lookup)),
+        max_returned_locations_(max_returned_locations) {}
 
   std::string ToString() const override {
     return Format("GetTableLocations($0, $1, $2)",
@@ -682,6 +707,9 @@ class LookupByKeyRpc : public LookupRpc {
     // Fill out the request.
     req_.mutable_table()->set_table_id(table_->id());
     req_.set_partition_key_start(partition_key_);
+    if (max_returned_locations_ > 0) {
+      req_.set_max_returned_locations(max_returned_locations_);
+    }
 
     // The end partition key is left unset intentionally so that we'll prefetch
     // some additional tablets.
@@ -697,12 +725,25 @@ class LookupByKeyRpc : public LookupRpc {
     });
   }
 
+  void Finished(const Status& status) override {
+    if (in_flight_lookup_) {
+      meta_cache()->InFlightLookupFinished(table_->id(), in_flight_lookup_, status);
+    }
+  }
+
   // Table to lookup.
   const YBTable* table_;
 
   // Encoded partition key to lookup.
   std::string partition_key_;
 
+  // Lookups of the partitions this lookup covers wait for it to finish. Null if this lookup is not
+  // coalesced with others.
+  std::shared_ptr<MetaCache::InFlightLookup> in_flight_lookup_;
+
+  // Maximum number of tablet locations to fetch, or 0 for the master's default.
+  int max_returned_locations_;
+
   // Request body.
   GetTableLocationsRequestPB req_;
 
@@ -753,13 +794,156 @@ void MetaCache::LookupTabletByKey(const YBTable* table,
                                   const MonoTime& deadline,
                                   RemoteTabletPtr* remote_tablet,
                                   const StatusCallback& callback) {
-  rpc::StartRpc<LookupByKeyRpc>(this,
-                                callback,
-                                table,
-                                partition_key,
-                                remote_tablet,
-                                deadline,
-                                client_->data_->messenger_);
+  RemoteTabletPtr result = LookupTabletByKeyFastPath(table, partition_key);
+  if (result && result->HasLeader()) {
+    if (remote_tablet) {
+      *remote_tablet = result;
+    }
+    callback.Run(Status::OK());
+    return;
+  }
+
+  // Lookups are coalesced only when they are for the same partition. The partition of the key is
+  // known when its tablet is cached without a leader, otherwise only lookups of the same key are.
+  const std::string lookup_key = result ? result->partition().partition_key_start()
+                                        : partition_key;
+  auto in_flight_lookup = std::make_shared<InFlightLookup>();
+  bool prefetch;
+  {
+    std::lock_guard<std::mutex> lock(in_flight_lookups_mutex_);
+    auto& table_lookups = in_flight_lookups_[table->id()];
+    for (const auto& lookup : table_lookups) {
+      // The prefetch of a table fetches the locations of all of its partitions.
+      if (lookup->whole_table || lookup->partition_key == lookup_key) {
+        AddLookupWaiterUnlocked(
+            lookup, LookupWaiter{table, partition_key, deadline, remote_tablet, callback});
+        return;
+      }
+    }
+    // The first lookup of a table fetches the locations of the whole table, and the lookup of this
+    // key waits for it.
+    prefetch = !HasCachedTablets(table->id());
+    if (prefetch) {
+      in_flight_lookup->whole_table = true;
+      AddLookupWaiterUnlocked(
+          in_flight_lookup, LookupWaiter{table, partition_key, deadline, remote_tablet, callback});
+    } else {
+      in_flight_lookup->partition_key = lookup_key;
+    }
+    table_lookups.push_back(in_flight_lookup);
+  }
+
+  if (prefetch) {
+    VLOG(2) << "Prefetching the tablet locations of table " << table->name().ToString();
+    rpc::StartRpc<LookupByKeyRpc>(this,
+                                  Bind(&DoNothingStatusCB),
+                                  table,
+                                  "" /* partition_key */,
+                                  nullptr /* remote_tablet */,
+                                  deadline,
+                                  client_->data_->messenger_,
+                                  std::move(in_flight_lookup),
+                                  FLAGS_meta_cache_prefetch_max_locations);
+  } else {
+    rpc::StartRpc<LookupByKeyRpc>(this,
+                                  callback,
+                                  table,
+                                  partition_key,
+                                  remote_tablet,
+                                  deadline,
+                                  client_->data_->messenger_,
+                                  std::move(in_flight_lookup));
+  }
+}
+
+bool MetaCache::HasCachedTablets(const std::string& table_id) {
+  shared_lock<rw_spinlock> l(lock_);
+  const TabletMap* tablets = FindOrNull(tablets_by_table_and_key_, table_id);
+  return tablets != nullptr && !tablets->empty();
+}
+
+void MetaCache::AddLookupWaiterUnlocked(const std::shared_ptr<InFlightLookup>& lookup,
+                                        LookupWaiter waiter) {
+  const int64_t waiter_id = next_lookup_waiter_id_++;
+  // The waiter fails at its own deadline, even if the lookup it waits for has a later one.
+  if (waiter.deadline != MonoTime::Max()) {
+    scoped_refptr<MetaCache> self(this);
+    std::weak_ptr<InFlightLookup> weak_lookup(lookup);
+    waiter.timeout_task_id = client_->data_->messenger_->ScheduleOnReactor(
+        [self, weak_lookup, waiter_id](const Status& status) {
+          if (status.ok()) {
+            self->LookupWaiterTimedOut(weak_lookup, waiter_id);
+          }
+        },
+        waiter.deadline - MonoTime::Now());
+  }
+  lookup->waiters.emplace(waiter_id, std::move(waiter));
+}
+
+void MetaCache::LookupWaiterTimedOut(const std::weak_ptr<InFlightLookup>& weak_lookup,
+                                     int64_t waiter_id) {
+  auto lookup = weak_lookup.lock();
+  if (!lookup) {
+    return;
+  }
+  StatusCallback callback;
+  {
+    std::lock_guard<std::mutex> lock(in_flight_lookups_mutex_);
+    auto it = lookup->waiters.find(waiter_id);
+    if (it == lookup->waiters.end()) {
+      return;
+    }
+    callback = std::move(it->second.callback);
+    lookup->waiters.erase(it);
+  }
+  callback.Run(STATUS(TimedOut, "Timed out waiting for the tablet location lookup"));
+}
+
+void MetaCache::InFlightLookupFinished(const std::string& table_id,
+                                       const std::shared_ptr<InFlightLookup>& lookup,
+                                       const Status& status) {
+  std::unordered_map<int64_t, LookupWaiter> waiters;
+  {
+    std::lock_guard<std::mutex> lock(in_flight_lookups_mutex_);
+    auto it = in_flight_lookups_.find(table_id);
+    if (it != in_flight_lookups_.end()) {
+      auto& table_lookups = it->second;
+      table_lookups.erase(std::remove(table_lookups.begin(), table_lookups.end(), lookup),
+                          table_lookups.end());
+      if (table_lookups.empty()) {
+        in_flight_lookups_.erase(it);
+      }
+    }
+    waiters.swap(lookup->waiters);
+  }
+
+  for (auto& entry : waiters) {
+    auto& waiter = entry.second;
+    if (waiter.timeout_task_id != -1) {
+      client_->data_->messenger_->AbortOnReactor(waiter.timeout_task_id);
+    }
+    if (status.ok()) {
+      // The tablet of the key is now cached, unless the lookup returned too few locations to cover
+      // it, in which case it is looked up on its own.
+      LookupTabletByKey(waiter.table, waiter.partition_key, waiter.deadline, waiter.remote_tablet,
+                        waiter.callback);
+    } else if (status.IsAborted()) {
+      // The meta cache is shutting down.
+      waiter.callback.Run(status);
+    } else {
+      // The failure could be specific to the lookup waited for, e.g. its deadline could have been
+      // earlier. So the waiter is retried with a lookup of its own, that is not coalesced, until
+      // its own deadline.
+      rpc::StartRpc<LookupByKeyRpc>(this,
+                                    waiter.callback,
+                                    waiter.table,
+                                    waiter.partition_key,
+                                    waiter.remote_tablet,
+                                    waiter.deadline,
+                                    client_->data_->messenger_,
+                                    nullptr /* in_flight_lookup */);
+    }
+  }
 }
 
 void MetaCache::LookupTabletById(const string& tablet_id,
@@ -34,6 +34,7 @@
 #define YB_CLIENT_META_CACHE_H
 
 #include <map>
+#include <mutex>
 #include <string>
 #include <memory>
 #include <unordered_map>
@@ -77,6 +78,8 @@ class TSInfoPB;
 namespace client {
 
 class ClientTest_TestMasterLookupPermits_Test;
+class ClientTest_TestMetaCachePrefetch_Test;
+class MetaCacheLookupTest;
 class YBClient;
 class YBTable;
 
@@ -248,6 +251,10 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
   // available, the tablet is stored in 'remote_tablet' (if not NULL) and the
   // callback is fired. Only tablets with non-failed LEADERs are considered.
   //
+  // The first lookup of a table fetches the locations of all of its tablets (up to
+  // --meta_cache_prefetch_max_locations) in a single master RPC, and lookups of keys covered by a
+  // lookup in flight wait for it rather than sending their own RPC.
+  //
   // NOTE: the callback may be called from an IO thread or inline with this
   // call if the cached data is already available.
   //
@@ -281,6 +288,45 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
   friend class LookupByIdRpc;
 
   FRIEND_TEST(client::ClientTest, TestMasterLookupPermits);
+  FRIEND_TEST(client::ClientTest, TestMetaCachePrefetch);
+  friend class client::MetaCacheLookupTest;
+
+  // A lookup by key waiting for a lookup in flight to the master.
+  struct LookupWaiter {
+    const YBTable* table;
+    std::string partition_key;
+    MonoTime deadline;
+    RemoteTabletPtr* remote_tablet;
+    StatusCallback callback;
+    // Reactor task that fails the waiter at its deadline, or -1 if there is none.
+    int64_t timeout_task_id = -1;
+  };
+
+  // A lookup of the location of the tablet of a partition, in flight to the master. When
+  // 'whole_table' is set, the lookup prefetches the locations of all the tablets of the table.
+  struct InFlightLookup {
+    // Start key of the partition, or the looked up key if its partition is not known yet.
+    std::string partition_key;
+    bool whole_table = false;
+    std::unordered_map<int64_t, LookupWaiter> waiters;
+  };
+
+  // Returns whether the locations of some tablets of the given table are cached.
+  bool HasCachedTablets(const std::string& table_id);
+
+  // Adds a waiter to the given lookup in flight, and schedules its timeout.
+  // Requires in_flight_lookups_mutex_ to be held.
+  void AddLookupWaiterUnlocked(const std::shared_ptr<InFlightLookup>& lookup, LookupWaiter waiter);
+
+  // Fails the waiter with the given ID if it is still waiting for the lookup.
+  void LookupWaiterTimedOut(const std::weak_ptr<InFlightLookup>& weak_lookup, int64_t waiter_id);
+
+  // Called when the given lookup in flight is done. Looks the keys of its waiters up again if the
+  // lookup succeeded, now that the cache has been filled. Otherwise retries every waiter with a
+  // lookup of its own.
+  void InFlightLookupFinished(const std::string& table_id,
+                              const std::shared_ptr<InFlightLookup>& lookup,
+                              const Status& status);
 
   // Called on the slow LookupTablet path when the master responds. Populates
   // the tablet caches and returns a reference to the first one.
@@ -330,6 +376,11 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
   // permits have been acquired.
   Semaphore master_lookup_sem_;
 
+  // Lookups by key in flight to the master, by table ID. Never locked while holding lock_.
+  std::mutex in_flight_lookups_mutex_;
+  std::unordered_map<std::string, std::vector<std::shared_ptr<InFlightLookup>>> in_flight_lookups_;
+  int64_t next_lookup_waiter_id_ = 0;
+
   rpc::Rpcs rpcs_;
 
   DISALLOW_COPY_AND_ASSIGN(MetaCache);
@@ -30,14 +30,23 @@
 
 #include "yb/yql/cql/ql/util/statement_result.h"
 
+#include "yb/tablet/tablet_peer.h"
+
 #include "yb/tserver/mini_tablet_server.h"
 #include "yb/tserver/tablet_server.h"
 #include "yb/tserver/tserver_service.proxy.h"
 
+#include "yb/util/metrics.h"
+
 using namespace std::literals; // NOLINT
 
 DECLARE_uint64(initial_seqno);
 DECLARE_int32(leader_lease_duration_ms);
+DECLARE_bool(enable_automatic_tablet_splitting);
+DECLARE_uint64(tablet_split_size_threshold_bytes);
+DECLARE_int32(max_wait_for_follower_safe_time_ms);
+
+METRIC_DECLARE_histogram(handler_latency_yb_tserver_TabletServerService_Read);
 
 namespace yb {
 namespace client {
@@ -294,6 +303,76 @@ class QLTabletTest : public QLDmlTestBase {
     return tablets;
   }
 
+  size_t CountRunningTablets(const YBTableName& table_name) {
+    size_t result = 0;
+    for (const auto& tablet : GetTabletInfos(table_name)) {
+      if (tablet->LockForRead()->data().is_running()) {
+        ++result;
+      }
+    }
+    return result;
+  }
+
+  // Returns the peers of the single tablet of the table, with the leader first.
+  CHECKED_STATUS GetPeersLeaderFirst(const YBTableName& table_name,
+                                     std::vector<tablet::TabletPeerPtr>* peers) {
+    auto tablet_infos = GetTabletInfos(table_name);
+    if (tablet_infos.size() != 1) {
+      return STATUS_FORMAT(IllegalState, "Expected one tablet, found $0", tablet_infos.size());
+    }
+    return WaitFor([this, &tablet_infos, peers] {
+      peers->clear();
+      for (int i = 0; i != cluster_->num_tablet_servers(); ++i) {
+        auto* tablet_manager = cluster_->mini_tablet_server(i)->server()->tablet_manager();
+        tablet::TabletPeerPtr peer;
+        if (!tablet_manager->LookupTablet(tablet_infos[0]->id(), &peer)) {
+          continue;
+        }
+        peers->push_back(peer);
+        if (peer->LeaderStatus() == consensus::Consensus::LeaderStatus::LEADER_AND_READY) {
+          std::swap(peers->front(), peers->back());
+        }
+      }
+      return peers->size() == static_cast<size_t>(cluster_->num_tablet_servers()) &&
+             peers->front()->LeaderStatus() ==
+                 consensus::Consensus::LeaderStatus::LEADER_AND_READY;
+    }, 10s, "Wait for leader");
+  }
+
+  tserver::MiniTabletServer* FindTabletServer(const tablet::TabletPeerPtr& peer) {
+    return cluster_->find_tablet_server(peer->permanent_uuid());
+  }
+
+  // Reads the value of the key directly from the tablet server of the peer, with the given bounded
+  // staleness.
+  void StaleRead(const tablet::TabletPeerPtr& peer, int32_t key, MonoDelta max_staleness,
+                 TableHandle* table, tserver::ReadResponsePB* resp,
+                 rpc::RpcController* controller) {
+    auto* tserver = FindTabletServer(peer);
+    ASSERT_NE(nullptr, tserver);
+    tserver::TabletServerServiceProxy proxy(
+        tserver->server()->messenger(), tserver->server()->rpc_server()->GetBoundAddresses()[0]);
+    tserver::ReadRequestPB req;
+    std::string partition_key;
+    auto op = CreateReadOp(key, table);
+    ASSERT_OK(op->GetPartitionKey(&partition_key));
+    auto* ql_batch = req.add_ql_batch();
+    *ql_batch = op->request();
+    const auto& hash_code = PartitionSchema::DecodeMultiColumnHashValue(partition_key);
+    ql_batch->set_hash_code(hash_code);
+    ql_batch->set_max_hash_code(hash_code);
+    req.set_tablet_id(peer->tablet_id());
+    req.set_consistency_level(YBConsistencyLevel::CONSISTENT_PREFIX);
+    req.set_max_staleness_us(max_staleness.ToMicroseconds());
+    controller->set_timeout(10s);
+    ASSERT_OK(proxy.Read(req, resp, controller));
+  }
+
+  int64_t NumReads(const tablet::TabletPeerPtr& peer) {
+    return METRIC_handler_latency_yb_tserver_TabletServerService_Read.Instantiate(
+        FindTabletServer(peer)->server()->metric_entity())->TotalCount();
+  }
+
   TableHandle table1_;
   TableHandle table2_;
 };
@@ -328,6 +407,161 @@ TEST_F(QLTabletTest, ImportToEmptyAndRestart) {
   VerifyTable(0, kTotalKeys, &table2_);
 }
 
+TEST_F(QLTabletTest, AutomaticTabletSplit) {
+  google::FlagSaver saver;
+
+  YBSchemaBuilder builder;
+  builder.AddColumn(kKey)->Type(INT32)->HashPrimaryKey()->NotNull();
+  builder.AddColumn(kValue)->Type(INT32);
+  ASSERT_OK(table1_.Create(kTable1Name, 1 /* num_tablets */, client_.get(), &builder));
+
+  // The client caches the location of the single tablet of the table.
+  FillTable(0, kTotalKeys, &table1_);
+  cluster_->FlushTablets();
+
+  // Any tablet with SST data exceeds the split threshold.
+  FLAGS_tablet_split_size_threshold_bytes = 1;
+  FLAGS_enable_automatic_tablet_splitting = true;
+  ASSERT_OK(WaitFor([this] { return CountRunningTablets(kTable1Name) >= 2; },
+                    60s, "Split tablet"));
+  FLAGS_enable_automatic_tablet_splitting = false;
+
+  // The client is redirected from the split tablet to the new tablets, both for reads and writes.
+  VerifyTable(0, kTotalKeys, &table1_);
+  FillTable(kTotalKeys, 2 * kTotalKeys, &table1_);
+  VerifyTable(0, 2 * kTotalKeys, &table1_);
+
+  // A new client that only knows about the new tablets sees the same data.
+  shared_ptr<YBClient> client;
+  ASSERT_OK(cluster_->CreateClient(nullptr, &client));
+  TableHandle table;
+  ASSERT_OK(table.Open(kTable1Name, client.get()));
+  auto session = client->NewSession();
+  for (int i = 0; i != 2 * kTotalKeys; ++i) {
+    auto value = GetValue(session, i, &table);
+    ASSERT_TRUE(value.is_initialized()) << "i: " << i;
+    ASSERT_EQ(ValueForKey(i), *value) << "i: " << i;
+  }
+}
+
+// The leader propagates its safe time to the followers with consensus requests, so follower safe
+// time advances past everything the leader has written, without using the follower clock.
+TEST_F(QLTabletTest, FollowerSafeTime) {
+  YBSchemaBuilder builder;
+  builder.AddColumn(kKey)->Type(INT32)->HashPrimaryKey()->NotNull();
+  builder.AddColumn(kValue)->Type(INT32);
+  ASSERT_OK(table1_.Create(kTable1Name, 1 /* num_tablets */, client_.get(), &builder));
+  FillTable(0, kTotalKeys, &table1_);
+
+  std::vector<tablet::TabletPeerPtr> peers;
+  ASSERT_OK(GetPeersLeaderFirst(kTable1Name, &peers));
+  const auto leader_safe_time = peers[0]->tablet()->SafeTimestampToRead();
+  for (size_t i = 1; i != peers.size(); ++i) {
+    auto* mvcc = peers[i]->tablet()->mvcc_manager();
+    ASSERT_OK(WaitFor([mvcc, leader_safe_time] {
+      return mvcc->SafeTimeForFollower(HybridTime::kMin, MonoTime::Now()) >= leader_safe_time;
+    }, 10s, "Propagate safe time"));
+    // The follower never gets ahead of the leader.
+    ASSERT_LE(mvcc->SafeTimeForFollower(HybridTime::kMin, MonoTime::Now()),
+              peers[0]->tablet()->SafeTimestampToRead());
+  }
+}
+
+TEST_F(QLTabletTest, FollowerReadWithinStaleness) {
+  google::FlagSaver saver;
+
+  YBSchemaBuilder builder;
+  builder.AddColumn(kKey)->Type(INT32)->HashPrimaryKey()->NotNull();
+  builder.AddColumn(kValue)->Type(INT32);
+  ASSERT_OK(table1_.Create(kTable1Name, 1 /* num_tablets */, client_.get(), &builder));
+  FillTable(0, kTotalKeys, &table1_);
+
+  std::vector<tablet::TabletPeerPtr> peers;
+  ASSERT_OK(GetPeersLeaderFirst(kTable1Name, &peers));
+  const auto& follower = peers[1];
+
+  // Within the allowed staleness the follower serves the read itself.
+  {
+    tserver::ReadResponsePB resp;
+    rpc::RpcController controller;
+    ASSERT_NO_FATALS(StaleRead(follower, 1, 60s, &table1_, &resp, &controller));
+    ASSERT_FALSE(resp.has_error()) << resp.ShortDebugString();
+    ASSERT_EQ(QLResponsePB::YQL_STATUS_OK, resp.ql_batch(0).status());
+    Slice data;
+    ASSERT_OK(controller.GetSidecar(resp.ql_batch(0).rows_data_sidecar(), &data));
+    auto columns = std::make_shared<std::vector<ColumnSchema>>(table1_.schema().columns());
+    auto row_block = ql::RowsResult(table1_.name(), columns, data.ToBuffer()).GetRowBlock();
+    ASSERT_EQ(1, row_block->row_count());
+    ASSERT_EQ(ValueForKey(1), row_block->row(0).column(0).int32_value());
+  }
+
+  // The follower safe time cannot be as recent as the read time, so the follower rejects it.
+  FLAGS_max_wait_for_follower_safe_time_ms = 0;
+  {
+    tserver::ReadResponsePB resp;
+    rpc::RpcController controller;
+    ASSERT_NO_FATALS(StaleRead(follower, 1, 0s, &table1_, &resp, &controller));
+    ASSERT_TRUE(resp.has_error());
+    ASSERT_EQ(tserver::TabletServerErrorPB::STALE_FOLLOWER, resp.error().code())
+        << resp.ShortDebugString();
+  }
+}
+
+// A client that is close to a stale follower retries the read on the leader.
+TEST_F(QLTabletTest, StaleFollowerReadRetriedOnLeader) {
+  google::FlagSaver saver;
+  constexpr int kReads = 10;
+
+  YBSchemaBuilder builder;
+  builder.AddColumn(kKey)->Type(INT32)->HashPrimaryKey()->NotNull();
+  builder.AddColumn(kValue)->Type(INT32);
+  ASSERT_OK(table1_.Create(kTable1Name, 1 /* num_tablets */, client_.get(), &builder));
+  FillTable(0, kTotalKeys, &table1_);
+
+  std::vector<tablet::TabletPeerPtr> peers;
+  ASSERT_OK(GetPeersLeaderFirst(kTable1Name, &peers));
+  const auto& leader = peers[0];
+  const auto& follower = peers[1];
+
+  YBClientBuilder client_builder;
+  client_builder.set_tserver_uuid(follower->permanent_uuid());
+  std::shared_ptr<YBClient> client;
+  ASSERT_OK(cluster_->CreateClient(&client_builder, &client));
+  TableHandle table;
+  ASSERT_OK(table.Open(kTable1Name, client.get()));
+  auto session = client->NewSession();
+
+  auto read = [this, &table, &session](int32_t key, MonoDelta max_staleness) {
+    const auto op = CreateReadOp(key, &table);
+    op->set_yb_consistency_level(YBConsistencyLevel::CONSISTENT_PREFIX);
+    op->set_max_staleness(max_staleness);
+    ASSERT_OK(session->Apply(op));
+    ASSERT_EQ(QLResponsePB::YQL_STATUS_OK, op->response().status());
+    auto row_block = RowsResult(op.get()).GetRowBlock();
+    ASSERT_EQ(1, row_block->row_count());
+    ASSERT_EQ(ValueForKey(key), row_block->row(0).column(0).int32_value());
+  };
+
+  // The closest replica serves reads that allow enough staleness.
+  auto leader_reads = NumReads(leader);
+  auto follower_reads = NumReads(follower);
+  for (int i = 0; i != kReads; ++i) {
+    ASSERT_NO_FATALS(read(i, 60s));
+  }
+  ASSERT_EQ(follower_reads + kReads, NumReads(follower));
+  ASSERT_EQ(leader_reads, NumReads(leader));
+
+  // Every read is rejected by the follower and then served by the leader.
+  FLAGS_max_wait_for_follower_safe_time_ms = 0;
+  leader_reads = NumReads(leader);
+  follower_reads = NumReads(follower);
+  for (int i = 0; i != kReads; ++i) {
+    ASSERT_NO_FATALS(read(i, 0s));
+  }
+  ASSERT_EQ(follower_reads + kReads, NumReads(follower));
+  ASSERT_EQ(leader_reads + kReads, NumReads(leader));
+}
+
 TEST_F(QLTabletTest, ImportToNonEmptyAndRestart) {
   CreateTables(0, kBigSeqNo);
 
@@ -32,6 +32,7 @@
 
 #include "yb/client/session-internal.h"
 
+#include <algorithm>
 #include <memory>
 #include <mutex>
 
@@ -39,6 +40,17 @@
 #include "yb/client/callbacks.h"
 #include "yb/client/error_collector.h"
 #include "yb/client/yb_op.h"
+#include "yb/util/flag_tags.h"
+
+DEFINE_int32(client_background_flush_linger_ms, 10,
+             "How long a session in AUTO_FLUSH_BACKGROUND mode buffers applied operations before "
+             "flushing them, unless they fill their share of the mutation buffer space sooner.");
+TAG_FLAG(client_background_flush_linger_ms, advanced);
+
+DEFINE_int32(client_max_background_flushes, 4,
+             "Maximum number of batches a session in AUTO_FLUSH_BACKGROUND mode has in flight at a "
+             "time. A batch is flushed once it fills this fraction of the mutation buffer space.");
+TAG_FLAG(client_max_background_flushes, advanced);
 
 MAKE_ENUM_LIMITS(yb::client::YBSession::FlushMode,
                  yb::client::YBSession::AUTO_FLUSH_SYNC,
@@ -54,11 +66,22 @@ using internal::ErrorCollector;
 
 using std::shared_ptr;
 
+namespace {
+
+const size_t kDefaultMutationBufferSpace = 7 * 1024 * 1024;
+
+size_t MaxBackgroundFlushes() {
+  return std::max(FLAGS_client_max_background_flushes, 1);
+}
+
+} // namespace
+
 YBSessionData::YBSessionData(shared_ptr<YBClient> client,
                              const YBTransactionPtr& transaction)
     : client_(std::move(client)),
       transaction_(transaction),
-      error_collector_(new ErrorCollector()) {
+      error_collector_(new ErrorCollector()),
+      mutation_buffer_space_(kDefaultMutationBufferSpace) {
   const auto metric_entity = client_->messenger()->metric_entity();
   async_rpc_metrics_ = metric_entity ? std::make_shared<AsyncRpcMetrics>(metric_entity) : nullptr;
 }
@@ -69,7 +92,11 @@ YBSessionData::~YBSessionData() {
 void YBSessionData::SetTransaction(YBTransactionPtr transaction) {
   transaction_ = std::move(transaction);
   internal::BatcherPtr old_batcher;
-  old_batcher.swap(batcher_);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    old_batcher.swap(batcher_);
+    buffered_bytes_ = 0;
+  }
   if (old_batcher) {
     LOG_IF(DFATAL, old_batcher->HasPendingOperations()) << "SetTransaction with non empty batcher";
     old_batcher->Abort(STATUS(Aborted, "Transaction changed"));
@@ -77,31 +104,125 @@ void YBSessionData::SetTransaction(YBTransactionPtr transaction) {
 }
 
 void YBSessionData::FlushFinished(internal::BatcherPtr batcher) {
-  std::lock_guard<simple_spinlock> l(lock_);
-  CHECK_EQ(flushed_batchers_.erase(batcher), 1);
+  internal::BatcherPtr batcher_to_flush;
+  std::vector<YBStatusCallback*> callbacks;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = flushed_batchers_.find(batcher);
+    CHECK(it != flushed_batchers_.end());
+    in_flight_bytes_ -= it->second;
+    flushed_batchers_.erase(it);
+    if (ShouldFlushInBackgroundUnlocked()) {
+      batcher_to_flush = DetachBatcherUnlocked();
+    }
+    if (flushed_batchers_.empty()) {
+      callbacks.swap(flush_callbacks_);
+    }
+  }
+  flush_finished_cond_.notify_all();
+
+  if (batcher_to_flush) {
+    FlushInBackground(std::move(batcher_to_flush));
+  }
+  if (!callbacks.empty()) {
+    const Status status = error_collector_->CountErrors() == 0
+        ? Status::OK() : STATUS(IOError, "Some errors occurred");
+    for (auto* callback : callbacks) {
+      callback->Run(status);
+    }
+  }
 }
 
 void YBSessionData::Abort() {
-  if (batcher_ && batcher_->HasPendingOperations()) {
-    batcher_->Abort(STATUS(Aborted, "Batch aborted"));
-    batcher_.reset();
+  internal::BatcherPtr old_batcher;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!batcher_ || !batcher_->HasPendingOperations()) {
+      return;
+    }
+    old_batcher.swap(batcher_);
+    buffered_bytes_ = 0;
   }
+  old_batcher->Abort(STATUS(Aborted, "Batch aborted"));
 }
 
 Status YBSessionData::Close(bool force) {
-  if (batcher_) {
+  internal::BatcherPtr old_batcher;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!batcher_) {
+      return Status::OK();
+    }
     if (batcher_->HasPendingOperations() && !force) {
       return STATUS(IllegalState, "Could not close. There are pending operations.");
     }
-    batcher_->Abort(STATUS(Aborted, "Batch aborted"));
-    batcher_.reset();
+    old_batcher.swap(batcher_);
+    buffered_bytes_ = 0;
   }
+  old_batcher->Abort(STATUS(Aborted, "Batch aborted"));
   return Status::OK();
 }
 
-void YBSessionData::FlushAsync(YBStatusCallback* callback) {
-  CHECK_NE(flush_mode_, YBSession::AUTO_FLUSH_BACKGROUND) << "TODO: handle flush background mode";
+internal::BatcherPtr YBSessionData::DetachBatcherUnlocked() {
+  internal::BatcherPtr result;
+  result.swap(batcher_);
+  if (result) {
+    flushed_batchers_.emplace(result, buffered_bytes_);
+    in_flight_bytes_ += buffered_bytes_;
+  }
+  buffered_bytes_ = 0;
+  linger_expired_ = false;
+  return result;
+}
+
+bool YBSessionData::ShouldFlushInBackgroundUnlocked() const {
+  if (flush_mode_ != YBSession::AUTO_FLUSH_BACKGROUND || !batcher_ ||
+      flushed_batchers_.size() >= MaxBackgroundFlushes()) {
+    return false;
+  }
+  // Each batch is flushed at its share of the buffer space, so that the maximal number of batches
+  // could be in flight without blocking Apply.
+  return linger_expired_ || buffered_bytes_ >= mutation_buffer_space_ / MaxBackgroundFlushes();
+}
 
+void YBSessionData::FlushInBackground(internal::BatcherPtr batcher) {
+  // Errors are reported to the error collector, while the callback keeps this session alive until
+  // the batcher calls FlushFinished, so that flush callbacks waiting for it are called.
+  auto self = shared_from_this();
+  batcher->FlushAsync(MakeYBStatusFunctorCallback([self](const Status&) {}));
+}
+
+void YBSessionData::ScheduleLingerFlush(uint64_t generation) {
+  std::weak_ptr<YBSessionData> weak_self = shared_from_this();
+  client_->messenger()->ScheduleOnReactor(
+      [weak_self, generation](const Status& status) {
+        auto self = weak_self.lock();
+        if (status.ok() && self) {
+          self->LingerFlush(generation);
+        }
+      },
+      MonoDelta::FromMilliseconds(FLAGS_client_background_flush_linger_ms));
+}
+
+void YBSessionData::LingerFlush(uint64_t generation) {
+  internal::BatcherPtr batcher_to_flush;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!batcher_ || batcher_generation_ != generation) {
+      return;
+    }
+    // If too many batches are in flight, the batcher is flushed when one of them finishes.
+    linger_expired_ = true;
+    if (ShouldFlushInBackgroundUnlocked()) {
+      batcher_to_flush = DetachBatcherUnlocked();
+    }
+  }
+  if (batcher_to_flush) {
+    FlushInBackground(std::move(batcher_to_flush));
+  }
+}
+
+void YBSessionData::FlushAsync(YBStatusCallback* callback) {
   // Swap in a new batcher to start building the next batch.
   // Save off the old batcher.
   //
@@ -110,12 +231,22 @@ void YBSessionData::FlushAsync(YBStatusCallback* callback) {
   // the batch fails "inline" on the same thread.
 
   internal::BatcherPtr old_batcher;
-  old_batcher.swap(batcher_);
-  if (old_batcher) {
-    {
-      std::lock_guard<simple_spinlock> l(lock_);
-      flushed_batchers_.insert(old_batcher);
+  bool background = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    old_batcher = DetachBatcherUnlocked();
+    if (flush_mode_ == YBSession::AUTO_FLUSH_BACKGROUND && !flushed_batchers_.empty()) {
+      // The callback is called once the batches flushed in the background before finish too.
+      background = true;
+      flush_callbacks_.push_back(callback);
+    }
+  }
+
+  if (background) {
+    if (old_batcher) {
+      FlushInBackground(std::move(old_batcher));
     }
+  } else if (old_batcher) {
     old_batcher->FlushAsync(callback);
   } else {
     callback->Run(Status::OK());
@@ -123,17 +254,48 @@ void YBSessionData::FlushAsync(YBStatusCallback* callback) {
 }
 
 Status YBSessionData::Apply(std::shared_ptr<YBOperation> yb_op) {
-  if (!batcher_) {
-    batcher_.reset(new Batcher(client_.get(), error_collector_.get(), shared_from_this(),
-                               transaction_));
-    if (timeout_.Initialized()) {
-      batcher_->SetTimeout(timeout_);
+  const bool background = flush_mode_ == YBSession::AUTO_FLUSH_BACKGROUND;
+  const size_t op_size = background ? yb_op->SpaceUsedByRequest() : 0;
+  internal::BatcherPtr batcher_to_flush;
+  bool new_batcher = false;
+  uint64_t generation = 0;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (background) {
+      // Apply backpressure until the batches in flight leave enough buffer space.
+      flush_finished_cond_.wait(lock, [this, op_size] {
+        return in_flight_bytes_ == 0 ||
+               buffered_bytes_ + in_flight_bytes_ + op_size <= mutation_buffer_space_;
+      });
+    }
+
+    if (!batcher_) {
+      batcher_.reset(new Batcher(client_.get(), error_collector_.get(), shared_from_this(),
+                                 transaction_));
+      if (timeout_.Initialized()) {
+        batcher_->SetTimeout(timeout_);
+      }
+      new_batcher = true;
+      generation = ++batcher_generation_;
+    }
+    Status s = batcher_->Add(yb_op);
+    if (!PREDICT_FALSE(s.ok())) {
+      error_collector_->AddError(yb_op, s);
+      return s;
+    }
+
+    if (background) {
+      buffered_bytes_ += op_size;
+      if (ShouldFlushInBackgroundUnlocked()) {
+        batcher_to_flush = DetachBatcherUnlocked();
+      }
     }
   }
-  Status s = batcher_->Add(yb_op);
-  if (!PREDICT_FALSE(s.ok())) {
-    error_collector_->AddError(yb_op, s);
-    return s;
+
+  if (batcher_to_flush) {
+    FlushInBackground(std::move(batcher_to_flush));
+  } else if (background && new_batcher) {
+    ScheduleLingerFlush(generation);
   }
 
   if (flush_mode_ == YBSession::AUTO_FLUSH_SYNC) {
@@ -151,10 +313,7 @@ Status YBSessionData::Flush() {
 }
 
 Status YBSessionData::SetFlushMode(YBSession::FlushMode mode) {
-  if (mode == YBSession::AUTO_FLUSH_BACKGROUND) {
-    return STATUS(NotSupported, "AUTO_FLUSH_BACKGROUND has not been implemented in the"
-        " c++ client (see KUDU-456).");
-  }
+  std::lock_guard<std::mutex> lock(mutex_);
   if (batcher_ && batcher_->HasPendingOperations()) {
     // TODO: there may be a more reasonable behavior here.
     return STATUS(IllegalState, "Cannot change flush mode when writes are buffered");
@@ -168,8 +327,18 @@ Status YBSessionData::SetFlushMode(YBSession::FlushMode mode) {
   return Status::OK();
 }
 
+Status YBSessionData::SetMutationBufferSpace(size_t size) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (size == 0) {
+    return STATUS(InvalidArgument, "Mutation buffer space should be positive");
+  }
+  mutation_buffer_space_ = size;
+  return Status::OK();
+}
+
 void YBSessionData::SetTimeout(MonoDelta timeout) {
   CHECK_GE(timeout, MonoDelta::kZero);
+  std::lock_guard<std::mutex> lock(mutex_);
   timeout_ = timeout;
   if (batcher_) {
     batcher_->SetTimeout(timeout);
@@ -178,16 +347,17 @@ void YBSessionData::SetTimeout(MonoDelta timeout) {
 
 int YBSessionData::CountBufferedOperations() const {
   CHECK_EQ(flush_mode_, YBSession::MANUAL_FLUSH);
+  std::lock_guard<std::mutex> lock(mutex_);
   return batcher_ ? batcher_->CountBufferedOperations() : 0;
 }
 
 bool YBSessionData::HasPendingOperations() const {
+  std::lock_guard<std::mutex> lock(mutex_);
   if (batcher_ && batcher_->HasPendingOperations()) {
     return true;
   }
-  std::lock_guard<simple_spinlock> l(lock_);
   for (const auto& b : flushed_batchers_) {
-    if (b->HasPendingOperations()) {
+    if (b.first->HasPendingOperations()) {
       return true;
     }
   }
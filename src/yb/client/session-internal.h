@@ -32,7 +32,10 @@
 #ifndef YB_CLIENT_SESSION_INTERNAL_H_
 #define YB_CLIENT_SESSION_INTERNAL_H_
 
-#include <unordered_set>
+#include <condition_variable>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 #include "yb/client/async_rpc.h"
 #include "yb/util/locks.h"
@@ -80,6 +83,7 @@ class YBSessionData : public std::enable_shared_from_this<YBSessionData> {
   CHECKED_STATUS Close(bool force);
 
   CHECKED_STATUS SetFlushMode(YBSession::FlushMode mode);
+  CHECKED_STATUS SetMutationBufferSpace(size_t size);
   void SetTimeout(MonoDelta timeout);
   bool HasPendingOperations() const;
   int CountBufferedOperations() const;
@@ -96,13 +100,32 @@ class YBSessionData : public std::enable_shared_from_this<YBSessionData> {
   }
 
  private:
+  // Moves batcher_ to flushed_batchers_ and returns it, mutex_ should be held.
+  internal::BatcherPtr DetachBatcherUnlocked();
+
+  // Returns true if batcher_ should be flushed in AUTO_FLUSH_BACKGROUND mode, mutex_ should be
+  // held.
+  bool ShouldFlushInBackgroundUnlocked() const;
+
+  // Flushes a batcher detached in AUTO_FLUSH_BACKGROUND mode.
+  void FlushInBackground(internal::BatcherPtr batcher);
+
+  // Flushes batcher_ once it has buffered operations for the linger time, if it is still the
+  // batcher with the given generation.
+  void ScheduleLingerFlush(uint64_t generation);
+  void LingerFlush(uint64_t generation);
+
   // The client that this session is associated with.
   const std::shared_ptr<YBClient> client_;
 
   YBTransactionPtr transaction_;
 
-  // Lock protecting flushed_batchers_.
-  mutable simple_spinlock lock_;
+  // Lock protecting batcher_, flushed_batchers_ and the state of AUTO_FLUSH_BACKGROUND mode.
+  mutable std::mutex mutex_;
+
+  // Signalled when a flushed batcher finishes, so that operations waiting for buffer space in
+  // AUTO_FLUSH_BACKGROUND mode could proceed.
+  std::condition_variable flush_finished_cond_;
 
   // Buffer for errors.
   scoped_refptr<internal::ErrorCollector> error_collector_;
@@ -110,18 +133,38 @@ class YBSessionData : public std::enable_shared_from_this<YBSessionData> {
   // The current batcher being prepared.
   scoped_refptr<internal::Batcher> batcher_;
 
-  // Any batchers which have been flushed but not yet finished.
+  // Any batchers which have been flushed but not yet finished, with the size of their operations
+  // buffered in AUTO_FLUSH_BACKGROUND mode.
   //
   // Upon a batch finishing, it will call FlushFinished(), which removes the batcher from
-  // this set. This set does not hold any reference count to the Batcher, since, while
+  // this map. This map does not hold any reference count to the Batcher, since, while
   // the flush is active, the batcher manages its own refcount. The Batcher will always
   // call FlushFinished() before it destructs itself, so we're guaranteed that these
   // pointers stay valid.
-  std::unordered_set<
-      internal::BatcherPtr, ScopedRefPtrHashFunctor, ScopedRefPtrEqualsFunctor> flushed_batchers_;
+  std::unordered_map<
+      internal::BatcherPtr, size_t, ScopedRefPtrHashFunctor, ScopedRefPtrEqualsFunctor>
+      flushed_batchers_;
 
   YBSession::FlushMode flush_mode_ = YBSession::AUTO_FLUSH_SYNC;
 
+  // Maximum size of the operations buffered or in flight in AUTO_FLUSH_BACKGROUND mode.
+  size_t mutation_buffer_space_;
+
+  // Size of the operations buffered in batcher_ in AUTO_FLUSH_BACKGROUND mode.
+  size_t buffered_bytes_ = 0;
+
+  // Size of the operations of flushed_batchers_.
+  size_t in_flight_bytes_ = 0;
+
+  // Incremented each time batcher_ is created, to tell whether a linger flush is still relevant.
+  uint64_t batcher_generation_ = 0;
+
+  // Whether batcher_ has been buffering operations for the linger time.
+  bool linger_expired_ = false;
+
+  // Callbacks of flushes in AUTO_FLUSH_BACKGROUND mode, called once all flushed batchers finish.
+  std::vector<YBStatusCallback*> flush_callbacks_;
+
   // Timeout for the next batch.
   MonoDelta timeout_;
 
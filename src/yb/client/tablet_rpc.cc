@@ -134,9 +134,6 @@ void TabletInvoker::Execute(const std::string& tablet_id) {
   //    updates the looked-up tablet.
   // Put another way, we don't care about the lookup results at all; we're
   // just using it to fetch the latest consensus configuration information.
-  //
-  // TODO: When we support tablet splits, we should let the lookup shift
-  // the write to another tablet (i.e. if it's since been split).
   if (!current_ts_) {
     client_->LookupTabletById(tablet_id_,
                               retrier_->deadline(),
@@ -207,6 +204,29 @@ bool TabletInvoker::Done(Status* status) {
     *status = resp_error_status;
   }
 
+  // The tablet has been split, so retrying it cannot succeed. The caller sends the request to the
+  // tablets it was split into, which the next lookup fetches from the master.
+  if (ErrorCode(rpc_->response_error()) == tserver::TabletServerErrorPB::TABLET_SPLIT) {
+    if (tablet_) {
+      tablet_->MarkStale();
+    }
+    return true;
+  }
+
+  // The follower lags behind the staleness allowed by a bounded staleness read, so retry it on the
+  // leader right away, there is nothing to wait for. Getting this error while targeting the leader
+  // means it is not the leader anymore, so back off as for other leader changes.
+  if (ErrorCode(rpc_->response_error()) == tserver::TabletServerErrorPB::STALE_FOLLOWER) {
+    if (consistent_prefix_) {
+      consistent_prefix_ = false;
+      retrier_->ImmediateRetry(command_, *status);
+    } else {
+      followers_.insert(current_ts_);
+      retrier_->DelayedRetry(command_, *status);
+    }
+    return false;
+  }
+
   // Oops, we failed over to a replica that wasn't a LEADER. Unlikely as
   // we're using consensus configuration information from the master, but still possible
   // (e.g. leader restarted and became a FOLLOWER). Try again.
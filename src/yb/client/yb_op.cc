@@ -103,6 +103,10 @@ Status YBRedisWriteOp::GetPartitionKey(std::string *partition_key) const {
   return table_->partition_schema().EncodeRedisKey(slice, partition_key);
 }
 
+size_t YBRedisWriteOp::SpaceUsedByRequest() const {
+  return redis_write_request_->SpaceUsed();
+}
+
 // YBRedisReadOp -----------------------------------------------------------------
 
 YBRedisReadOp::YBRedisReadOp(const shared_ptr<YBTable>& table)
@@ -128,6 +132,10 @@ Status YBRedisReadOp::GetPartitionKey(std::string *partition_key) const {
   return table_->partition_schema().EncodeRedisKey(slice, partition_key);
 }
 
+size_t YBRedisReadOp::SpaceUsedByRequest() const {
+  return redis_read_request_->SpaceUsed();
+}
+
 // YBqlOp -----------------------------------------------------------------
   YBqlOp::YBqlOp(const shared_ptr<YBTable>& table)
       : YBOperation(table) , ql_response_(new QLResponsePB()) {
@@ -180,6 +188,10 @@ Status YBqlWriteOp::GetPartitionKey(string* partition_key) const {
                                               partition_key);
 }
 
+size_t YBqlWriteOp::SpaceUsedByRequest() const {
+  return ql_write_request_->SpaceUsed();
+}
+
 void YBqlWriteOp::SetHashCode(const uint16_t hash_code) {
   ql_write_request_->set_hash_code(hash_code);
 }
@@ -270,6 +282,10 @@ Status YBqlReadOp::GetPartitionKey(string* partition_key) const {
   return Status::OK();
 }
 
+size_t YBqlReadOp::SpaceUsedByRequest() const {
+  return ql_read_request_->SpaceUsed();
+}
+
 std::vector<ColumnSchema> MakeColumnSchemasFromColDesc(
   const google::protobuf::RepeatedPtrField<QLRSColDescPB>& rscol_descs) {
   std::vector<ColumnSchema> column_schemas;
@@ -41,6 +41,8 @@
 
 #include "yb/client/meta_cache.h"
 
+#include "yb/util/monotime.h"
+
 namespace yb {
 
 class EncodedKey;
@@ -104,6 +106,10 @@ class YBOperation {
   // Returns the partition key of the operation.
   virtual CHECKED_STATUS GetPartitionKey(std::string* partition_key) const = 0;
 
+  // Returns the memory used by the request of the operation, used to limit the size of the
+  // operations buffered by a session.
+  virtual size_t SpaceUsedByRequest() const = 0;
+
  protected:
   explicit YBOperation(const std::shared_ptr<YBTable>& table);
 
@@ -158,6 +164,8 @@ class YBRedisWriteOp : public YBRedisOp {
 
   virtual CHECKED_STATUS GetPartitionKey(std::string* partition_key) const override;
 
+  size_t SpaceUsedByRequest() const override;
+
  protected:
   virtual Type type() const override {
     return REDIS_WRITE;
@@ -194,6 +202,8 @@ class YBRedisReadOp : public YBRedisOp {
 
   CHECKED_STATUS GetPartitionKey(std::string* partition_key) const override;
 
+  size_t SpaceUsedByRequest() const override;
+
  protected:
   virtual Type type() const override { return REDIS_READ; }
 
@@ -245,6 +255,8 @@ class YBqlWriteOp : public YBqlOp {
 
   virtual CHECKED_STATUS GetPartitionKey(std::string* partition_key) const override;
 
+  size_t SpaceUsedByRequest() const override;
+
  protected:
   virtual Type type() const override {
     return QL_WRITE;
@@ -281,6 +293,8 @@ class YBqlReadOp : public YBqlOp {
   // Also sets the hash_code and max_hash_code in the request.
   virtual CHECKED_STATUS GetPartitionKey(std::string* partition_key) const override;
 
+  size_t SpaceUsedByRequest() const override;
+
   const YBConsistencyLevel yb_consistency_level() {
     return yb_consistency_level_;
   }
@@ -295,6 +309,11 @@ class YBqlReadOp : public YBqlOp {
   const ReadHybridTime& read_time() const { return read_time_; }
   void SetReadTime(const ReadHybridTime& value) { read_time_ = value; }
 
+  // With CONSISTENT_PREFIX consistency level, allows a follower to serve the read only if its data
+  // is not older than the given staleness, otherwise the read is retried on the leader.
+  const MonoDelta& max_staleness() const { return max_staleness_; }
+  void set_max_staleness(const MonoDelta& value) { max_staleness_ = value; }
+
  protected:
   virtual Type type() const override { return QL_READ; }
 
@@ -304,6 +323,7 @@ class YBqlReadOp : public YBqlOp {
   std::unique_ptr<QLReadRequestPB> ql_read_request_;
   YBConsistencyLevel yb_consistency_level_;
   ReadHybridTime read_time_;
+  MonoDelta max_staleness_;
 };
 
 std::vector<ColumnSchema> MakeColumnSchemasFromColDesc(
@@ -412,7 +412,8 @@ YB_DEFINE_ENUM(StateChangeReason,
     (NEW_LEADER_ELECTED)
     (FOLLOWER_NO_OP_COMPLETE)
     (LEADER_CONFIG_CHANGE_COMPLETE)
-    (FOLLOWER_CONFIG_CHANGE_COMPLETE));
+    (FOLLOWER_CONFIG_CHANGE_COMPLETE)
+    (TABLET_SPLIT));
 
 // Context provided for callback on master/tablet-server peer state change for post processing
 // e.g., update in-memory contents.
@@ -464,6 +465,8 @@ struct StateChangeContext {
       case StateChangeReason::FOLLOWER_CONFIG_CHANGE_COMPLETE:
         return strings::Substitute("Config change $0 complete on follower",
           change_record.ShortDebugString());
+      case StateChangeReason::TABLET_SPLIT:
+        return "Tablet split";
       case StateChangeReason::INVALID_REASON: FALLTHROUGH_INTENDED;
       default:
         return "INVALID REASON";
@@ -506,6 +509,15 @@ class ReplicaOperationFactory {
  public:
   virtual CHECKED_STATUS StartReplicaOperation(const ConsensusRoundPtr& context) = 0;
 
+  // Returns safe time to read on the leader, that is sent to followers with consensus requests.
+  virtual HybridTime PropagatedSafeTime() {
+    return HybridTime::kInvalidHybridTime;
+  }
+
+  // Sets safe time received from the leader, after all operations preceding the leader's
+  // committed index at the moment it was sent were started on this replica.
+  virtual void SetPropagatedSafeTime(HybridTime ht) {}
+
   virtual ~ReplicaOperationFactory() {}
 };
 
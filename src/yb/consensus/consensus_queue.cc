@@ -305,6 +305,10 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
                                         bool* needs_remote_bootstrap,
                                         RaftPeerPB::MemberType* member_type,
                                         bool* last_exchange_successful) {
+  // Safe time is taken before the committed index, so all operations it covers are committed.
+  HybridTime propagated_safe_time = propagated_safe_time_provider_
+      ? propagated_safe_time_provider_() : HybridTime::kInvalidHybridTime;
+
   TrackedPeer* peer = nullptr;
   OpId preceding_id;
   MonoDelta unreachable_time = MonoDelta::kMin;
@@ -334,6 +338,11 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
     preceding_id = queue_state_.last_appended;
     request->mutable_committed_index()->CopyFrom(queue_state_.committed_index);
     request->set_caller_term(queue_state_.current_term);
+    if (propagated_safe_time.is_valid()) {
+      request->set_propagated_safe_time(propagated_safe_time.ToUint64());
+    } else {
+      request->clear_propagated_safe_time();
+    }
     unreachable_time =
         MonoTime::Now().GetDeltaSince(peer->last_successful_communication_time);
   }
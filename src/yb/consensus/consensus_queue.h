@@ -33,6 +33,7 @@
 #ifndef YB_CONSENSUS_CONSENSUS_QUEUE_H_
 #define YB_CONSENSUS_CONSENSUS_QUEUE_H_
 
+#include <functional>
 #include <iosfwd>
 #include <map>
 #include <string>
@@ -295,6 +296,12 @@ class PeerMessageQueue {
   void NotifyObserversOfFailedFollower(const std::string& uuid,
                                        const std::string& reason);
 
+  // Sets the provider of safe time sent to followers in ConsensusRequestPB::propagated_safe_time.
+  // Should be called before the queue is used.
+  void SetPropagatedSafeTimeProvider(std::function<HybridTime()> provider) {
+    propagated_safe_time_provider_ = std::move(provider);
+  }
+
  private:
   FRIEND_TEST(ConsensusQueueTest, TestQueueAdvancesCommittedIndex);
 
@@ -447,6 +454,8 @@ class PeerMessageQueue {
   Metrics metrics_;
 
   server::ClockPtr clock_;
+
+  std::function<HybridTime()> propagated_safe_time_provider_;
 };
 
 inline std::ostream& operator <<(std::ostream& out, PeerMessageQueue::Mode mode) {
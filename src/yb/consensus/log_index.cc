@@ -57,15 +57,12 @@
 #include "yb/gutil/map-util.h"
 #include "yb/gutil/stringprintf.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/util/errno.h"
 #include "yb/util/locks.h"
 
 using std::string;
 using strings::Substitute;
 
-#define RETRY_ON_EINTR(ret, expr) do { \
-  ret = expr; \
-} while ((ret == -1) && (errno == EINTR));
-
 namespace yb {
 namespace log {
 
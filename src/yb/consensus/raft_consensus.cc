@@ -238,6 +238,11 @@ scoped_refptr<RaftConsensus> RaftConsensus::Create(
                                                            local_peer_pb,
                                                            options.tablet_id,
                                                            clock));
+  if (operation_factory) {
+    queue->SetPropagatedSafeTimeProvider([operation_factory] {
+      return operation_factory->PropagatedSafeTime();
+    });
+  }
 
   gscoped_ptr<ThreadPool> thread_pool;
   CHECK_OK(ThreadPoolBuilder(Substitute("$0-raft", options.tablet_id.substr(0, 6)))
@@ -1517,6 +1522,15 @@ Status RaftConsensus::UpdateReplica(ConsensusRequestPB* request,
     // 4 - Mark operations as committed
     RETURN_NOT_OK(MarkOperationsAsCommittedUnlocked(*request, deduped_req, last_from_leader));
 
+    // Safe time propagated by the leader covers operations up to its committed index, so it is
+    // only usable once we have started all of them.
+    if (request->has_propagated_safe_time() &&
+        state_->GetLastReceivedOpIdCurLeaderUnlocked().index() >=
+            request->committed_index().index()) {
+      state_->GetReplicaOperationFactoryUnlocked()->SetPropagatedSafeTime(
+          HybridTime(request->propagated_safe_time()));
+    }
+
     // Fill the response with the current state. We will not mutate anymore state until
     // we actually reply to the leader, we'll just wait for the messages to be durable.
     FillConsensusResponseOKUnlocked(response);
@@ -18,6 +18,8 @@
 #include "yb/rocksdb/table.h"
 #include "yb/rocksdb/table/full_filter_block.h"
 
+#include "yb/common/partition.h"
+#include "yb/docdb/docdb_compaction_filter.h"
 #include "yb/docdb/docdb_test_util.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/rocksutil/yb_rocksdb.h"
@@ -405,5 +407,36 @@ TEST(DocKeyTest, TestWriteId) {
   TestRoundTripDocOrSubDocKeyEncodingDecoding(subdoc_key);
 }
 
+TEST(DocKeyTest, TestKeyBounds) {
+  // Bounds of a tablet covering the hash codes [0x4000, 0x8000).
+  KeyBounds bounds;
+  ASSERT_FALSE(bounds.IsInitialized());
+  bounds.lower.AppendValueType(ValueType::kUInt16Hash);
+  bounds.lower.AppendRawBytes(PartitionSchema::EncodeMultiColumnHashValue(0x4000));
+  bounds.upper.AppendValueType(ValueType::kUInt16Hash);
+  bounds.upper.AppendRawBytes(PartitionSchema::EncodeMultiColumnHashValue(0x8000));
+  ASSERT_TRUE(bounds.IsInitialized());
+
+  const auto within_bounds = [&bounds](uint16_t hash) {
+    return bounds.IsWithinBounds(
+        SubDocKey(DocKey(hash, {PrimitiveValue("h")}, {PrimitiveValue("r")}),
+                  PrimitiveValue("c"), HybridTime::FromMicros(1000)).Encode().AsSlice());
+  };
+  ASSERT_FALSE(within_bounds(0x0000));
+  ASSERT_FALSE(within_bounds(0x3fff));
+  ASSERT_TRUE(within_bounds(0x4000));
+  ASSERT_TRUE(within_bounds(0x7fff));
+  ASSERT_FALSE(within_bounds(0x8000));
+  ASSERT_FALSE(within_bounds(0xffff));
+
+  // Keys without a hash component are not bounded.
+  ASSERT_TRUE(bounds.IsWithinBounds(DocKey({PrimitiveValue("a")}).Encode().AsSlice()));
+
+  // An empty bound does not restrict keys on that side.
+  bounds.upper.Clear();
+  ASSERT_TRUE(within_bounds(0xffff));
+  ASSERT_FALSE(within_bounds(0x3fff));
+}
+
 }  // namespace docdb
 }  // namespace yb
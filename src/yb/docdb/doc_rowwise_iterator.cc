@@ -23,6 +23,7 @@
 #include "yb/docdb/doc_key.h"
 #include "yb/docdb/doc_ql_scanspec.h"
 #include "yb/docdb/intent_aware_iterator.h"
+#include "yb/docdb/row_cache.h"
 #include "yb/docdb/subdocument.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/rocksdb/db/compaction.h"
@@ -60,7 +61,8 @@ DocRowwiseIterator::DocRowwiseIterator(
     const TransactionOperationContextOpt& txn_op_context,
     rocksdb::DB *db,
     const ReadHybridTime& read_time,
-    yb::util::PendingOperationCounter* pending_op_counter)
+    yb::util::PendingOperationCounter* pending_op_counter,
+    RowCache* row_cache)
     : projection_(projection),
       schema_(schema),
       txn_op_context_(txn_op_context),
@@ -68,7 +70,8 @@ DocRowwiseIterator::DocRowwiseIterator(
       db_(db),
       has_bound_key_(false),
       pending_op_(pending_op_counter),
-      done_(false) {
+      done_(false),
+      row_cache_(row_cache) {
   projection_subkeys_.reserve(projection.num_columns() + 1);
   projection_subkeys_.push_back(PrimitiveValue::SystemColumnId(SystemColumnIds::kLivenessColumn));
   for (size_t i = projection_.num_key_columns(); i < projection.num_columns(); i++) {
@@ -130,6 +133,29 @@ Status DocRowwiseIterator::Init(const common::QLScanSpec& spec) {
   const KeyBytes row_key_encoded = lower_doc_key.Encode();
   const Slice row_key_encoded_as_slice = row_key_encoded.AsSlice();
 
+  // Rows with a TTL would expire in the cache, and transactional tables could have committed
+  // intents that are not applied yet, which the cache does not know about.
+  if (row_cache_ != nullptr && !txn_op_context_ && TableTTL(schema_).Equals(Value::kMaxTtl) &&
+      IsPointRead(lower_doc_key, upper_doc_key)) {
+    row_cache_key_ = row_key_encoded;
+    if (row_cache_->Lookup(row_cache_key_.AsSlice(), read_time_.read, &row_)) {
+      row_key_ = lower_doc_key;
+      row_from_cache_ = true;
+      row_ready_ = true;
+      return Status::OK();
+    }
+    row_cache_invalidation_count_ = row_cache_->InvalidationCount(row_cache_key_.AsSlice());
+    fill_row_cache_ = true;
+    // Read all the columns, so that the cached row could serve any projection.
+    projection_subkeys_.clear();
+    projection_subkeys_.push_back(
+        PrimitiveValue::SystemColumnId(SystemColumnIds::kLivenessColumn));
+    for (size_t i = schema_.num_key_columns(); i < schema_.num_columns(); i++) {
+      projection_subkeys_.emplace_back(schema_.column_id(i));
+    }
+    std::sort(projection_subkeys_.begin(), projection_subkeys_.end());
+  }
+
   db_iter_ = CreateIntentAwareIterator(
       db_, mode, row_key_encoded_as_slice, doc_spec.QueryId(), txn_op_context_, read_time_,
       doc_spec.CreateFileFilter());
@@ -164,6 +190,35 @@ Status DocRowwiseIterator::Init(const common::QLScanSpec& spec) {
   return Status::OK();
 }
 
+bool DocRowwiseIterator::IsPointRead(
+    const DocKey& lower_doc_key, const DocKey& upper_doc_key) const {
+  if (lower_doc_key.hashed_group().size() != schema_.num_hash_key_columns() ||
+      lower_doc_key.range_group().size() != schema_.num_range_key_columns()) {
+    return false;
+  }
+  for (const auto& component : lower_doc_key.range_group()) {
+    if (component.value_type() == ValueType::kLowest ||
+        component.value_type() == ValueType::kHighest) {
+      return false;
+    }
+  }
+  // The upper bound of a single row is its key followed by +inf, see DocQLScanSpec.
+  DocKey single_row_upper_doc_key = lower_doc_key;
+  single_row_upper_doc_key.AddRangeComponent(PrimitiveValue(ValueType::kHighest));
+  return upper_doc_key == single_row_upper_doc_key;
+}
+
+void DocRowwiseIterator::MaybeInsertIntoRowCache() const {
+  // A write above the read time was seen, so the row could be newer than its state as of it.
+  if (row_key_.Encode().CompareTo(row_cache_key_) != 0 ||
+      db_iter_->max_seen_ht() > read_time_.read ||
+      row_.HasTtl()) {
+    return;
+  }
+  row_cache_->Insert(
+      row_cache_key_.AsSlice(), read_time_.read, row_cache_invalidation_count_, row_);
+}
+
 Status DocRowwiseIterator::EnsureIteratorPositionCorrect() const {
   if (!is_forward_scan_) {
     db_iter_->PrevDocKey(row_key_);
@@ -181,6 +236,12 @@ bool DocRowwiseIterator::HasNext() const {
 
   if (done_) return false;
 
+  if (row_from_cache_) {
+    // The only row of the point read was already returned.
+    done_ = true;
+    return false;
+  }
+
   bool doc_found = false;
   while (!doc_found) {
     if (!db_iter_->valid()) {
@@ -253,6 +314,10 @@ bool DocRowwiseIterator::HasNext() const {
     }
   }
   row_ready_ = true;
+  if (fill_row_cache_) {
+    fill_row_cache_ = false;
+    MaybeInsertIntoRowCache();
+  }
   return true;
 }
 
@@ -477,6 +542,9 @@ void DocRowwiseIterator::SkipRow() {
 }
 
 HybridTime DocRowwiseIterator::RestartReadHt() {
+  if (db_iter_ == nullptr) {
+    return HybridTime::kInvalidHybridTime;
+  }
   auto max_seen_ht = db_iter_->max_seen_ht();
   if (max_seen_ht.is_valid() && max_seen_ht > db_iter_->read_time().read) {
     return max_seen_ht;
@@ -541,7 +609,7 @@ void DocRowwiseIterator::GetIteratorStats(std::vector<IteratorStats>* stats) con
 }
 
 CHECKED_STATUS DocRowwiseIterator::GetNextReadSubDocKey(SubDocKey* sub_doc_key) const {
-  if (db_iter_ == nullptr) {
+  if (db_iter_ == nullptr && !row_from_cache_) {
     return STATUS(Corruption, "Iterator not initialized.");
   }
 
@@ -38,6 +38,7 @@ namespace yb {
 namespace docdb {
 
 class IntentAwareIterator;
+class RowCache;
 
 // An adapter between SQL-mapped-to-document-DB and Kudu's RowwiseIterator.
 class DocRowwiseIterator : public common::QLRowwiseIteratorIf {
@@ -47,7 +48,8 @@ class DocRowwiseIterator : public common::QLRowwiseIteratorIf {
                      const TransactionOperationContextOpt& txn_op_context,
                      rocksdb::DB *db,
                      const ReadHybridTime& read_time,
-                     yb::util::PendingOperationCounter* pending_op_counter = nullptr);
+                     yb::util::PendingOperationCounter* pending_op_counter = nullptr,
+                     RowCache* row_cache = nullptr);
   virtual ~DocRowwiseIterator();
 
   CHECKED_STATUS Init(ScanSpec *spec) override;
@@ -128,6 +130,12 @@ class DocRowwiseIterator : public common::QLRowwiseIteratorIf {
                                      const Value& value,
                                      bool* is_valid) const;
 
+  // Returns true if the scan bounds select a single row by its full primary key.
+  bool IsPointRead(const DocKey& lower_doc_key, const DocKey& upper_doc_key) const;
+
+  // Caches the row just read by a point read, if its state as of read_time_ is still current.
+  void MaybeInsertIntoRowCache() const;
+
   // For reverse scans, moves the iterator to the first kv-pair of the previous row after having
   // constructed the current row. For forward scans nothing is necessary because GetSubDocument
   // ensures that the iterator will be positioned on the first kv-pair of the next row.
@@ -178,6 +186,21 @@ class DocRowwiseIterator : public common::QLRowwiseIteratorIf {
 
   // Used for keeping track of errors that happen in HasNext. Returned
   mutable Status status_;
+
+  // Serves the point reads of a non-transactional table, if set.
+  RowCache* const row_cache_;
+
+  // The encoded key of the row of a point read that uses row_cache_.
+  KeyBytes row_cache_key_;
+
+  // The row of the point read was found in row_cache_, db_iter_ is not used.
+  bool row_from_cache_ = false;
+
+  // The row of the point read was not found in row_cache_ and should be inserted once read.
+  mutable bool fill_row_cache_ = false;
+
+  // The invalidation count of row_cache_ for row_cache_key_ before the row was read.
+  uint64_t row_cache_invalidation_count_ = 0;
 };
 
 }  // namespace docdb
@@ -374,6 +374,34 @@ TEST_F(DocDBTest, DocPathTest) {
   ASSERT_EQ("123", doc_path.subkey(1).ToString());
 }
 
+TEST_F(DocDBTest, SubcompactionBoundary) {
+  DocDBCompactionFilterFactory factory(
+      std::make_shared<FixedHybridTimeRetentionPolicy>(HybridTime::kMax, MonoDelta::kMax));
+
+  for (const auto& doc_key : {DocKey(PrimitiveValues("mydockey", 123456)),
+                              DocKey(0x1234, PrimitiveValues("hashed"), PrimitiveValues(10))}) {
+    SCOPED_TRACE(doc_key.ToString());
+    const KeyBytes encoded_doc_key(doc_key.Encode());
+    ASSERT_EQ(encoded_doc_key.data(),
+              factory.GetSubcompactionBoundary(encoded_doc_key.AsSlice()).ToBuffer());
+
+    // A boundary inside of a document is moved to the start of the document, so that all the
+    // subkeys of the document are compacted by the same subcompaction.
+    const KeyBytes subkey(
+        SubDocKey(doc_key, PrimitiveValue("subkey1"), HybridTime::FromMicros(1000)).Encode());
+    ASSERT_EQ(encoded_doc_key.data(),
+              factory.GetSubcompactionBoundary(subkey.AsSlice()).ToBuffer());
+    const KeyBytes nested_subkey(SubDocKey(
+        doc_key, PrimitiveValue("subkey1"), PrimitiveValue(20), HybridTime::FromMicros(2000))
+            .Encode());
+    ASSERT_EQ(encoded_doc_key.data(),
+              factory.GetSubcompactionBoundary(nested_subkey.AsSlice()).ToBuffer());
+  }
+
+  // The compaction is not split at a key that is not a document key.
+  ASSERT_TRUE(factory.GetSubcompactionBoundary(Slice()).empty());
+}
+
 TEST_F(DocDBTest, HistoryCompactionFirstRowHandlingRegression) {
   // A regression test for a bug in an initial version of compaction cleanup.
   const DocKey doc_key(PrimitiveValues("mydockey", 123456));
@@ -27,12 +27,34 @@
 namespace yb {
 namespace docdb {
 
+// The range [lower, upper) of hashed document keys that belong to a tablet, an empty bound meaning
+// no bound. A tablet created by splitting another tablet starts with all the data of the split
+// tablet, and the keys outside of its bounds are only dropped by compactions. Keys of documents
+// without a hash component are not bounded.
+struct KeyBounds {
+  KeyBytes lower;
+  KeyBytes upper;
+
+  bool IsInitialized() const {
+    return lower.size() != 0 || upper.size() != 0;
+  }
+
+  bool IsWithinBounds(const Slice& key) const {
+    if (key.empty() || key[0] != static_cast<uint8_t>(ValueType::kUInt16Hash)) {
+      return true;
+    }
+    return (lower.size() == 0 || key.compare(lower.AsSlice()) >= 0) &&
+           (upper.size() == 0 || key.compare(upper.AsSlice()) < 0);
+  }
+};
+
 class DocDBCompactionFilter : public rocksdb::CompactionFilter {
  public:
   DocDBCompactionFilter(HybridTime history_cutoff,
                         ColumnIdsPtr deleted_cols,
                         bool is_full_compaction,
-                        MonoDelta table_ttl);
+                        MonoDelta table_ttl,
+                        const KeyBounds* key_bounds = nullptr);
 
   ~DocDBCompactionFilter() override;
   bool Filter(int level,
@@ -100,6 +122,9 @@ class DocDBCompactionFilter : public rocksdb::CompactionFilter {
   MonoDelta table_ttl_;
 
   ColumnIdsPtr deleted_cols_;
+
+  // Keys outside of these bounds are removed by any compaction. Not owned, may be null.
+  const KeyBounds* key_bounds_;
 };
 
 // A strategy for deciding the history cutoff. We may implement this differently in production and
@@ -139,14 +164,21 @@ class FixedHybridTimeRetentionPolicy : public HistoryRetentionPolicy {
 
 class DocDBCompactionFilterFactory : public rocksdb::CompactionFilterFactory {
  public:
-  explicit DocDBCompactionFilterFactory(std::shared_ptr<HistoryRetentionPolicy> retention_policy);
+  // 'key_bounds', if not null, must outlive the factory and the filters it creates.
+  explicit DocDBCompactionFilterFactory(std::shared_ptr<HistoryRetentionPolicy> retention_policy,
+                                        const KeyBounds* key_bounds = nullptr);
   ~DocDBCompactionFilterFactory() override;
   std::unique_ptr<rocksdb::CompactionFilter> CreateCompactionFilter(
       const rocksdb::CompactionFilter::Context& context) override;
   const char* Name() const override;
 
+  // DocDBCompactionFilter tracks state across the subkeys of a document, so subcompactions are
+  // split at document key boundaries only.
+  Slice GetSubcompactionBoundary(const Slice& user_key) const override;
+
  private:
   std::shared_ptr<HistoryRetentionPolicy> retention_policy_;
+  const KeyBounds* key_bounds_;
 };
 
 }  // namespace docdb
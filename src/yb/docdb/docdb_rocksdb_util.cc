@@ -34,6 +34,9 @@ DEFINE_int32(rocksdb_base_background_compactions, 2,
 DEFINE_int32(rocksdb_max_background_compactions, 4,
              "Increased number of threads to do background compactions (used when compactions need "
              "to catch up.)");
+DEFINE_int32(rocksdb_max_subcompactions, 1,
+             "Maximal number of key range parts a single compaction is split into, to be run by "
+             "concurrent threads.");
 DEFINE_int32(rocksdb_level0_file_num_compaction_trigger, 5,
              "Number of files to trigger level-0 compaction. -1 if compaction should not be "
              "triggered by number of files at all.");
@@ -56,6 +59,13 @@ DEFINE_uint64(rocksdb_max_file_size_for_compaction, 0,
 DEFINE_int64(db_block_size_bytes, 32 * 1024,
              "Size of RocksDB block (in bytes).");
 
+DEFINE_int64(db_scan_initial_readahead_size_bytes, 64 * 1024,
+             "Size of the first prefetch of data blocks when a scan reads consecutive blocks of an "
+             "SST file. Every next prefetch of the scan doubles it.");
+DEFINE_int64(db_scan_max_readahead_size_bytes, 1024 * 1024,
+             "Maximal size of a prefetch of data blocks done by a scan, which bounds the data "
+             "prefetched ahead of it. 0 - disable the readahead.");
+
 DEFINE_int64(db_write_buffer_size, -1,
              "Size of RocksDB write buffer (in bytes). -1 to use default.");
 
@@ -334,6 +344,7 @@ void InitRocksDBOptions(
   options->initial_seqno = FLAGS_initial_seqno;
   options->boundary_extractor = DocBoundaryValuesExtractorInstance();
   options->memory_monitor = tablet_options.memory_monitor;
+  options->background_work_scheduler = tablet_options.background_work_scheduler;
   if (FLAGS_db_write_buffer_size != -1) {
     options->write_buffer_size = FLAGS_db_write_buffer_size;
   }
@@ -352,6 +363,8 @@ void InitRocksDBOptions(
     table_options.cache_index_and_filter_blocks = false;
   }
   table_options.block_size = FLAGS_db_block_size_bytes;
+  table_options.initial_auto_readahead_size = FLAGS_db_scan_initial_readahead_size_bytes;
+  table_options.max_auto_readahead_size = FLAGS_db_scan_max_readahead_size_bytes;
 
   // Set our custom bloom filter that is docdb aware.
   if (FLAGS_use_docdb_aware_bloom_filter) {
@@ -375,6 +388,7 @@ void InitRocksDBOptions(
     options->base_background_compactions = FLAGS_rocksdb_base_background_compactions;
     options->max_background_compactions = FLAGS_rocksdb_max_background_compactions;
     options->max_background_flushes = FLAGS_rocksdb_max_background_flushes;
+    options->max_subcompactions = FLAGS_rocksdb_max_subcompactions;
     options->level0_file_num_compaction_trigger = FLAGS_rocksdb_level0_file_num_compaction_trigger;
     options->level0_slowdown_writes_trigger = FLAGS_rocksdb_level0_slowdown_writes_trigger;
     options->level0_stop_writes_trigger = FLAGS_rocksdb_level0_stop_writes_trigger;
@@ -387,7 +401,9 @@ void InitRocksDBOptions(
     options->compaction_options_universal.min_merge_width =
         FLAGS_rocksdb_universal_compaction_min_merge_width;
     options->compaction_size_threshold_bytes = FLAGS_rocksdb_compaction_size_threshold_bytes;
-    if (FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec > 0) {
+    if (tablet_options.rate_limiter) {
+      options->rate_limiter = tablet_options.rate_limiter;
+    } else if (FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec > 0) {
       options->rate_limiter.reset(
           rocksdb::NewGenericRateLimiter(FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec));
     }
@@ -23,10 +23,13 @@
 namespace yb {
 namespace docdb {
 
+class RowCache;
+
 // Implementation of QLStorageIf with rocksdb as a backend. This is what all of our QL tables use.
 class QLRocksDBStorage : public common::QLStorageIf {
  public:
-  explicit QLRocksDBStorage(rocksdb::DB *rocksdb);
+  // Point reads are served from row_cache, if it is set.
+  explicit QLRocksDBStorage(rocksdb::DB *rocksdb, RowCache* row_cache = nullptr);
 
   CHECKED_STATUS GetIterator(const QLReadRequestPB& request,
                              const Schema& projection,
@@ -45,6 +48,7 @@ class QLRocksDBStorage : public common::QLStorageIf {
                                  ReadHybridTime* req_read_time) const override;
  private:
   rocksdb::DB *const rocksdb_;
+  RowCache* const row_cache_;
 };
 
 }  // namespace docdb
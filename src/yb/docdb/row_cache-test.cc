@@ -0,0 +1,162 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/row_cache.h"
+
+#include <string>
+
+#include "yb/docdb/doc_key.h"
+#include "yb/util/format.h"
+#include "yb/util/mem_tracker.h"
+#include "yb/util/test_util.h"
+
+using std::string;
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+SubDocument MakeRow(const string& value) {
+  SubDocument row;
+  auto column = PrimitiveValue(value);
+  column.SetTtl(-1);
+  row.SetChildPrimitive(PrimitiveValue(ColumnId(10)), column);
+  return row;
+}
+
+} // namespace
+
+class RowCacheTest : public YBTest {
+ protected:
+  RowCacheTest()
+      : mem_tracker_(MemTracker::CreateTracker(-1, "row_cache-test")),
+        cache_(new RowCache(16 * 1024 * 1024, HybridTime::FromMicros(100), mem_tracker_)) {}
+
+  ~RowCacheTest() {
+    cache_.reset();
+    mem_tracker_->UnregisterFromParent();
+  }
+
+  void Insert(const string& key, MicrosTime read_micros, const string& value) {
+    auto invalidation_count = cache_->InvalidationCount(key);
+    cache_->Insert(key, HybridTime::FromMicros(read_micros), invalidation_count, MakeRow(value));
+  }
+
+  bool Lookup(const string& key, MicrosTime read_micros, SubDocument* row) {
+    return cache_->Lookup(key, HybridTime::FromMicros(read_micros), row);
+  }
+
+  std::shared_ptr<MemTracker> mem_tracker_;
+  std::unique_ptr<RowCache> cache_;
+};
+
+TEST_F(RowCacheTest, LookupAtReadTime) {
+  Insert("key", 200, "value");
+  SubDocument row;
+  // The row read at 200 could miss the writes at or below 200 for a read at an earlier time.
+  ASSERT_FALSE(Lookup("key", 150, &row));
+  ASSERT_TRUE(Lookup("key", 200, &row));
+  ASSERT_EQ(MakeRow("value"), row);
+  ASSERT_TRUE(Lookup("key", 300, &row));
+  ASSERT_FALSE(Lookup("other_key", 300, &row));
+  ASSERT_GT(mem_tracker_->consumption(), 0);
+}
+
+TEST_F(RowCacheTest, Invalidate) {
+  Insert("key", 200, "value");
+  cache_->Invalidate("key", HybridTime::FromMicros(250));
+  SubDocument row;
+  ASSERT_FALSE(Lookup("key", 300, &row));
+  ASSERT_EQ(0, mem_tracker_->consumption());
+
+  // The row read at 240 misses the write at 250.
+  Insert("key", 240, "value");
+  ASSERT_FALSE(Lookup("key", 300, &row));
+
+  Insert("key", 260, "new_value");
+  ASSERT_TRUE(Lookup("key", 300, &row));
+  ASSERT_EQ(MakeRow("new_value"), row);
+}
+
+TEST_F(RowCacheTest, InvalidateDuringRead) {
+  auto invalidation_count = cache_->InvalidationCount("key");
+  cache_->Invalidate("key", HybridTime::FromMicros(150));
+  cache_->Insert("key", HybridTime::FromMicros(200), invalidation_count, MakeRow("value"));
+  SubDocument row;
+  ASSERT_FALSE(Lookup("key", 300, &row));
+}
+
+TEST_F(RowCacheTest, InvalidatePrefix) {
+  auto row_key = [](int hash, int range) {
+    return DocKey(hash, {PrimitiveValue::Int32(hash)}, {PrimitiveValue::Int32(range)})
+        .Encode().AsStringRef();
+  };
+  // The prefix of the keys of the rows having the given hashed part, i.e. its doc key without the
+  // closing group end.
+  auto hash_prefix = [](int hash) {
+    auto key = DocKey(hash, {PrimitiveValue::Int32(hash)}).Encode().AsStringRef();
+    key.pop_back();
+    return key;
+  };
+  for (int hash = 1; hash <= 2; ++hash) {
+    for (int range = 1; range <= 2; ++range) {
+      Insert(row_key(hash, range), 200, "value");
+    }
+  }
+  ASSERT_EQ(4U, cache_->size());
+
+  cache_->InvalidatePrefix(hash_prefix(1), HybridTime::FromMicros(250));
+  SubDocument row;
+  ASSERT_FALSE(Lookup(row_key(1, 1), 300, &row));
+  ASSERT_FALSE(Lookup(row_key(1, 2), 300, &row));
+  ASSERT_TRUE(Lookup(row_key(2, 1), 300, &row));
+  ASSERT_TRUE(Lookup(row_key(2, 2), 300, &row));
+
+  // Rows without a hashed part are invalidated in all the shards.
+  for (int range = 1; range <= 10; ++range) {
+    Insert(DocKey({PrimitiveValue::Int32(1), PrimitiveValue::Int32(range)}).Encode().AsStringRef(),
+           300, "value");
+  }
+  ASSERT_EQ(12U, cache_->size());
+  auto range_prefix = DocKey({PrimitiveValue::Int32(1)}).Encode().AsStringRef();
+  range_prefix.pop_back();
+  cache_->InvalidatePrefix(range_prefix, HybridTime::FromMicros(350));
+  ASSERT_EQ(2U, cache_->size());
+}
+
+TEST_F(RowCacheTest, WritesBeforeCreation) {
+  // Writes applied before the cache was created could be up to 100.
+  Insert("key", 50, "value");
+  SubDocument row;
+  ASSERT_FALSE(Lookup("key", 300, &row));
+}
+
+TEST_F(RowCacheTest, Eviction) {
+  cache_.reset();
+  cache_.reset(new RowCache(16 * 1024, HybridTime::FromMicros(100), mem_tracker_));
+  const string large_value(512, 'x');
+  for (int i = 0; i != 1000; ++i) {
+    Insert(Format("key_$0", i), 200, large_value);
+  }
+  ASSERT_GT(cache_->size(), 0U);
+  ASSERT_LT(cache_->size(), 1000U);
+  ASSERT_LE(mem_tracker_->consumption(), 16 * 1024);
+
+  cache_->Clear();
+  ASSERT_EQ(0U, cache_->size());
+  ASSERT_EQ(0, mem_tracker_->consumption());
+}
+
+}  // namespace docdb
+}  // namespace yb
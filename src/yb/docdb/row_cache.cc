@@ -0,0 +1,172 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/row_cache.h"
+
+#include <iterator>
+
+#include "yb/docdb/doc_key.h"
+#include "yb/util/mem_tracker.h"
+
+namespace yb {
+namespace docdb {
+
+RowCache::RowCache(size_t capacity_bytes,
+                   HybridTime initial_write_ht,
+                   const std::shared_ptr<MemTracker>& parent_mem_tracker)
+    : capacity_bytes_(capacity_bytes),
+      mem_tracker_(MemTracker::CreateTracker(-1, "RowCache", parent_mem_tracker)) {
+  for (auto& shard : shards_) {
+    shard.max_write_ht = initial_write_ht;
+  }
+}
+
+RowCache::~RowCache() {
+  Clear();
+  mem_tracker_->UnregisterFromParent();
+}
+
+size_t RowCache::HashedPartSize(const Slice& encoded_doc_key) {
+  auto size = DocKey::EncodedSize(encoded_doc_key, DocKeyPart::HASHED_PART_ONLY);
+  return size.ok() ? *size : 0;
+}
+
+size_t RowCache::ShardIndex(const Slice& encoded_doc_key) {
+  const size_t hashed_part_size = HashedPartSize(encoded_doc_key);
+  const Slice shard_key = hashed_part_size != 0
+      ? Slice(encoded_doc_key.data(), hashed_part_size) : encoded_doc_key;
+  return shard_key.hash() % kNumShards;
+}
+
+RowCache::Shard& RowCache::GetShard(const Slice& encoded_doc_key) {
+  return shards_[ShardIndex(encoded_doc_key)];
+}
+
+const RowCache::Shard& RowCache::GetShard(const Slice& encoded_doc_key) const {
+  return shards_[ShardIndex(encoded_doc_key)];
+}
+
+bool RowCache::Lookup(const Slice& encoded_doc_key, HybridTime read_ht, SubDocument* row) {
+  auto& shard = GetShard(encoded_doc_key);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto it = shard.entries.find(encoded_doc_key);
+  // The cached row could include writes above an earlier read time.
+  if (it == shard.entries.end() || read_ht < it->second->read_ht) {
+    return false;
+  }
+  shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+  *row = it->second->row;
+  return true;
+}
+
+uint64_t RowCache::InvalidationCount(const Slice& encoded_doc_key) const {
+  const auto& shard = GetShard(encoded_doc_key);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  return shard.invalidation_count;
+}
+
+void RowCache::Insert(const Slice& encoded_doc_key, HybridTime read_ht,
+                      uint64_t invalidation_count, SubDocument row) {
+  const size_t shard_capacity = capacity_bytes_ / kNumShards;
+  const size_t charge = sizeof(Entry) + encoded_doc_key.size() + row.ApproximateMemoryUsage();
+  if (charge > shard_capacity) {
+    return;
+  }
+
+  auto& shard = GetShard(encoded_doc_key);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  // A write applied during the read could have been missed by it, and a write applied before it
+  // above read_ht is not reflected in the row, while it would be for a later read.
+  if (shard.invalidation_count != invalidation_count || read_ht < shard.max_write_ht) {
+    return;
+  }
+  auto it = shard.entries.find(encoded_doc_key);
+  if (it != shard.entries.end()) {
+    EraseUnlocked(&shard, it->second);
+  }
+  while (shard.usage + charge > shard_capacity) {
+    EraseUnlocked(&shard, std::prev(shard.lru.end()));
+  }
+  if (!mem_tracker_->TryConsume(charge)) {
+    return;
+  }
+  shard.lru.push_front(Entry{encoded_doc_key.ToBuffer(), read_ht, std::move(row), charge});
+  shard.entries.emplace(shard.lru.front().key, shard.lru.begin());
+  shard.usage += charge;
+}
+
+void RowCache::Invalidate(const Slice& encoded_doc_key, HybridTime write_ht) {
+  auto& shard = GetShard(encoded_doc_key);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  ++shard.invalidation_count;
+  shard.max_write_ht.MakeAtLeast(write_ht);
+  auto it = shard.entries.find(encoded_doc_key);
+  if (it != shard.entries.end()) {
+    EraseUnlocked(&shard, it->second);
+  }
+}
+
+void RowCache::InvalidatePrefix(const Slice& doc_key_prefix, HybridTime write_ht) {
+  if (HashedPartSize(doc_key_prefix) != 0) {
+    InvalidatePrefixInShard(&GetShard(doc_key_prefix), doc_key_prefix, write_ht);
+    return;
+  }
+  // Without the hashed part, the rows under the prefix could be in any shard.
+  for (auto& shard : shards_) {
+    InvalidatePrefixInShard(&shard, doc_key_prefix, write_ht);
+  }
+}
+
+void RowCache::InvalidatePrefixInShard(
+    Shard* shard, const Slice& doc_key_prefix, HybridTime write_ht) {
+  std::lock_guard<std::mutex> lock(shard->mutex);
+  ++shard->invalidation_count;
+  shard->max_write_ht.MakeAtLeast(write_ht);
+  // Writes to key prefixes are rare, so the shard is just scanned.
+  for (auto it = shard->lru.begin(); it != shard->lru.end();) {
+    auto next = std::next(it);
+    if (Slice(it->key).starts_with(doc_key_prefix)) {
+      EraseUnlocked(shard, it);
+    }
+    it = next;
+  }
+}
+
+void RowCache::Clear() {
+  for (auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    ++shard.invalidation_count;
+    while (!shard.lru.empty()) {
+      EraseUnlocked(&shard, shard.lru.begin());
+    }
+  }
+}
+
+size_t RowCache::size() const {
+  size_t result = 0;
+  for (const auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    result += shard.entries.size();
+  }
+  return result;
+}
+
+void RowCache::EraseUnlocked(Shard* shard, EntryList::iterator it) {
+  shard->entries.erase(it->key);
+  shard->usage -= it->charge;
+  mem_tracker_->Release(it->charge);
+  shard->lru.erase(it);
+}
+
+}  // namespace docdb
+}  // namespace yb
@@ -0,0 +1,133 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_ROW_CACHE_H_
+#define YB_DOCDB_ROW_CACHE_H_
+
+#include <array>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "yb/common/hybrid_time.h"
+#include "yb/docdb/subdocument.h"
+#include "yb/util/slice.h"
+
+namespace yb {
+
+class MemTracker;
+
+namespace docdb {
+
+// Caches the rows of a tablet, decoded as the subdocuments of their encoded DocKeys, so that
+// repeated point reads of hot rows don't have to go to RocksDB.
+//
+// A row is cached with the hybrid time it was read at, and serves reads at that time or later until
+// a write to the row is applied, which erases it. For that to be correct, a row read at some time
+// is only inserted if all writes applied to the rows of its shard, before and during the read, are
+// at or below that time. Rows are evicted in LRU order when their memory, accounted in a
+// MemTracker, can not grow anymore.
+//
+// Rows are sharded by the hashed part of their DocKeys, if they have one, so a write to a key
+// prefix that includes the hashed part only touches the shard of the rows under that prefix.
+//
+// This class is thread-safe.
+class RowCache {
+ public:
+  // Writes applied before the cache was created must be at or below initial_write_ht.
+  RowCache(size_t capacity_bytes,
+           HybridTime initial_write_ht,
+           const std::shared_ptr<MemTracker>& parent_mem_tracker);
+  ~RowCache();
+
+  RowCache(const RowCache&) = delete;
+  void operator=(const RowCache&) = delete;
+
+  // Copies the row cached for the given encoded doc key to row and returns true, if the cached row
+  // can serve a read at read_ht.
+  bool Lookup(const Slice& encoded_doc_key, HybridTime read_ht, SubDocument* row);
+
+  // Returns the number of writes applied to the shard of the given encoded doc key so far. Must be
+  // called before reading a row that is going to be inserted.
+  uint64_t InvalidationCount(const Slice& encoded_doc_key) const;
+
+  // Caches the row read at read_ht for the given encoded doc key. invalidation_count is what
+  // InvalidationCount returned before the read. Does nothing if the row could have been written
+  // since it was read.
+  void Insert(const Slice& encoded_doc_key, HybridTime read_ht, uint64_t invalidation_count,
+              SubDocument row);
+
+  // Erases the cached row of the given encoded doc key. Must be called after a write at write_ht
+  // to the row is applied.
+  void Invalidate(const Slice& encoded_doc_key, HybridTime write_ht);
+
+  // Erases the cached rows whose encoded doc keys start with the given prefix, i.e. an encoded doc
+  // key without its closing group end. Must be called after a write at write_ht to the prefix is
+  // applied.
+  void InvalidatePrefix(const Slice& doc_key_prefix, HybridTime write_ht);
+
+  // Erases all the cached rows, e.g. after rows were changed bypassing the write path.
+  void Clear();
+
+  // Returns the number of cached rows.
+  size_t size() const;
+
+ private:
+  static constexpr size_t kNumShards = 16;
+
+  struct Entry {
+    std::string key;
+    HybridTime read_ht;
+    SubDocument row;
+    size_t charge;
+  };
+
+  typedef std::list<Entry> EntryList;
+
+  struct Shard {
+    mutable std::mutex mutex;
+    // Most recently used entries first.
+    EntryList lru;
+    // Keys point to the key of the entry.
+    std::unordered_map<Slice, EntryList::iterator, Slice::Hash> entries;
+    // Sum of the charges of the entries.
+    size_t usage = 0;
+    uint64_t invalidation_count = 0;
+    // The highest hybrid time of a write applied to a row of this shard.
+    HybridTime max_write_ht;
+  };
+
+  // Returns the size of the hashed part of the given doc key or its prefix, or 0 if there is none.
+  static size_t HashedPartSize(const Slice& encoded_doc_key);
+
+  Shard& GetShard(const Slice& encoded_doc_key);
+  const Shard& GetShard(const Slice& encoded_doc_key) const;
+  static size_t ShardIndex(const Slice& encoded_doc_key);
+
+  // Erases the cached rows of the shard under the given prefix, and accounts the write to it.
+  void InvalidatePrefixInShard(Shard* shard, const Slice& doc_key_prefix, HybridTime write_ht);
+
+  // Erases the given entry of the shard, whose mutex must be held.
+  void EraseUnlocked(Shard* shard, EntryList::iterator it);
+
+  const size_t capacity_bytes_;
+  std::shared_ptr<MemTracker> mem_tracker_;
+  std::array<Shard, kNumShards> shards_;
+};
+
+}  // namespace docdb
+}  // namespace yb
+
+#endif  // YB_DOCDB_ROW_CACHE_H_
@@ -238,6 +238,64 @@ string SubDocument::ToString() const {
   return ss.str();
 }
 
+namespace {
+
+// Approximate number of bytes used by a node of std::map, in addition to its value.
+constexpr size_t kMapNodeOverhead = 32;
+
+size_t PrimitiveValueMemoryUsage(const PrimitiveValue& value) {
+  size_t result = sizeof(PrimitiveValue);
+  if (value.IsString()) {
+    result += value.GetString().size();
+  } else if (value.value_type() == ValueType::kDecimal ||
+             value.value_type() == ValueType::kDecimalDescending) {
+    result += value.GetDecimal().size();
+  }
+  return result;
+}
+
+} // namespace
+
+size_t SubDocument::ApproximateMemoryUsage() const {
+  if (has_valid_object_container()) {
+    size_t result = sizeof(SubDocument) + sizeof(ObjectContainer);
+    for (const auto& child : object_container()) {
+      result += kMapNodeOverhead + PrimitiveValueMemoryUsage(child.first) +
+                child.second.ApproximateMemoryUsage();
+    }
+    return result;
+  }
+  if (has_valid_array_container()) {
+    size_t result = sizeof(SubDocument) + sizeof(ArrayContainer);
+    for (const auto& child : array_container()) {
+      result += child.ApproximateMemoryUsage();
+    }
+    return result;
+  }
+  return PrimitiveValueMemoryUsage(*this);
+}
+
+bool SubDocument::HasTtl() const {
+  if (has_valid_object_container()) {
+    for (const auto& child : object_container()) {
+      if (child.second.HasTtl()) {
+        return true;
+      }
+    }
+    return false;
+  }
+  if (has_valid_array_container()) {
+    for (const auto& child : array_container()) {
+      if (child.HasTtl()) {
+        return true;
+      }
+    }
+    return false;
+  }
+  // The TTL is only set on primitive values, collections carry it on their elements.
+  return !IsCollectionType(type_) && GetTtl() >= 0;
+}
+
 ostream& operator <<(ostream& out, const SubDocument& subdoc) {
   SubDocumentToStreamInternal(out, subdoc, 0);
   return out;
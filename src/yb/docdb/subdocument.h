@@ -144,6 +144,13 @@ class SubDocument : public PrimitiveValue {
   // Creates a JSON-like string representation of this subdocument.
   std::string ToString() const;
 
+  // Returns the approximate number of bytes of memory used by this subdocument and its children.
+  size_t ApproximateMemoryUsage() const;
+
+  // Returns true if a primitive value of this subdocument or of its children was read with a TTL,
+  // i.e. it is going to expire.
+  bool HasTtl() const;
+
   // Attempts to delete a child subdocument of an object with the given key. Fatals if this is not
   // an object.
   // @return true if a child object was deleted, false if it did not exist.
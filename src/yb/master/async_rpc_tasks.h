@@ -324,6 +324,34 @@ class AsyncAlterTable : public RetryingTSRpcTask {
   tserver::AlterSchemaResponsePB resp_;
 };
 
+// Send the "Split Tablet" request to the leader replica of the tablet.
+// Keeps retrying until we get an "ok" response.
+//  - Tablet server applies the split idempotently, so a retried request that was already applied
+//    also succeeds.
+class AsyncSplitTablet : public RetryingTSRpcTask {
+ public:
+  AsyncSplitTablet(Master *master,
+                   ThreadPool* callback_pool,
+                   const scoped_refptr<TabletInfo>& tablet);
+
+  Type type() const override { return ASYNC_SPLIT_TABLET; }
+
+  std::string type_name() const override { return "Split Tablet"; }
+
+  std::string description() const override;
+
+  std::string tablet_id() const override;
+
+ private:
+  std::string permanent_uuid() const;
+
+  void HandleResponse(int attempt) override;
+  bool SendRequest(int attempt) override;
+
+  scoped_refptr<TabletInfo> tablet_;
+  tserver::SplitTabletResponsePB resp_;
+};
+
 class CommonInfoForRaftTask : public RetryingTSRpcTask {
  public:
   CommonInfoForRaftTask(
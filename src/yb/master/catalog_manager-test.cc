@@ -30,6 +30,7 @@
 // under the License.
 //
 
+#include "yb/gutil/strings/util.h"
 #include "yb/master/catalog_manager-test_base.h"
 
 namespace yb {
@@ -129,5 +130,49 @@ TEST(TestLoadBalancerCommunity, TestLoadBalancerAlgorithm) {
   lb->TestAlgorithm();
 }
 
+// Replays a cluster where the tablet counts are even, but both hot tablets sit on the same tablet
+// server. Balancing on tablet load should separate them.
+TEST(TestLoadBalancerCommunity, TestLoadAwareBalancingSimulation) {
+  ClusterLoadSnapshot snapshot;
+  snapshot.num_replicas = 1;
+  snapshot.tablet_servers = {"ts-0", "ts-1", "ts-2"};
+  const vector<std::pair<TabletId, TabletServerId>> placement = {
+      {"hot-a", "ts-0"}, {"hot-b", "ts-0"}, {"cold-0", "ts-1"}, {"cold-1", "ts-1"},
+      {"cold-2", "ts-2"}, {"cold-3", "ts-2"}};
+  for (const auto& entry : placement) {
+    ClusterLoadSnapshot::Tablet tablet;
+    tablet.table_id = CURRENT_TEST_NAME();
+    tablet.tablet_id = entry.first;
+    tablet.replicas = {entry.second};
+    if (HasPrefixString(entry.first, "hot")) {
+      tablet.load.read_ops_per_sec = 1000;
+    }
+    snapshot.tablets.push_back(tablet);
+  }
+
+  ClusterLoadBalancerMocked cb;
+
+  // Tablet counts are even, so nothing moves when balancing on counts.
+  FLAGS_load_balancer_use_tablet_load = false;
+  cb.LoadSnapshot(snapshot);
+  ASSERT_EQ(0, cb.SimulateLoadBalancing(10));
+
+  FLAGS_load_balancer_use_tablet_load = true;
+  cb.LoadSnapshot(snapshot);
+  // One move per run: add hot-a elsewhere, remove its old replica, then do the same for a cold
+  // tablet from the server that received hot-a.
+  ASSERT_EQ(4, cb.SimulateLoadBalancing(10));
+  FLAGS_load_balancer_use_tablet_load = false;
+
+  auto hot_a_replicas = cb.GetReplicas("hot-a");
+  auto hot_b_replicas = cb.GetReplicas("hot-b");
+  ASSERT_EQ(1, hot_a_replicas.size());
+  ASSERT_EQ(1, hot_b_replicas.size());
+  ASSERT_NE(*hot_a_replicas.begin(), *hot_b_replicas.begin());
+  for (const auto& entry : placement) {
+    ASSERT_EQ(1, cb.GetReplicas(entry.first).size()) << entry.first;
+  }
+}
+
 } // namespace master
 } // namespace yb
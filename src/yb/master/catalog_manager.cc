@@ -55,6 +55,7 @@
 
 #include <algorithm>
 #include <functional>
+#include <limits>
 #include <mutex>
 #include <set>
 #include <unordered_map>
@@ -186,6 +187,21 @@ DEFINE_test_flag(bool, catalog_manager_simulate_system_table_create_failure, fal
 DEFINE_string(cluster_uuid, "", "Cluster UUID to be used by this cluster");
 TAG_FLAG(cluster_uuid, hidden);
 
+DEFINE_bool(enable_automatic_tablet_splitting, false,
+            "Whether the master should split the tablets of user tables whose size or load "
+            "exceeds the tablet split thresholds.");
+TAG_FLAG(enable_automatic_tablet_splitting, experimental);
+
+DEFINE_uint64(tablet_split_size_threshold_bytes, 10ULL << 30,
+              "A tablet whose leader reports more SST data than this is split. 0 disables "
+              "splitting based on the tablet size.");
+TAG_FLAG(tablet_split_size_threshold_bytes, advanced);
+
+DEFINE_double(tablet_split_ops_threshold, 0,
+              "A tablet whose leader reports more read and write operations per second than "
+              "this is split. 0 disables splitting based on the tablet load.");
+TAG_FLAG(tablet_split_ops_threshold, advanced);
+
 DECLARE_int32(yb_num_shards_per_tserver);
 
 namespace yb {
@@ -325,8 +341,9 @@ class TabletLoader : public Visitor<PersistentTabletInfo> {
       return STATUS(Corruption, "Missing table for tablet: ", tablet_id);
     }
 
-    // Add the tablet to the Table
-    if (!l->mutable_data()->is_deleted()) {
+    // Add the tablet to the Table. A tablet created by a split that did not complete yet is only
+    // added when the split completes.
+    if (!l->mutable_data()->is_deleted() && !l->mutable_data()->is_pending_split_child()) {
       table->AddTablet(tablet);
     }
     l->Commit();
@@ -598,6 +615,7 @@ void CatalogManagerBgTasks::Run() {
         }
       } else {
         catalog_manager_->load_balance_policy_->RunLoadBalancer();
+        catalog_manager_->SplitTabletsIfNeeded();
       }
     }
 
@@ -791,6 +809,7 @@ Status CatalogManager::VisitSysCatalog() {
   // empty version 0.
   RETURN_NOT_OK(PrepareDefaultClusterConfig());
 
+  TabletLocationsChanged();
   return Status::OK();
 }
 
@@ -1583,6 +1602,7 @@ Status CatalogManager::CreateTable(const CreateTableRequestPB* orig_req,
   for (TabletInfo *tablet : tablets) {
     tablet->mutable_metadata()->CommitMutation();
   }
+  TabletLocationsChanged();
 
   VLOG(1) << "Created table " << table->ToString();
   LOG(INFO) << "Successfully created " << object_type << " " << table->ToString()
@@ -1833,6 +1853,7 @@ Status CatalogManager::DeleteTable(const DeleteTableRequestPB* req,
   for (int i = 0; i < table_locks.size(); i++) {
     table_locks[i]->Commit();
   }
+  TabletLocationsChanged();
 
   // The table lock (l) and the global lock (lock_) must be released for the next call.
   for (int i = 0; i < deleted_tables.size(); i++) {
@@ -2272,6 +2293,7 @@ Status CatalogManager::AlterTable(const AlterTableRequestPB* req,
   // Update the in-memory state
   TRACE("Committing in-memory state");
   l->Commit();
+  TabletLocationsChanged();
 
   SendAlterTableRequest(table);
 
@@ -2620,10 +2642,33 @@ Status CatalogManager::HandleReportedTablet(TSDescriptor* ts_desc,
   }
   VLOG(3) << "tablet report: " << report.ShortDebugString();
 
+  // A tablet server only creates the tablets of a split after the split was committed, so a report
+  // from one of them means that the split can be completed.
+  TabletId split_parent_tablet_id;
+  {
+    auto tablet_lock = tablet->LockForRead();
+    if (tablet_lock->data().is_pending_split_child()) {
+      split_parent_tablet_id = tablet_lock->data().pb.split_parent_tablet_id();
+    }
+  }
+  if (!split_parent_tablet_id.empty()) {
+    scoped_refptr<TabletInfo> parent;
+    {
+      boost::shared_lock<LockType> l(lock_);
+      parent = FindPtrOrNull(tablet_map_, split_parent_tablet_id);
+    }
+    if (parent) {
+      RETURN_NOT_OK(CompleteTabletSplit(parent));
+    }
+  }
+
   // TODO: we don't actually need to do the COW here until we see we're going
   // to change the state. Can we change CowedObject to lazily do the copy?
   auto table_lock = tablet->table()->LockForRead();
   auto tablet_lock = tablet->LockForWrite();
+  // Whether the report changed the persistent state of the tablet. Most reports, e.g. the full
+  // reports all tablet servers send after a master failover, don't.
+  bool tablet_modified = false;
 
   // If the TS is reporting a tablet which has been deleted, or a tablet from
   // a table which has been deleted, send it an RPC to delete it.
@@ -2724,6 +2769,7 @@ Status CatalogManager::HandleReportedTablet(TSDescriptor* ts_desc,
       VLOG(1) << "Tablet " << tablet->ToString() << " is now online";
       tablet_lock->mutable_data()->set_state(SysTabletsEntryPB::RUNNING,
                                              "Tablet reported with an active leader");
+      tablet_modified = true;
     }
 
     // The Master only accepts committed consensus configurations since it needs the committed index
@@ -2787,6 +2833,7 @@ Status CatalogManager::HandleReportedTablet(TSDescriptor* ts_desc,
 
       RETURN_NOT_OK(ResetTabletReplicasFromReportedConfig(*final_report, tablet,
                                                           tablet_lock.get(), table_lock.get()));
+      tablet_modified = true;
 
       // Sanity check replicas for this tablet.
       TabletInfo::ReplicaMap replica_map;
@@ -2806,15 +2853,20 @@ Status CatalogManager::HandleReportedTablet(TSDescriptor* ts_desc,
   }
 
   table_lock->Unlock();
-  // We update the tablets each time that someone reports it.
-  // This shouldn't be very frequent and should only happen when something in fact changed.
-  Status s = sys_catalog_->UpdateItem(tablet.get());
-  if (!s.ok()) {
-    LOG(WARNING) << "Error updating tablets: " << s.ToString() << ". Tablet report was: "
-                 << report.ShortDebugString();
-    return s;
+  if (tablet_modified) {
+    Status s = sys_catalog_->UpdateItem(tablet.get());
+    if (!s.ok()) {
+      LOG(WARNING) << "Error updating tablets: " << s.ToString() << ". Tablet report was: "
+                   << report.ShortDebugString();
+      return s;
+    }
+    tablet_lock->Commit();
+  } else {
+    // Nothing to persist, drop the unchanged copy of the metadata.
+    tablet_lock->Unlock();
   }
-  tablet_lock->Commit();
+  // The replica locations may have changed even if the persistent state did not.
+  TabletLocationsChanged();
 
   // Need to defer the AlterTable command to after we've committed the new tablet data,
   // since the tablet report may also be updating the raft config, and the Alter Table
@@ -3528,6 +3580,239 @@ void CatalogManager::SendAlterTabletRequest(const scoped_refptr<TabletInfo>& tab
   WARN_NOT_OK(call->Run(), "Failed to send alter table request");
 }
 
+namespace {
+
+// Returns the partition key in the middle of the hash range of 'partition', or an empty string if
+// the range has a single hash value.
+string MiddleHashPartitionKey(const PartitionPB& partition) {
+  const uint32_t start = partition.partition_key_start().empty()
+      ? 0 : PartitionSchema::DecodeMultiColumnHashValue(partition.partition_key_start());
+  const uint32_t end = partition.partition_key_end().empty()
+      ? std::numeric_limits<uint16_t>::max() + 1
+      : PartitionSchema::DecodeMultiColumnHashValue(partition.partition_key_end());
+  if (end <= start + 1) {
+    return "";
+  }
+  return PartitionSchema::EncodeMultiColumnHashValue(start + (end - start) / 2);
+}
+
+// Returns true if the load reported by the leader of 'tablet' exceeds a split threshold.
+bool TabletExceedsSplitThresholds(const TabletInfo& tablet) {
+  TabletInfo::ReplicaMap locations;
+  tablet.GetReplicaLocations(&locations);
+  for (const auto& replica : locations) {
+    if (replica.second.role != consensus::RaftPeerPB::LEADER) {
+      continue;
+    }
+    TabletLoad load;
+    if (!replica.second.ts_desc->GetTabletLoad(tablet.tablet_id(), &load)) {
+      return false;
+    }
+    return (FLAGS_tablet_split_size_threshold_bytes > 0 &&
+            load.sst_file_size > FLAGS_tablet_split_size_threshold_bytes) ||
+           (FLAGS_tablet_split_ops_threshold > 0 &&
+            load.ops_per_sec() > FLAGS_tablet_split_ops_threshold);
+  }
+  return false;
+}
+
+} // namespace
+
+void CatalogManager::SplitTabletsIfNeeded() {
+  if (!FLAGS_enable_automatic_tablet_splitting) {
+    return;
+  }
+
+  std::vector<scoped_refptr<TabletInfo>> tablets_to_split;
+  std::vector<scoped_refptr<TabletInfo>> splits_in_progress;
+  {
+    boost::shared_lock<LockType> l(lock_);
+    for (const TabletInfoMap::value_type& entry : tablet_map_) {
+      const scoped_refptr<TabletInfo>& tablet = entry.second;
+      const scoped_refptr<TableInfo>& table = tablet->table();
+      if (!table || IsSystemTable(*table)) {
+        continue;
+      }
+
+      // Only non-transactional YQL tables are split, since their rows can be divided by hash code
+      // without moving any transaction state.
+      {
+        auto table_lock = table->LockForRead();
+        const SysTablesEntryPB& table_pb = table_lock->data().pb;
+        if (table_pb.state() != SysTablesEntryPB::RUNNING ||
+            table_pb.table_type() != YQL_TABLE_TYPE ||
+            table_pb.partition_schema().hash_schema() !=
+                PartitionSchemaPB::MULTI_COLUMN_HASH_SCHEMA ||
+            table_pb.schema().table_properties().is_transactional()) {
+          continue;
+        }
+      }
+
+      auto tablet_lock = tablet->LockForRead();
+      if (!tablet_lock->data().is_running()) {
+        continue;
+      }
+      if (tablet_lock->data().pb.split_tablet_ids_size() > 0) {
+        splits_in_progress.push_back(tablet);
+      } else if (TabletExceedsSplitThresholds(*tablet) &&
+                 !MiddleHashPartitionKey(tablet_lock->data().pb.partition()).empty()) {
+        tablets_to_split.push_back(tablet);
+      }
+    }
+  }
+
+  // Resend the split requests that are not being sent anymore, e.g. after a master failover.
+  for (const scoped_refptr<TabletInfo>& tablet : splits_in_progress) {
+    bool has_split_task = false;
+    for (const auto& task : tablet->table()->GetTasks()) {
+      if (task->type() == MonitoredTask::ASYNC_SPLIT_TABLET &&
+          static_cast<AsyncSplitTablet*>(task.get())->tablet_id() == tablet->tablet_id()) {
+        has_split_task = true;
+        break;
+      }
+    }
+    if (!has_split_task) {
+      SendSplitTabletRequest(tablet);
+    }
+  }
+
+  // Split one tablet per run, so that the cluster absorbs the new tablets gradually.
+  if (!tablets_to_split.empty() && splits_in_progress.empty()) {
+    WARN_NOT_OK(StartTabletSplit(tablets_to_split.front()),
+                "Failed to split tablet " + tablets_to_split.front()->tablet_id());
+  }
+}
+
+Status CatalogManager::StartTabletSplit(const scoped_refptr<TabletInfo>& tablet) {
+  TableInfo* table = tablet->table().get();
+  PartitionPB partition;
+  {
+    auto l = tablet->LockForRead();
+    partition = l->data().pb.partition();
+  }
+  const string split_partition_key = MiddleHashPartitionKey(partition);
+  if (split_partition_key.empty()) {
+    return STATUS(InvalidArgument, "Tablet covers a single hash value", tablet->tablet_id());
+  }
+
+  PartitionPB partition1 = partition;
+  partition1.set_partition_key_end(split_partition_key);
+  PartitionPB partition2 = partition;
+  partition2.set_partition_key_start(split_partition_key);
+
+  // The new tablets are created locked, and stay in PREPARING state until the split completes.
+  vector<TabletInfo*> new_tablets = {
+      CreateTabletInfo(table, partition1), CreateTabletInfo(table, partition2) };
+  vector<scoped_refptr<TabletInfo>> new_tablet_refs(new_tablets.begin(), new_tablets.end());
+  for (TabletInfo* new_tablet : new_tablets) {
+    new_tablet->mutable_metadata()->mutable_dirty()->pb.set_split_parent_tablet_id(
+        tablet->tablet_id());
+  }
+
+  auto tablet_lock = tablet->LockForWrite();
+  if (!tablet_lock->data().is_running() || tablet_lock->data().pb.split_tablet_ids_size() > 0) {
+    for (TabletInfo* new_tablet : new_tablets) {
+      new_tablet->mutable_metadata()->AbortMutation();
+    }
+    return STATUS(IllegalState, "Tablet is not running or already being split",
+                  tablet->tablet_id());
+  }
+  SysTabletsEntryPB* tablet_pb = &tablet_lock->mutable_data()->pb;
+  for (TabletInfo* new_tablet : new_tablets) {
+    tablet_pb->add_split_tablet_ids(new_tablet->tablet_id());
+  }
+  tablet_pb->set_split_partition_key(split_partition_key);
+
+  Status s = sys_catalog_->AddAndUpdateItems(new_tablets, {tablet.get()});
+  if (!s.ok()) {
+    for (TabletInfo* new_tablet : new_tablets) {
+      new_tablet->mutable_metadata()->AbortMutation();
+    }
+    return s.CloneAndPrepend("An error occurred while persisting the tablet split");
+  }
+  tablet_lock->Commit();
+  {
+    std::lock_guard<LockType> l(lock_);
+    for (TabletInfo* new_tablet : new_tablets) {
+      new_tablet->mutable_metadata()->CommitMutation();
+      tablet_map_[new_tablet->tablet_id()] = new_tablet;
+    }
+  }
+
+  LOG(INFO) << "Splitting tablet " << tablet->ToString() << " into "
+            << new_tablets[0]->tablet_id() << " and " << new_tablets[1]->tablet_id();
+  SendSplitTabletRequest(tablet);
+  return Status::OK();
+}
+
+void CatalogManager::SendSplitTabletRequest(const scoped_refptr<TabletInfo>& tablet) {
+  auto call = std::make_shared<AsyncSplitTablet>(master_, worker_pool_.get(), tablet);
+  tablet->table()->AddTask(call);
+  WARN_NOT_OK(call->Run(), "Failed to send split tablet request");
+}
+
+Status CatalogManager::CompleteTabletSplit(const scoped_refptr<TabletInfo>& tablet) {
+  vector<scoped_refptr<TabletInfo>> new_tablets;
+  {
+    auto l = tablet->LockForRead();
+    if (l->data().is_deleted()) {
+      // The split was already completed.
+      return Status::OK();
+    }
+    boost::shared_lock<LockType> l_map(lock_);
+    for (const auto& new_tablet_id : l->data().pb.split_tablet_ids()) {
+      scoped_refptr<TabletInfo> new_tablet = FindPtrOrNull(tablet_map_, new_tablet_id);
+      if (!new_tablet) {
+        return STATUS(NotFound, "Tablet created by split not found", new_tablet_id);
+      }
+      new_tablets.push_back(new_tablet);
+    }
+  }
+  if (new_tablets.size() != 2) {
+    return STATUS(IllegalState, "Tablet is not being split", tablet->tablet_id());
+  }
+
+  auto tablet_lock = tablet->LockForWrite();
+  if (tablet_lock->data().is_deleted()) {
+    return Status::OK();
+  }
+  auto new_tablet1_lock = new_tablets[0]->LockForWrite();
+  auto new_tablet2_lock = new_tablets[1]->LockForWrite();
+
+  // The new tablets are hosted by the same tablet servers as the split tablet.
+  TabletInfo::ReplicaMap locations;
+  tablet->GetReplicaLocations(&locations);
+  for (auto* new_tablet_lock : {new_tablet1_lock.get(), new_tablet2_lock.get()}) {
+    new_tablet_lock->mutable_data()->pb.mutable_committed_consensus_state()->CopyFrom(
+        tablet_lock->data().pb.committed_consensus_state());
+    new_tablet_lock->mutable_data()->set_state(
+        SysTabletsEntryPB::RUNNING, Substitute("Split from $0", tablet->tablet_id()));
+  }
+  tablet_lock->mutable_data()->set_state(
+      SysTabletsEntryPB::DELETED,
+      Substitute("Split into $0 and $1 at $2", new_tablets[0]->tablet_id(),
+                 new_tablets[1]->tablet_id(), LocalTimeAsString()));
+
+  Status s = sys_catalog_->UpdateItems<TabletInfo>(
+      {tablet.get(), new_tablets[0].get(), new_tablets[1].get()});
+  if (!s.ok()) {
+    return s.CloneAndPrepend("An error occurred while persisting the completed tablet split");
+  }
+  new_tablet1_lock->Commit();
+  new_tablet2_lock->Commit();
+  tablet_lock->Commit();
+
+  for (const scoped_refptr<TabletInfo>& new_tablet : new_tablets) {
+    new_tablet->SetReplicaLocations(locations);
+  }
+  // The first new tablet starts at the same partition key as the split tablet, so it replaces it.
+  tablet->table()->AddTablets({new_tablets[0].get(), new_tablets[1].get()});
+  TabletLocationsChanged();
+
+  LOG(INFO) << "Completed split of tablet " << tablet->ToString();
+  return Status::OK();
+}
+
 void CatalogManager::DeleteTabletReplicas(
     const TabletInfo* tablet,
     const std::string& msg) {
@@ -3692,6 +3977,11 @@ void CatalogManager::ExtractTabletsToProcess(
       continue;
     }
 
+    // Tablets created by a split are created by the tablet servers, not assigned.
+    if (tablet_lock->data().is_pending_split_child()) {
+      continue;
+    }
+
     // Tablets not yet assigned or with a report just received
     tablets_to_process->push_back(tablet);
   }
@@ -4223,7 +4513,7 @@ Status CatalogManager::BuildLocationsForTablet(const scoped_refptr<TabletInfo>&
 
   TSRegistrationPB reg;
 
-  TabletInfo::ReplicaMap locs;
+  std::shared_ptr<const TabletInfo::ReplicaMap> locs_ptr;
   consensus::ConsensusStatePB cstate;
   {
     auto l_tablet = tablet->LockForRead();
@@ -4235,14 +4525,15 @@ Status CatalogManager::BuildLocationsForTablet(const scoped_refptr<TabletInfo>&
       return STATUS(ServiceUnavailable, "Tablet not running");
     }
 
-    tablet->GetReplicaLocations(&locs);
-    if (locs.empty() && l_tablet->data().pb.has_committed_consensus_state()) {
+    locs_ptr = tablet->GetReplicaLocations();
+    if (locs_ptr->empty() && l_tablet->data().pb.has_committed_consensus_state()) {
       cstate = l_tablet->data().pb.committed_consensus_state();
     }
 
     locs_pb->mutable_partition()->CopyFrom(tablet->metadata().state().pb.partition());
   }
 
+  const TabletInfo::ReplicaMap& locs = *locs_ptr;
   locs_pb->set_tablet_id(tablet->tablet_id());
   locs_pb->set_stale(locs.empty());
 
@@ -4799,25 +5090,37 @@ TabletInfo::TabletInfo(const scoped_refptr<TableInfo>& table,
     : tablet_id_(std::move(tablet_id)),
       table_(table),
       last_update_time_(MonoTime::Now()),
+      replica_locations_(std::make_shared<ReplicaMap>()),
       reported_schema_version_(0) {}
 
 TabletInfo::~TabletInfo() {
 }
 
 void TabletInfo::SetReplicaLocations(ReplicaMap replica_locations) {
+  auto new_locations = std::make_shared<ReplicaMap>(std::move(replica_locations));
   std::lock_guard<simple_spinlock> l(lock_);
   last_update_time_ = MonoTime::Now();
-  replica_locations_ = std::move(replica_locations);
+  replica_locations_ = std::move(new_locations);
 }
 
 void TabletInfo::GetReplicaLocations(ReplicaMap* replica_locations) const {
+  *replica_locations = *GetReplicaLocations();
+}
+
+std::shared_ptr<const TabletInfo::ReplicaMap> TabletInfo::GetReplicaLocations() const {
   std::lock_guard<simple_spinlock> l(lock_);
-  *replica_locations = replica_locations_;
+  return replica_locations_;
 }
 
 bool TabletInfo::AddToReplicaLocations(const TabletReplica& replica) {
   std::lock_guard<simple_spinlock> l(lock_);
-  return InsertIfNotPresent(&replica_locations_, replica.ts_desc->permanent_uuid(), replica);
+  if (ContainsKey(*replica_locations_, replica.ts_desc->permanent_uuid())) {
+    return false;
+  }
+  auto new_locations = std::make_shared<ReplicaMap>(*replica_locations_);
+  InsertOrDie(new_locations.get(), replica.ts_desc->permanent_uuid(), replica);
+  replica_locations_ = std::move(new_locations);
+  return true;
 }
 
 void TabletInfo::set_last_update_time(const MonoTime& ts) {
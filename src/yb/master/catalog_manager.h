@@ -32,6 +32,7 @@
 #ifndef YB_MASTER_CATALOG_MANAGER_H
 #define YB_MASTER_CATALOG_MANAGER_H
 
+#include <atomic>
 #include <list>
 #include <map>
 #include <set>
@@ -173,6 +174,12 @@ struct PersistentTabletInfo : public Persistent<SysTabletsEntryPB, SysRowEntry::
            pb.state() == SysTabletsEntryPB::DELETED;
   }
 
+  // A tablet created by a split that did not complete yet. It is created by the tablet servers
+  // when they apply the split, so it is neither assigned by the master nor visible to clients.
+  bool is_pending_split_child() const {
+    return pb.state() == SysTabletsEntryPB::PREPARING && pb.has_split_parent_tablet_id();
+  }
+
   // Helper to set the state of the tablet with a custom message.
   // Requires that the caller has prepared this object for write.
   // The change will only be visible after Commit().
@@ -236,6 +243,9 @@ class TabletInfo : public RefCountedThreadSafe<TabletInfo>,
   void SetReplicaLocations(ReplicaMap replica_locations);
   void GetReplicaLocations(ReplicaMap* replica_locations) const;
 
+  // Returns an immutable snapshot of the replica locations, without copying them.
+  std::shared_ptr<const ReplicaMap> GetReplicaLocations() const;
+
   // Adds the given replica to the replica_locations_ map.
   // Returns true iff the replica was inserted.
   bool AddToReplicaLocations(const TabletReplica& replica);
@@ -281,8 +291,9 @@ class TabletInfo : public RefCountedThreadSafe<TabletInfo>,
   MonoTime last_update_time_;
 
   // The locations in the latest Raft config where this tablet has been
-  // reported. The map is keyed by tablet server UUID.
-  ReplicaMap replica_locations_;
+  // reported. The map is keyed by tablet server UUID. Never modified in place, so that readers
+  // can keep using a snapshot after releasing the lock.
+  std::shared_ptr<const ReplicaMap> replica_locations_;
 
   // Reported schema version (in-memory only).
   uint32_t reported_schema_version_ = 0;
@@ -872,6 +883,13 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
 
   void GetAllNamespaces(std::vector<scoped_refptr<NamespaceInfo> >* namespaces);
 
+  // Returns a counter that is incremented after every change to the set of running tables or to
+  // the state or replica locations of their tablets. Used to invalidate data derived from the
+  // tablet locations, such as the cached contents of system.partitions.
+  int64_t tablet_locations_version() const {
+    return tablet_locations_version_.load(std::memory_order_acquire);
+  }
+
   // Return all the available (user-defined) types.
   void GetAllUDTypes(std::vector<scoped_refptr<UDTypeInfo> >* types);
 
@@ -1177,6 +1195,21 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   // tablet.
   void SendAlterTabletRequest(const scoped_refptr<TabletInfo>& tablet);
 
+  // Starts splitting the tablets of user tables whose size or load reported by their leader exceeds
+  // the split thresholds, and resends the split requests that are not in progress anymore.
+  void SplitTabletsIfNeeded();
+
+  // Creates the tablets 'tablet' is split into, persists them along with the split of 'tablet',
+  // and sends the split request.
+  CHECKED_STATUS StartTabletSplit(const scoped_refptr<TabletInfo>& tablet);
+
+  // Start the background task to send the SplitTablet() RPC to the leader for this tablet.
+  void SendSplitTabletRequest(const scoped_refptr<TabletInfo>& tablet);
+
+  // Completes the split of 'tablet' after its leader applied it: the new tablets become visible
+  // to clients, and 'tablet' is deleted.
+  CHECKED_STATUS CompleteTabletSplit(const scoped_refptr<TabletInfo>& tablet);
+
   // Delete the specified table in memory. The TableInfo, DeletedTableInfo and lock of the deleted
   // table are appended to the lists. The caller will be responsible for committing the change and
   // deleting the actual table and tablets.
@@ -1370,6 +1403,14 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   // correctly.
   int64_t leader_ready_term_;
 
+  // See tablet_locations_version(). Incremented only once the change is visible to readers, so
+  // that data built at a given version is never older than the state at that version.
+  std::atomic<int64_t> tablet_locations_version_{0};
+
+  void TabletLocationsChanged() {
+    tablet_locations_version_.fetch_add(1, std::memory_order_acq_rel);
+  }
+
   // Lock used to fence operations and leader elections. All logical operations
   // (i.e. create table, alter table, etc.) should acquire this lock for
   // reading. Following an election where this master is elected leader, it
@@ -1384,6 +1425,7 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   // Async operations are accessing some private methods
   // (TODO: this stuff should be deferred and done in the background thread)
   friend class AsyncAlterTable;
+  friend class AsyncSplitTablet;
 
   // Number of live tservers metric.
   scoped_refptr<AtomicGauge<uint32_t>> metric_num_tablet_servers_live_;
@@ -14,6 +14,7 @@
 #include "yb/master/cluster_balance.h"
 
 #include <algorithm>
+#include <cmath>
 #include <memory>
 
 #include <boost/thread/locks.hpp>
@@ -41,6 +42,21 @@ DEFINE_int32(load_balancer_max_concurrent_moves,
              1,
              "Maximum number of concurrent LeaderMoves/Adds/Removals.");
 
+DEFINE_bool(load_balancer_use_tablet_load,
+            false,
+            "Balance tablet replicas and leaders on their reported load (read/write rates and SST "
+                "sizes) instead of only on their counts.");
+
+DEFINE_double(load_balancer_tablet_ops_weight,
+              1.0,
+              "Weight of a tablet's read/write rate, relative to its count, when balancing on "
+                  "tablet load.");
+
+DEFINE_double(load_balancer_tablet_sst_size_weight,
+              1.0,
+              "Weight of a tablet's SST size, relative to its count, when balancing on tablet "
+                  "load.");
+
 DECLARE_int32(min_leader_stepdown_retry_interval_ms);
 
 namespace yb {
@@ -124,6 +140,10 @@ void ClusterLoadBalancer::RunLoadBalancer() {
   // Lock the CatalogManager maps for the duration of the load balancer run.
   boost::shared_lock<CatalogManager::LockType> l(catalog_manager_->lock_);
 
+  RunLoadBalancerUnlocked();
+}
+
+void ClusterLoadBalancer::RunLoadBalancerUnlocked() {
   int remaining_adds = options_.kMaxConcurrentAdds;
   int remaining_removals = options_.kMaxConcurrentRemovals;
   int remaining_leader_moves = options_.kMaxConcurrentLeaderMoves;
@@ -258,6 +278,9 @@ bool ClusterLoadBalancer::AnalyzeTablets(const TableId& table_uuid) {
   // low for the given configuration.
   state_->AdjustLeaderBalanceThreshold();
 
+  // Weights depend on the load of all the tablets of the table, so compute them before sorting.
+  state_->ComputeTabletWeights();
+
   // Once we've analyzed both the tablet server information as well as the tablets, we can sort the
   // load and are ready to apply the load balancing rules.
   state_->SortLoad();
@@ -400,8 +423,7 @@ void ClusterLoadBalancer::DumpSortedLoad() const {
   out << "Table load: ";
   for (int left = 0; left <= last_pos; ++left) {
     const TabletServerId& uuid = state_->sorted_load_[left];
-    int load = state_->GetLoad(uuid);
-    out << uuid << ":" << load << " ";
+    out << uuid << ":" << state_->GetBalancingLoad(uuid) << " ";
   }
   VLOG(1) << out.str();
 }
@@ -412,6 +434,12 @@ bool ClusterLoadBalancer::GetLoadToMove(
     return false;
   }
 
+  // Weighted loads count both the old and the new replica of a tablet being moved, which makes
+  // them ambiguous until the move completes. Wait for over-replication to be resolved first.
+  if (state_->use_tablet_load() && !state_->tablets_over_replicated_.empty()) {
+    return false;
+  }
+
   // Start with two indices pointing at left and right most ends of the sorted_load_ structure.
   //
   // We will try to find two TSs that have at least one tablet that can be moved amongst them, from
@@ -437,7 +465,8 @@ bool ClusterLoadBalancer::GetLoadToMove(
     for (int right = last_pos; right >= 0; --right) {
       const TabletServerId& low_load_uuid = state_->sorted_load_[left];
       const TabletServerId& high_load_uuid = state_->sorted_load_[right];
-      int load_variance = state_->GetLoad(high_load_uuid) - state_->GetLoad(low_load_uuid);
+      double load_variance =
+          state_->GetBalancingLoad(high_load_uuid) - state_->GetBalancingLoad(low_load_uuid);
 
       // Check for state change or end conditions.
       if (left == right || load_variance < options_.kMinLoadVarianceToBalance) {
@@ -514,6 +543,12 @@ bool ClusterLoadBalancer::GetTabletToMove(
 
   bool same_placement = state_->per_ts_meta_[from_ts].descriptor->placement_id() ==
                         state_->per_ts_meta_[to_ts].descriptor->placement_id();
+  const double load_variance =
+      state_->GetBalancingLoad(from_ts) - state_->GetBalancingLoad(to_ts);
+  // When balancing on tablet load, pick the tablet whose weight is closest to half the load
+  // difference, which evens out the two servers the most.
+  bool found = false;
+  double best_distance = 0;
   for (const auto& tablet_id : non_over_replicated_tablets) {
     const auto& placement_info = GetPlacementByTablet(tablet_id);
     // TODO(bogdan): this should be augmented as well to allow dropping by one replica, if still
@@ -533,11 +568,24 @@ bool ClusterLoadBalancer::GetTabletToMove(
     // If we got here, it means we either have no placement, in which case we can pick any TS, or
     // we have placement and it's valid to move across these two tablet servers, so set the tablet
     // and leave.
-    *moving_tablet_id = tablet_id;
-    return true;
+    if (!state_->use_tablet_load()) {
+      *moving_tablet_id = tablet_id;
+      return true;
+    }
+    // A tablet at least as heavy as the load difference would just move the imbalance around.
+    const double weight = state_->GetTabletWeight(tablet_id);
+    if (weight >= load_variance || !state_->HasDiskRoomForTablet(tablet_id, from_ts, to_ts)) {
+      continue;
+    }
+    const double distance = std::abs(weight - load_variance / 2);
+    if (!found || distance < best_distance) {
+      *moving_tablet_id = tablet_id;
+      best_distance = distance;
+      found = true;
+    }
   }
   // If we couldn't select a tablet above, we have to return failure.
-  return false;
+  return found;
 }
 
 bool ClusterLoadBalancer::GetLeaderToMove(
@@ -574,8 +622,8 @@ bool ClusterLoadBalancer::GetLeaderToMove(
     for (int right = last_pos; right >= 0; --right) {
       const TabletServerId& low_load_uuid = state_->sorted_leader_load_[left];
       const TabletServerId& high_load_uuid = state_->sorted_leader_load_[right];
-      int load_variance =
-          state_->GetLeaderLoad(high_load_uuid) - state_->GetLeaderLoad(low_load_uuid);
+      double load_variance = state_->GetBalancingLeaderLoad(high_load_uuid) -
+                             state_->GetBalancingLeaderLoad(low_load_uuid);
 
       // Check for state change or end conditions.
       if (left == right || load_variance < options_.kMinLeaderLoadVarianceToBalance) {
@@ -592,10 +640,30 @@ bool ClusterLoadBalancer::GetLeaderToMove(
       // If there are, we have a candidate we want, so fill in the output params and return.
       const set<TabletId>& leaders = state_->per_ts_meta_[high_load_uuid].leaders;
       const set<TabletId>& peers = state_->per_ts_meta_[low_load_uuid].running_tablets;
-      set<TabletId> intersection;
-      const auto& itr = std::inserter(intersection, intersection.begin());
+      vector<TabletId> intersection;
+      const auto& itr = std::back_inserter(intersection);
       std::set_intersection(leaders.begin(), leaders.end(), peers.begin(), peers.end(), itr);
 
+      if (state_->use_tablet_load()) {
+        // Only consider leaders lighter than the load difference, best fitting ones first.
+        const auto& per_tablet_meta = state_->per_tablet_meta_;
+        auto leader_weight = [&per_tablet_meta](const TabletId& tablet_id) {
+          auto it = per_tablet_meta.find(tablet_id);
+          return it == per_tablet_meta.end() ? 1.0 : it->second.leader_weight;
+        };
+        intersection.erase(
+            std::remove_if(intersection.begin(), intersection.end(),
+                           [&](const TabletId& tablet_id) {
+                             return leader_weight(tablet_id) >= load_variance;
+                           }),
+            intersection.end());
+        std::stable_sort(intersection.begin(), intersection.end(),
+                         [&](const TabletId& lhs, const TabletId& rhs) {
+                           return std::abs(leader_weight(lhs) - load_variance / 2) <
+                                  std::abs(leader_weight(rhs) - load_variance / 2);
+                         });
+      }
+
       for (const auto& tablet_id : intersection) {
         *moving_tablet_id = tablet_id;
         *from_ts = high_load_uuid;
@@ -65,6 +65,11 @@ namespace master {
 //  leaders and moving some leaders to the servers with less to achieve an even distribution. If
 //  a threshold is set in the configuration, the balancer will just keep the numbers of leaders
 //  on each server below it instead of maintaining an even distribution.
+//
+//  If load_balancer_use_tablet_load is set, the load of a tablet server is not its tablet count,
+//  but the sum of the weights of its tablets, where the weight of a tablet is derived from its
+//  reported read/write rates and SST size, relative to the other tablets of the same table. The
+//  tablet (or leader) picked for a move is then the one that best evens out the two servers.
 class ClusterLoadBalancer {
  public:
   explicit ClusterLoadBalancer(CatalogManager* cm);
@@ -175,6 +180,10 @@ class ClusterLoadBalancer {
   // Higher level methods and members.
   //
 
+  // Executes one run of the load balancing algorithm over all the tables, assuming the
+  // CatalogManager maps are already locked (or are not used, as in testing).
+  void RunLoadBalancerUnlocked();
+
   // Recreates the ClusterLoadState object.
   void ResetState();
 
@@ -3,11 +3,31 @@
 #ifndef YB_MASTER_CLUSTER_BALANCE_MOCKED_H
 #define YB_MASTER_CLUSTER_BALANCE_MOCKED_H
 
+#include <algorithm>
+
+#include "yb/gutil/strings/substitute.h"
 #include "yb/master/cluster_balance.h"
 
 namespace yb {
 namespace master {
 
+// A snapshot of the tablet placement and load of a cluster, which ClusterLoadBalancerMocked can
+// replay to simulate load balancing runs, e.g. to evaluate the load-aware balancing settings
+// against the state of a real cluster.
+struct ClusterLoadSnapshot {
+  struct Tablet {
+    TableId table_id;
+    TabletId tablet_id;
+    // Tablet servers hosting a replica of this tablet, the first one being the leader.
+    std::vector<TabletServerId> replicas;
+    TabletLoad load;
+  };
+
+  int num_replicas = 3;
+  std::vector<TabletServerId> tablet_servers;
+  std::vector<Tablet> tablets;
+};
+
 class ClusterLoadBalancerMocked : public ClusterLoadBalancer {
  public:
   ClusterLoadBalancerMocked() : ClusterLoadBalancer(nullptr) {
@@ -34,10 +54,14 @@ class ClusterLoadBalancerMocked : public ClusterLoadBalancer {
 
   const BlacklistPB& GetServerBlacklist() const override { return blacklist_; }
 
+  bool SkipLoadBalancing(const TableInfo& table) const override { return false; }
+
   void SendReplicaChanges(scoped_refptr<TabletInfo> tablet, const TabletServerId& ts_uuid,
                           const bool is_add, const bool should_remove,
                           const TabletServerId& new_leader_uuid) override {
-    // Do nothing.
+    // Only record the change, so that a simulation can apply it.
+    replica_changes_.push_back({tablet->tablet_id(), ts_uuid, is_add, should_remove,
+                                new_leader_uuid});
   }
 
   void GetPendingTasks(const TableId& table_uuid,
@@ -55,6 +79,91 @@ class ClusterLoadBalancerMocked : public ClusterLoadBalancer {
     }
   }
 
+  // Replaces the current state with the given snapshot. The load balancer options are reset to
+  // their production defaults, so that the simulation is rate-limited the same way as a real run.
+  void LoadSnapshot(const ClusterLoadSnapshot& snapshot) {
+    options_ = Options();
+    ts_descs_.clear();
+    tablet_map_.clear();
+    table_map_.clear();
+    cluster_placement_.Clear();
+    blacklist_.Clear();
+    replica_changes_.clear();
+    tablet_loads_.clear();
+
+    cluster_placement_.set_num_replicas(snapshot.num_replicas);
+    for (const auto& ts_uuid : snapshot.tablet_servers) {
+      ts_descs_.push_back(NewTabletServer(ts_uuid));
+    }
+    for (const auto& snapshot_tablet : snapshot.tablets) {
+      auto& table = table_map_[snapshot_tablet.table_id];
+      if (!table) {
+        table = new TableInfo(snapshot_tablet.table_id);
+      }
+      scoped_refptr<TabletInfo> tablet(new TabletInfo(table, snapshot_tablet.tablet_id));
+      {
+        auto l = tablet->LockForWrite();
+        // Partition keys only need to be unique within the table for the simulation.
+        l->mutable_data()->pb.mutable_partition()->set_partition_key_start(
+            strings::Substitute("$0", tablet_map_.size()));
+        l->mutable_data()->pb.set_state(SysTabletsEntryPB::RUNNING);
+        table->AddTablet(tablet.get());
+        l->Commit();
+      }
+
+      TabletInfo::ReplicaMap replica_map;
+      for (const auto& ts_uuid : snapshot_tablet.replicas) {
+        auto& replica = replica_map[ts_uuid];
+        replica.ts_desc = FindTabletServer(ts_uuid);
+        CHECK(replica.ts_desc) << "Unknown tablet server " << ts_uuid;
+        replica.state = tablet::RUNNING;
+        replica.role = replica_map.size() == 1 ? consensus::RaftPeerPB::LEADER
+                                               : consensus::RaftPeerPB::FOLLOWER;
+      }
+      tablet->SetReplicaLocations(replica_map);
+      tablet_map_[snapshot_tablet.tablet_id] = tablet;
+      tablet_loads_[snapshot_tablet.tablet_id] = snapshot_tablet.load;
+    }
+    PublishTabletLoads();
+  }
+
+  // Runs the load balancer on the loaded snapshot until a run issues no change, or up to
+  // max_runs times. The changes of each run are applied as if they completed instantly, with the
+  // load of a tablet following its replicas. Returns the number of runs that issued changes.
+  int SimulateLoadBalancing(int max_runs) {
+    for (int run = 0; run < max_runs; ++run) {
+      replica_changes_.clear();
+      RunLoadBalancerUnlocked();
+      if (replica_changes_.empty()) {
+        return run;
+      }
+      for (const auto& change : replica_changes_) {
+        ApplyReplicaChange(change);
+      }
+      PublishTabletLoads();
+    }
+    return max_runs;
+  }
+
+  // Returns the tablet servers currently hosting a replica of the given tablet.
+  std::set<TabletServerId> GetReplicas(const TabletId& tablet_id) const {
+    TabletInfo::ReplicaMap replica_map;
+    tablet_map_.at(tablet_id)->GetReplicaLocations(&replica_map);
+    std::set<TabletServerId> result;
+    for (const auto& replica : replica_map) {
+      result.insert(replica.first);
+    }
+    return result;
+  }
+
+  struct ReplicaChange {
+    TabletId tablet_id;
+    TabletServerId ts_uuid;
+    bool is_add;
+    bool should_remove;
+    TabletServerId new_leader_uuid;
+  };
+
   TSDescriptorVector ts_descs_;
   AffinitizedZonesSet affinitized_zones_;
   TabletInfoMap tablet_map_;
@@ -64,6 +173,86 @@ class ClusterLoadBalancerMocked : public ClusterLoadBalancer {
   vector<TabletId> pending_add_replica_tasks_;
   vector<TabletId> pending_remove_replica_tasks_;
   vector<TabletId> pending_stepdown_leader_tasks_;
+  vector<ReplicaChange> replica_changes_;
+
+ private:
+  std::shared_ptr<TSDescriptor> NewTabletServer(const TabletServerId& ts_uuid) {
+    NodeInstancePB node;
+    node.set_permanent_uuid(ts_uuid);
+    TSRegistrationPB reg;
+    reg.mutable_common()->add_rpc_addresses()->set_host(ts_uuid);
+    std::shared_ptr<TSDescriptor> ts(new TSDescriptor(ts_uuid));
+    CHECK_OK(ts->Register(node, reg));
+    return ts;
+  }
+
+  TSDescriptor* FindTabletServer(const TabletServerId& ts_uuid) const {
+    for (const auto& ts_desc : ts_descs_) {
+      if (ts_desc->permanent_uuid() == ts_uuid) {
+        return ts_desc.get();
+      }
+    }
+    return nullptr;
+  }
+
+  void ApplyReplicaChange(const ReplicaChange& change) {
+    const auto& tablet = tablet_map_.at(change.tablet_id);
+    TabletInfo::ReplicaMap replica_map;
+    tablet->GetReplicaLocations(&replica_map);
+    if (change.is_add) {
+      auto& replica = replica_map[change.ts_uuid];
+      replica.ts_desc = FindTabletServer(change.ts_uuid);
+      replica.state = tablet::RUNNING;
+      replica.role = consensus::RaftPeerPB::FOLLOWER;
+    } else {
+      auto it = replica_map.find(change.ts_uuid);
+      if (it == replica_map.end()) {
+        return;
+      }
+      const bool was_leader = it->second.role == consensus::RaftPeerPB::LEADER;
+      if (change.should_remove) {
+        replica_map.erase(it);
+      } else {
+        it->second.role = consensus::RaftPeerPB::FOLLOWER;
+      }
+      if (was_leader) {
+        auto new_leader = replica_map.find(change.new_leader_uuid);
+        if (new_leader == replica_map.end()) {
+          new_leader = std::find_if(replica_map.begin(), replica_map.end(),
+                                    [&change](const TabletInfo::ReplicaMap::value_type& entry) {
+                                      return entry.first != change.ts_uuid;
+                                    });
+        }
+        if (new_leader != replica_map.end()) {
+          new_leader->second.role = consensus::RaftPeerPB::LEADER;
+        }
+      }
+    }
+    tablet->SetReplicaLocations(replica_map);
+  }
+
+  // Makes every tablet server report the load of the tablets it currently hosts.
+  void PublishTabletLoads() {
+    std::unordered_map<TabletServerId, TabletLoadMap> loads_by_ts;
+    for (const auto& entry : tablet_map_) {
+      TabletInfo::ReplicaMap replica_map;
+      entry.second->GetReplicaLocations(&replica_map);
+      for (const auto& replica : replica_map) {
+        loads_by_ts[replica.first][entry.first] = tablet_loads_[entry.first];
+      }
+    }
+    for (const auto& ts_desc : ts_descs_) {
+      auto& tablet_loads = loads_by_ts[ts_desc->permanent_uuid()];
+      uint64_t total_sst_file_size = 0;
+      for (const auto& entry : tablet_loads) {
+        total_sst_file_size += entry.second.sst_file_size;
+      }
+      ts_desc->set_total_sst_file_size(total_sst_file_size);
+      ts_desc->set_tablet_loads(std::move(tablet_loads));
+    }
+  }
+
+  std::unordered_map<TabletId, TabletLoad> tablet_loads_;
 };
 
 } // namespace master
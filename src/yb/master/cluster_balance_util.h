@@ -38,6 +38,12 @@ DECLARE_int32(leader_balance_unresponsive_timeout_ms);
 
 DECLARE_int32(load_balancer_max_concurrent_moves);
 
+DECLARE_bool(load_balancer_use_tablet_load);
+
+DECLARE_double(load_balancer_tablet_ops_weight);
+
+DECLARE_double(load_balancer_tablet_sst_size_weight);
+
 namespace yb {
 namespace master {
 
@@ -106,6 +112,16 @@ struct CBTabletMetadata {
   // Leader stepdown failures. We use this to prevent retrying the same leader stepdown too soon.
   LeaderStepDownFailureTimes leader_stepdown_failures;
 
+  // Reported load of this tablet: the read/write rates as seen by the leader (or by any replica,
+  // if the leader did not report yet) and the largest SST size across the replicas.
+  TabletLoad load;
+
+  // Relative weight of a replica of this tablet, used when balancing on tablet load. An average
+  // tablet of the table has a weight of 1, so weighted loads are comparable with tablet counts.
+  double weight = 1.0;
+
+  // Relative weight of the leader of this tablet, based on its read/write rates only.
+  double leader_weight = 1.0;
 };
 
 struct CBTabletServerMetadata {
@@ -120,19 +136,24 @@ struct CBTabletServerMetadata {
 
   // The set of tablet leader ids that this tablet server is currently running.
   std::set<TabletId> leaders;
+
+  // Total size of the SST files on this tablet server, as last reported and adjusted by the moves
+  // done in the current run.
+  uint64_t sst_file_size = 0;
 };
 
 class ClusterLoadState {
  public:
   ClusterLoadState()
       : leader_balance_threshold_(FLAGS_leader_balance_threshold),
+        use_tablet_load_(FLAGS_load_balancer_use_tablet_load),
         current_time_(MonoTime::Now()) {}
   virtual ~ClusterLoadState() {}
 
   // Comparators used for sorting by load.
   bool CompareByUuid(const TabletServerId& a, const TabletServerId& b) {
-    int load_a = GetLoad(a);
-    int load_b = GetLoad(b);
+    double load_a = GetBalancingLoad(a);
+    double load_b = GetBalancingLoad(b);
     if (load_a == load_b) {
       return a < b;
     } else {
@@ -163,7 +184,7 @@ class ClusterLoadState {
   struct LeaderLoadComparator {
     explicit LeaderLoadComparator(ClusterLoadState* state) : state_(state) {}
     bool operator()(const TabletServerId& a, const TabletServerId& b) {
-      return state_->GetLeaderLoad(a) < state_->GetLeaderLoad(b);
+      return state_->GetBalancingLeaderLoad(a) < state_->GetBalancingLeaderLoad(b);
     }
     ClusterLoadState* state_;
   };
@@ -179,6 +200,45 @@ class ClusterLoadState {
     return per_ts_meta_.at(ts_uuid).leaders.size();
   }
 
+  // Get the sum of the weights of the tablets on a certain TS.
+  double GetWeightedLoad(const TabletServerId& ts_uuid) const {
+    const auto& ts_meta = per_ts_meta_.at(ts_uuid);
+    double load = 0;
+    for (const auto* tablets : {&ts_meta.running_tablets, &ts_meta.starting_tablets}) {
+      for (const auto& tablet_id : *tablets) {
+        load += GetTabletWeight(tablet_id);
+      }
+    }
+    return load;
+  }
+
+  // Get the sum of the leader weights of the tablets led by a certain TS.
+  double GetWeightedLeaderLoad(const TabletServerId& ts_uuid) const {
+    double load = 0;
+    for (const auto& tablet_id : per_ts_meta_.at(ts_uuid).leaders) {
+      auto it = per_tablet_meta_.find(tablet_id);
+      load += it == per_tablet_meta_.end() ? 1.0 : it->second.leader_weight;
+    }
+    return load;
+  }
+
+  double GetTabletWeight(const TabletId& tablet_id) const {
+    auto it = per_tablet_meta_.find(tablet_id);
+    return it == per_tablet_meta_.end() ? 1.0 : it->second.weight;
+  }
+
+  // The load that the balancing decisions are based on: either the tablet count, or the weighted
+  // load if balancing on tablet load is enabled.
+  double GetBalancingLoad(const TabletServerId& ts_uuid) const {
+    return use_tablet_load_ ? GetWeightedLoad(ts_uuid) : GetLoad(ts_uuid);
+  }
+
+  double GetBalancingLeaderLoad(const TabletServerId& ts_uuid) const {
+    return use_tablet_load_ ? GetWeightedLeaderLoad(ts_uuid) : GetLeaderLoad(ts_uuid);
+  }
+
+  bool use_tablet_load() const { return use_tablet_load_; }
+
   void SetBlacklist(const BlacklistPB& blacklist) { blacklist_ = blacklist; }
 
   // Update the per-tablet information for this tablet.
@@ -193,6 +253,7 @@ class ClusterLoadState {
     // Get replicas for this tablet.
     TabletInfo::ReplicaMap replica_map;
     tablet->GetReplicaLocations(&replica_map);
+    UpdateTabletLoad(tablet_id, replica_map, &tablet_meta.load);
     // Set state information for both the tablet and the tablet server replicas.
     for (const auto& replica : replica_map) {
       const auto& ts_uuid = replica.first;
@@ -316,6 +377,7 @@ class ClusterLoadState {
     // tablet servers that happen to not be serving any tablets, so were not in the map yet.
     auto& ts_meta = per_ts_meta_[ts_uuid];
     ts_meta.descriptor = ts_desc;
+    ts_meta.sst_file_size = ts_desc->total_sst_file_size();
 
     sorted_load_.push_back(ts_uuid);
 
@@ -375,6 +437,46 @@ class ClusterLoadState {
     return true;
   }
 
+  // When balancing on tablet load, a tablet should not be moved to a tablet server that would end
+  // up holding more SST data than the source tablet server holds now.
+  bool HasDiskRoomForTablet(
+      const TabletId& tablet_id, const TabletServerId& from_ts, const TabletServerId& to_ts) {
+    if (!use_tablet_load_) {
+      return true;
+    }
+    const auto tablet_size = per_tablet_meta_[tablet_id].load.sst_file_size;
+    return per_ts_meta_[to_ts].sst_file_size + tablet_size <= per_ts_meta_[from_ts].sst_file_size;
+  }
+
+  // Computes the replica and leader weights of the tablets, relative to the average tablet of the
+  // table. Weights are only used when balancing on tablet load, but computing them is cheap.
+  void ComputeTabletWeights() {
+    if (per_tablet_meta_.empty()) {
+      return;
+    }
+    double total_ops = 0;
+    double total_size = 0;
+    for (const auto& entry : per_tablet_meta_) {
+      total_ops += entry.second.load.ops_per_sec();
+      total_size += entry.second.load.sst_file_size;
+    }
+    const double mean_ops = total_ops / per_tablet_meta_.size();
+    const double mean_size = total_size / per_tablet_meta_.size();
+    // Terms with no data (e.g. no tablet reported any traffic) are left out, so that an idle
+    // table is balanced on tablet counts alone.
+    const double ops_weight = mean_ops > 0 ? FLAGS_load_balancer_tablet_ops_weight : 0;
+    const double size_weight = mean_size > 0 ? FLAGS_load_balancer_tablet_sst_size_weight : 0;
+    for (auto& entry : per_tablet_meta_) {
+      auto& tablet_meta = entry.second;
+      const double ops_term =
+          ops_weight > 0 ? ops_weight * tablet_meta.load.ops_per_sec() / mean_ops : 0;
+      const double size_term =
+          size_weight > 0 ? size_weight * tablet_meta.load.sst_file_size / mean_size : 0;
+      tablet_meta.weight = (1.0 + ops_term + size_term) / (1.0 + ops_weight + size_weight);
+      tablet_meta.leader_weight = (1.0 + ops_term) / (1.0 + ops_weight);
+    }
+  }
+
   bool HasValidPlacement(const TabletServerId& ts_uuid, const PlacementInfoPB* placement_info) {
     if (!placement_info->placement_blocks().empty()) {
       for (const auto& pb : placement_info->placement_blocks()) {
@@ -456,6 +558,7 @@ class ClusterLoadState {
 
   void AddReplica(const TabletId& tablet_id, const TabletServerId& to_ts) {
     per_ts_meta_[to_ts].starting_tablets.insert(tablet_id);
+    per_ts_meta_[to_ts].sst_file_size += per_tablet_meta_[tablet_id].load.sst_file_size;
     ++per_tablet_meta_[tablet_id].starting;
     ++total_starting_;
     tablets_added_.insert(tablet_id);
@@ -473,6 +576,9 @@ class ClusterLoadState {
       --per_tablet_meta_[tablet_id].starting;
       --total_starting_;
     }
+    auto& from_sst_file_size = per_ts_meta_[from_ts].sst_file_size;
+    from_sst_file_size -= std::min(from_sst_file_size,
+                                   per_tablet_meta_[tablet_id].load.sst_file_size);
     if (per_tablet_meta_[tablet_id].leader_uuid == from_ts) {
       MoveLeader(tablet_id, from_ts);
     }
@@ -588,10 +694,33 @@ class ClusterLoadState {
   unordered_map<TableId, TabletToTabletServerMap> pending_remove_replica_tasks_;
   unordered_map<TableId, TabletToTabletServerMap> pending_stepdown_leader_tasks_;
 
+  // Whether to balance on tablet load rather than on tablet counts, fixed for the whole run.
+  bool use_tablet_load_ = false;
+
   // Time at which we started the current round of load balancing.
   MonoTime current_time_;
 
  private:
+  // Collects the load reported for a tablet by the tablet servers hosting its replicas.
+  void UpdateTabletLoad(
+      const TabletId& tablet_id, const TabletInfo::ReplicaMap& replica_map, TabletLoad* load) {
+    bool has_leader_load = false;
+    for (const auto& replica : replica_map) {
+      TabletLoad replica_load;
+      if (!replica.second.ts_desc->GetTabletLoad(tablet_id, &replica_load)) {
+        continue;
+      }
+      load->sst_file_size = std::max(load->sst_file_size, replica_load.sst_file_size);
+      // Reads are served by the leader, so its rates are the most accurate.
+      const bool is_leader = replica.second.role == consensus::RaftPeerPB::LEADER;
+      if (is_leader || (!has_leader_load && replica_load.ops_per_sec() > load->ops_per_sec())) {
+        load->read_ops_per_sec = replica_load.read_ops_per_sec;
+        load->write_ops_per_sec = replica_load.write_ops_per_sec;
+        has_leader_load = has_leader_load || is_leader;
+      }
+    }
+  }
+
   DISALLOW_COPY_AND_ASSIGN(ClusterLoadState);
 }; // ClusterLoadState
 
@@ -43,6 +43,7 @@
 #include "yb/gutil/strings/substitute.h"
 #include "yb/master/master-test-util.h"
 #include "yb/master/call_home.h"
+#include "yb/master/catalog_manager.h"
 #include "yb/master/master.h"
 #include "yb/master/master.proxy.h"
 #include "yb/master/mini_master.h"
@@ -66,6 +67,14 @@ DECLARE_string(callhome_collection_level);
 DECLARE_string(callhome_tag);
 DECLARE_string(callhome_url);
 DECLARE_bool(catalog_manager_check_ts_count_for_create_table);
+DECLARE_int32(max_create_tablets_per_ts);
+
+DEFINE_int32(tablet_report_bench_num_tservers, 200,
+             "Number of simulated tablet servers in the tablet report benchmark");
+
+DEFINE_int32(tablet_report_bench_replicas_per_tserver, 5000,
+             "Number of tablet replicas hosted by each simulated tablet server in the tablet "
+             "report benchmark");
 
 #define NAMESPACE_ENTRY(namespace) \
     std::make_tuple(k##namespace##NamespaceName, k##namespace##NamespaceId)
@@ -406,6 +415,114 @@ TEST_F(MasterTest, TestRegisterAndHeartbeat) {
   }
 }
 
+// Simulates tablet servers sending full tablet reports for all of their replicas, first to get the
+// tablets running, then again as they do after a master failover, when nothing changed.
+TEST_F(MasterTest, TestTabletReportsBenchmark) {
+  const int num_tservers = AllowSlowTests() ? FLAGS_tablet_report_bench_num_tservers : 10;
+  const int replicas_per_tserver =
+      AllowSlowTests() ? FLAGS_tablet_report_bench_replicas_per_tserver : 30;
+  const int kNumReplicas = 3;
+  const int num_tablets = num_tservers * replicas_per_tserver / kNumReplicas;
+  FLAGS_max_create_tablets_per_ts = 0;
+
+  vector<TSToMasterCommonPB> tservers(num_tservers);
+  for (int i = 0; i < num_tservers; ++i) {
+    tservers[i].mutable_ts_instance()->set_permanent_uuid(Substitute("ts-$0", i));
+    tservers[i].mutable_ts_instance()->set_instance_seqno(1);
+
+    TSHeartbeatRequestPB req;
+    TSHeartbeatResponsePB resp;
+    req.mutable_common()->CopyFrom(tservers[i]);
+    MakeHostPortPB("localhost", 1000 + i, req.mutable_registration()->mutable_common()
+                                              ->add_rpc_addresses());
+    MakeHostPortPB("localhost", 2000 + i, req.mutable_registration()->mutable_common()
+                                              ->add_http_addresses());
+    ASSERT_OK(proxy_->TSHeartbeat(req, &resp, ResetAndGetController()));
+    ASSERT_FALSE(resp.needs_reregister());
+  }
+
+  const TableName kTableName = "report_bench";
+  CreateTableRequestPB create_req;
+  CreateTableResponsePB create_resp;
+  create_req.set_name(kTableName);
+  create_req.mutable_namespace_()->set_name(default_namespace_name);
+  create_req.set_num_tablets(num_tablets);
+  ASSERT_OK(SchemaToPB(Schema({ ColumnSchema("key", INT32) }, 1), create_req.mutable_schema()));
+  ASSERT_OK(proxy_->CreateTable(create_req, &create_resp, ResetAndGetController()));
+  ASSERT_FALSE(create_resp.has_error()) << create_resp.ShortDebugString();
+
+  // Wait for the master to pick the replicas of every tablet, then report these replicas.
+  auto table = mini_master_->master()->catalog_manager()->GetTableInfo(create_resp.table_id());
+  ASSERT_TRUE(table != nullptr);
+  std::vector<scoped_refptr<TabletInfo>> tablets;
+  table->GetAllTablets(&tablets);
+  ASSERT_EQ(num_tablets, tablets.size());
+  ASSERT_OK(WaitFor([&tablets]() -> Result<bool> {
+    for (const auto& tablet : tablets) {
+      if (tablet->LockForRead()->data().pb.state() != SysTabletsEntryPB::CREATING) {
+        return false;
+      }
+    }
+    return true;
+  }, MonoDelta::FromSeconds(60), "Wait for tablets to be assigned"));
+
+  std::unordered_map<TabletServerId, TabletReportPB> reports;
+  for (const auto& tablet : tablets) {
+    consensus::ConsensusStatePB cstate =
+        tablet->LockForRead()->data().pb.committed_consensus_state();
+    cstate.set_current_term(1);
+    cstate.set_leader_uuid(cstate.config().peers(0).permanent_uuid());
+    cstate.mutable_config()->set_opid_index(1);
+    for (const auto& peer : cstate.config().peers()) {
+      ReportedTabletPB* reported = reports[peer.permanent_uuid()].add_updated_tablets();
+      reported->set_tablet_id(tablet->tablet_id());
+      reported->set_state(tablet::RUNNING);
+      reported->set_tablet_data_state(tablet::TABLET_DATA_READY);
+      reported->set_schema_version(0);
+      *reported->mutable_committed_consensus_state() = cstate;
+    }
+  }
+
+  int32_t sequence_number = 0;
+  auto send_full_reports = [&](MonoDelta* elapsed) {
+    const MonoTime start = MonoTime::Now();
+    for (const auto& common : tservers) {
+      TSHeartbeatRequestPB req;
+      TSHeartbeatResponsePB resp;
+      req.mutable_common()->CopyFrom(common);
+      TabletReportPB* report = req.mutable_tablet_report();
+      *report = reports[common.ts_instance().permanent_uuid()];
+      report->set_is_incremental(false);
+      report->set_sequence_number(sequence_number);
+      ASSERT_OK(proxy_->TSHeartbeat(req, &resp, ResetAndGetController()));
+      ASSERT_FALSE(resp.needs_full_tablet_report());
+    }
+    ++sequence_number;
+    *elapsed = MonoTime::Now().GetDeltaSince(start);
+  };
+
+  MonoDelta initial_time;
+  ASSERT_NO_FATALS(send_full_reports(&initial_time));
+  MonoDelta repeated_time;
+  ASSERT_NO_FATALS(send_full_reports(&repeated_time));
+  LOG(INFO) << "Full reports of " << num_tservers << " tablet servers with "
+            << replicas_per_tserver << " replicas each took " << initial_time.ToString()
+            << " when all tablets changed and " << repeated_time.ToString()
+            << " when no tablet changed";
+
+  GetTableLocationsRequestPB req;
+  GetTableLocationsResponsePB resp;
+  req.mutable_table()->set_table_name(kTableName);
+  req.mutable_table()->mutable_namespace_()->set_name(default_namespace_name);
+  req.set_max_returned_locations(num_tablets);
+  ASSERT_OK(proxy_->GetTableLocations(req, &resp, ResetAndGetController()));
+  ASSERT_FALSE(resp.has_error()) << resp.error().ShortDebugString();
+  ASSERT_EQ(num_tablets, resp.tablet_locations_size());
+  for (const auto& locations : resp.tablet_locations()) {
+    ASSERT_EQ(kNumReplicas, locations.replicas_size()) << locations.ShortDebugString();
+  }
+}
+
 Status MasterTest::CreateTable(const NamespaceName& namespace_name,
                                const TableName& table_name,
                                const Schema& schema) {
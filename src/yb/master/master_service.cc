@@ -159,6 +159,14 @@ void MasterServiceImpl::TSHeartbeat(const TSHeartbeatRequestPB* req,
     ts_desc->set_total_sst_file_size(req->metrics().total_sst_file_size());
     ts_desc->set_write_ops_per_sec(req->metrics().write_ops_per_sec());
     ts_desc->set_read_ops_per_sec(req->metrics().read_ops_per_sec());
+    TabletLoadMap tablet_loads;
+    for (const auto& tablet_metrics : req->metrics().tablet_metrics()) {
+      auto& tablet_load = tablet_loads[tablet_metrics.tablet_id()];
+      tablet_load.sst_file_size = tablet_metrics.sst_file_size();
+      tablet_load.read_ops_per_sec = tablet_metrics.read_ops_per_sec();
+      tablet_load.write_ops_per_sec = tablet_metrics.write_ops_per_sec();
+    }
+    ts_desc->set_tablet_loads(std::move(tablet_loads));
   }
 
   if (req->has_tablet_report()) {
@@ -62,6 +62,15 @@ bool MasterTabletServiceImpl::GetTabletOrRespond(
   return true;
 }
 
+bool MasterTabletServiceImpl::GetFollowerReadTimeOrRespond(
+    const tserver::ReadRequestPB* req,
+    tserver::ReadResponsePB* resp,
+    rpc::RpcContext* context,
+    ReadHybridTime* read_time) {
+  // System tablets are only read on the leader master, that checks its leadership in Read().
+  return true;
+}
+
 void MasterTabletServiceImpl::Write(const tserver::WriteRequestPB* req,
                                     tserver::WriteResponsePB* resp,
                                     rpc::RpcContext context)  {
@@ -71,6 +71,12 @@ class MasterTabletServiceImpl : public yb::tserver::TabletServiceImpl {
       rpc::RpcContext* context,
       std::shared_ptr<tablet::AbstractTablet>* tablet) override;
 
+  bool GetFollowerReadTimeOrRespond(
+      const tserver::ReadRequestPB* req,
+      tserver::ReadResponsePB* resp,
+      rpc::RpcContext* context,
+      ReadHybridTime* read_time) override;
+
   Master *const master_;
   DISALLOW_COPY_AND_ASSIGN(MasterTabletServiceImpl);
 };
@@ -35,6 +35,7 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <unordered_map>
 
 #include "yb/gutil/gscoped_ptr.h"
 #include "yb/tserver/tserver_service.proxy.h"
@@ -61,6 +62,17 @@ namespace master {
 class TSRegistrationPB;
 class TSInformationPB;
 
+// Load of a single tablet replica, as last reported by the tablet server hosting it.
+struct TabletLoad {
+  uint64_t sst_file_size = 0;
+  double read_ops_per_sec = 0;
+  double write_ops_per_sec = 0;
+
+  double ops_per_sec() const { return read_ops_per_sec + write_ops_per_sec; }
+};
+
+typedef std::unordered_map<std::string, TabletLoad> TabletLoadMap;
+
 typedef util::SharedPtrTuple<tserver::TabletServerAdminServiceProxy,
                              tserver::TabletServerServiceProxy,
                              consensus::ConsensusServiceProxy> ProxyTuple;
@@ -187,6 +199,23 @@ class TSDescriptor {
     return tsMetrics_.write_ops_per_sec;
   }
 
+  // Replaces the per-tablet load reported by this tablet server.
+  void set_tablet_loads(TabletLoadMap tablet_loads) {
+    std::lock_guard<simple_spinlock> l(lock_);
+    tablet_loads_ = std::move(tablet_loads);
+  }
+
+  // Returns false if this tablet server did not report any load for the given tablet yet.
+  bool GetTabletLoad(const std::string& tablet_id, TabletLoad* tablet_load) const {
+    std::lock_guard<simple_spinlock> l(lock_);
+    auto it = tablet_loads_.find(tablet_id);
+    if (it == tablet_loads_.end()) {
+      return false;
+    }
+    *tablet_load = it->second;
+    return true;
+  }
+
   void ClearMetrics() {
     tsMetrics_.ClearMetrics();
   }
@@ -217,6 +246,7 @@ class TSDescriptor {
 
   FRIEND_TEST(TestTSDescriptor, TestReplicaCreationsDecay);
   template<class ClusterLoadBalancerClass> friend class TestLoadBalancerBase;
+  friend class ClusterLoadBalancerMocked;
 
   explicit TSDescriptor(std::string perm_id);
 
@@ -249,6 +279,9 @@ class TSDescriptor {
 
   struct TSMetrics tsMetrics_;
 
+  // Per-tablet load from the last metrics report, keyed by tablet id.
+  TabletLoadMap tablet_loads_;
+
   const std::string permanent_uuid_;
   int64_t latest_seqno_;
 
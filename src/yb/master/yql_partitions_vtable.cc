@@ -25,7 +25,24 @@ YQLPartitionsVTable::YQLPartitionsVTable(const Master* const master)
 
 Status YQLPartitionsVTable::RetrieveData(const QLReadRequestPB& request,
                                          std::unique_ptr<QLRowBlock>* vtable) const {
-  vtable->reset(new QLRowBlock(schema_));
+  // Read the version before building the rows, so that a change made in the meantime invalidates
+  // them.
+  const int64_t version = master_->catalog_manager()->tablet_locations_version();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!cached_data_ || cached_version_ != version) {
+    std::unique_ptr<QLRowBlock> data(new QLRowBlock(schema_));
+    RETURN_NOT_OK(BuildData(data.get()));
+    cached_data_ = std::move(data);
+    cached_version_ = version;
+  }
+
+  // The caller filters the rows in place, so it gets its own copy.
+  vtable->reset(new QLRowBlock(*cached_data_));
+  return Status::OK();
+}
+
+Status YQLPartitionsVTable::BuildData(QLRowBlock* vtable) const {
   std::vector<scoped_refptr<TableInfo> > tables;
   CatalogManager* catalog_manager = master_->catalog_manager();
   catalog_manager->GetAllTables(&tables, true /* includeOnlyRunningTables */);
@@ -47,7 +64,7 @@ Status YQLPartitionsVTable::RetrieveData(const QLReadRequestPB& request,
     table->GetAllTablets(&tablets);
     for (const scoped_refptr<TabletInfo>& tablet : tablets) {
 
-      QLRow& row = (*vtable)->Extend();
+      QLRow& row = vtable->Extend();
       RETURN_NOT_OK(SetColumnValue(kKeyspaceName, nsInfo->name(), &row));
       RETURN_NOT_OK(SetColumnValue(kTableName, table->name(), &row));
 
@@ -14,6 +14,8 @@
 #ifndef YB_MASTER_YQL_PARTITIONS_VTABLE_H
 #define YB_MASTER_YQL_PARTITIONS_VTABLE_H
 
+#include <mutex>
+
 #include "yb/master/master.h"
 #include "yb/master/yql_virtual_table.h"
 
@@ -21,6 +23,9 @@ namespace yb {
 namespace master {
 
 // VTable implementation of system_schema.partitions.
+//
+// Drivers read this table on every connection and topology refresh, so the rows are built once and
+// reused until the catalog manager reports a change of the tablet locations.
 class YQLPartitionsVTable : public YQLVirtualTable {
  public:
   explicit YQLPartitionsVTable(const Master* const master);
@@ -29,6 +34,17 @@ class YQLPartitionsVTable : public YQLVirtualTable {
  protected:
   Schema CreateSchema() const;
  private:
+  // Builds the rows of the table from the current state of the catalog manager.
+  CHECKED_STATUS BuildData(QLRowBlock* vtable) const;
+
+  // Protects the cached rows below. Held while the rows are rebuilt, so that concurrent readers
+  // wait for a single rebuild instead of all doing the same work.
+  mutable std::mutex mutex_;
+
+  // The rows built at tablet locations version cached_version_, if any.
+  mutable std::unique_ptr<QLRowBlock> cached_data_;
+  mutable int64_t cached_version_ = -1;
+
   static constexpr const char* const kKeyspaceName = "keyspace_name";
   static constexpr const char* const kTableName = "table_name";
   static constexpr const char* const kStartKey = "start_key";
@@ -0,0 +1,69 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+#ifndef ROCKSDB_INCLUDE_ROCKSDB_BACKGROUND_WORK_SCHEDULER_H
+#define ROCKSDB_INCLUDE_ROCKSDB_BACKGROUND_WORK_SCHEDULER_H
+
+#include <stdint.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace rocksdb {
+
+enum class BackgroundWorkType {
+  kFlush,
+  kCompaction,
+};
+
+// Runs the background flushes and compactions of the DBs sharing it. Unlike the thread pools of
+// Env, which run the work in the order it was scheduled, the queued work with the highest
+// priority runs first, so the DBs closest to stalling writes get the threads. The priority is
+// evaluated each time a thread picks the next work, since the state of a DB changes while its
+// work is waiting.
+class BackgroundWorkScheduler {
+ public:
+  struct WorkInfo {
+    BackgroundWorkType type;
+    int64_t priority;
+    std::string description;
+    bool running;
+  };
+
+  virtual ~BackgroundWorkScheduler() {}
+
+  // Arranges to run "function(arg)" once in a thread serving work of the given type. "tag"
+  // identifies the DB the work belongs to. If the work is unscheduled before it starts,
+  // "unschedule_function(arg)" is called instead, if set.
+  // "priority_function" returns the current priority of the work. It is called with the lock of
+  // the scheduler held, so it should be cheap and must not block or call the scheduler. It is not
+  // called after the work is started or unscheduled.
+  virtual void Schedule(void (*function)(void*), void* arg, BackgroundWorkType type,
+                        std::function<int64_t()> priority_function, void* tag,
+                        void (*unschedule_function)(void*), std::string description) = 0;
+
+  // Removes the queued work of the given type and tag. Returns the number of removed items.
+  virtual int Unschedule(void* tag, BackgroundWorkType type) = 0;
+
+  // Returns the running work followed by the queued work, in the order it will run.
+  virtual std::vector<WorkInfo> GetWorkInfos() const = 0;
+};
+
+// Creates a BackgroundWorkScheduler with the given number of threads for flushes and compactions.
+// If there are no flush threads, the flushes run on the compaction threads.
+extern BackgroundWorkScheduler* NewBackgroundWorkScheduler(
+    int num_flush_threads, int num_compaction_threads);
+
+}  // namespace rocksdb
+
+#endif // ROCKSDB_INCLUDE_ROCKSDB_BACKGROUND_WORK_SCHEDULER_H
@@ -146,6 +146,14 @@ class CompactionFilterFactory {
 
   // Returns a name that identifies this compaction filter factory.
   virtual const char* Name() const = 0;
+
+  // Used when a compaction is split into subcompactions by key range. Returns the prefix of
+  // user_key at which a subcompaction boundary may be placed, so that the keys the filters of
+  // this factory need to see together go to the same subcompaction, or an empty slice if no
+  // boundary may be placed near user_key.
+  virtual Slice GetSubcompactionBoundary(const Slice& user_key) const {
+    return user_key;
+  }
 };
 
 }  // namespace rocksdb
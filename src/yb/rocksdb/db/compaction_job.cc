@@ -48,6 +48,7 @@
 #include "yb/rocksdb/db/memtable_list.h"
 #include "yb/rocksdb/db/merge_context.h"
 #include "yb/rocksdb/db/merge_helper.h"
+#include "yb/rocksdb/db/table_cache.h"
 #include "yb/rocksdb/db/version_set.h"
 #include "yb/rocksdb/port/likely.h"
 #include "yb/rocksdb/port/port.h"
@@ -60,6 +61,7 @@
 #include "yb/rocksdb/table/block_based_table_factory.h"
 #include "yb/rocksdb/table/merger.h"
 #include "yb/rocksdb/table/table_builder.h"
+#include "yb/rocksdb/table/table_reader.h"
 #include "yb/rocksdb/util/coding.h"
 #include "yb/rocksdb/util/file_reader_writer.h"
 #include "yb/rocksdb/util/iostats_context_imp.h"
@@ -329,7 +331,10 @@ void CompactionJob::Prepare() {
 
   // Is this compaction producing files at the bottommost level?
   bottommost_level_ = c->bottommost_level();
+}
 
+void CompactionJob::PrepareSubcompactions() {
+  auto* c = compact_->compaction;
   if (c->ShouldFormSubcompactions()) {
     const uint64_t start_micros = env_->NowMicros();
     GenSubcompactionBoundaries();
@@ -363,6 +368,9 @@ struct RangeWithSize {
 // to the working set and then finds the approximate size of data in between
 // each consecutive pair of slices. Then it divides these ranges into
 // consecutive groups such that each group has a similar size.
+//
+// Runs without the DB mutex, since it reads the input tables. So it uses the input version and
+// the options of the compaction, rather than the current ones of the column family.
 void CompactionJob::GenSubcompactionBoundaries() {
   auto* c = compact_->compaction;
   auto* cfd = c->column_family_data();
@@ -390,6 +398,13 @@ void CompactionJob::GenSubcompactionBoundaries() {
           bounds.emplace_back(flevel->files[i].smallest.key);
           bounds.emplace_back(flevel->files[i].largest.key);
         }
+        if (c->number_levels() == 1) {
+          // With a single level all input files usually cover the whole key range, so their
+          // boundaries do not split it. Sample keys inside of the files instead.
+          for (size_t i = 0; i < num_files; i++) {
+            SampleFileKeys(flevel->files[i].fd);
+          }
+        }
       } else {
         // For all other levels add the smallest/largest key in the level to
         // encompass the range covered by that level
@@ -408,6 +423,11 @@ void CompactionJob::GenSubcompactionBoundaries() {
     }
   }
 
+  // Slices are created after all the keys are sampled, since sampling could reallocate them.
+  for (const auto& key : sampled_keys_) {
+    bounds.emplace_back(key);
+  }
+
   std::sort(bounds.begin(), bounds.end(),
     [cfd_comparator] (const Slice& a, const Slice& b) -> bool {
       return cfd_comparator->Compare(ExtractUserKey(a), ExtractUserKey(b)) < 0;
@@ -422,7 +442,7 @@ void CompactionJob::GenSubcompactionBoundaries() {
   // size of data covered by keys in that range
   uint64_t sum = 0;
   std::vector<RangeWithSize> ranges;
-  auto* v = cfd->current();
+  auto* v = c->input_version();
   for (auto it = bounds.begin();;) {
     const Slice a = *it;
     it++;
@@ -439,9 +459,15 @@ void CompactionJob::GenSubcompactionBoundaries() {
 
   // Group the ranges into subcompactions
   const double min_file_fill_percent = 4.0 / 5;
+  const auto* mutable_cf_options = c->mutable_cf_options();
+  uint64_t max_file_size = mutable_cf_options->MaxFileSizeForLevel(out_lvl);
+  if (max_file_size == std::numeric_limits<uint64_t>::max() &&
+      mutable_cf_options->target_file_size_base > 0) {
+    // Output file size is not limited, so do not make subcompactions smaller than a target file.
+    max_file_size = mutable_cf_options->target_file_size_base;
+  }
   uint64_t max_output_files = static_cast<uint64_t>(std::ceil(
-      sum / min_file_fill_percent /
-      cfd->GetCurrentMutableCFOptions()->MaxFileSizeForLevel(out_lvl)));
+      sum / min_file_fill_percent / max_file_size));
   uint64_t subcompactions =
       std::min({static_cast<uint64_t>(ranges.size()),
                 static_cast<uint64_t>(db_options_.max_subcompactions),
@@ -451,6 +477,7 @@ void CompactionJob::GenSubcompactionBoundaries() {
                                     : std::numeric_limits<double>::max();
 
   if (subcompactions > 1) {
+    auto* filter_factory = cfd->ioptions()->compaction_filter_factory;
     // Greedily add ranges to the subcompaction until the sum of the ranges'
     // sizes becomes >= the expected mean size of a subcompaction
     sum = 0;
@@ -462,7 +489,16 @@ void CompactionJob::GenSubcompactionBoundaries() {
         continue;
       }
       if (sum >= mean) {
-        boundaries_.emplace_back(ExtractUserKey(ranges[i].range.limit));
+        Slice boundary = ExtractUserKey(ranges[i].range.limit);
+        if (filter_factory != nullptr) {
+          boundary = filter_factory->GetSubcompactionBoundary(boundary);
+          // Keep adding ranges to this subcompaction if the filter does not allow to split it here.
+          if (boundary.empty() || (!boundaries_.empty() &&
+                                   cfd_comparator->Compare(boundary, boundaries_.back()) <= 0)) {
+            continue;
+          }
+        }
+        boundaries_.emplace_back(boundary);
         sizes_.emplace_back(sum);
         subcompactions--;
         sum = 0;
@@ -475,10 +511,25 @@ void CompactionJob::GenSubcompactionBoundaries() {
   }
 }
 
+void CompactionJob::SampleFileKeys(const FileDescriptor& fd) {
+  auto* cfd = compact_->compaction->column_family_data();
+  Cache::Handle* handle = nullptr;
+  Status s = cfd->table_cache()->FindTable(
+      env_options_, cfd->internal_comparator(), fd, &handle, kDefaultQueryId);
+  if (!s.ok()) {
+    // Subcompaction boundaries are only a hint, the compaction itself would report the error.
+    return;
+  }
+  cfd->table_cache()->GetTableReaderFromHandle(handle)->SampleKeys(
+      db_options_.max_subcompactions, &sampled_keys_);
+  cfd->table_cache()->ReleaseHandle(handle);
+}
+
 Status CompactionJob::Run() {
   AutoThreadOperationStageUpdater stage_updater(
       ThreadStatus::STAGE_COMPACTION_RUN);
   TEST_SYNC_POINT("CompactionJob::Run():Start");
+  PrepareSubcompactions();
   log_buffer_->FlushBufferToLog();
   LogCompaction();
 
@@ -98,7 +98,11 @@ class CompactionJob {
   struct SubcompactionState;
 
   void AggregateStatistics();
+  // Splits the compaction into subcompactions. REQUIRED: mutex not held
+  void PrepareSubcompactions();
   void GenSubcompactionBoundaries();
+  // Appends keys that split the given input file into parts of similar size to sampled_keys_.
+  void SampleFileKeys(const FileDescriptor& fd);
 
   // update the thread status for starting a compaction.
   void ReportStartedCompaction(Compaction* compaction);
@@ -168,6 +172,8 @@ class CompactionJob {
   bool bottommost_level_;
   bool paranoid_file_checks_;
   bool measure_io_stats_;
+  // Stores the keys sampled from input files for GenSubcompactionBoundaries()
+  std::vector<std::string> sampled_keys_;
   // Stores the Slices that designate the boundaries for each subcompaction
   std::vector<Slice> boundaries_;
   // Stores the approx size of keys covered in the range of each subcompaction
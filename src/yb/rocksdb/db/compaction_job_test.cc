@@ -27,6 +27,7 @@
 
 #include "yb/rocksdb/db/compaction_job.h"
 #include "yb/rocksdb/db/column_family.h"
+#include "yb/rocksdb/db/table_cache.h"
 #include "yb/rocksdb/db/version_set.h"
 #include "yb/rocksdb/db/writebuffer.h"
 #include "yb/rocksdb/cache.h"
@@ -1018,6 +1019,88 @@ TEST_F(CompactionJobTest, CorruptionAfterDeletion) {
   RunCompaction({files}, expected_results);
 }
 
+// Compaction of a single level universal storage, that is split into subcompactions, should
+// produce level-0 files with disjoint key ranges, that together contain all the input keys.
+TEST_F(CompactionJobTest, SingleLevelSubcompactions) {
+  db_options_.max_subcompactions = 4;
+  cf_options_.compaction_style = kCompactionStyleUniversal;
+  cf_options_.num_levels = 1;
+  // Mock files are 20 bytes in size, so the compaction could be split into files this small.
+  cf_options_.target_file_size_base = 10;
+  NewDB();
+
+  // The files cover key ranges of different length, so each one ends at a distinct boundary.
+  const size_t kNumFiles = 3;
+  const size_t kKeysPerFile = 100;
+  SequenceNumber sequence_number = 0;
+  std::map<std::string, std::string> expected_values;
+  for (size_t i = 0; i < kNumFiles; ++i) {
+    auto contents = mock::MakeMockFile();
+    for (size_t k = 0; k < (i + 1) * kKeysPerFile; ++k) {
+      char key[10];
+      snprintf(key, sizeof(key), "key%03d", static_cast<int>(k));
+      auto value = ToString(i * 1000 + k);
+      contents.insert({test::KeyStr(key, ++sequence_number, kTypeValue), value});
+      expected_values[key] = value;
+    }
+    AddMockFile(contents);
+  }
+  SetLastSequence(sequence_number);
+
+  auto files = cfd_->current()->storage_info()->LevelFiles(0);
+  ASSERT_EQ(kNumFiles, files.size());
+  CompactionInputFiles compaction_input_files;
+  compaction_input_files.level = 0;
+  compaction_input_files.files = files;
+  Compaction compaction(cfd_->current()->storage_info(), *cfd_->GetLatestMutableCFOptions(),
+                        {compaction_input_files}, 0 /* output_level */, 1024 * 1024, 10, 0,
+                        kNoCompression, {}, true);
+  compaction.SetInputVersion(cfd_->current());
+  ASSERT_TRUE(compaction.ShouldFormSubcompactions());
+
+  LogBuffer log_buffer(InfoLogLevel::INFO_LEVEL, db_options_.info_log.get());
+  mutex_.Lock();
+  EventLogger event_logger(db_options_.info_log.get());
+  CompactionJob compaction_job(
+      0, &compaction, db_options_, env_options_, versions_.get(),
+      &shutting_down_, &log_buffer, nullptr, nullptr, nullptr, &mutex_,
+      &bg_error_, {}, kMaxSequenceNumber, table_cache_,
+      &event_logger, false, false, dbname_, &compaction_job_stats_);
+  compaction_job.Prepare();
+  mutex_.Unlock();
+  ASSERT_OK(compaction_job.Run());
+  mutex_.Lock();
+  ASSERT_OK(compaction_job.Install(*cfd_->GetLatestMutableCFOptions()));
+  mutex_.Unlock();
+
+  // Each file ends a range of the same size, so there is a subcompaction per input file.
+  ASSERT_EQ(kNumFiles, compaction_job_stats_.num_output_files);
+  auto output_files = cfd_->current()->storage_info()->LevelFiles(0);
+  ASSERT_EQ(kNumFiles, output_files.size());
+  std::sort(output_files.begin(), output_files.end(),
+            [this](FileMetaData* lhs, FileMetaData* rhs) {
+    return cfd_->internal_comparator().Compare(lhs->smallest.key, rhs->smallest.key) < 0;
+  });
+
+  std::map<std::string, std::string> values;
+  for (size_t i = 0; i != output_files.size(); ++i) {
+    if (i > 0) {
+      ASSERT_LT(cfd_->user_comparator()->Compare(output_files[i - 1]->largest.key.user_key(),
+                                                 output_files[i]->smallest.key.user_key()), 0);
+    }
+    std::unique_ptr<InternalIterator> iter(cfd_->table_cache()->NewIterator(
+        ReadOptions(), env_options_, cfd_->internal_comparator(), output_files[i]->fd));
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      ParsedInternalKey key;
+      ASSERT_TRUE(ParseInternalKey(iter->key(), &key));
+      ASSERT_TRUE(values.emplace(key.user_key.ToString(), iter->value().ToString()).second)
+          << key.DebugString();
+    }
+    ASSERT_OK(iter->status());
+  }
+  ASSERT_EQ(expected_values, values);
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
@@ -474,6 +474,56 @@ TEST_F(CompactionPickerTest, AllowsTrivialMoveUniversal) {
   ASSERT_TRUE(compaction->is_trivial_move());
 }
 
+// Level-0 files produced by subcompactions have overlapping sequence numbers and disjoint key
+// ranges, so they form a single sorted run that is picked as a whole.
+TEST_F(CompactionPickerTest, UniversalSortedRunOfMultipleFiles) {
+  UniversalCompactionPicker universal_compaction_picker(ioptions_, &icmp_);
+  NewVersionStorage(1, kCompactionStyleUniversal);
+
+  Add(0, 1U, "150", "250", 100, 0, 400, 450);
+  Add(0, 2U, "100", "199", 60, 0, 201, 350);
+  Add(0, 3U, "200", "299", 60, 0, 200, 349);
+  Add(0, 4U, "150", "250", 100, 0, 100, 150);
+  Add(0, 5U, "100", "299", 1000, 0, 10, 50);
+  UpdateVersionStorageInfo();
+
+  // 5 files, but 4 sorted runs.
+  ASSERT_EQ(4.0 / mutable_cf_options_.level0_file_num_compaction_trigger,
+            vstorage_->CompactionScore(0));
+  ASSERT_TRUE(universal_compaction_picker.NeedsCompaction(vstorage_.get()));
+
+  std::unique_ptr<Compaction> compaction(
+      universal_compaction_picker.PickCompaction(
+          cf_name_, mutable_cf_options_, vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction.get() != nullptr);
+  // File 1 is smaller than the next sorted run, so reduction of read amplification starts from
+  // the run of files 2 and 3, that has the total size of 120, and adds file 4.
+  ASSERT_EQ(1U, compaction->num_input_levels());
+  ASSERT_EQ(3U, compaction->num_input_files(0));
+  ASSERT_EQ(2U, compaction->input(0, 0)->fd.GetNumber());
+  ASSERT_EQ(3U, compaction->input(0, 1)->fd.GetNumber());
+  ASSERT_EQ(4U, compaction->input(0, 2)->fd.GetNumber());
+}
+
+TEST_F(CompactionPickerTest, UniversalSortedRunsBelowTrigger) {
+  UniversalCompactionPicker universal_compaction_picker(ioptions_, &icmp_);
+  NewVersionStorage(1, kCompactionStyleUniversal);
+
+  Add(0, 1U, "150", "250", 100, 0, 400, 450);
+  Add(0, 2U, "100", "199", 100, 0, 201, 350);
+  Add(0, 3U, "200", "299", 100, 0, 200, 349);
+  Add(0, 4U, "150", "250", 100, 0, 100, 150);
+  UpdateVersionStorageInfo();
+
+  // There are as many files as the trigger, but only 3 sorted runs.
+  ASSERT_EQ(4, mutable_cf_options_.level0_file_num_compaction_trigger);
+  ASSERT_FALSE(universal_compaction_picker.NeedsCompaction(vstorage_.get()));
+  std::unique_ptr<Compaction> compaction(
+      universal_compaction_picker.PickCompaction(
+          cf_name_, mutable_cf_options_, vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction.get() == nullptr);
+}
+
 TEST_F(CompactionPickerTest, NeedsCompactionFIFO) {
   NewVersionStorage(1, kCompactionStyleFIFO);
   const int kFileCount =
@@ -178,10 +178,12 @@ DBOptions SanitizeOptions(const std::string& dbname, const DBOptions& src) {
         result.num_reserved_small_compaction_threads >= result.base_background_compactions) {
     result.num_reserved_small_compaction_threads = result.base_background_compactions - 1;
   }
-  result.env->IncBackgroundThreadsIfNeeded(src.max_background_compactions,
-                                           Env::Priority::LOW);
-  result.env->IncBackgroundThreadsIfNeeded(src.max_background_flushes,
-                                           Env::Priority::HIGH);
+  if (!result.background_work_scheduler) {
+    result.env->IncBackgroundThreadsIfNeeded(src.max_background_compactions,
+                                             Env::Priority::LOW);
+    result.env->IncBackgroundThreadsIfNeeded(src.max_background_flushes,
+                                             Env::Priority::HIGH);
+  }
 
   if (result.rate_limiter.get() != nullptr) {
     if (result.bytes_per_sync == 0) {
@@ -378,6 +380,12 @@ DBImpl::~DBImpl() {
   CancelAllBackgroundWork(false);
   int compactions_unscheduled = env_->UnSchedule(this, Env::Priority::LOW);
   int flushes_unscheduled = env_->UnSchedule(this, Env::Priority::HIGH);
+  if (db_options_.background_work_scheduler) {
+    compactions_unscheduled += db_options_.background_work_scheduler->Unschedule(
+        this, BackgroundWorkType::kCompaction);
+    flushes_unscheduled += db_options_.background_work_scheduler->Unschedule(
+        this, BackgroundWorkType::kFlush);
+  }
   mutex_.Lock();
   bg_compaction_scheduled_ -= compactions_unscheduled;
   bg_flush_scheduled_ -= flushes_unscheduled;
@@ -2485,8 +2493,8 @@ Status DBImpl::RunManualCompaction(ColumnFamilyData* cfd, int input_level,
       ca->m = &manual;
       manual.incomplete = false;
       bg_compaction_scheduled_++;
-      env_->Schedule(&DBImpl::BGWorkCompaction, ca, Env::Priority::LOW, this,
-                     &DBImpl::UnscheduleCallback);
+      ScheduleBackgroundWork(&DBImpl::BGWorkCompaction, ca, BackgroundWorkType::kCompaction,
+                             Env::Priority::LOW, &DBImpl::UnscheduleCallback);
       scheduled = true;
     }
   }
@@ -2590,6 +2598,9 @@ void DBImpl::MaybeScheduleFlushOrCompaction() {
     // Compaction may introduce data race to DB open
     return;
   }
+  // Called whenever the state of the DB changes, so the work that is already queued is picked by
+  // the current urgency of this DB.
+  UpdateBackgroundWorkPriorities();
   if (bg_work_paused_ > 0) {
     // we paused the background work
     return;
@@ -2602,7 +2613,8 @@ void DBImpl::MaybeScheduleFlushOrCompaction() {
          bg_flush_scheduled_ < db_options_.max_background_flushes) {
     unscheduled_flushes_--;
     bg_flush_scheduled_++;
-    env_->Schedule(&DBImpl::BGWorkFlush, this, Env::Priority::HIGH, this);
+    ScheduleBackgroundWork(
+        &DBImpl::BGWorkFlush, this, BackgroundWorkType::kFlush, Env::Priority::HIGH);
   }
 
   auto bg_compactions_allowed = BGCompactionsAllowed();
@@ -2615,7 +2627,8 @@ void DBImpl::MaybeScheduleFlushOrCompaction() {
                bg_compactions_allowed) {
       unscheduled_flushes_--;
       bg_flush_scheduled_++;
-      env_->Schedule(&DBImpl::BGWorkFlush, this, Env::Priority::LOW, this);
+      ScheduleBackgroundWork(
+          &DBImpl::BGWorkFlush, this, BackgroundWorkType::kFlush, Env::Priority::LOW);
     }
   }
 
@@ -2631,9 +2644,64 @@ void DBImpl::MaybeScheduleFlushOrCompaction() {
     ca->m = nullptr;
     bg_compaction_scheduled_++;
     unscheduled_compactions_--;
-    env_->Schedule(&DBImpl::BGWorkCompaction, ca, Env::Priority::LOW, this,
-                   &DBImpl::UnscheduleCallback);
+    ScheduleBackgroundWork(&DBImpl::BGWorkCompaction, ca, BackgroundWorkType::kCompaction,
+                           Env::Priority::LOW, &DBImpl::UnscheduleCallback);
+  }
+}
+
+void DBImpl::ScheduleBackgroundWork(void (*function)(void*), void* arg, BackgroundWorkType type,
+                                    Env::Priority pri, void (*unschedule_function)(void*)) {
+  mutex_.AssertHeld();
+  auto* scheduler = db_options_.background_work_scheduler.get();
+  if (scheduler == nullptr) {
+    env_->Schedule(function, arg, pri, this, unschedule_function);
+    return;
+  }
+  // Evaluated with the lock of the scheduler held, so it must not lock mutex_, which is held while
+  // scheduling.
+  auto* priority = type == BackgroundWorkType::kFlush ? &flush_priority_ : &compaction_priority_;
+  scheduler->Schedule(
+      function, arg, type, [priority] { return priority->load(std::memory_order_acquire); }, this,
+      unschedule_function, dbname_);
+}
+
+void DBImpl::UpdateBackgroundWorkPriorities() {
+  mutex_.AssertHeld();
+  if (!db_options_.background_work_scheduler) {
+    return;
+  }
+  flush_priority_.store(
+      BackgroundWorkPriority(BackgroundWorkType::kFlush), std::memory_order_release);
+  compaction_priority_.store(
+      BackgroundWorkPriority(BackgroundWorkType::kCompaction), std::memory_order_release);
+}
+
+int64_t DBImpl::BackgroundWorkPriority(BackgroundWorkType type) {
+  mutex_.AssertHeld();
+  // Work of the DBs whose writes are already delayed or stopped goes first.
+  const int64_t stall_bonus =
+      write_controller_.IsStopped() || write_controller_.NeedsDelay()
+          ? std::numeric_limits<int32_t>::max() : 0;
+  int64_t priority = 0;
+  for (auto cfd : *versions_->GetColumnFamilySet()) {
+    if (cfd->IsDropped()) {
+      continue;
+    }
+    if (type == BackgroundWorkType::kFlush) {
+      // Flushing the largest memtables releases the most memory.
+      priority += cfd->imm()->ApproximateUnflushedMemTablesMemoryUsage() +
+                  cfd->mem()->ApproximateMemoryUsage();
+    } else {
+      // Percentage of the number of level-0 files (sorted runs for universal compaction) at which
+      // writes are slowed down.
+      const int slowdown_trigger =
+          std::max(cfd->GetLatestMutableCFOptions()->level0_slowdown_writes_trigger, 1);
+      priority = std::max<int64_t>(
+          priority, cfd->current()->storage_info()->l0_delay_trigger_count() * 100 /
+                        slowdown_trigger);
+    }
   }
+  return priority + stall_bonus;
 }
 
 int DBImpl::BGCompactionsAllowed() const {
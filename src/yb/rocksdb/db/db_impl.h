@@ -50,6 +50,7 @@
 #include "yb/rocksdb/db/write_thread.h"
 #include "yb/rocksdb/db/writebuffer.h"
 #include "yb/rocksdb/port/port.h"
+#include "yb/rocksdb/background_work_scheduler.h"
 #include "yb/rocksdb/db.h"
 #include "yb/rocksdb/env.h"
 #include "yb/rocksdb/memtablerep.h"
@@ -592,6 +593,14 @@ class DBImpl : public DB {
   void MaybeScheduleFlushOrCompaction();
   void SchedulePendingFlush(ColumnFamilyData* cfd);
   void SchedulePendingCompaction(ColumnFamilyData* cfd);
+  // Schedules background work on db_options_.background_work_scheduler if set, or on the env
+  // thread pool of the given priority otherwise.
+  void ScheduleBackgroundWork(void (*function)(void*), void* arg, BackgroundWorkType type,
+                              Env::Priority pri, void (*unschedule_function)(void*) = nullptr);
+  // Urgency of background work of the given type, the higher the sooner the work should run.
+  int64_t BackgroundWorkPriority(BackgroundWorkType type);
+  // Refreshes flush_priority_ and compaction_priority_ from the current state of the DB.
+  void UpdateBackgroundWorkPriorities();
   static void BGWorkCompaction(void* arg);
   static void BGWorkFlush(void* db);
   static void UnscheduleCallback(void* arg);
@@ -832,6 +841,11 @@ class DBImpl : public DB {
   // number of background memtable flush jobs, submitted to the HIGH pool
   int bg_flush_scheduled_;
 
+  // The last computed BackgroundWorkPriority of flushes and compactions. They are read by the
+  // background work scheduler when it picks the next work, without the DB mutex.
+  std::atomic<int64_t> flush_priority_{0};
+  std::atomic<int64_t> compaction_priority_{0};
+
   // stores the number of flushes are currently running
   int num_running_flushes_;
 
@@ -21,6 +21,7 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 #include <cstdlib>
+#include "yb/rocksdb/background_work_scheduler.h"
 #include "yb/rocksdb/db/db_test_util.h"
 #include "yb/rocksdb/port/stack_trace.h"
 
@@ -72,6 +73,24 @@ TEST_F(DBTest2, IteratorPropertyVersionNumber) {
   delete iter2;
   delete iter3;
 }
+
+TEST_F(DBTest2, SchedulerFlushWithoutFlushThreads) {
+  Options options = CurrentOptions();
+  // Flushes are scheduled with the compactions, and there are no flush threads in the scheduler.
+  options.max_background_flushes = 0;
+  options.background_work_scheduler.reset(NewBackgroundWorkScheduler(0, 1));
+  Reopen(options);
+
+  ASSERT_OK(Put("a", "1"));
+  ASSERT_OK(Flush());
+  ASSERT_EQ(1, NumTableFilesAtLevel(0));
+  ASSERT_OK(Put("b", "2"));
+  ASSERT_OK(Flush());
+  ASSERT_EQ(2, NumTableFilesAtLevel(0));
+  ASSERT_EQ("1", Get("a"));
+  ASSERT_EQ("2", Get("b"));
+  Close();
+}
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
@@ -56,6 +56,17 @@ bool NewestFirstBySeqNo(FileMetaData* a, FileMetaData* b) {
   return a->fd.GetNumber() > b->fd.GetNumber();
 }
 
+bool InSameSortedRun(const FileMetaData& newer, const FileMetaData& older,
+                     const Comparator* user_comparator) {
+  if (newer.smallest.seqno > older.largest.seqno) {
+    return false;
+  }
+  return user_comparator->Compare(
+             newer.largest.key.user_key(), older.smallest.key.user_key()) < 0 ||
+         user_comparator->Compare(
+             older.largest.key.user_key(), newer.smallest.key.user_key()) < 0;
+}
+
 namespace {
 bool BySmallestKey(FileMetaData* a, FileMetaData* b,
                    const InternalKeyComparator* cmp) {
@@ -153,7 +164,9 @@ class VersionBuilder::Rep {
           assert(f1->largest.seqno > f2->largest.seqno ||
                  // We can have multiple files with seqno = 0 as a result of
                  // using DB::AddFile()
-                 (f1->largest.seqno == 0 && f2->largest.seqno == 0));
+                 (f1->largest.seqno == 0 && f2->largest.seqno == 0) ||
+                 // Outputs of a compaction split into subcompactions.
+                 InSameSortedRun(*f1, *f2, vstorage->InternalComparator()->user_comparator()));
         } else {
           assert(level_nonzero_cmp_(f1, f2));
 
@@ -26,6 +26,7 @@
 
 namespace rocksdb {
 
+class Comparator;
 class TableCache;
 class VersionStorageInfo;
 class VersionEdit;
@@ -54,4 +55,10 @@ class VersionBuilder {
 };
 
 extern bool NewestFirstBySeqNo(FileMetaData* a, FileMetaData* b);
+
+// Returns true if level-0 files "newer" and "older", adjacent in NewestFirstBySeqNo order,
+// belong to the same sorted run. This is the case for the outputs of a level-0 compaction split
+// into subcompactions: their sequence number ranges overlap while their key ranges do not.
+extern bool InSameSortedRun(const FileMetaData& newer, const FileMetaData& older,
+                            const Comparator* user_comparator);
 }  // namespace rocksdb
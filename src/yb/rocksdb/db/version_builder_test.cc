@@ -19,6 +19,7 @@
 //
 
 #include <string>
+#include "yb/rocksdb/db/version_builder.h"
 #include "yb/rocksdb/db/version_edit.h"
 #include "yb/rocksdb/db/version_set.h"
 #include "yb/rocksdb/util/logging.h"
@@ -336,6 +337,73 @@ TEST_F(VersionBuilderTest, ApplyDeleteAndSaveTo) {
   UnrefFilesInVersion(&new_vstorage);
 }
 
+TEST_F(VersionBuilderTest, InSameSortedRun) {
+  auto make_file = [this](const char* smallest, const char* largest,
+                          SequenceNumber smallest_seqno, SequenceNumber largest_seqno) {
+    FileMetaData f;
+    f.smallest = GetBoundaryValues(smallest, smallest_seqno, smallest_seqno);
+    f.largest = GetBoundaryValues(largest, largest_seqno, largest_seqno);
+    return f;
+  };
+
+  // Outputs of subcompactions: overlapping sequence numbers, disjoint key ranges in either order.
+  auto newer = make_file("100", "199", 100U, 200U);
+  ASSERT_TRUE(InSameSortedRun(newer, make_file("200", "299", 101U, 199U), ucmp_));
+  ASSERT_TRUE(InSameSortedRun(newer, make_file("000", "099", 101U, 199U), ucmp_));
+
+  // Overlapping sequence numbers and key ranges.
+  ASSERT_FALSE(InSameSortedRun(newer, make_file("150", "299", 101U, 199U), ucmp_));
+  ASSERT_FALSE(InSameSortedRun(newer, make_file("199", "299", 101U, 199U), ucmp_));
+
+  // Files from different flushes or compactions, even with disjoint key ranges.
+  ASSERT_FALSE(InSameSortedRun(newer, make_file("200", "299", 50U, 99U), ucmp_));
+  ASSERT_FALSE(InSameSortedRun(newer, make_file("150", "299", 50U, 99U), ucmp_));
+}
+
+TEST_F(VersionBuilderTest, ApplySubcompactionOutputsToLevel0) {
+  Add(0, 1U, "100", "299", 100U, 0, 10U, 50U);
+  UpdateVersionStorageInfo();
+
+  // Outputs of a level-0 compaction split into two subcompactions, and a newer flushed file that
+  // overlaps both of them.
+  VersionEdit version_edit;
+  version_edit.AddTestFile(0, FileDescriptor(10U, 0, 100U, 30U),
+                           GetBoundaryValues("100", 60U, 60U), GetBoundaryValues("199", 150U, 150U),
+                           false);
+  version_edit.AddTestFile(0, FileDescriptor(11U, 0, 100U, 30U),
+                           GetBoundaryValues("200", 61U, 61U), GetBoundaryValues("299", 149U, 149U),
+                           false);
+  version_edit.AddTestFile(0, FileDescriptor(12U, 0, 100U, 30U),
+                           GetBoundaryValues("150", 160U, 160U),
+                           GetBoundaryValues("250", 170U, 170U), false);
+
+  EnvOptions env_options;
+  VersionBuilder version_builder(env_options, nullptr, &vstorage_);
+  VersionStorageInfo new_vstorage(&icmp_, ucmp_, options_.num_levels,
+                                  kCompactionStyleLevel, nullptr);
+  version_builder.Apply(&version_edit);
+  // Checks the order of level-0 files in debug builds.
+  version_builder.SaveTo(&new_vstorage);
+
+  const auto& level0_files = new_vstorage.LevelFiles(0);
+  ASSERT_EQ(4U, level0_files.size());
+  ASSERT_EQ(12U, level0_files[0]->fd.GetNumber());
+  ASSERT_EQ(11U, level0_files[1]->fd.GetNumber());
+  ASSERT_EQ(10U, level0_files[2]->fd.GetNumber());
+  ASSERT_EQ(1U, level0_files[3]->fd.GetNumber());
+
+  // Files 11 and 10 form a single sorted run, though the largest sequence number of file 11 is
+  // smaller.
+  new_vstorage.CalculateBaseBytes(ioptions_, mutable_cf_options_);
+  ASSERT_EQ(3, new_vstorage.l0_delay_trigger_count());
+  new_vstorage.ComputeCompactionScore(mutable_cf_options_, fifo_options_);
+  ASSERT_EQ(0, new_vstorage.CompactionScoreLevel(0));
+  ASSERT_DOUBLE_EQ(3.0 / mutable_cf_options_.level0_file_num_compaction_trigger,
+                   new_vstorage.CompactionScore(0));
+
+  UnrefFilesInVersion(&new_vstorage);
+}
+
 TEST_F(VersionBuilderTest, EstimatedActiveKeys) {
   const uint32_t kTotalSamples = 20;
   const uint32_t kNumLevels = 5;
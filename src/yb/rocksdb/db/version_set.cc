@@ -1235,11 +1235,16 @@ void VersionStorageInfo::ComputeCompactionScore(
       // overwrites/deletions).
       int num_sorted_runs = 0;
       uint64_t total_size = 0;
+      const FileMetaData* prev = nullptr;
       for (auto* f : files_[level]) {
         if (!f->being_compacted) {
           total_size += f->compensated_file_size;
-          num_sorted_runs++;
+          // Outputs of a compaction split into subcompactions form one sorted run.
+          if (prev == nullptr || !InSameSortedRun(*prev, *f, user_comparator_)) {
+            num_sorted_runs++;
+          }
         }
+        prev = f;
       }
       if (compaction_style_ == kCompactionStyleUniversal) {
         // For universal compaction, we use level0 score to indicate
@@ -1872,14 +1877,14 @@ void VersionStorageInfo::CalculateBaseBytes(const ImmutableCFOptions& ioptions,
   // Special logic to set number of sorted runs.
   // It is to match the previous behavior when all files are in L0.
   int num_l0_count = 0;
-  if (options.max_file_size_for_compaction == std::numeric_limits<uint64_t>::max()) {
-    num_l0_count = static_cast<int>(files_[0].size());
-  } else {
-    for (const auto& file : files_[0]) {
-      if (file->fd.GetTotalFileSize() <= options.max_file_size_for_compaction) {
-        ++num_l0_count;
-      }
-    }
+  const FileMetaData* prev = nullptr;
+  for (const auto& file : files_[0]) {
+    // Outputs of a compaction split into subcompactions form one sorted run.
+    if (file->fd.GetTotalFileSize() <= options.max_file_size_for_compaction &&
+        (prev == nullptr || !InSameSortedRun(*prev, *file, user_comparator_))) {
+      ++num_l0_count;
+    }
+    prev = file;
   }
   if (compaction_style_ == kCompactionStyleUniversal) {
     // For universal compaction, we use level0 score to indicate
@@ -487,6 +487,14 @@ class RandomAccessFile : public File {
 
   virtual void Hint(AccessPattern pattern) {}
 
+  // Asks to asynchronously load "n" bytes starting at "offset" into the
+  // system cache, in anticipation of reading them soon. Does not wait for the
+  // data to be read. If the system is not caching the file contents, then this
+  // is a noop.
+  virtual Status Prefetch(uint64_t offset, size_t n) {
+    return Status::OK();
+  }
+
   // Remove any kind of caching of data from the offset to offset+length
   // of this file. If the length is 0, then it refers to the end of file.
   // If the system is not caching the file contents, then this is a noop.
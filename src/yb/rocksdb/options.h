@@ -65,6 +65,7 @@ class Statistics;
 class InternalKeyComparator;
 class WalFilter;
 class MemoryMonitor;
+class BackgroundWorkScheduler;
 
 // DB contents are stored in a set of blocks, each of which holds a
 // sequence of key,value pairs.  Each block may be compressed before
@@ -1114,6 +1115,12 @@ struct DBOptions {
   // Default: nullptr (disabled)
   std::shared_ptr<MemoryMonitor> memory_monitor;
 
+  // Shared scheduler to run background flushes and compactions by priority, instead of the
+  // thread pools of env.
+  //
+  // Default: nullptr (disabled)
+  std::shared_ptr<BackgroundWorkScheduler> background_work_scheduler;
+
   // Specify the file access pattern once a compaction is started.
   // It will be applied to all input files of a compaction.
   // Default: NORMAL
@@ -174,6 +174,17 @@ struct BlockBasedTableOptions {
   // Default: false
   bool skip_table_builder_flush = false;
 
+  // When an iterator reads consecutive data blocks of a table, the blocks
+  // following them are prefetched asynchronously. The first prefetch covers
+  // initial_auto_readahead_size bytes, every next one doubles it, up to
+  // max_auto_readahead_size bytes, which bounds the data prefetched ahead of a
+  // single scan. Reading a block that does not follow the previous one starts
+  // over. 0 disables the readahead.
+  //
+  // Default: 8KB and 256KB
+  size_t initial_auto_readahead_size = 8 * 1024;
+  size_t max_auto_readahead_size = 256 * 1024;
+
   // We currently have three versions:
   // 0 -- This version is currently written out by all RocksDB's versions by
   // default.  Can be read by really old RocksDB's. Doesn't support changing
@@ -23,6 +23,8 @@
 
 #include "yb/rocksdb/table/block_based_table_reader.h"
 
+#include <algorithm>
+#include <limits>
 #include <string>
 #include <utility>
 #include <cinttypes>
@@ -1103,6 +1105,7 @@ class BlockBasedTable::BlockEntryIteratorState : public TwoLevelIteratorState {
         skip_filters_(skip_filters) {}
 
   InternalIterator* NewSecondaryIterator(const Slice& index_value) override {
+    MaybeReadahead(index_value);
     return table_->NewDataBlockIterator(read_options_, index_value);
   }
 
@@ -1114,10 +1117,57 @@ class BlockBasedTable::BlockEntryIteratorState : public TwoLevelIteratorState {
   }
 
  private:
+  // Number of consecutive data blocks to read before starting the readahead, so that point reads
+  // and short scans don't prefetch anything.
+  static constexpr int kMinSequentialReadsForReadahead = 2;
+
+  // Detects sequential reads of data blocks and prefetches the blocks following them. The next
+  // window is requested when the reads get within half a window of the prefetched data, so it is
+  // loaded while the previous one is consumed.
+  void MaybeReadahead(const Slice& index_value) {
+    const auto& table_options = table_->rep_->table_options;
+    if (table_options.max_auto_readahead_size == 0 ||
+        read_options_.read_tier == kBlockCacheTier) {
+      return;
+    }
+    BlockHandle handle;
+    Slice input = index_value;
+    if (!handle.DecodeFrom(&input).ok()) {
+      return;
+    }
+    const uint64_t block_end = handle.offset() + handle.size() + kBlockTrailerSize;
+    if (handle.offset() == next_block_offset_) {
+      ++num_sequential_reads_;
+    } else {
+      num_sequential_reads_ = 0;
+      readahead_size_ = std::min(table_options.initial_auto_readahead_size,
+                                 table_options.max_auto_readahead_size);
+      readahead_limit_ = 0;
+    }
+    next_block_offset_ = block_end;
+    if (num_sequential_reads_ < kMinSequentialReadsForReadahead ||
+        block_end + readahead_size_ / 2 <= readahead_limit_) {
+      return;
+    }
+    const uint64_t start = std::max(block_end, readahead_limit_);
+    // Readahead is best effort, a failure shows up on the actual read if it matters.
+    table_->rep_->data_reader_with_cache_prefix->reader->Prefetch(start, readahead_size_);
+    readahead_limit_ = start + readahead_size_;
+    readahead_size_ = std::min(readahead_size_ * 2, table_options.max_auto_readahead_size);
+  }
+
   // Don't own table_
   BlockBasedTable* const table_;
   const ReadOptions read_options_;
   const bool skip_filters_;
+
+  // Offset right after the last read data block, i.e. where the next one starts if the reads are
+  // sequential.
+  uint64_t next_block_offset_ = std::numeric_limits<uint64_t>::max();
+  int num_sequential_reads_ = 0;
+  size_t readahead_size_ = 0;
+  // End of the prefetched part of the data file.
+  uint64_t readahead_limit_ = 0;
 };
 
 // This will be broken if the user specifies an unusual implementation
@@ -1517,6 +1567,31 @@ uint64_t BlockBasedTable::ApproximateOffsetOf(const Slice& key) {
   return result;
 }
 
+void BlockBasedTable::SampleKeys(size_t max_keys, std::vector<std::string>* keys) {
+  // The number of index entries is taken from the table properties, so the index is passed once,
+  // up to the last sampled entry.
+  const size_t num_blocks =
+      rep_->table_properties ? rep_->table_properties->num_data_blocks : 0;
+  if (max_keys == 0 || num_blocks <= 1) {
+    return;
+  }
+  unique_ptr<InternalIterator> index_iter(NewIndexIterator(ReadOptions::kDefault));
+  // The key of an index entry separates its data block from the next one, so the key of the last
+  // entry is never sampled.
+  const size_t step = std::max<size_t>(num_blocks / (max_keys + 1), 1);
+  size_t num_passed_blocks = 0;
+  for (index_iter->SeekToFirst(); index_iter->Valid() && max_keys > 0; index_iter->Next()) {
+    ++num_passed_blocks;
+    if (num_passed_blocks == num_blocks) {
+      break;
+    }
+    if (num_passed_blocks % step == 0) {
+      keys->push_back(index_iter->key().ToString());
+      --max_keys;
+    }
+  }
+}
+
 bool BlockBasedTable::TEST_filter_block_preloaded() const {
   return rep_->filter != nullptr;
 }
@@ -25,6 +25,8 @@
 #define ROCKSDB_TABLE_TABLE_READER_H
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "yb/util/slice.h"
 
@@ -72,6 +74,11 @@ class TableReader {
   // be close to the file length.
   virtual uint64_t ApproximateOffsetOf(const Slice& key) = 0;
 
+  // Appends to keys up to max_keys internal keys, in increasing order, that split the table into
+  // parts of approximately equal size. Used to choose subcompaction boundaries, so the default
+  // implementation appends nothing.
+  virtual void SampleKeys(size_t max_keys, std::vector<std::string>* keys) {}
+
   // Set up the table for Compaction. Might change some parameters with
   // posix_fadvise
   virtual void SetupForCompaction() = 0;
@@ -320,8 +320,8 @@ class TableConstructor: public Constructor {
 
     // Open the table
     uniq_id_ = cur_uniq_id_++;
-    file_reader_.reset(test::GetRandomAccessFileReader(new test::StringSource(
-        GetSink()->contents(), uniq_id_, ioptions.allow_mmap_reads)));
+    source_ = new test::StringSource(GetSink()->contents(), uniq_id_, ioptions.allow_mmap_reads);
+    file_reader_.reset(test::GetRandomAccessFileReader(source_));
     return ioptions.table_factory->NewTableReader(
         TableReaderOptions(ioptions, soptions, internal_comparator),
         std::move(file_reader_), GetSink()->contents().size(), &table_reader_);
@@ -342,8 +342,8 @@ class TableConstructor: public Constructor {
   }
 
   virtual Status Reopen(const ImmutableCFOptions& ioptions) {
-    file_reader_.reset(test::GetRandomAccessFileReader(new test::StringSource(
-        GetSink()->contents(), uniq_id_, ioptions.allow_mmap_reads)));
+    source_ = new test::StringSource(GetSink()->contents(), uniq_id_, ioptions.allow_mmap_reads);
+    file_reader_.reset(test::GetRandomAccessFileReader(source_));
     return ioptions.table_factory->NewTableReader(
         TableReaderOptions(ioptions, soptions, *last_internal_key_),
         std::move(file_reader_), GetSink()->contents().size(), &table_reader_);
@@ -353,6 +353,11 @@ class TableConstructor: public Constructor {
     return table_reader_.get();
   }
 
+  // The file the table is read from, owned by the table reader.
+  const test::StringSource* source() const {
+    return source_;
+  }
+
   bool AnywayDeleteIterator() const override {
     return convert_to_internal_key_;
   }
@@ -360,6 +365,7 @@ class TableConstructor: public Constructor {
  private:
   void Reset() {
     uniq_id_ = 0;
+    source_ = nullptr;
     table_reader_.reset();
     file_writer_.reset();
     file_reader_.reset();
@@ -370,6 +376,7 @@ class TableConstructor: public Constructor {
   }
 
   uint64_t uniq_id_;
+  test::StringSource* source_ = nullptr;
   unique_ptr<WritableFileWriter> file_writer_;
   unique_ptr<RandomAccessFileReader> file_reader_;
   unique_ptr<TableReader> table_reader_;
@@ -1517,6 +1524,49 @@ TEST_F(BlockBasedTableTest, NumBlockStat) {
             c.GetTableReader()->GetTableProperties()->num_data_blocks);
 }
 
+TEST_F(BlockBasedTableTest, AutoReadahead) {
+  Random rnd(test::RandomSeed());
+  TableConstructor c(BytewiseComparator());
+  Options options;
+  options.compression = kNoCompression;
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 1000;
+  table_options.initial_auto_readahead_size = 2000;
+  table_options.max_auto_readahead_size = 8000;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+
+  for (int i = 0; i < 100; ++i) {
+    // Each block holds roughly one key/value pair.
+    c.Add(RandomString(&rnd, 900), "val");
+  }
+
+  std::vector<std::string> ks;
+  stl_wrappers::KVMap kvmap;
+  const ImmutableCFOptions ioptions(options);
+  c.Finish(options, ioptions, table_options,
+           GetPlainInternalComparator(options.comparator), &ks, &kvmap);
+
+  // Point reads don't prefetch anything.
+  for (const auto& key : ks) {
+    std::unique_ptr<InternalIterator> iter(c.NewIterator());
+    iter->Seek(key);
+    ASSERT_TRUE(iter->Valid());
+  }
+  ASSERT_EQ(0U, c.source()->total_prefetched_bytes());
+
+  // A full scan prefetches ahead of it, in windows of at most max_auto_readahead_size bytes.
+  std::unique_ptr<InternalIterator> iter(c.NewIterator());
+  size_t num_keys = 0;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    ++num_keys;
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(ks.size(), num_keys);
+  const size_t prefetched_bytes = c.source()->total_prefetched_bytes();
+  ASSERT_GT(prefetched_bytes, 50000U);
+  ASSERT_LE(prefetched_bytes, c.source()->Size() + table_options.max_auto_readahead_size);
+}
+
 // A simple tool that takes the snapshot of block cache statistics.
 class BlockCachePropertiesSnapshot {
  public:
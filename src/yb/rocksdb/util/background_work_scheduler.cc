@@ -0,0 +1,206 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/rocksdb/background_work_scheduler.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <iterator>
+#include <list>
+#include <mutex>
+#include <utility>
+
+#include "yb/util/format.h"
+#include "yb/util/status.h"
+#include "yb/util/thread.h"
+
+namespace rocksdb {
+
+namespace {
+
+class PriorityBackgroundWorkScheduler : public BackgroundWorkScheduler {
+ public:
+  PriorityBackgroundWorkScheduler(int num_flush_threads, int num_compaction_threads)
+      : has_flush_threads_(num_flush_threads > 0) {
+    StartThreads(BackgroundWorkType::kFlush, "flush", num_flush_threads);
+    StartThreads(BackgroundWorkType::kCompaction, "compaction", num_compaction_threads);
+  }
+
+  ~PriorityBackgroundWorkScheduler() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    cond_.notify_all();
+    for (auto& thread : threads_) {
+      thread->Join();
+    }
+    for (auto& work : queue_) {
+      if (work.unschedule_function != nullptr) {
+        work.unschedule_function(work.arg);
+      }
+    }
+  }
+
+  void Schedule(void (*function)(void*), void* arg, BackgroundWorkType type,
+                std::function<int64_t()> priority_function, void* tag,
+                void (*unschedule_function)(void*), std::string description) override {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      queue_.push_back(Work{function, arg, type, std::move(priority_function), 0 /* priority */,
+                            tag, unschedule_function, std::move(description),
+                            next_serial_no_++});
+    }
+    cond_.notify_all();
+  }
+
+  int Unschedule(void* tag, BackgroundWorkType type) override {
+    std::vector<Work> removed;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = std::stable_partition(queue_.begin(), queue_.end(), [tag, type](const Work& work) {
+        return work.tag != tag || work.type != type;
+      });
+      std::move(it, queue_.end(), std::back_inserter(removed));
+      queue_.erase(it, queue_.end());
+    }
+    for (auto& work : removed) {
+      if (work.unschedule_function != nullptr) {
+        work.unschedule_function(work.arg);
+      }
+    }
+    return static_cast<int>(removed.size());
+  }
+
+  std::vector<WorkInfo> GetWorkInfos() const override {
+    std::vector<WorkInfo> result;
+    std::vector<std::pair<int64_t, const Work*>> queued;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      // The priority of the running work is the one it was picked with.
+      for (const auto& work : running_) {
+        result.push_back(WorkInfo{work.type, work.priority, work.description, true});
+      }
+      queued.reserve(queue_.size());
+      for (const auto& work : queue_) {
+        queued.emplace_back(work.priority_function(), &work);
+      }
+      std::sort(queued.begin(), queued.end(), [](const auto& lhs, const auto& rhs) {
+        return RunsBefore(lhs.first, *lhs.second, rhs.first, *rhs.second);
+      });
+      for (const auto& entry : queued) {
+        const auto& work = *entry.second;
+        result.push_back(WorkInfo{work.type, entry.first, work.description, false});
+      }
+    }
+    return result;
+  }
+
+ private:
+  struct Work {
+    void (*function)(void*);
+    void* arg;
+    BackgroundWorkType type;
+    std::function<int64_t()> priority_function;
+    // Priority the work was picked with, once it is running.
+    int64_t priority;
+    void* tag;
+    void (*unschedule_function)(void*);
+    std::string description;
+    // Orders the work of the same priority by the time it was scheduled.
+    uint64_t serial_no;
+  };
+
+  // Flushes go before compactions when they share threads, as they release memory and unblock
+  // writes. Priorities of different work types are not comparable.
+  static bool RunsBefore(int64_t lhs_priority, const Work& lhs, int64_t rhs_priority,
+                         const Work& rhs) {
+    if (lhs.type != rhs.type) {
+      return lhs.type == BackgroundWorkType::kFlush;
+    }
+    if (lhs_priority != rhs_priority) {
+      return lhs_priority > rhs_priority;
+    }
+    return lhs.serial_no < rhs.serial_no;
+  }
+
+  void StartThreads(BackgroundWorkType type, const char* name, int num_threads) {
+    for (int i = 0; i < num_threads; ++i) {
+      scoped_refptr<yb::Thread> thread;
+      CHECK_OK(yb::Thread::Create(
+          "rocksdb", yb::Format("bg_$0_$1", name, i), &PriorityBackgroundWorkScheduler::ThreadMain,
+          this, type, &thread));
+      threads_.push_back(std::move(thread));
+    }
+  }
+
+  // Without flush threads, like the DBs scheduling flushes to the low priority Env pool when
+  // max_background_flushes is 0, the flushes run on the compaction threads.
+  bool Serves(BackgroundWorkType thread_type, const Work& work) const {
+    return work.type == thread_type ||
+           (!has_flush_threads_ && thread_type == BackgroundWorkType::kCompaction);
+  }
+
+  void ThreadMain(BackgroundWorkType type) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+      if (stopping_) {
+        return;
+      }
+      // The queue is expected to be short, i.e. a few items per DB at most, so it is scanned
+      // instead of being kept ordered. This also lets the priorities be evaluated when the work is
+      // picked rather than when it was scheduled.
+      auto next = queue_.end();
+      int64_t next_priority = 0;
+      for (auto it = queue_.begin(); it != queue_.end(); ++it) {
+        if (!Serves(type, *it)) {
+          continue;
+        }
+        const int64_t priority = it->priority_function();
+        if (next == queue_.end() || RunsBefore(priority, *it, next_priority, *next)) {
+          next = it;
+          next_priority = priority;
+        }
+      }
+      if (next == queue_.end()) {
+        cond_.wait(lock);
+        continue;
+      }
+      next->priority = next_priority;
+      auto running_it = running_.insert(running_.end(), std::move(*next));
+      queue_.erase(next);
+      lock.unlock();
+      running_it->function(running_it->arg);
+      lock.lock();
+      running_.erase(running_it);
+    }
+  }
+
+  const bool has_flush_threads_;
+  mutable std::mutex mutex_;
+  std::condition_variable cond_;
+  bool stopping_ = false;
+  uint64_t next_serial_no_ = 0;
+  std::vector<Work> queue_;
+  std::list<Work> running_;
+  std::vector<scoped_refptr<yb::Thread>> threads_;
+};
+
+} // namespace
+
+BackgroundWorkScheduler* NewBackgroundWorkScheduler(
+    int num_flush_threads, int num_compaction_threads) {
+  return new PriorityBackgroundWorkScheduler(num_flush_threads, num_compaction_threads);
+}
+
+}  // namespace rocksdb
@@ -0,0 +1,184 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "yb/rocksdb/background_work_scheduler.h"
+#include "yb/rocksdb/util/testharness.h"
+
+namespace rocksdb {
+
+namespace {
+
+struct TestWork {
+  int id;
+  std::mutex* mutex;
+  std::vector<int>* done;
+  std::atomic<bool>* release = nullptr;
+
+  static void Run(void* arg) {
+    auto* work = static_cast<TestWork*>(arg);
+    while (work->release != nullptr && !work->release->load()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    std::lock_guard<std::mutex> lock(*work->mutex);
+    work->done->push_back(work->id);
+  }
+
+  static void Unschedule(void* arg) {
+    auto* work = static_cast<TestWork*>(arg);
+    std::lock_guard<std::mutex> lock(*work->mutex);
+    work->done->push_back(-work->id);
+  }
+};
+
+} // namespace
+
+class BackgroundWorkSchedulerTest : public testing::Test {
+ protected:
+  void Schedule(BackgroundWorkScheduler* scheduler, TestWork* work, int64_t priority, void* tag) {
+    scheduler->Schedule(&TestWork::Run, work, BackgroundWorkType::kCompaction,
+                        [priority] { return priority; }, tag, &TestWork::Unschedule, "test");
+  }
+
+  void Schedule(BackgroundWorkScheduler* scheduler, TestWork* work,
+                std::atomic<int64_t>* priority, void* tag) {
+    scheduler->Schedule(&TestWork::Run, work, BackgroundWorkType::kCompaction,
+                        [priority] { return priority->load(); }, tag, &TestWork::Unschedule,
+                        "test");
+  }
+
+  std::vector<int> WaitDone(size_t count) {
+    for (;;) {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (done_.size() >= count) {
+          return done_;
+        }
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+
+  std::mutex mutex_;
+  std::vector<int> done_;
+};
+
+TEST_F(BackgroundWorkSchedulerTest, RunsByPriority) {
+  std::unique_ptr<BackgroundWorkScheduler> scheduler(NewBackgroundWorkScheduler(1, 1));
+  std::atomic<bool> release(false);
+  TestWork blocker{1, &mutex_, &done_, &release};
+  TestWork low{2, &mutex_, &done_};
+  TestWork high{3, &mutex_, &done_};
+  TestWork medium{4, &mutex_, &done_};
+  TestWork medium_later{5, &mutex_, &done_};
+  int tag1 = 0;
+  int tag2 = 0;
+
+  // The blocker has the highest priority, so it runs first even if it did not start yet.
+  Schedule(scheduler.get(), &blocker, 100, &tag1);
+  Schedule(scheduler.get(), &low, 1, &tag1);
+  Schedule(scheduler.get(), &high, 3, &tag2);
+  Schedule(scheduler.get(), &medium, 2, &tag1);
+  Schedule(scheduler.get(), &medium_later, 2, &tag2);
+  ASSERT_EQ(5U, scheduler->GetWorkInfos().size());
+  ASSERT_EQ(0, scheduler->Unschedule(&tag1, BackgroundWorkType::kFlush));
+
+  release = true;
+  ASSERT_EQ(std::vector<int>({1, 3, 4, 5, 2}), WaitDone(5));
+}
+
+TEST_F(BackgroundWorkSchedulerTest, PriorityChangesWhileQueued) {
+  std::unique_ptr<BackgroundWorkScheduler> scheduler(NewBackgroundWorkScheduler(1, 1));
+  std::atomic<bool> release(false);
+  TestWork blocker{1, &mutex_, &done_, &release};
+  TestWork first{2, &mutex_, &done_};
+  TestWork second{3, &mutex_, &done_};
+  std::atomic<int64_t> first_priority(2);
+  std::atomic<int64_t> second_priority(1);
+  int tag1 = 0;
+  int tag2 = 0;
+
+  Schedule(scheduler.get(), &blocker, 100, &tag1);
+  Schedule(scheduler.get(), &first, &first_priority, &tag1);
+  Schedule(scheduler.get(), &second, &second_priority, &tag2);
+  while (!scheduler->GetWorkInfos().front().running) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  // The DB of the second work became more urgent after its work was scheduled.
+  second_priority = 3;
+  auto infos = scheduler->GetWorkInfos();
+  ASSERT_EQ(3U, infos.size());
+  ASSERT_EQ(3, infos[1].priority);
+  ASSERT_EQ(2, infos[2].priority);
+
+  release = true;
+  ASSERT_EQ(std::vector<int>({1, 3, 2}), WaitDone(3));
+}
+
+TEST_F(BackgroundWorkSchedulerTest, FlushesWithoutFlushThreads) {
+  std::unique_ptr<BackgroundWorkScheduler> scheduler(NewBackgroundWorkScheduler(0, 1));
+  std::atomic<bool> release(false);
+  TestWork blocker{1, &mutex_, &done_, &release};
+  TestWork compaction{2, &mutex_, &done_};
+  TestWork flush{3, &mutex_, &done_};
+  int tag = 0;
+
+  Schedule(scheduler.get(), &blocker, 1, &tag);
+  while (!scheduler->GetWorkInfos().front().running) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  Schedule(scheduler.get(), &compaction, 100, &tag);
+  scheduler->Schedule(&TestWork::Run, &flush, BackgroundWorkType::kFlush, [] { return 0; }, &tag,
+                      &TestWork::Unschedule, "test");
+
+  // The flush runs on the compaction thread, before the queued compaction.
+  release = true;
+  ASSERT_EQ(std::vector<int>({1, 3, 2}), WaitDone(3));
+}
+
+TEST_F(BackgroundWorkSchedulerTest, Unschedule) {
+  std::unique_ptr<BackgroundWorkScheduler> scheduler(NewBackgroundWorkScheduler(1, 1));
+  std::atomic<bool> release(false);
+  TestWork blocker{1, &mutex_, &done_, &release};
+  TestWork first{2, &mutex_, &done_};
+  TestWork second{3, &mutex_, &done_};
+  int tag1 = 0;
+  int tag2 = 0;
+
+  Schedule(scheduler.get(), &blocker, 100, &tag1);
+  Schedule(scheduler.get(), &first, 1, &tag2);
+  Schedule(scheduler.get(), &second, 1, &tag1);
+  // Wait for the blocker to start, so it is not unscheduled.
+  while (!scheduler->GetWorkInfos().front().running) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_EQ(1, scheduler->Unschedule(&tag1, BackgroundWorkType::kCompaction));
+  ASSERT_EQ(std::vector<int>({-3}), WaitDone(1));
+
+  release = true;
+  ASSERT_EQ(std::vector<int>({-3, 1, 2}), WaitDone(3));
+}
+
+}  // namespace rocksdb
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -558,6 +558,12 @@ static std::unordered_map<std::string,
     {"skip_table_builder_flush",
      {offsetof(struct BlockBasedTableOptions, skip_table_builder_flush),
       OptionType::kBoolean, OptionVerificationType::kNormal}},
+    {"initial_auto_readahead_size",
+     {offsetof(struct BlockBasedTableOptions, initial_auto_readahead_size),
+      OptionType::kSizeT, OptionVerificationType::kNormal}},
+    {"max_auto_readahead_size",
+     {offsetof(struct BlockBasedTableOptions, max_auto_readahead_size),
+      OptionType::kSizeT, OptionVerificationType::kNormal}},
     {"format_version",
      {offsetof(struct BlockBasedTableOptions, format_version),
       OptionType::kUInt32T, OptionVerificationType::kNormal}}};
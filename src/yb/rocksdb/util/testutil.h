@@ -237,7 +237,8 @@ class StringSource: public RandomAccessFile {
       : contents_(contents.cdata(), contents.size()),
         uniq_id_(uniq_id),
         mmap_(mmap),
-        total_reads_(0) {}
+        total_reads_(0),
+        total_prefetched_bytes_(0) {}
 
   virtual ~StringSource() { }
 
@@ -272,15 +273,23 @@ class StringSource: public RandomAccessFile {
     return static_cast<size_t>(rid-id);
   }
 
+  virtual Status Prefetch(uint64_t offset, size_t n) override {
+    total_prefetched_bytes_ += n;
+    return Status::OK();
+  }
+
   int total_reads() const { return total_reads_; }
 
   void set_total_reads(int tr) { total_reads_ = tr; }
 
+  size_t total_prefetched_bytes() const { return total_prefetched_bytes_; }
+
  private:
   std::string contents_;
   uint64_t uniq_id_;
   bool mmap_;
   mutable int total_reads_;
+  size_t total_prefetched_bytes_;
 };
 
 class NullLogger : public Logger {
@@ -79,7 +79,7 @@ Connection::Connection(Reactor* reactor,
       direction_(direction),
       connected_(connected),
       last_activity_time_(CoarseMonoClock::Now()),
-      read_buffer_(FLAGS_rpc_initial_buffer_size, context->BufferLimit()),
+      read_buffer_(reactor->read_buffer_allocator(), context->BufferLimit()),
       context_(std::move(context)) {
   auto status = socket_.GetSocketAddress(&local_);
   if (!status.ok()) {
@@ -291,6 +291,10 @@ void Connection::Handler(ev::io& watcher, int revents) {  // NOLINT
 
   if (status.ok() && (revents & EV_READ)) {
     status = ReadHandler();
+    // Connections are mostly idle between calls, so they should not hold receive memory then.
+    if (read_buffer_.empty()) {
+      read_buffer_.Release();
+    }
   }
 
   if (status.ok() && (revents & EV_WRITE)) {
@@ -318,7 +322,8 @@ Status Connection::ReadHandler() {
   last_activity_time_ = reactor_->cur_time();
 
   for (;;) {
-    auto received = Receive();
+    bool drained = false;
+    auto received = Receive(&drained);
     if (PREDICT_FALSE(!received.ok())) {
       if (received.status().error_code() == ESHUTDOWN) {
         VLOG(1) << ToString() << " shut down by remote end.";
@@ -337,13 +342,13 @@ Status Connection::ReadHandler() {
     if (!continue_receiving.ok()) {
       return continue_receiving.status();
     }
-    if (!continue_receiving.get()) {
+    if (!continue_receiving.get() || drained) {
       return Status::OK();
     }
   }
 }
 
-Result<bool> Connection::Receive() {
+Result<bool> Connection::Receive(bool* drained) {
   RETURN_NOT_OK(read_buffer_.PrepareRead());
 
   size_t max_receive = context_->MaxReceive(Slice(read_buffer_.begin(), read_buffer_.size()));
@@ -369,6 +374,7 @@ Result<bool> Connection::Receive() {
   }
 
   read_buffer_.DataAppended(nread);
+  *drained = nread < remaining_buf_capacity;
   return nread != 0;
 }
 
@@ -396,6 +402,7 @@ Status Connection::HandleCallResponse(Slice call_data) {
   RETURN_NOT_OK(resp.ParseFrom(call_data));
 
   ++responded_call_count_;
+  reactor_->messenger()->SetCompressionSupported(remote_, resp.compression_supported());
   auto awaiting = awaiting_response_.find(resp.call_id());
   if (awaiting == awaiting_response_.end()) {
     LOG(ERROR) << ToString() << ": Got a response for call id " << resp.call_id() << " which "
@@ -434,13 +441,17 @@ Status Connection::DoWrite() {
     return Status::OK();
   }
   while (!sending_.empty()) {
-    const size_t kMaxIov = 16;
+    // Small calls take a couple of iovecs each, so a large limit lets a single writev send all the
+    // calls queued to the connection during a reactor loop iteration.
+    const size_t kMaxIov = 128;
     iovec iov[kMaxIov];
     const int iov_len = static_cast<int>(std::min(kMaxIov, sending_.size()));
     size_t offset = send_position_;
+    size_t total_len = 0;
     for (auto i = 0; i != iov_len; ++i) {
       iov[i].iov_base = sending_[i].data() + offset;
       iov[i].iov_len = sending_[i].size() - offset;
+      total_len += iov[i].iov_len;
       offset = 0;
     }
 
@@ -469,6 +480,14 @@ Status Connection::DoWrite() {
         call->Transferred(Status::OK(), this);
       }
     }
+
+    // A partial write means that the socket send buffer is full, so instead of another writev
+    // failing with EAGAIN, we wait for the socket to become writable.
+    if (static_cast<size_t>(written) < total_len && !sending_.empty()) {
+      waiting_write_ready_ = true;
+      io_.set(ev::READ|ev::WRITE);
+      return Status::OK();
+    }
   }
 
   return Status::OK();
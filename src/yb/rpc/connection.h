@@ -247,7 +247,10 @@ class Connection final : public std::enable_shared_from_this<Connection> {
 
   void ClearSending(const Status& status);
 
-  Result<bool> Receive();
+  // Receives the available data into read_buffer_, returns whether anything was received. Sets
+  // drained to true if the socket had less data than could be received, so that the caller does
+  // not need another recv to find out that there is nothing left.
+  Result<bool> Receive(bool* drained);
 
   // Try to parse received data into calls and process them.
   Result<bool> TryProcessCalls();
@@ -83,5 +83,32 @@ TEST_F(GrowableBufferTest, TestConsume) {
   }
 }
 
+TEST_F(GrowableBufferTest, TestRelease) {
+  auto allocator = std::make_shared<GrowableBufferAllocator>(kInitialSize, 1);
+  GrowableBuffer buffer(allocator, kSizeLimit);
+
+  // Memory is not allocated until the first read.
+  ASSERT_EQ(buffer.capacity_left(), 0);
+  ASSERT_OK(buffer.PrepareRead());
+  ASSERT_EQ(buffer.capacity_left(), kInitialSize);
+  const uint8_t* block = buffer.write_position();
+  buffer.DataAppended(kInitialSize / 2);
+  buffer.Consume(kInitialSize / 2);
+  ASSERT_TRUE(buffer.empty());
+
+  // The released block is reused by the next read.
+  buffer.Release();
+  ASSERT_EQ(buffer.capacity_left(), 0);
+  ASSERT_EQ(allocator->free_blocks(), 1);
+  ASSERT_OK(buffer.PrepareRead());
+  ASSERT_EQ(allocator->free_blocks(), 0);
+  ASSERT_EQ(buffer.write_position(), block);
+
+  // A grown buffer is freed instead of being returned to the allocator.
+  ASSERT_OK(buffer.EnsureFreeSpace(kInitialSize * 2));
+  buffer.Release();
+  ASSERT_EQ(allocator->free_blocks(), 0);
+}
+
 } // namespace rpc
 } // namespace yb
@@ -15,7 +15,9 @@
 
 #include "yb/rpc/growable_buffer.h"
 
+#include <algorithm>
 #include <iostream>
+#include <mutex>
 
 #include "yb/gutil/strings/substitute.h"
 
@@ -24,11 +26,60 @@ using strings::Substitute;
 namespace yb {
 namespace rpc {
 
+GrowableBufferAllocator::GrowableBufferAllocator(size_t block_size, size_t max_free_blocks)
+    : block_size_(block_size), max_free_blocks_(max_free_blocks) {
+}
+
+GrowableBufferAllocator::~GrowableBufferAllocator() {
+  for (auto* block : free_blocks_) {
+    free(block);
+  }
+}
+
+uint8_t* GrowableBufferAllocator::Allocate() {
+  {
+    std::lock_guard<simple_spinlock> lock(mutex_);
+    if (!free_blocks_.empty()) {
+      auto* result = free_blocks_.back();
+      free_blocks_.pop_back();
+      return result;
+    }
+  }
+  return static_cast<uint8_t*>(malloc(block_size_));
+}
+
+void GrowableBufferAllocator::Free(uint8_t* block) {
+  {
+    std::lock_guard<simple_spinlock> lock(mutex_);
+    if (free_blocks_.size() < max_free_blocks_) {
+      free_blocks_.push_back(block);
+      return;
+    }
+  }
+  free(block);
+}
+
+size_t GrowableBufferAllocator::free_blocks() const {
+  std::lock_guard<simple_spinlock> lock(mutex_);
+  return free_blocks_.size();
+}
+
 GrowableBuffer::GrowableBuffer(size_t initial, size_t limit)
-    : buffer_(static_cast<uint8_t*>(malloc(initial))),
+    : initial_(initial),
+      buffer_(static_cast<uint8_t*>(malloc(initial))),
       limit_(limit),
-      capacity_(initial),
-      size_(0) {
+      capacity_(initial) {
+}
+
+GrowableBuffer::GrowableBuffer(std::shared_ptr<GrowableBufferAllocator> allocator, size_t limit)
+    : allocator_(std::move(allocator)),
+      initial_(std::min(allocator_->block_size(), limit)),
+      limit_(limit) {
+}
+
+GrowableBuffer::~GrowableBuffer() {
+  Clear();
+  Release();
 }
 
 void GrowableBuffer::DumpTo(std::ostream& out) const {
@@ -38,47 +89,69 @@ void GrowableBuffer::DumpTo(std::ostream& out) const {
 void GrowableBuffer::Consume(size_t count) {
   if (count > size_) {
     LOG(DFATAL) << "Consume more bytes than contained: " << size_ << " vs " << count;
+    count = size_;
   }
-  if (count) {
-    size_t left = size_ - count;
-    if (left) {
-      memmove(buffer_.get(), buffer_.get() + count, left);
-    }
-    size_ = left;
+  pos_ += count;
+  size_ -= count;
+  if (size_ == 0) {
+    pos_ = 0;
+  }
+}
+
+void GrowableBuffer::Compact() {
+  if (pos_ != 0) {
+    memmove(buffer_, buffer_ + pos_, size_);
+    pos_ = 0;
   }
 }
 
 void GrowableBuffer::Swap(GrowableBuffer* rhs) {
   DCHECK_EQ(limit_, rhs->limit_);
 
-  buffer_.swap(rhs->buffer_);
+  allocator_.swap(rhs->allocator_);
+  std::swap(initial_, rhs->initial_);
+  std::swap(buffer_, rhs->buffer_);
   std::swap(capacity_, rhs->capacity_);
+  std::swap(pos_, rhs->pos_);
   std::swap(size_, rhs->size_);
 }
 
 Status GrowableBuffer::Reshape(size_t new_capacity) {
   DCHECK_LE(new_capacity, limit_);
   if (new_capacity != capacity_) {
-    auto new_buffer = static_cast<uint8_t *>(realloc(buffer_.get(), new_capacity));
+    Compact();
+    uint8_t* new_buffer;
+    if (buffer_) {
+      new_buffer = static_cast<uint8_t*>(realloc(buffer_, new_capacity));
+    } else if (allocator_ && new_capacity == allocator_->block_size()) {
+      new_buffer = allocator_->Allocate();
+    } else {
+      new_buffer = static_cast<uint8_t*>(malloc(new_capacity));
+    }
     if (!new_buffer) {
       return STATUS(RuntimeError,
           Substitute("Failed to change buffer size from $0 to $1 bytes", capacity_, new_capacity));
     }
-    buffer_.release();
-    buffer_.reset(new_buffer);
+    buffer_ = new_buffer;
     capacity_ = new_capacity;
   }
   return Status::OK();
 }
 
 Status GrowableBuffer::PrepareRead() {
-  if (size_ * 2 > capacity_) {
-    const size_t new_capacity = std::min(limit_, capacity_ * 2);
-    if (size_ == new_capacity) {
-      return STATUS(RuntimeError,
-          Substitute("Prepare read when buffer already full size: $0, limit: $1", size_, limit_));
+  if (!buffer_) {
+    return Reshape(initial_);
+  }
+  if ((pos_ + size_) * 2 > capacity_) {
+    Compact();
+    if (size_ * 2 > capacity_) {
+      const size_t new_capacity = std::min(limit_, capacity_ * 2);
+      if (size_ == new_capacity) {
+        return STATUS(RuntimeError,
+            Substitute("Prepare read when buffer already full size: $0, limit: $1", size_, limit_));
+      }
+      return Reshape(new_capacity);
     }
-    return Reshape(new_capacity);
   }
   return Status::OK();
 }
@@ -93,8 +166,11 @@ Status GrowableBuffer::EnsureFreeSpace(size_t len) {
             len,
             limit_));
   }
+  if (pos_ + expected > capacity_) {
+    Compact();
+  }
   if (expected > capacity_) {
-    size_t new_capacity = capacity_ * 2;
+    size_t new_capacity = std::max(capacity_ * 2, initial_);
     while (new_capacity < expected) {
       new_capacity *= 2;
     }
@@ -115,12 +191,27 @@ Status GrowableBuffer::AppendData(const uint8_t* data, size_t len) {
 }
 
 void GrowableBuffer::DataAppended(size_t len) {
-  if (size_ + len > capacity_) {
-    LOG(DFATAL) << "Data appended over capacity: " << size_ << " + " << len << " > " << capacity_;
+  if (pos_ + size_ + len > capacity_) {
+    LOG(DFATAL) << "Data appended over capacity: " << pos_ << " + " << size_ << " + " << len
+                << " > " << capacity_;
   }
   size_ += len;
 }
 
+void GrowableBuffer::Release() {
+  DCHECK_EQ(size_, 0);
+  if (!buffer_) {
+    return;
+  }
+  if (allocator_ && capacity_ == allocator_->block_size()) {
+    allocator_->Free(buffer_);
+  } else {
+    free(buffer_);
+  }
+  buffer_ = nullptr;
+  capacity_ = 0;
+  pos_ = 0;
+}
 
 std::ostream& operator<<(std::ostream& out, const GrowableBuffer& receiver) {
   receiver.DumpTo(out);
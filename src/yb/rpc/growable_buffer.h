@@ -17,9 +17,11 @@
 
 #include <iosfwd>
 #include <memory>
+#include <vector>
 
 #include "yb/gutil/gscoped_ptr.h"
 
+#include "yb/util/locks.h"
 #include "yb/util/status.h"
 
 #include "yb/util/net/socket.h"
@@ -27,36 +29,74 @@
 namespace yb {
 namespace rpc {
 
+// Pool of fixed size blocks used as the initial memory of receive buffers, so that buffers could
+// give their memory back while they are empty, e.g. the buffers of idle connections, and get it
+// again cheaply when data arrives.
+//
+// This class is thread-safe.
+class GrowableBufferAllocator {
+ public:
+  GrowableBufferAllocator(size_t block_size, size_t max_free_blocks);
+  ~GrowableBufferAllocator();
+
+  GrowableBufferAllocator(const GrowableBufferAllocator&) = delete;
+  void operator=(const GrowableBufferAllocator&) = delete;
+
+  size_t block_size() const { return block_size_; }
+
+  // Returns a block of block_size() bytes, allocated by malloc.
+  uint8_t* Allocate();
+
+  // Returns the block to the pool, or frees it if the pool already has max_free_blocks.
+  void Free(uint8_t* block);
+
+  size_t free_blocks() const;
+
+ private:
+  const size_t block_size_;
+  const size_t max_free_blocks_;
+  mutable simple_spinlock mutex_;
+  std::vector<uint8_t*> free_blocks_;
+};
+
 // Convenience buffer for receiving bytes.
 // Major features:
 //   Limit allocated bytes.
 //   Resize depending on used size.
 //   Consume read data.
+//   Release memory while empty, when created with an allocator.
 class GrowableBuffer {
  public:
   explicit GrowableBuffer(size_t initial, size_t limit);
 
+  // Creates a buffer which does not allocate memory until the first read, and takes its initial
+  // memory from the given allocator.
+  GrowableBuffer(std::shared_ptr<GrowableBufferAllocator> allocator, size_t limit);
+
+  ~GrowableBuffer();
+
+  GrowableBuffer(const GrowableBuffer&) = delete;
+  void operator=(const GrowableBuffer&) = delete;
+
   inline bool empty() const { return size_ == 0; }
   inline size_t size() const { return size_; }
-  inline const uint8_t* begin() const { return buffer_.get(); }
-  inline const uint8_t* end() const { return buffer_.get() + size_; }
-  inline size_t capacity_left() const { return capacity_ - size_; }
-  inline uint8_t* write_position() { return buffer_.get() + size_; }
+  inline const uint8_t* begin() const { return buffer_ + pos_; }
+  inline const uint8_t* end() const { return begin() + size_; }
+  inline size_t capacity_left() const { return capacity_ - pos_ - size_; }
+  inline uint8_t* write_position() { return buffer_ + pos_ + size_; }
   inline size_t limit() const { return limit_; }
 
   void Swap(GrowableBuffer* rhs);
   // Reset buffer size to zero. Like with std::vector Clean does not deallocate any memory.
-  void Clear() { size_ = 0; }
+  void Clear() {
+    size_ = 0;
+    pos_ = 0;
+  }
   void DumpTo(std::ostream& out) const;
 
-  // Removes first `count` bytes from buffer, moves remaining bytes to the beginning of the buffer.
-  // This function should be used with care, because it has linear complexity in terms of the
-  // remaining number of bytes.
-  //
-  // A good use case for this class and function is the following.
-  // This function is used after we parse all complete packets to move incomplete packet to the
-  // beginning of the buffer. Usually, there is just a small amount of incomplete data.
-  // Since even a big packet is received by parts, we will move only the first received block.
+  // Removes first `count` bytes from buffer. The remaining bytes are moved to the beginning of the
+  // buffer only when space is needed for the next read, which usually happens just for the
+  // incomplete packet left after parsing all complete packets.
   void Consume(size_t count);
 
   // Ensures there is some space to read into. Depending on currently used size.
@@ -76,20 +116,37 @@ class GrowableBuffer {
   inline CHECKED_STATUS AppendData(const Slice& slice) {
     return AppendData(slice.data(), slice.size());
   }
+
+  // Frees the memory of the buffer, which should be empty. It is allocated again by the next
+  // PrepareRead or EnsureFreeSpace.
+  void Release();
+
  private:
   CHECKED_STATUS Reshape(size_t new_capacity);
 
-  // Contained data
-  std::unique_ptr<uint8_t, FreeDeleter> buffer_;
+  // Moves the contained data to the beginning of the buffer.
+  void Compact();
+
+  // Allocator of the initial memory, could be null.
+  std::shared_ptr<GrowableBufferAllocator> allocator_;
+
+  // Capacity allocated when the buffer has no memory.
+  size_t initial_;
+
+  // Contained data, allocated by malloc.
+  uint8_t* buffer_ = nullptr;
 
   // Max capacity for this buffer
-  const size_t limit_;
+  size_t limit_;
 
   // Current capacity, i.e. allocated bytes
-  size_t capacity_;
+  size_t capacity_ = 0;
+
+  // Offset of the contained data in the buffer.
+  size_t pos_ = 0;
 
   // Currently used bytes
-  size_t size_;
+  size_t size_ = 0;
 };
 
 std::ostream& operator<<(std::ostream& out, const GrowableBuffer& receiver);
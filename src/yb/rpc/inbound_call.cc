@@ -34,6 +34,8 @@
 
 #include "yb/gutil/strings/substitute.h"
 #include "yb/rpc/connection.h"
+#include "yb/rpc/messenger.h"
+#include "yb/rpc/reactor.h"
 #include "yb/common/redis_protocol.pb.h"
 #include "yb/rpc/rpc_introspection.pb.h"
 #include "yb/rpc/serialization.h"
@@ -73,15 +75,46 @@ DEFINE_int32(rpc_slow_query_threshold_ms, 10000,
 TAG_FLAG(rpc_slow_query_threshold_ms, advanced);
 TAG_FLAG(rpc_slow_query_threshold_ms, runtime);
 
+DEFINE_int32(rpc_trace_sampling_interval, 16,
+             "Record compact timestamps of the call phases for every Nth inbound call. "
+             "0 disables sampled tracing.");
+TAG_FLAG(rpc_trace_sampling_interval, advanced);
+TAG_FLAG(rpc_trace_sampling_interval, runtime);
+
+DEFINE_double(rpc_trace_capture_percentile, 99,
+              "Sampled calls handled longer than this percentile of the method handler latency "
+              "are captured and shown on /rpcz.");
+TAG_FLAG(rpc_trace_capture_percentile, advanced);
+TAG_FLAG(rpc_trace_capture_percentile, runtime);
+
 namespace yb {
 namespace rpc {
 
+namespace {
+
+// Number of inbound calls created by this thread since the last sampled one.
+__thread int32_t calls_since_sampled = 0;
+
+bool ShouldSampleCall() {
+  auto interval = FLAGS_rpc_trace_sampling_interval;
+  if (interval <= 0 || ++calls_since_sampled < interval) {
+    return false;
+  }
+  calls_since_sampled = 0;
+  return true;
+}
+
+} // namespace
+
 InboundCall::InboundCall(ConnectionPtr conn, CallProcessedListener call_processed_listener)
     : trace_(new Trace),
       conn_(std::move(conn)),
       call_processed_listener_(std::move(call_processed_listener)) {
   TRACE_TO(trace_, "Created InboundCall");
   RecordCallReceived();
+  if (ShouldSampleCall()) {
+    sampled_trace_ = new SampledTrace(timing_.time_received);
+  }
 }
 
 InboundCall::~InboundCall() {
@@ -129,6 +162,9 @@ void InboundCall::RecordHandlingStarted(scoped_refptr<Histogram> incoming_queue_
   DCHECK(incoming_queue_time != nullptr);
   DCHECK(!timing_.time_handled.Initialized());  // Protect against multiple calls.
   timing_.time_handled = MonoTime::Now();
+  if (sampled_trace_) {
+    sampled_trace_->RecordPhase(TracePhase::kQueue, timing_.time_handled);
+  }
   incoming_queue_time->Increment(
       timing_.time_handled.GetDeltaSince(timing_.time_received).ToMicroseconds());
 }
@@ -139,6 +175,25 @@ void InboundCall::RecordHandlingCompleted(scoped_refptr<Histogram> handler_run_t
   if (handler_run_time) {
     handler_run_time->Increment((timing_.time_completed - timing_.time_handled).ToMicroseconds());
   }
+  if (sampled_trace_) {
+    sampled_trace_->RecordPhase(TracePhase::kRespond, timing_.time_completed);
+    if (handler_run_time && timing_.time_handled) {
+      CaptureSampledTrace(*handler_run_time);
+    }
+  }
+}
+
+void InboundCall::CaptureSampledTrace(const Histogram& handler_run_time) {
+  auto threshold = handler_run_time.CachedValueAtPercentile(FLAGS_rpc_trace_capture_percentile);
+  auto handling_time = timing_.time_completed - timing_.time_handled;
+  // Local calls have no connection, so there is no messenger to keep their traces.
+  if (threshold == 0 || static_cast<uint64_t>(handling_time.ToMicroseconds()) <= threshold ||
+      !conn_) {
+    return;
+  }
+  conn_->reactor()->messenger()->sampled_traces()->Add({
+      service_name() + "." + method_name(), MonoDelta::FromMicroseconds(threshold),
+      timing_.time_completed - timing_.time_received, sampled_trace_});
 }
 
 bool InboundCall::ClientTimedOut() const {
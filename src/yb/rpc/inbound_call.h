@@ -56,6 +56,7 @@
 #include "yb/util/faststring.h"
 #include "yb/util/monotime.h"
 #include "yb/util/ref_cnt_buffer.h"
+#include "yb/util/sampled_trace.h"
 #include "yb/util/slice.h"
 #include "yb/util/status.h"
 
@@ -103,6 +104,11 @@ class InboundCall : public RpcCall {
 
   Trace* trace();
 
+  // Compact trace of the call phases, null if this call was not sampled.
+  SampledTrace* sampled_trace() const {
+    return sampled_trace_.get();
+  }
+
   // When this InboundCall was received (instantiated).
   // Should only be called once on a given instance.
   // Not thread-safe. Should only be called by the current "owner" thread.
@@ -117,6 +123,8 @@ class InboundCall : public RpcCall {
   // When RPC call Handle() completed execution on the server side.
   // Updates the Histogram with time elapsed since the call was started,
   // and should only be called once on a given instance.
+  // A sampled call that took longer than the live percentile of the histogram is captured to the
+  // messenger's sampled traces.
   // Not thread-safe. Should only be called by the current "owner" thread.
   void RecordHandlingCompleted(scoped_refptr<Histogram> handler_run_time);
 
@@ -145,6 +153,8 @@ class InboundCall : public RpcCall {
 
   void QueueResponse(bool is_success);
 
+  void CaptureSampledTrace(const Histogram& handler_run_time);
+
   // The serialized bytes of the request param protobuf. Set by ParseFrom().
   // This references memory held by 'transfer_'.
   Slice serialized_request_;
@@ -155,6 +165,9 @@ class InboundCall : public RpcCall {
   // The trace buffer.
   scoped_refptr<Trace> trace_;
 
+  // Phase timestamps of a sampled call.
+  SampledTracePtr sampled_trace_;
+
   // Timing information related to this RPC call.
   InboundCallTiming timing_;
 
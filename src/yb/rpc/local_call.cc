@@ -33,7 +33,7 @@ LocalOutboundCall::LocalOutboundCall(
           std::move(callback)) {
 }
 
-Status LocalOutboundCall::SetRequestParam(const google::protobuf::Message& req) {
+Status LocalOutboundCall::SetRequestParam(const google::protobuf::Message& req, bool compress) {
   req_ = &req;
   return Status::OK();
 }
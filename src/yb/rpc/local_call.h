@@ -32,7 +32,7 @@ class LocalOutboundCall : public OutboundCall {
                     google::protobuf::Message* response_storage,
                     RpcController* controller, ResponseCallback callback);
 
-  CHECKED_STATUS SetRequestParam(const google::protobuf::Message& req) override;
+  CHECKED_STATUS SetRequestParam(const google::protobuf::Message& req, bool compress) override;
 
   const std::shared_ptr<LocalYBInboundCall>& CreateLocalInboundCall();
 
@@ -37,6 +37,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <list>
 #include <mutex>
 #include <set>
@@ -57,6 +58,7 @@
 #include "yb/rpc/connection.h"
 #include "yb/rpc/constants.h"
 #include "yb/rpc/rpc_header.pb.h"
+#include "yb/rpc/rpc_introspection.pb.h"
 #include "yb/rpc/rpc_service.h"
 #include "yb/rpc/yb_rpc.h"
 
@@ -81,6 +83,10 @@ DEFINE_int32(rpc_default_keepalive_time_ms, 65000,
              "will disconnect the client.");
 TAG_FLAG(rpc_default_keepalive_time_ms, advanced);
 DEFINE_uint64(io_thread_pool_size, 4, "Size of allocated IO Thread Pool.");
+DEFINE_int32(rpc_max_captured_slow_calls, 256,
+             "Number of the latest sampled slow inbound calls kept by the messenger to be shown "
+             "on /rpcz.");
+TAG_FLAG(rpc_max_captured_slow_calls, advanced);
 
 namespace yb {
 namespace rpc {
@@ -250,6 +256,24 @@ bool Messenger::IsArtificiallyDisconnectedFrom(const IpAddress& remote) {
   return false;
 }
 
+void Messenger::SetCompressionSupported(const Endpoint& remote, bool supported) {
+  // Called for each response, so the write lock is taken only when the state changes.
+  if (CompressionSupported(remote) == supported) {
+    return;
+  }
+  std::lock_guard<percpu_rwlock> guard(lock_);
+  if (supported) {
+    compression_supported_.insert(remote);
+  } else {
+    compression_supported_.erase(remote);
+  }
+}
+
+bool Messenger::CompressionSupported(const Endpoint& remote) const {
+  shared_lock<rw_spinlock> guard(lock_.get_lock());
+  return compression_supported_.count(remote) != 0;
+}
+
 void Messenger::ShutdownAcceptor() {
   std::unique_ptr<Acceptor> acceptor;
   {
@@ -363,7 +387,8 @@ Messenger::Messenger(const MessengerBuilder &bld)
     metric_entity_(bld.metric_entity_),
     retain_self_(this),
     io_thread_pool_(FLAGS_io_thread_pool_size),
-    scheduler_(&io_thread_pool_.io_service()) {
+    scheduler_(&io_thread_pool_.io_service()),
+    sampled_traces_(std::max(FLAGS_rpc_max_captured_slow_calls, 0)) {
   for (int i = 0; i < bld.num_reactors_; i++) {
     reactors_.push_back(new Reactor(retain_self_, i, bld));
   }
@@ -404,6 +429,18 @@ Status Messenger::DumpRunningRpcs(const DumpRunningRpcsRequestPB& req,
   for (Reactor* reactor : reactors_) {
     RETURN_NOT_OK(reactor->DumpRunningRpcs(req, resp));
   }
+  for (const auto& entry : sampled_traces_.Entries()) {
+    auto* call_pb = resp->add_slow_calls();
+    call_pb->set_method(entry.name);
+    call_pb->set_micros_elapsed(entry.elapsed.ToMicroseconds());
+    call_pb->set_threshold_micros(entry.threshold.ToMicroseconds());
+    for (const auto& phase_and_duration : entry.trace->PhaseDurations()) {
+      auto* phase_pb = call_pb->add_phases();
+      // Strip the 'k' prefix of the enum value name.
+      phase_pb->set_phase(ToString(phase_and_duration.first).substr(1));
+      phase_pb->set_micros(phase_and_duration.second.ToMicroseconds());
+    }
+  }
   return Status::OK();
 }
 
@@ -58,6 +58,7 @@
 #include "yb/util/metrics.h"
 #include "yb/util/monotime.h"
 #include "yb/util/net/sockaddr.h"
+#include "yb/util/sampled_trace.h"
 #include "yb/util/status.h"
 
 namespace yb {
@@ -180,7 +181,7 @@ class Messenger {
 
   CHECKED_STATUS QueueEventOnAllReactors(ServerEventListPtr server_event);
 
-  // Dump the current RPCs into the given protobuf.
+  // Dump the current RPCs and the captured slow calls into the given protobuf.
   CHECKED_STATUS DumpRunningRpcs(const DumpRunningRpcsRequestPB& req,
                          DumpRunningRpcsResponsePB* resp);
 
@@ -217,10 +218,22 @@ class Messenger {
   void BreakConnectivityWith(const IpAddress& address);
   void RestoreConnectivityWith(const IpAddress& address);
 
+  // Remembers whether the server at remote accepts compressed requests, as told by its last
+  // response.
+  void SetCompressionSupported(const Endpoint& remote, bool supported);
+
+  // Whether requests to the server at remote could be compressed.
+  bool CompressionSupported(const Endpoint& remote) const;
+
   Scheduler& scheduler() {
     return scheduler_;
   }
 
+  // Traces of the slowest sampled inbound calls.
+  SampledTraceRing* sampled_traces() {
+    return &sampled_traces_;
+  }
+
  private:
   FRIEND_TEST(TestRpc, TestConnectionKeepalive);
   friend class DelayedTask;
@@ -317,9 +330,14 @@ class Messenger {
   // Set of addresses with artificially broken connectivity.
   std::unordered_set<IpAddress, IpAddressHash> broken_connectivity_;
 
+  // Servers that accept compressed requests.
+  std::unordered_set<Endpoint, EndpointHash> compression_supported_;
+
   IoThreadPool io_thread_pool_;
   Scheduler scheduler_;
 
+  SampledTraceRing sampled_traces_;
+
   DISALLOW_COPY_AND_ASSIGN(Messenger);
 };
 
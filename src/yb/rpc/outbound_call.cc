@@ -50,6 +50,7 @@
 #include "yb/rpc/serialization.h"
 
 #include "yb/util/concurrent_value.h"
+#include "yb/util/faststring.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/kernel_stack_watchdog.h"
 #include "yb/util/memory/memory.h"
@@ -227,7 +228,7 @@ void OutboundCall::Serialize(std::deque<RefCntBuffer>* output) const {
   output->push_back(buffer_);
 }
 
-Status OutboundCall::SetRequestParam(const Message& message) {
+Status OutboundCall::SetRequestParam(const Message& message, bool compress) {
   using serialization::SerializeHeader;
   using serialization::SerializeMessage;
 
@@ -241,20 +242,47 @@ Status OutboundCall::SetRequestParam(const Message& message) {
   if (!status.ok()) {
     return status;
   }
-  size_t header_size = 0;
-
   RequestHeader header;
   InitHeader(&header);
-  status = SerializeHeader(header, message_size, &buffer_, message_size, &header_size);
+  status = SerializeHeader(header, message_size, &buffer_, message_size, &header_size_);
   remote_method_pool_->Release(header.release_remote_method());
   if (!status.ok()) {
     return status;
   }
-  return SerializeMessage(message,
-                          &buffer_,
-                          /* additional_size */ 0,
-                          /* use_cached_size */ true,
-                          header_size);
+  RETURN_NOT_OK(SerializeMessage(message,
+                                 &buffer_,
+                                 /* additional_size */ 0,
+                                 /* use_cached_size */ true,
+                                 header_size_));
+  if (compress) {
+    CompressRequest();
+  }
+  return Status::OK();
+}
+
+void OutboundCall::CompressRequest() {
+  const Slice body(buffer_.udata() + header_size_, buffer_.udata() + buffer_.size());
+  faststring compressed;
+  if (!serialization::Compress(body, &compressed)) {
+    return;
+  }
+
+  RequestHeader header;
+  InitHeader(&header);
+  header.set_uncompressed_size(body.size());
+  RefCntBuffer buffer;
+  size_t header_size = 0;
+  auto status = serialization::SerializeHeader(
+      header, compressed.size(), &buffer, compressed.size(), &header_size);
+  remote_method_pool_->Release(header.release_remote_method());
+  if (!status.ok()) {
+    LOG(DFATAL) << "Failed to serialize compressed request header: " << status;
+    return;
+  }
+  memcpy(buffer.udata() + header_size, compressed.data(), compressed.size());
+  buffer_ = std::move(buffer);
+  header_size_ = header_size;
+  request_compressed_ = true;
 }
 
 Status OutboundCall::status() const {
@@ -489,6 +517,9 @@ void OutboundCall::InitHeader(RequestHeader* header) {
     header->set_timeout_millis(timeout.ToMilliseconds());
   }
   header->set_allocated_remote_method(remote_method_pool_->Take());
+  if (serialization::CompressionEnabled()) {
+    header->set_compression_supported(true);
+  }
 }
 
 ///
@@ -553,7 +584,15 @@ Status CallResponse::ParseFrom(Slice source) {
 
   response_data_.assign(source.data(), source.end());
   source = Slice(response_data_.data(), response_data_.size());
-  RETURN_NOT_OK(serialization::ParseYBMessage(source, &header_, &entire_message));
+  Slice body;
+  RETURN_NOT_OK(serialization::ParseYBHeader(source, &header_, &body));
+  if (header_.has_uncompressed_size()) {
+    std::vector<uint8_t> decompressed(header_.uncompressed_size());
+    RETURN_NOT_OK(serialization::Decompress(body, decompressed.data(), decompressed.size()));
+    response_data_.swap(decompressed);
+    body = Slice(response_data_.data(), response_data_.size());
+  }
+  RETURN_NOT_OK(serialization::ParseYBBody(body, &entire_message));
 
   // Use information from header to extract the payload slices.
   const size_t sidecars = header_.sidecar_offsets_size();
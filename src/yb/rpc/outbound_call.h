@@ -147,6 +147,18 @@ class CallResponse {
     return header_.call_id();
   }
 
+  // Return true if the server accepts compressed requests.
+  bool compression_supported() const {
+    DCHECK(parsed_);
+    return header_.compression_supported();
+  }
+
+  // Return true if the response body, including sidecars, was sent compressed.
+  bool compressed() const {
+    DCHECK(parsed_);
+    return header_.has_uncompressed_size();
+  }
+
   // Return the serialized response data. This is just the response "body" --
   // either a serialized ErrorStatusPB, or the serialized user response protobuf.
   const Slice &serialized_response() const {
@@ -202,7 +214,10 @@ class OutboundCall : public RpcCall {
   //
   // Because the data is fully serialized by this call, 'req' may be
   // subsequently mutated with no ill effects.
-  virtual CHECKED_STATUS SetRequestParam(const google::protobuf::Message& req);
+  //
+  // If 'compress' is set, i.e. the server is known to accept compressed requests, a large enough
+  // request is compressed here, so the work is done by the caller rather than by the reactor.
+  virtual CHECKED_STATUS SetRequestParam(const google::protobuf::Message& req, bool compress);
 
   // Serialize the call for the wire. Requires that SetRequestParam()
   // is called first. This is called from the Reactor thread.
@@ -258,6 +273,15 @@ class OutboundCall : public RpcCall {
     return trace_.get();
   }
 
+  bool request_compressed() const {
+    return request_compressed_;
+  }
+
+  // Should only be called once the call is finished.
+  const CallResponse& call_response() const {
+    return call_response_;
+  }
+
  protected:
   friend class RpcController;
 
@@ -288,6 +312,9 @@ class OutboundCall : public RpcCall {
 
   virtual void NotifyTransferred(const Status& status, Connection* conn) override;
 
+  // Replaces the serialized request body with its compressed form, if it is large enough.
+  void CompressRequest();
+
   void set_state(State new_state);
   State state() const;
 
@@ -325,6 +352,12 @@ class OutboundCall : public RpcCall {
   // Buffers for storing segments of the wire-format request.
   RefCntBuffer buffer_;
 
+  // Size of the request header in buffer_, including the total length prefix.
+  size_t header_size_ = 0;
+
+  // Whether buffer_ holds the compressed request.
+  bool request_compressed_ = false;
+
   // Once a response has been received for this call, contains that response.
   CallResponse call_response_;
 
@@ -109,7 +109,8 @@ void Proxy::AsyncRequest(const RemoteMethod* method,
                                      controller,
                                      std::move(callback));
   auto call = controller->call_.get();
-  Status s = call->SetRequestParam(req);
+  Status s = call->SetRequestParam(
+      req, !call_local_service_ && messenger_->CompressionSupported(conn_ids_[idx].remote()));
   if (PREDICT_FALSE(!s.ok())) {
     // Failed to serialize request: likely the request is missing a required
     // field.
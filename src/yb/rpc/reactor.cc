@@ -52,6 +52,7 @@
 #include "yb/gutil/ref_counted.h"
 #include "yb/gutil/stringprintf.h"
 #include "yb/rpc/connection.h"
+#include "yb/rpc/growable_buffer.h"
 #include "yb/rpc/messenger.h"
 #include "yb/rpc/rpc_controller.h"
 #include "yb/rpc/rpc_introspection.pb.h"
@@ -72,6 +73,19 @@
 using std::string;
 using std::shared_ptr;
 
+DEFINE_int32(rpc_max_inline_calls_per_reactor_iteration, 64,
+             "Maximum number of inline-safe inbound calls handled right on a reactor thread per "
+             "event loop iteration. The calls above it are queued to the service thread pool. "
+             "0 disables handling calls on reactor threads.");
+TAG_FLAG(rpc_max_inline_calls_per_reactor_iteration, advanced);
+TAG_FLAG(rpc_max_inline_calls_per_reactor_iteration, runtime);
+
+DEFINE_int32(rpc_max_cached_read_buffers_per_reactor, 1024,
+             "Maximum number of initial size receive buffers kept by a reactor for reuse after "
+             "its connections become idle.");
+TAG_FLAG(rpc_max_cached_read_buffers_per_reactor, advanced);
+
+DECLARE_uint64(rpc_initial_buffer_size);
 DECLARE_string(local_ip_for_outbound_sockets);
 DECLARE_int32(num_connections_to_server);
 
@@ -113,7 +127,9 @@ Reactor::Reactor(const shared_ptr<Messenger>& messenger,
     cur_time_(CoarseMonoClock::Now()),
     last_unused_tcp_scan_(cur_time_),
     connection_keepalive_time_(bld.connection_keepalive_time()),
-    coarse_timer_granularity_(bld.coarse_timer_granularity()) {
+    coarse_timer_granularity_(bld.coarse_timer_granularity()),
+    read_buffer_allocator_(std::make_shared<GrowableBufferAllocator>(
+        FLAGS_rpc_initial_buffer_size, FLAGS_rpc_max_cached_read_buffers_per_reactor)) {
   static std::once_flag libev_once;
   std::call_once(libev_once, DoInitLibEv);
 
@@ -262,6 +278,21 @@ void Reactor::CleanWaitingConnections() {
   waiting_conns_.remove_if([](const ConnectionPtr& conn) { return conn->context().Idle(); });
 }
 
+bool Reactor::TryStartInlineCall() {
+  DCHECK(IsCurrentThread());
+
+  const auto iteration = loop_.iteration();
+  if (iteration != inline_calls_iteration_) {
+    inline_calls_iteration_ = iteration;
+    inline_calls_ = 0;
+  }
+  if (inline_calls_ >= FLAGS_rpc_max_inline_calls_per_reactor_iteration) {
+    return false;
+  }
+  ++inline_calls_;
+  return true;
+}
+
 void Reactor::CheckReadyToStop() {
   DCHECK(IsCurrentThread());
 
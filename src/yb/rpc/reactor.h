@@ -70,6 +70,7 @@ typedef std::list<ConnectionPtr> ConnectionList;
 
 class DumpRunningRpcsRequestPB;
 class DumpRunningRpcsResponsePB;
+class GrowableBufferAllocator;
 class Messenger;
 class MessengerBuilder;
 class Reactor;
@@ -248,6 +249,16 @@ class Reactor {
 
   CoarseMonoClock::TimePoint cur_time() const { return cur_time_; }
 
+  // Allocator of the receive buffers of this reactor's connections.
+  const std::shared_ptr<GrowableBufferAllocator>& read_buffer_allocator() const {
+    return read_buffer_allocator_;
+  }
+
+  // Returns true if an inline-safe inbound call could be handled right on this reactor thread,
+  // i.e. the budget of such calls per event loop iteration is not exhausted yet, so that they
+  // could not starve the other connections. Should be called from the reactor thread.
+  bool TryStartInlineCall();
+
   // Drop all connections with remote address. Used in tests with broken connectivity.
   void DropWithRemoteAddress(const IpAddress& address);
 
@@ -413,6 +424,12 @@ class Reactor {
   std::vector<OutboundCallPtr> processing_outbound_queue_;
   std::vector<ConnectionPtr> processing_connections_;
   std::shared_ptr<ReactorTask> process_outbound_queue_task_;
+
+  // Event loop iteration and the number of calls handled inline in it, see TryStartInlineCall.
+  unsigned int inline_calls_iteration_ = 0;
+  int inline_calls_ = 0;
+
+  std::shared_ptr<GrowableBufferAllocator> read_buffer_allocator_;
 };
 
 }  // namespace rpc
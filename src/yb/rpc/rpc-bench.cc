@@ -38,10 +38,13 @@
 #include "yb/rpc/rpc-test-base.h"
 #include "yb/rpc/rtest.proxy.h"
 #include "yb/util/countdown_latch.h"
+#include "yb/util/format.h"
 #include "yb/util/test_util.h"
 
 using namespace std::literals; // NOLINT
 
+DECLARE_bool(enable_rpc_compression);
+
 using std::string;
 using std::shared_ptr;
 
@@ -56,6 +59,10 @@ class RpcBench : public RpcTestBase {
  protected:
   friend class ClientThread;
 
+  // Runs client threads making calls for 10 seconds. If echo_size is not zero, the calls are echo
+  // calls of compressible data of that size, otherwise they are add calls.
+  void RunBenchmark(size_t echo_size);
+
   Endpoint server_endpoint_;
   shared_ptr<Messenger> client_messenger_;
   std::atomic<bool> should_run_{true};
@@ -63,8 +70,9 @@ class RpcBench : public RpcTestBase {
 
 class ClientThread {
  public:
-  explicit ClientThread(RpcBench *bench)
+  ClientThread(RpcBench *bench, size_t echo_size)
     : bench_(bench),
+      echo_size_(echo_size),
       request_count_(0) {
   }
 
@@ -81,6 +89,11 @@ class ClientThread {
 
     rpc_test::CalculatorServiceProxy p(client_messenger, bench_->server_endpoint_);
 
+    if (echo_size_ != 0) {
+      RunEcho(&p);
+      return;
+    }
+
     rpc_test::AddRequestPB req;
     rpc_test::AddResponsePB resp;
     while (bench_->should_run_.load(std::memory_order_acquire)) {
@@ -94,14 +107,31 @@ class ClientThread {
     }
   }
 
+  void RunEcho(rpc_test::CalculatorServiceProxy* p) {
+    rpc_test::EchoRequestPB req;
+    rpc_test::EchoResponsePB resp;
+    std::string* data = req.mutable_data();
+    while (data->size() < echo_size_) {
+      *data += Format("row $0 of the echoed data, ", data->size() % 997);
+    }
+    data->resize(echo_size_);
+    while (bench_->should_run_.load(std::memory_order_acquire)) {
+      RpcController controller;
+      controller.set_timeout(MonoDelta::FromSeconds(10));
+      CHECK_OK(p->Echo(req, &resp, &controller));
+      CHECK_EQ(req.data().size(), resp.data().size());
+      request_count_++;
+    }
+  }
+
   std::unique_ptr<std::thread> thread_;
   RpcBench *bench_;
+  size_t echo_size_;
   int request_count_;
 };
 
 
-// Test making successful RPC calls.
-TEST_F(RpcBench, BenchmarkCalls) {
+void RpcBench::RunBenchmark(size_t echo_size) {
   TestServerOptions options;
   options.n_worker_threads = 1;
 
@@ -124,7 +154,7 @@ TEST_F(RpcBench, BenchmarkCalls) {
   constexpr int kNumThreads = 16;
 #endif
   for (int i = 0; i < kNumThreads; i++) {
-    auto thr = std::make_unique<ClientThread>(this);
+    auto thr = std::make_unique<ClientThread>(this, echo_size);
     thr->Start();
     threads.push_back(std::move(thr));
   }
@@ -149,6 +179,22 @@ TEST_F(RpcBench, BenchmarkCalls) {
   LOG(INFO) << "Sys CPU per req:  " << sys_cpu_micros_per_req << "us";
 }
 
+// Test making successful RPC calls.
+TEST_F(RpcBench, BenchmarkCalls) {
+  RunBenchmark(0);
+}
+
+// Compare large calls with and without compression of the messages.
+TEST_F(RpcBench, BenchmarkLargeCalls) {
+  FLAGS_enable_rpc_compression = false;
+  RunBenchmark(256 * 1024);
+}
+
+TEST_F(RpcBench, BenchmarkCompressedLargeCalls) {
+  FLAGS_enable_rpc_compression = true;
+  RunBenchmark(256 * 1024);
+}
+
 } // namespace rpc
 } // namespace yb
 
@@ -91,6 +91,12 @@ constexpr std::chrono::milliseconds kDefaultKeepAlive = 1s;
 const MessengerOptions kDefaultClientMessengerOptions = {1, kDefaultKeepAlive};
 const MessengerOptions kDefaultServerMessengerOptions = {3, kDefaultKeepAlive};
 
+void FillCompressible(uint8_t* data, size_t size) {
+  for (size_t i = 0; i != size; ++i) {
+    data[i] = 'a' + i % 26;
+  }
+}
+
 const char* GenericCalculatorService::kFullServiceName = "yb.rpc.GenericCalculatorService";
 const char* GenericCalculatorService::kAddMethodName = "Add";
 const char* GenericCalculatorService::kSleepMethodName = "Sleep";
@@ -138,7 +144,11 @@ void GenericCalculatorService::DoSendStrings(InboundCall* incoming) {
   SendStringsResponsePB resp;
   for (auto size : req.sizes()) {
     auto sidecar = RefCntBuffer(size);
-    RandomString(sidecar.udata(), size, &r);
+    if (req.compressible()) {
+      FillCompressible(sidecar.udata(), size);
+    } else {
+      RandomString(sidecar.udata(), size, &r);
+    }
     int idx = 0;
     auto status = down_cast<YBInboundCall*>(incoming)->AddRpcSidecar(sidecar, &idx);
     if (!status.ok()) {
@@ -244,6 +254,10 @@ class CalculatorService: public CalculatorServiceIf {
     context.RespondSuccess();
   }
 
+  bool IsInlineSafe(const std::string& method_name) const override {
+    return method_name == "Ping";
+  }
+
   void Disconnect(
       const DisconnectRequestPB* peq, DisconnectResponsePB* resp, RpcContext context) override {
     context.CloseConnection();
@@ -62,6 +62,9 @@ namespace yb { namespace rpc {
 std::unique_ptr<ServiceIf> CreateCalculatorService(
   const scoped_refptr<MetricEntity>& metric_entity, std::string name = std::string());
 
+// Fills the buffer with a repeated byte sequence, as SendStrings does for compressible sidecars.
+void FillCompressible(uint8_t* data, size_t size);
+
 // Implementation of CalculatorService which just implements the generic
 // RPC handler (no generated code).
 class GenericCalculatorService : public ServiceIf {
@@ -336,6 +336,88 @@ TEST_F(TestRpc, TestRpcSidecar) {
   DoTestSidecar(p, sizes, Status::kRemoteError);
 }
 
+// Test that large messages are compressed, and pass through compressed intact.
+TEST_F(TestRpc, TestCompression) {
+  std::string data;
+  for (int i = 0; data.size() < 1024 * 1024; ++i) {
+    data += Format("compressible data $0, ", i % 1000);
+  }
+
+  faststring compressed;
+  ASSERT_TRUE(serialization::Compress(data, &compressed));
+  ASSERT_LT(compressed.size(), data.size() / 2);
+  std::string decompressed(data.size(), 0);
+  ASSERT_OK(serialization::Decompress(
+      Slice(compressed.data(), compressed.size()), pointer_cast<uint8_t*>(&decompressed[0]),
+      decompressed.size()));
+  ASSERT_EQ(data, decompressed);
+  ASSERT_FALSE(serialization::Compress(Slice(data.data(), 100), &compressed));
+
+  // Set up server.
+  Endpoint server_addr;
+  StartTestServerWithGeneratedCode(&server_addr);
+
+  // Set up client.
+  shared_ptr<Messenger> client_messenger(CreateMessenger("Client"));
+  Proxy p(client_messenger, server_addr, rpc_test::CalculatorServiceIf::static_service_name());
+  RemoteMethod method(rpc_test::CalculatorServiceIf::static_service_name(), "Echo");
+
+  // The first response tells the client that the server accepts compressed requests, so only the
+  // later requests are compressed. The responses are compressed since the first call, because
+  // each request tells that the client accepts compressed responses.
+  for (int i = 0; i != 3; ++i) {
+    rpc_test::EchoRequestPB req;
+    req.set_data(data);
+    rpc_test::EchoResponsePB resp;
+    RpcController controller;
+    controller.set_timeout(MonoDelta::FromSeconds(10));
+    ASSERT_OK(p.SyncRequest(&method, req, &resp, &controller));
+    ASSERT_EQ(data, resp.data());
+    ASSERT_EQ(i != 0, controller.call_->request_compressed()) << "Call " << i;
+    ASSERT_TRUE(controller.call_->call_response().compressed()) << "Call " << i;
+  }
+
+  // Small messages are sent as is.
+  {
+    rpc_test::EchoRequestPB req;
+    req.set_data("small");
+    rpc_test::EchoResponsePB resp;
+    RpcController controller;
+    controller.set_timeout(MonoDelta::FromSeconds(10));
+    ASSERT_OK(p.SyncRequest(&method, req, &resp, &controller));
+    ASSERT_EQ("small", resp.data());
+    ASSERT_FALSE(controller.call_->request_compressed());
+    ASSERT_FALSE(controller.call_->call_response().compressed());
+  }
+
+  // Sidecars are compressed together with the response body, and are restored by the client.
+  Endpoint generic_server_addr;
+  StartTestServer(&generic_server_addr);
+  Proxy generic_proxy(
+      client_messenger, generic_server_addr, GenericCalculatorService::static_service_name());
+  const std::vector<size_t> kSizes = {100 * 1024, 1, 2 * 1024 * 1024};
+  rpc_test::SendStringsRequestPB req;
+  for (auto size : kSizes) {
+    req.add_sizes(size);
+  }
+  req.set_compressible(true);
+  rpc_test::SendStringsResponsePB resp;
+  RpcController controller;
+  controller.set_timeout(MonoDelta::FromSeconds(10));
+  ASSERT_OK(generic_proxy.SyncRequest(
+      GenericCalculatorService::SendStringsMethod(), req, &resp, &controller));
+  ASSERT_TRUE(controller.call_->call_response().compressed());
+  ASSERT_EQ(kSizes.size(), resp.sidecars_size());
+  std::string expected;
+  for (size_t i = 0; i != kSizes.size(); ++i) {
+    Slice sidecar;
+    ASSERT_OK(controller.GetSidecar(resp.sidecars(i), &sidecar));
+    expected.resize(kSizes[i]);
+    FillCompressible(pointer_cast<uint8_t*>(&expected[0]), expected.size());
+    ASSERT_EQ(expected, sidecar.ToBuffer()) << "Sidecar " << i;
+  }
+}
+
 // Test that timeouts are properly handled.
 TEST_F(TestRpc, TestCallTimeout) {
   Endpoint server_addr;
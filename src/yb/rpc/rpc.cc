@@ -76,14 +76,23 @@ bool RpcRetrier::HandleResponse(RpcCommand* rpc, Status* out_status) {
 }
 
 void RpcRetrier::DelayedRetry(RpcCommand* rpc, const Status& why_status) {
-  if (!why_status.ok() && (last_error_.ok() || last_error_.IsTimedOut())) {
-    last_error_ = why_status;
-  }
   // Add some jitter to the retry delay.
   //
   // If the delay causes us to miss our deadline, RetryCb will fail the
   // RPC on our behalf.
   int num_ms = ++attempt_num_ + RandomUniformInt(0, 4);
+  ScheduleRetry(rpc, why_status, MonoDelta::FromMilliseconds(num_ms));
+}
+
+void RpcRetrier::ImmediateRetry(RpcCommand* rpc, const Status& why_status) {
+  ++attempt_num_;
+  ScheduleRetry(rpc, why_status, MonoDelta::kZero);
+}
+
+void RpcRetrier::ScheduleRetry(RpcCommand* rpc, const Status& why_status, MonoDelta delay) {
+  if (!why_status.ok() && (last_error_.ok() || last_error_.IsTimedOut())) {
+    last_error_ = why_status;
+  }
 
   RpcRetrierState expected_state = RpcRetrierState::kIdle;
   while (!state_.compare_exchange_strong(expected_state, RpcRetrierState::kWaiting)) {
@@ -97,7 +106,7 @@ void RpcRetrier::DelayedRetry(RpcCommand* rpc, const Status& why_status) {
     }
   }
   task_id_ = messenger_->ScheduleOnReactor(
-      std::bind(&RpcRetrier::DoRetry, this, rpc, _1), MonoDelta::FromMilliseconds(num_ms));
+      std::bind(&RpcRetrier::DoRetry, this, rpc, _1), delay);
 }
 
 void RpcRetrier::DoRetry(RpcCommand* rpc, const Status& status) {
@@ -115,6 +115,10 @@ class RpcRetrier {
   // Callers should ensure that 'rpc' remains alive.
   void DelayedRetry(RpcCommand* rpc, const Status& why_status);
 
+  // Same as DelayedRetry, but retries the RPC without a backoff delay. Used when the RPC is sent to
+  // another server and there is no reason to wait before it.
+  void ImmediateRetry(RpcCommand* rpc, const Status& why_status);
+
   RpcController* mutable_controller() { return &controller_; }
   const RpcController& controller() const { return controller_; }
 
@@ -129,6 +133,9 @@ class RpcRetrier {
   void Abort();
 
  private:
+  // Schedules the retry of an RPC after the given delay.
+  void ScheduleRetry(RpcCommand* rpc, const Status& why_status, MonoDelta delay);
+
   // Called when an RPC comes up for retrying. Actually sends the RPC.
   void DoRetry(RpcCommand* rpc, const Status& status);
 
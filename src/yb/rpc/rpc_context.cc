@@ -191,6 +191,10 @@ Trace* RpcContext::trace() {
   return call_->trace();
 }
 
+SampledTrace* RpcContext::sampled_trace() {
+  return call_->sampled_trace();
+}
+
 void RpcContext::Panic(const char* filepath, int line_number, const string& message) {
   // Use the LogMessage class directly so that the log messages appear to come from
   // the line of code which caused the panic, not this code.
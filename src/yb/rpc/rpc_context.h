@@ -49,6 +49,7 @@ class Message;
 
 namespace yb {
 
+class SampledTrace;
 class Trace;
 
 namespace util {
@@ -94,6 +95,9 @@ class RpcContext {
   // Return the trace buffer for this call.
   Trace* trace();
 
+  // Return the compact trace of the call phases, null if this call is not sampled.
+  SampledTrace* sampled_trace();
+
   // Send a response to the call. The service may call this method
   // before or after returning from the original handler method,
   // and it may call this method from a different thread.
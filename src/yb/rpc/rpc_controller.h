@@ -35,6 +35,7 @@
 #include <memory>
 
 #include <glog/logging.h>
+#include <gtest/gtest_prod.h>
 
 #include "yb/gutil/macros.h"
 #include "yb/rpc/rpc_fwd.h"
@@ -134,6 +135,7 @@ class RpcController {
   CHECKED_STATUS GetSidecar(int idx, Slice* sidecar) const;
 
  private:
+  FRIEND_TEST(TestRpc, TestCompression);
   friend class OutboundCall;
   friend class Proxy;
 
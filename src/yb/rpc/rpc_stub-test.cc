@@ -52,7 +52,9 @@
 
 DEFINE_bool(is_panic_test_child, false, "Used by TestRpcPanic");
 DECLARE_bool(socket_inject_short_recvs);
+DECLARE_bool(socket_inject_short_writes);
 DECLARE_int32(rpc_slow_query_threshold_ms);
+DECLARE_int32(rpc_trace_sampling_interval);
 
 using namespace std::chrono_literals;
 
@@ -147,6 +149,38 @@ TEST_F(RpcStubTest, TestShortRecvs) {
   }
 }
 
+// Sends many calls at once, so they are written with more iovecs than a single writev accepts,
+// while recv() and writev() transfer random prefixes of the requested data. Checks that partial
+// writes resume at the right position, and that a short recv() does not lose the rest of the data.
+TEST_F(RpcStubTest, TestShortRecvsAndWrites) {
+  google::FlagSaver saver;
+  FLAGS_socket_inject_short_recvs = true;
+  FLAGS_socket_inject_short_writes = true;
+
+  constexpr int kNumCalls = 500;
+
+  CalculatorServiceProxy p(client_messenger_, server_endpoint_);
+
+  vector<EchoRequestPB> reqs(kNumCalls);
+  vector<EchoResponsePB> resps(kNumCalls);
+  vector<RpcController> controllers(kNumCalls);
+  CountDownLatch latch(kNumCalls);
+  Random rng(GetRandomSeed32());
+  for (int i = 0; i != kNumCalls; ++i) {
+    // Mostly small calls, with a large one from time to time.
+    int size = i % 50 == 0 ? 256 * 1024 : 1 + i % 100;
+    reqs[i].set_data(RandomHumanReadableString(size, &rng));
+    controllers[i].set_timeout(MonoDelta::FromSeconds(30));
+    p.EchoAsync(reqs[i], &resps[i], &controllers[i], [&latch]() { latch.CountDown(); });
+  }
+  latch.Wait();
+
+  for (int i = 0; i != kNumCalls; ++i) {
+    ASSERT_OK(controllers[i].status()) << "Call " << i;
+    ASSERT_EQ(reqs[i].data(), resps[i].data()) << "Call " << i;
+  }
+}
+
 void CheckForward(CalculatorServiceProxy* proxy,
                   const Endpoint& endpoint,
                   const std::string& expected) {
@@ -455,6 +489,36 @@ TEST_F(RpcStubTest, TestDontHandleTimedOutCalls) {
   ASSERT_EQ(1, timed_out_in_queue->value());
 }
 
+// Inline-safe calls are handled on the reactor thread, so they don't wait for busy workers.
+TEST_F(RpcStubTest, TestInlineCallsBypassBusyWorkers) {
+  CalculatorServiceProxy p(client_messenger_, server_endpoint_);
+  vector<AsyncSleep*> sleeps;
+  ElementDeleter d(&sleeps);
+
+  // Queue enough sleep calls to keep the worker threads busy for a couple of seconds.
+  const size_t kNumSleeps = 20;
+  CountDownLatch latch(kNumSleeps);
+  for (size_t i = 0; i < kNumSleeps; i++) {
+    gscoped_ptr<AsyncSleep> sleep(new AsyncSleep);
+    sleep->rpc.set_timeout(MonoDelta::FromSeconds(30));
+    sleep->req.set_sleep_micros(300 * 1000);
+    p.SleepAsync(sleep->req, &sleep->resp, &sleep->rpc, [&latch]() { latch.CountDown(); });
+    sleeps.push_back(sleep.release());
+  }
+
+  RpcController rpc;
+  rpc.set_timeout(MonoDelta::FromMilliseconds(500));
+  PingRequestPB req;
+  PingResponsePB resp;
+  req.set_id(0);
+  ASSERT_OK(p.Ping(req, &resp, &rpc));
+
+  latch.Wait();
+  for (const auto* sleep : sleeps) {
+    ASSERT_OK(sleep->rpc.status());
+  }
+}
+
 TEST_F(RpcStubTest, TestDumpCallsInFlight) {
   CountDownLatch latch(1);
   CalculatorServiceProxy p(client_messenger_, server_endpoint_);
@@ -499,6 +563,39 @@ TEST_F(RpcStubTest, TestDumpCallsInFlight) {
   latch.Wait();
 }
 
+TEST_F(RpcStubTest, TestCaptureSlowCalls) {
+  google::FlagSaver saver;
+  FLAGS_rpc_trace_sampling_interval = 1;
+
+  CalculatorServiceProxy p(client_messenger_, server_endpoint_);
+  SleepRequestPB req;
+  SleepResponsePB resp;
+  // Fast calls establish the live percentile of the method latency.
+  for (int i = 0; i != 10; ++i) {
+    RpcController rpc;
+    req.set_sleep_micros(1000);
+    ASSERT_OK(p.Sleep(req, &resp, &rpc));
+  }
+  RpcController rpc;
+  req.set_sleep_micros(100 * 1000);
+  ASSERT_OK(p.Sleep(req, &resp, &rpc));
+
+  DumpRunningRpcsRequestPB dump_req;
+  DumpRunningRpcsResponsePB dump_resp;
+  ASSERT_OK(server_messenger().DumpRunningRpcs(dump_req, &dump_resp));
+  LOG(INFO) << "server messenger: " << dump_resp.DebugString();
+  ASSERT_GT(dump_resp.slow_calls_size(), 0);
+  const auto& slow_call = dump_resp.slow_calls(dump_resp.slow_calls_size() - 1);
+  ASSERT_STR_CONTAINS(slow_call.method(), "Sleep");
+  ASSERT_GE(slow_call.micros_elapsed(), 100 * 1000);
+  ASSERT_LT(slow_call.threshold_micros(), 100 * 1000);
+  // Service calls are queued and responded, they have no tablet phases.
+  ASSERT_EQ(2, slow_call.phases_size());
+  ASSERT_EQ("Queue", slow_call.phases(0).phase());
+  ASSERT_EQ("Respond", slow_call.phases(1).phase());
+  ASSERT_GE(slow_call.phases(1).micros(), 100 * 1000);
+}
+
 namespace {
 struct RefCountedTest : public RefCountedThreadSafe<RefCountedTest> {
 };
@@ -32,6 +32,8 @@
 
 #include "yb/rpc/serialization.h"
 
+#include <lz4.h>
+
 #include <google/protobuf/message_lite.h>
 #include <google/protobuf/io/coded_stream.h>
 #include <glog/logging.h>
@@ -40,12 +42,25 @@
 #include "yb/gutil/stringprintf.h"
 #include "yb/rpc/constants.h"
 #include "yb/util/faststring.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/ref_cnt_buffer.h"
 #include "yb/util/slice.h"
 #include "yb/util/status.h"
 
 DECLARE_int32(rpc_max_message_size);
 
+DEFINE_bool(enable_rpc_compression, true,
+            "Whether to compress the bodies of large RPC messages, including sidecars, with LZ4 "
+            "when sending to peers that support it, and to let peers compress the messages they "
+            "send to this process.");
+TAG_FLAG(enable_rpc_compression, advanced);
+TAG_FLAG(enable_rpc_compression, runtime);
+
+DEFINE_int32(rpc_compression_min_size, 16 * 1024,
+             "Minimum size of an RPC message body to compress it.");
+TAG_FLAG(rpc_compression_min_size, advanced);
+TAG_FLAG(rpc_compression_min_size, runtime);
+
 using google::protobuf::MessageLite;
 using google::protobuf::io::CodedInputStream;
 using google::protobuf::io::CodedOutputStream;
@@ -137,6 +152,14 @@ Status SerializeHeader(const MessageLite& header,
 Status ParseYBMessage(const Slice& buf,
                       MessageLite* parsed_header,
                       Slice* parsed_main_message) {
+  Slice body;
+  RETURN_NOT_OK(ParseYBHeader(buf, parsed_header, &body));
+  return ParseYBBody(body, parsed_main_message);
+}
+
+Status ParseYBHeader(const Slice& buf,
+                     MessageLite* parsed_header,
+                     Slice* body) {
   if (PREDICT_FALSE(buf.size() < kMsgLengthPrefixLength)) {
     return STATUS(Corruption, "Invalid packet: not enough bytes for length header",
                               buf.ToDebugString());
@@ -159,6 +182,14 @@ Status ParseYBMessage(const Slice& buf,
   }
   in.PopLimit(l);
 
+  *body = Slice(buf.data() + in.CurrentPosition(), buf.end());
+  return Status::OK();
+}
+
+Status ParseYBBody(const Slice& buf, Slice* parsed_main_message) {
+  CodedInputStream in(buf.data(), buf.size());
+  in.SetTotalBytesLimit(FLAGS_rpc_max_message_size, FLAGS_rpc_max_message_size*3/4);
+
   uint32_t main_msg_len;
   if (PREDICT_FALSE(!in.ReadVarint32(&main_msg_len))) {
     return STATUS(Corruption, "Invalid packet: missing main msg length",
@@ -182,6 +213,40 @@ Status ParseYBMessage(const Slice& buf,
   return Status::OK();
 }
 
+bool CompressionEnabled() {
+  return FLAGS_enable_rpc_compression;
+}
+
+bool Compress(const Slice& body, faststring* output) {
+  if (!FLAGS_enable_rpc_compression ||
+      body.size() < static_cast<size_t>(FLAGS_rpc_compression_min_size) ||
+      body.size() > LZ4_MAX_INPUT_SIZE) {
+    return false;
+  }
+  output->resize(LZ4_compressBound(body.size()));
+  const int size = LZ4_compress_default(
+      body.cdata(), reinterpret_cast<char*>(output->data()), body.size(), output->size());
+  if (size <= 0 || static_cast<size_t>(size) >= body.size()) {
+    return false;
+  }
+  output->resize(size);
+  return true;
+}
+
+Status Decompress(const Slice& input, uint8_t* output, size_t uncompressed_size) {
+  if (PREDICT_FALSE(uncompressed_size > static_cast<size_t>(FLAGS_rpc_max_message_size))) {
+    return STATUS_FORMAT(Corruption, "Invalid packet: uncompressed size $0 exceeds limit $1",
+                         uncompressed_size, FLAGS_rpc_max_message_size);
+  }
+  const int size = LZ4_decompress_safe(
+      input.cdata(), reinterpret_cast<char*>(output), input.size(), uncompressed_size);
+  if (PREDICT_FALSE(size < 0 || static_cast<size_t>(size) != uncompressed_size)) {
+    return STATUS_FORMAT(Corruption, "Invalid packet: failed to decompress $0 bytes to $1 bytes",
+                         input.size(), uncompressed_size);
+  }
+  return Status::OK();
+}
+
 }  // namespace serialization
 }  // namespace rpc
 }  // namespace yb
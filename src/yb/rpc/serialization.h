@@ -95,6 +95,32 @@ Status ParseYBMessage(const Slice& buf,
                       google::protobuf::MessageLite* parsed_header,
                       Slice* parsed_main_message);
 
+// Deserialize the header of the request or response.
+// In: data buffer Slice.
+// Out: parsed_header PB initialized,
+//      body pointing to the rest of the original buffer, which should be passed to ParseYBBody,
+//      after decompression if the header says that the body is compressed.
+Status ParseYBHeader(const Slice& buf,
+                     google::protobuf::MessageLite* parsed_header,
+                     Slice* body);
+
+// Deserialize the body of the request or response, i.e. the data following its header.
+// In: body Slice.
+// Out: parsed_main_message pointing to offset in body containing the main payload.
+Status ParseYBBody(const Slice& body, Slice* parsed_main_message);
+
+// Returns true if this process accepts compressed messages and compresses the messages it sends.
+bool CompressionEnabled();
+
+// Compresses the serialized body of a message, i.e. the data following its header, with LZ4 into
+// output. Returns false if the body should be sent uncompressed, because compression is disabled,
+// the body is too small, or it does not get smaller.
+bool Compress(const Slice& body, faststring* output);
+
+// Decompresses the LZ4 compressed body of a message into output, which should have
+// uncompressed_size bytes.
+Status Decompress(const Slice& input, uint8_t* output, size_t uncompressed_size);
+
 
 }  // namespace serialization
 }  // namespace rpc
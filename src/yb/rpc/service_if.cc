@@ -59,5 +59,13 @@ ServiceIf::~ServiceIf() {
 void ServiceIf::Shutdown() {
 }
 
+bool ServiceIf::IsInlineSafe(const std::string& method_name) const {
+  return false;
+}
+
+RpcPriority ServiceIf::MethodPriority(const std::string& method_name) const {
+  return RpcPriority::kNormal;
+}
+
 } // namespace rpc
 } // namespace yb
@@ -37,6 +37,7 @@
 #include "yb/gutil/macros.h"
 #include "yb/gutil/ref_counted.h"
 #include "yb/rpc/rpc_fwd.h"
+#include "yb/util/enums.h"
 #include "yb/util/metrics.h"
 #include "yb/util/net/sockaddr.h"
 
@@ -60,6 +61,10 @@ struct RpcMethodMetrics {
   scoped_refptr<Histogram> handler_latency;
 };
 
+// Priority classes of calls waiting in a service queue. Calls of a higher class are handled first,
+// and are dropped last when the queue is full.
+YB_DEFINE_ENUM(RpcPriority, (kHigh)(kNormal)(kLow));
+
 // Handles incoming messages that initiate an RPC.
 class ServiceIf {
  public:
@@ -68,6 +73,13 @@ class ServiceIf {
 
   virtual void Shutdown();
   virtual std::string service_name() const = 0;
+
+  // Returns true if the given method is cheap and never blocks, so that its calls could be
+  // handled on the reactor thread that received them, instead of being queued to a service thread.
+  virtual bool IsInlineSafe(const std::string& method_name) const;
+
+  // Returns the priority class of calls to the given method while they wait in the service queue.
+  virtual RpcPriority MethodPriority(const std::string& method_name) const;
 };
 
 }  // namespace rpc
@@ -0,0 +1,360 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/rpc/service_pool.h"
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "yb/gutil/strings/util.h"
+#include "yb/rpc/inbound_call.h"
+#include "yb/rpc/rpc_introspection.pb.h"
+#include "yb/rpc/service_if.h"
+#include "yb/rpc/thread_pool.h"
+#include "yb/util/countdown_latch.h"
+#include "yb/util/metrics.h"
+#include "yb/util/semaphore.h"
+#include "yb/util/test_util.h"
+
+using namespace std::literals;
+
+METRIC_DECLARE_entity(server);
+METRIC_DECLARE_histogram(rpc_incoming_queue_time);
+METRIC_DECLARE_histogram(rpc_incoming_queue_time_high_priority);
+METRIC_DECLARE_histogram(rpc_incoming_queue_time_low_priority);
+
+namespace yb {
+namespace rpc {
+
+namespace {
+
+const std::string kBlockMethod = "Block";
+
+// Call that is not attached to a connection, and records the failure it was responded with.
+class TestCall : public InboundCall {
+ public:
+  TestCall(std::string method_name, MonoTime deadline)
+      : InboundCall(nullptr /* conn */, nullptr /* call_processed_listener */),
+        method_name_(std::move(method_name)), deadline_(deadline) {}
+
+  const Endpoint& remote_address() const override {
+    static const Endpoint endpoint;
+    return endpoint;
+  }
+
+  const Endpoint& local_address() const override {
+    return remote_address();
+  }
+
+  MonoTime GetClientDeadline() const override { return deadline_; }
+
+  const std::string& method_name() const override { return method_name_; }
+
+  const std::string& service_name() const override {
+    static const std::string name = "TestService";
+    return name;
+  }
+
+  void RespondFailure(ErrorStatusPB::RpcErrorCodePB error_code, const Status& status) override {
+    error_code_ = error_code;
+    failed_ = true;
+  }
+
+  void Serialize(std::deque<RefCntBuffer>* output) const override {}
+
+  std::string ToString() const override { return method_name_; }
+
+  bool DumpPB(const DumpRunningRpcsRequestPB& req, RpcCallInProgressPB* resp) override {
+    return false;
+  }
+
+  bool failed() const { return failed_; }
+
+  ErrorStatusPB::RpcErrorCodePB error_code() const { return error_code_; }
+
+ private:
+  void LogTrace() const override {}
+
+  const std::string method_name_;
+  const MonoTime deadline_;
+  std::atomic<bool> failed_{false};
+  std::atomic<ErrorStatusPB::RpcErrorCodePB> error_code_{ErrorStatusPB::FATAL_UNKNOWN};
+};
+
+// Records the handled calls. The priority class of a method is given by its name prefix, and
+// the handler of kBlockMethod waits until the test releases it.
+class TestService : public ServiceIf {
+ public:
+  void Handle(InboundCallPtr call) override {
+    if (call->method_name() == kBlockMethod) {
+      blocked_.CountDown();
+      release_.Wait();
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    handled_.push_back(call->method_name());
+  }
+
+  std::string service_name() const override { return "TestService"; }
+
+  RpcPriority MethodPriority(const std::string& method_name) const override {
+    if (HasPrefixString(method_name, "High")) {
+      return RpcPriority::kHigh;
+    }
+    if (HasPrefixString(method_name, "Low")) {
+      return RpcPriority::kLow;
+    }
+    return RpcPriority::kNormal;
+  }
+
+  void WaitBlocked() { blocked_.Wait(); }
+
+  void Release() { release_.CountDown(); }
+
+  std::vector<std::string> handled() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return handled_;
+  }
+
+ private:
+  CountDownLatch blocked_{1};
+  CountDownLatch release_{1};
+  mutable std::mutex mutex_;
+  std::vector<std::string> handled_;
+};
+
+// Counts the handled calls, and releases the semaphore for each of them.
+class CountingService : public ServiceIf {
+ public:
+  explicit CountingService(Semaphore* semaphore) : semaphore_(semaphore) {}
+
+  void Handle(InboundCallPtr call) override {
+    ++handled_;
+    semaphore_->Release();
+  }
+
+  std::string service_name() const override { return "CountingService"; }
+
+  size_t handled() const { return handled_.load(); }
+
+ private:
+  Semaphore* const semaphore_;
+  std::atomic<size_t> handled_{0};
+};
+
+} // namespace
+
+class ServicePoolTest : public YBTest {
+ protected:
+  ServicePoolTest()
+      : metric_entity_(METRIC_ENTITY_server.Instantiate(&metric_registry_, "test.service_pool")) {
+  }
+
+  void TearDown() override {
+    if (service_) {
+      service_->Release();
+    }
+    if (thread_pool_) {
+      thread_pool_->Shutdown();
+    }
+    service_pool_.reset();
+    thread_pool_.reset();
+    YBTest::TearDown();
+  }
+
+  // Creates a pool with a single worker, that is occupied by a blocked call.
+  void StartBlockedPool(size_t max_tasks, size_t thread_pool_queue_limit) {
+    thread_pool_.reset(new ThreadPool("test", thread_pool_queue_limit, 1 /* max_workers */));
+    std::unique_ptr<TestService> service(new TestService);
+    service_ = service.get();
+    service_pool_.reset(new ServicePool(
+        max_tasks, thread_pool_.get(), std::move(service), metric_entity_));
+    service_pool_->QueueInboundCall(NewCall(kBlockMethod, MonoTime::Max()));
+    service_->WaitBlocked();
+  }
+
+  std::shared_ptr<TestCall> NewCall(const std::string& method_name, MonoTime deadline) {
+    return std::make_shared<TestCall>(method_name, deadline);
+  }
+
+  void Enqueue(const std::shared_ptr<TestCall>& call) {
+    service_pool_->QueueInboundCall(call);
+  }
+
+  // Releases the blocked call and waits until the expected calls are handled.
+  void ReleaseAndWaitHandled(const std::vector<std::string>& expected) {
+    service_->Release();
+    ASSERT_OK(WaitFor([this, &expected] { return service_->handled().size() >= expected.size(); },
+                      10s, "Handle calls"));
+    ASSERT_EQ(expected, service_->handled());
+  }
+
+  void CheckOverflow(const TestCall& call) {
+    ASSERT_TRUE(call.failed()) << call.ToString();
+    ASSERT_EQ(ErrorStatusPB::ERROR_SERVER_TOO_BUSY, call.error_code()) << call.ToString();
+  }
+
+  MetricRegistry metric_registry_;
+  scoped_refptr<MetricEntity> metric_entity_;
+  std::unique_ptr<ThreadPool> thread_pool_;
+  std::unique_ptr<ServicePool> service_pool_;
+  TestService* service_ = nullptr;
+};
+
+TEST_F(ServicePoolTest, FullQueueShedsLeastUrgentCall) {
+  StartBlockedPool(3 /* max_tasks */, 10 /* thread_pool_queue_limit */);
+
+  auto now = MonoTime::Now();
+  auto first = NewCall("First", now + 10s);
+  auto late = NewCall("Late", now + 20s);
+  Enqueue(first);
+  Enqueue(late);
+
+  // The queue is full, so the call with the latest deadline gives its place to a more urgent one.
+  auto early = NewCall("Early", now + 5s);
+  Enqueue(early);
+  CheckOverflow(*late);
+  ASSERT_FALSE(early->failed());
+
+  // A new call that is the least urgent one is dropped itself.
+  auto later = NewCall("Later", now + 30s);
+  Enqueue(later);
+  CheckOverflow(*later);
+
+  // A call of a higher class sheds the least urgent call of a lower class, despite its deadline.
+  auto high = NewCall("High", now + 60s);
+  Enqueue(high);
+  CheckOverflow(*first);
+  ASSERT_FALSE(high->failed());
+
+  // A call of a lower class is dropped when there are only calls of higher classes in the queue.
+  auto low = NewCall("Low", now + 1s);
+  Enqueue(low);
+  CheckOverflow(*low);
+
+  ASSERT_EQ(4, service_pool_->RpcsQueueOverflowMetric()->value());
+  ASSERT_NO_FATALS(ReleaseAndWaitHandled({kBlockMethod, "High", "Early"}));
+}
+
+TEST_F(ServicePoolTest, ThreadPoolOverflowDropsLeastUrgentCall) {
+  // There are enough tasks, but the thread pool queue has room for a single task only.
+  StartBlockedPool(4 /* max_tasks */, 1 /* thread_pool_queue_limit */);
+
+  auto now = MonoTime::Now();
+  auto late = NewCall("Late", now + 20s);
+  auto early = NewCall("Early", now + 10s);
+  Enqueue(late);
+  // The task of this call does not fit into the thread pool, so the least urgent queued call is
+  // dropped instead, and the task of the dropped call handles this one.
+  Enqueue(early);
+  CheckOverflow(*late);
+  ASSERT_FALSE(early->failed());
+
+  ASSERT_EQ(1, service_pool_->RpcsQueueOverflowMetric()->value());
+  ASSERT_NO_FATALS(ReleaseAndWaitHandled({kBlockMethod, "Early"}));
+}
+
+TEST_F(ServicePoolTest, RejectExpiredCall) {
+  StartBlockedPool(3 /* max_tasks */, 10 /* thread_pool_queue_limit */);
+
+  auto expired = NewCall("Expired", MonoTime::Now() - 1s);
+  Enqueue(expired);
+  ASSERT_TRUE(expired->failed());
+  ASSERT_EQ(ErrorStatusPB::ERROR_SERVER_TOO_BUSY, expired->error_code());
+  ASSERT_EQ(1, service_pool_->RpcsTimedOutInQueueMetricForTests()->value());
+  ASSERT_EQ(0, service_pool_->RpcsQueueOverflowMetric()->value());
+
+  // The expired call did not take queue space.
+  auto now = MonoTime::Now();
+  auto first = NewCall("First", now + 10s);
+  auto second = NewCall("Second", now + 20s);
+  Enqueue(first);
+  Enqueue(second);
+  ASSERT_FALSE(first->failed());
+  ASSERT_FALSE(second->failed());
+
+  ASSERT_NO_FATALS(ReleaseAndWaitHandled({kBlockMethod, "First", "Second"}));
+}
+
+// Keeps the service queue full while the tasks of the handled calls finish concurrently, and
+// checks that a call fitting into the queue is never rejected because of a lack of free tasks.
+TEST_F(ServicePoolTest, FullQueueDoesNotShed) {
+  constexpr int kMaxInHandler = 16;
+  constexpr size_t kNumWorkers = 4;
+  constexpr int kNumProducers = 8;
+  constexpr int kCallsPerProducer = 20000;
+
+  // A call releases the semaphore when it is handled, i.e. before its task is done. So at most
+  // kMaxInHandler calls are queued or being handled, plus a call per worker whose task is not
+  // done yet, and the queue could be filled exactly to its capacity.
+  Semaphore semaphore(kMaxInHandler);
+  const size_t max_tasks = kMaxInHandler + kNumWorkers;
+  thread_pool_.reset(new ThreadPool("test", max_tasks, kNumWorkers));
+  std::unique_ptr<CountingService> service(new CountingService(&semaphore));
+  auto* counting_service = service.get();
+  service_pool_.reset(new ServicePool(
+      max_tasks, thread_pool_.get(), std::move(service), metric_entity_));
+
+  // A shed call never releases the semaphore, so the producers stop when they run out of it.
+  std::atomic<bool> stuck{false};
+  std::vector<std::thread> producers;
+  for (int i = 0; i != kNumProducers; ++i) {
+    producers.emplace_back([this, &semaphore, &stuck] {
+      for (int j = 0; j != kCallsPerProducer && !stuck; ++j) {
+        if (!semaphore.TimedAcquire(MonoDelta::FromSeconds(10))) {
+          stuck = true;
+          break;
+        }
+        Enqueue(NewCall("Call", MonoTime::Max()));
+      }
+    });
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+
+  ASSERT_EQ(0, service_pool_->RpcsQueueOverflowMetric()->value());
+  ASSERT_FALSE(stuck);
+  const size_t total_calls = kNumProducers * kCallsPerProducer;
+  ASSERT_OK(WaitFor([counting_service, total_calls] {
+    return counting_service->handled() >= total_calls;
+  }, 30s, "Handle calls"));
+  ASSERT_EQ(total_calls, counting_service->handled());
+}
+
+TEST_F(ServicePoolTest, QueueTimePerClass) {
+  StartBlockedPool(5 /* max_tasks */, 10 /* thread_pool_queue_limit */);
+
+  auto deadline = MonoTime::Now() + 10s;
+  Enqueue(NewCall("Low", deadline));
+  Enqueue(NewCall("Normal", deadline));
+  Enqueue(NewCall("High1", deadline));
+  Enqueue(NewCall("High2", deadline));
+
+  // Higher classes are handled first.
+  ASSERT_NO_FATALS(ReleaseAndWaitHandled({kBlockMethod, "High1", "High2", "Normal", "Low"}));
+
+  ASSERT_EQ(2, METRIC_rpc_incoming_queue_time_high_priority.Instantiate(metric_entity_)
+                   ->TotalCount());
+  // Includes the blocked call.
+  ASSERT_EQ(2, METRIC_rpc_incoming_queue_time.Instantiate(metric_entity_)->TotalCount());
+  ASSERT_EQ(1, METRIC_rpc_incoming_queue_time_low_priority.Instantiate(metric_entity_)
+                   ->TotalCount());
+}
+
+} // namespace rpc
+} // namespace yb
@@ -32,7 +32,10 @@
 
 #include "yb/rpc/service_pool.h"
 
+#include <array>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -41,12 +44,15 @@
 #include "yb/gutil/gscoped_ptr.h"
 #include "yb/gutil/ref_counted.h"
 
+#include "yb/rpc/connection.h"
 #include "yb/rpc/inbound_call.h"
 #include "yb/rpc/messenger.h"
+#include "yb/rpc/reactor.h"
 #include "yb/rpc/service_if.h"
 #include "yb/rpc/tasks_pool.h"
 
 #include "yb/gutil/strings/substitute.h"
+#include "yb/util/continuous_profiler.h"
 #include "yb/util/metrics.h"
 #include "yb/util/status.h"
 #include "yb/util/thread.h"
@@ -59,7 +65,21 @@ METRIC_DEFINE_histogram(server, rpc_incoming_queue_time,
                         "RPC Queue Time",
                         yb::MetricUnit::kMicroseconds,
                         "Number of microseconds incoming RPC requests spend in the worker queue",
-                        60000000LU, 3);
+                        60000000LU, 3, yb::SHARDED_HISTOGRAM);
+
+METRIC_DEFINE_histogram(server, rpc_incoming_queue_time_high_priority,
+                        "RPC Queue Time of High Priority Calls",
+                        yb::MetricUnit::kMicroseconds,
+                        "Number of microseconds incoming high priority RPC requests spend in the "
+                        "worker queue",
+                        60000000LU, 3, yb::SHARDED_HISTOGRAM);
+
+METRIC_DEFINE_histogram(server, rpc_incoming_queue_time_low_priority,
+                        "RPC Queue Time of Low Priority Calls",
+                        yb::MetricUnit::kMicroseconds,
+                        "Number of microseconds incoming low priority RPC requests spend in the "
+                        "worker queue",
+                        60000000LU, 3, yb::SHARDED_HISTOGRAM);
 
 METRIC_DEFINE_counter(server, rpcs_timed_out_in_queue,
                       "RPC Queue Timeouts",
@@ -78,10 +98,11 @@ namespace rpc {
 
 namespace {
 
+// Handles the most urgent call queued to the pool when it is run. There is a task for each queued
+// call.
 class InboundCallTask final {
  public:
-  InboundCallTask(ServicePoolImpl* pool, InboundCallPtr call)
-      : pool_(pool), call_(std::move(call)) {
+  explicit InboundCallTask(ServicePoolImpl* pool) : pool_(pool) {
   }
 
   void Run();
@@ -89,7 +110,6 @@ class InboundCallTask final {
 
  private:
   ServicePoolImpl* pool_;
-  InboundCallPtr call_;
 };
 
 } // namespace
@@ -102,10 +122,14 @@ class ServicePoolImpl {
        const scoped_refptr<MetricEntity>& entity)
       : thread_pool_(thread_pool),
         service_(std::move(service)),
-        incoming_queue_time_(METRIC_rpc_incoming_queue_time.Instantiate(entity)),
+        incoming_queue_time_{{
+            METRIC_rpc_incoming_queue_time_high_priority.Instantiate(entity),
+            METRIC_rpc_incoming_queue_time.Instantiate(entity),
+            METRIC_rpc_incoming_queue_time_low_priority.Instantiate(entity)}},
         rpcs_timed_out_in_queue_(METRIC_rpcs_timed_out_in_queue.Instantiate(entity)),
         rpcs_queue_overflow_(METRIC_rpcs_queue_overflow.Instantiate(entity)),
         tasks_pool_(max_tasks) {
+    static_assert(kRpcPriorityMapSize == 3, "Queue time metric should be defined for each class");
   }
 
   ~ServicePoolImpl() {
@@ -120,10 +144,51 @@ class ServicePoolImpl {
   }
 
   void Enqueue(InboundCallPtr call) {
+    if (service_->IsInlineSafe(call->method_name()) && CanHandleInline(*call)) {
+      TRACE_TO(call->trace(), "Handling call on reactor thread");
+      Handle(std::move(call));
+      return;
+    }
+
+    // Don't waste the queue space on a call that could not be answered in time.
+    if (PREDICT_FALSE(call->ClientTimedOut())) {
+      TimedOutInQueue(call);
+      return;
+    }
+
     TRACE_TO(call->trace(), "Inserting onto call queue");
 
-    if (!tasks_pool_.Enqueue(thread_pool_, this, std::move(call))) {
-      Overflow(call, "service", tasks_pool_.size());
+    const auto priority = service_->MethodPriority(call->method_name());
+    const auto deadline = call->GetClientDeadline();
+    InboundCallPtr shed_call;
+    {
+      std::lock_guard<std::mutex> lock(queue_mutex_);
+      if (num_calls_ < tasks_pool_.size()) {
+        ++num_calls_;
+      } else {
+        shed_call = ShedUnlocked(priority, deadline);
+        if (!shed_call) {
+          shed_call = call;
+        }
+      }
+      if (shed_call != call) {
+        queues_[util::to_underlying(priority)].emplace(deadline, call);
+      }
+    }
+
+    if (shed_call) {
+      Overflow(shed_call, "service", tasks_pool_.size());
+      // Either the new call was dropped, or it took the place of the shed call in the queue, and
+      // the task of the shed call handles it.
+      return;
+    }
+
+    const bool enqueued = priority == RpcPriority::kHigh
+        ? tasks_pool_.EnqueueHighPriority(thread_pool_, this)
+        : tasks_pool_.Enqueue(thread_pool_, this);
+    if (!enqueued) {
+      // All tasks could still be held by the calls that just left the queue.
+      TaskDone(STATUS(ServiceUnavailable, "No free tasks"));
     }
   }
 
@@ -170,45 +235,135 @@ class ServicePoolImpl {
   }
 
   void Handle(InboundCallPtr incoming) {
-    incoming->RecordHandlingStarted(incoming_queue_time_);
+    const auto priority = service_->MethodPriority(incoming->method_name());
+    incoming->RecordHandlingStarted(incoming_queue_time_[util::to_underlying(priority)]);
     ADOPT_TRACE(incoming->trace());
 
     if (PREDICT_FALSE(incoming->ClientTimedOut())) {
-      TRACE_TO(incoming->trace(), "Skipping call since client already timed out");
-      rpcs_timed_out_in_queue_->Increment();
-
-      // Respond as a failure, even though the client will probably ignore
-      // the response anyway.
-      incoming->RespondFailure(
-          ErrorStatusPB::ERROR_SERVER_TOO_BUSY,
-          STATUS(TimedOut, "Call waited in the queue past client deadline"));
-
+      TimedOutInQueue(incoming);
       return;
     }
 
     TRACE_TO(incoming->trace(), "Handling call");
 
+    // Keep the call alive while its method name is referenced by the profiling tag.
+    const InboundCallPtr call = incoming;
+    ScopedProfilingTag method_tag(ProfilingTag::kMethod, call->method_name());
     service_->Handle(std::move(incoming));
   }
 
+  // Handles the most urgent queued call, i.e. the one with the earliest deadline in the highest
+  // priority class.
+  void HandleNext() {
+    InboundCallPtr call;
+    {
+      std::lock_guard<std::mutex> lock(queue_mutex_);
+      for (auto& queue : queues_) {
+        if (!queue.empty()) {
+          call = std::move(queue.begin()->second);
+          queue.erase(queue.begin());
+          break;
+        }
+      }
+    }
+    if (call) {
+      Handle(std::move(call));
+    }
+  }
+
+  // Invoked when a task is done. If the task failed, the least urgent queued call is dropped
+  // instead of it.
+  void TaskDone(const Status& status) {
+    InboundCallPtr call;
+    {
+      std::lock_guard<std::mutex> lock(queue_mutex_);
+      --num_calls_;
+      if (!status.ok()) {
+        call = PopLeastUrgentUnlocked();
+      }
+    }
+    if (call) {
+      Processed(call, status);
+    }
+  }
+
  private:
+  // Returns true if the call was received by the current reactor thread, which could handle it.
+  static bool CanHandleInline(const InboundCall& call) {
+    auto connection = call.connection();
+    if (!connection) {
+      return false;
+    }
+    auto* reactor = connection->reactor();
+    return reactor->IsCurrentThread() && reactor->TryStartInlineCall();
+  }
+
+  void TimedOutInQueue(const InboundCallPtr& call) {
+    TRACE_TO(call->trace(), "Skipping call since client already timed out");
+    rpcs_timed_out_in_queue_->Increment();
+
+    // Respond as a failure, even though the client will probably ignore
+    // the response anyway.
+    call->RespondFailure(
+        ErrorStatusPB::ERROR_SERVER_TOO_BUSY,
+        STATUS(TimedOut, "Call waited in the queue past client deadline"));
+  }
+
+  // Removes the queued call with the latest deadline in the lowest priority class, or returns
+  // null if there are no queued calls.
+  InboundCallPtr PopLeastUrgentUnlocked() {
+    for (auto it = queues_.rbegin(); it != queues_.rend(); ++it) {
+      if (!it->empty()) {
+        auto last = std::prev(it->end());
+        auto result = std::move(last->second);
+        it->erase(last);
+        return result;
+      }
+    }
+    return nullptr;
+  }
+
+  // Removes and returns a queued call that is less urgent than a new call with the given priority
+  // and deadline, so that the new call could take its place in the full queue. Returns null if
+  // the new call is the least urgent one.
+  InboundCallPtr ShedUnlocked(RpcPriority priority, MonoTime deadline) {
+    const size_t index = util::to_underlying(priority);
+    for (auto i = kRpcPriorityMapSize; i-- > index;) {
+      auto& queue = queues_[i];
+      if (queue.empty()) {
+        continue;
+      }
+      if (i == index && !deadline.ComesBefore(queue.rbegin()->first)) {
+        return nullptr;
+      }
+      return PopLeastUrgentUnlocked();
+    }
+    return nullptr;
+  }
+
   ThreadPool* thread_pool_;
   std::unique_ptr<ServiceIf> service_;
-  scoped_refptr<Histogram> incoming_queue_time_;
+  // Queue time histograms of calls, indexed by RpcPriority.
+  std::array<scoped_refptr<Histogram>, kRpcPriorityMapSize> incoming_queue_time_;
   scoped_refptr<Counter> rpcs_timed_out_in_queue_;
   scoped_refptr<Counter> rpcs_queue_overflow_;
 
   std::atomic<bool> closing_ = {false};
   TasksPool<InboundCallTask> tasks_pool_;
+
+  std::mutex queue_mutex_;
+  // Queued calls ordered by client deadline, indexed by RpcPriority.
+  std::array<std::multimap<MonoTime, InboundCallPtr>, kRpcPriorityMapSize> queues_;
+  // Number of queued calls and calls that left the queue while their task is not done yet.
+  size_t num_calls_ = 0;
 };
 
 void InboundCallTask::Run() {
-  pool_->Handle(call_);
+  pool_->HandleNext();
 }
 
 void InboundCallTask::Done(const Status& status) {
-  InboundCallPtr call = call_;
-  pool_->Processed(call, status);
+  pool_->TaskDone(status);
 }
 
 ServicePool::ServicePool(size_t max_tasks,
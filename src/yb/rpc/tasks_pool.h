@@ -36,10 +36,8 @@ class TasksPool {
 
   template <class... Args>
   bool Enqueue(ThreadPool* thread_pool, Args&&... args) {
-    WrappedTask* task = nullptr;
-    if (queue_.pop(task)) {
-      task->pool = this;
-      new (&task->storage) Task(std::forward<Args>(args)...);
+    WrappedTask* task = Allocate(std::forward<Args>(args)...);
+    if (task) {
       thread_pool->Enqueue(task);
       return true;
     } else {
@@ -47,6 +45,17 @@ class TasksPool {
     }
   }
 
+  template <class... Args>
+  bool EnqueueHighPriority(ThreadPool* thread_pool, Args&&... args) {
+    WrappedTask* task = Allocate(std::forward<Args>(args)...);
+    if (task) {
+      thread_pool->EnqueueHighPriority(task);
+      return true;
+    } else {
+      return false;
+    }
+  }
+
   size_t size() const {
     return tasks_.size();
   }
@@ -54,6 +63,17 @@ class TasksPool {
   struct WrappedTask;
   friend struct WrappedTask;
 
+  template <class... Args>
+  WrappedTask* Allocate(Args&&... args) {
+    WrappedTask* task = nullptr;
+    if (!queue_.pop(task)) {
+      return nullptr;
+    }
+    task->pool = this;
+    new (&task->storage) Task(std::forward<Args>(args)...);
+    return task;
+  }
+
   void Released(WrappedTask* task) {
     CHECK(queue_.bounded_push(task));
   }
@@ -70,12 +90,15 @@ class TasksPool {
       task().Run();
     }
 
+    // The task is returned to the pool before it is notified, so the owner of the pool could
+    // allocate a task for new work as soon as it learns that this one is done.
     void Done(const Status& status) override {
-      task().Done(status);
+      Task done_task(std::move(task()));
       task().~Task();
       TasksPool<Task>* tasks_pool = pool;
       pool = nullptr;
       tasks_pool->Released(this);
+      done_task.Done(status);
     }
 
     virtual ~WrappedTask() {
@@ -208,5 +208,64 @@ TEST_F(ThreadPoolTest, TestShutdown) {
   }
 }
 
+// Records the order in which the tasks were run, the first task waits for start_latch.
+class OrderedTask final : public ThreadPoolTask {
+ public:
+  OrderedTask(std::atomic<size_t>* counter, CountDownLatch* start_latch, CountDownLatch* latch)
+      : counter_(counter), start_latch_(start_latch), latch_(latch) {}
+
+  size_t order() const {
+    return order_;
+  }
+
+ private:
+  void Run() override {
+    order_ = (*counter_)++;
+    if (order_ == 0) {
+      start_latch_->Wait();
+    }
+  }
+
+  void Done(const Status& status) override {
+    latch_->CountDown();
+  }
+
+  std::atomic<size_t>* counter_;
+  CountDownLatch* start_latch_;
+  CountDownLatch* latch_;
+  size_t order_ = 0;
+};
+
+TEST_F(ThreadPoolTest, TestHighPriority) {
+  constexpr size_t kTotalTasks = 10;
+  constexpr size_t kTotalWorkers = 1;
+  ThreadPool pool("test", kTotalTasks, kTotalWorkers);
+
+  std::atomic<size_t> counter(0);
+  CountDownLatch start_latch(1);
+  CountDownLatch latch(kTotalTasks + 2);
+  OrderedTask blocking_task(&counter, &start_latch, &latch);
+  ASSERT_TRUE(pool.Enqueue(&blocking_task));
+  while (counter == 0) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  std::vector<std::unique_ptr<OrderedTask>> tasks;
+  for (size_t i = 0; i != kTotalTasks; ++i) {
+    tasks.emplace_back(new OrderedTask(&counter, &start_latch, &latch));
+    ASSERT_TRUE(pool.Enqueue(tasks.back().get()));
+  }
+  OrderedTask high_priority_task(&counter, &start_latch, &latch);
+  ASSERT_TRUE(pool.EnqueueHighPriority(&high_priority_task));
+  start_latch.CountDown();
+  latch.Wait();
+
+  // The worker was busy with the blocking task, so the high priority task runs next.
+  ASSERT_EQ(1, high_priority_task.order());
+  for (size_t i = 0; i != kTotalTasks; ++i) {
+    ASSERT_EQ(i + 2, tasks[i]->order());
+  }
+}
+
 } // namespace rpc
 } // namespace yb
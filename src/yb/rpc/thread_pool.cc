@@ -37,13 +37,20 @@ typedef boost::lockfree::queue<Worker*> WaitingWorkers;
 struct ThreadPoolShare {
   ThreadPoolOptions options;
   TaskQueue task_queue;
+  // Tasks that are picked before any task of task_queue.
+  TaskQueue high_priority_task_queue;
   WaitingWorkers waiting_workers;
 
   explicit ThreadPoolShare(ThreadPoolOptions o)
       : options(std::move(o)),
         task_queue(options.queue_limit),
+        high_priority_task_queue(options.queue_limit),
         waiting_workers(options.max_workers) {
   }
+
+  bool PopTask(ThreadPoolTask** task) {
+    return high_priority_task_queue.pop(*task) || task_queue.pop(*task);
+  }
 };
 
 namespace {
@@ -104,7 +111,7 @@ class Worker {
   bool PopTask(ThreadPoolTask** task) {
     // First of all we try to get already queued task, w/o locking.
     // If there is no task, so we could go to waiting state.
-    if (share_->task_queue.pop(*task)) {
+    if (share_->PopTask(task)) {
       return true;
     }
     std::unique_lock<std::mutex> lock(mutex_);
@@ -120,7 +127,7 @@ class Worker {
       // the worker queue. So worker queue could be empty in this case, and nobody was notified
       // about new task. So we check there for this case. This technique is similar to
       // double check.
-      if (share_->task_queue.pop(*task)) {
+      if (share_->PopTask(task)) {
         return true;
       }
 
@@ -128,7 +135,7 @@ class Worker {
 
       // Sometimes another worker could steal task before we wake up. In this case we will
       // just enqueue ourselves back.
-      if (share_->task_queue.pop(*task)) {
+      if (share_->PopTask(task)) {
         return true;
       }
     }
@@ -171,14 +178,22 @@ class ThreadPool::Impl {
     return share_.options;
   }
 
-  bool Enqueue(ThreadPoolTask* task) {
+  TaskQueue* task_queue() {
+    return &share_.task_queue;
+  }
+
+  TaskQueue* high_priority_task_queue() {
+    return &share_.high_priority_task_queue;
+  }
+
+  bool Enqueue(ThreadPoolTask* task, TaskQueue* queue) {
     ++adding_;
     if (closing_) {
       --adding_;
       task->Done(shutdown_status_);
       return false;
     }
-    bool added = share_.task_queue.bounded_push(task);
+    bool added = queue->bounded_push(task);
     --adding_;
     if (!added) {
       task->Done(queue_full_status_);
@@ -213,6 +228,7 @@ class ThreadPool::Impl {
       std::lock_guard<std::mutex> lock(mutex_);
       if (closing_) {
         CHECK(share_.task_queue.empty());
+        CHECK(share_.high_priority_task_queue.empty());
         CHECK(workers_.empty());
         return;
       }
@@ -231,7 +247,7 @@ class ThreadPool::Impl {
       std::this_thread::sleep_for(std::chrono::milliseconds(10));
     }
     ThreadPoolTask* task = nullptr;
-    while (share_.task_queue.pop(task)) {
+    while (share_.PopTask(&task)) {
       task->Done(shutdown_status_);
     }
   }
@@ -272,7 +288,11 @@ bool ThreadPool::IsCurrentThreadRpcWorker() {
 }
 
 bool ThreadPool::Enqueue(ThreadPoolTask* task) {
-  return impl_->Enqueue(task);
+  return impl_->Enqueue(task, impl_->task_queue());
+}
+
+bool ThreadPool::EnqueueHighPriority(ThreadPoolTask* task) {
+  return impl_->Enqueue(task, impl_->high_priority_task_queue());
 }
 
 void ThreadPool::Shutdown() {
@@ -60,6 +60,10 @@ class ThreadPool {
   const ThreadPoolOptions& options() const;
 
   bool Enqueue(ThreadPoolTask* task);
+
+  // Enqueues the task ahead of all tasks added by Enqueue, so that it is not delayed by them when
+  // the pool is overloaded.
+  bool EnqueueHighPriority(ThreadPoolTask* task);
   void Shutdown();
 
   static bool IsCurrentThreadRpcWorker();
@@ -17,6 +17,7 @@
 
 #include <google/protobuf/io/coded_stream.h>
 
+#include "yb/gutil/casts.h"
 #include "yb/gutil/endian.h"
 
 #include "yb/rpc/messenger.h"
@@ -24,6 +25,7 @@
 #include "yb/rpc/rpc_introspection.pb.h"
 #include "yb/rpc/serialization.h"
 
+#include "yb/util/faststring.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/size_literals.h"
 #include "yb/util/debug/trace_event.h"
@@ -33,6 +35,7 @@ using google::protobuf::io::CodedInputStream;
 using yb::operator"" _MB;
 
 DECLARE_bool(rpc_dump_all_traces);
+DECLARE_int32(rpc_compression_min_size);
 // Maximum size of RPC should be larger than size of consensus batch
 // At each layer, we embed the "message" from the previous layer.
 // In order to send three strings of 64, the request from cql/redis will be larger
@@ -230,7 +233,16 @@ Status YBInboundCall::ParseFrom(Slice source) {
 
   request_data_.assign(source.data(), source.end());
   source = Slice(request_data_.data(), request_data_.size());
-  RETURN_NOT_OK(serialization::ParseYBMessage(source, &header_, &serialized_request_));
+  Slice body;
+  RETURN_NOT_OK(serialization::ParseYBHeader(source, &header_, &body));
+  if (header_.has_uncompressed_size()) {
+    std::vector<char> decompressed(header_.uncompressed_size());
+    RETURN_NOT_OK(serialization::Decompress(
+        body, pointer_cast<uint8_t*>(decompressed.data()), decompressed.size()));
+    request_data_.swap(decompressed);
+    body = Slice(request_data_.data(), request_data_.size());
+  }
+  RETURN_NOT_OK(serialization::ParseYBBody(body, &serialized_request_));
 
   // Adopt the service/method info from the header as soon as it's available.
   if (PREDICT_FALSE(!header_.has_remote_method())) {
@@ -266,6 +278,10 @@ Status YBInboundCall::SerializeResponseBuffer(const google::protobuf::MessageLit
   ResponseHeader resp_hdr;
   resp_hdr.set_call_id(header_.call_id());
   resp_hdr.set_is_error(!is_success);
+  const bool compression_supported = serialization::CompressionEnabled();
+  if (compression_supported) {
+    resp_hdr.set_compression_supported(true);
+  }
   uint32_t absolute_sidecar_offset = protobuf_msg_size;
   for (auto& car : sidecars_) {
     resp_hdr.add_sidecar_offsets(absolute_sidecar_offset);
@@ -293,11 +309,33 @@ Status YBInboundCall::SerializeResponseBuffer(const google::protobuf::MessageLit
   if (!status.ok()) {
     return status;
   }
-  return SerializeMessage(response,
-                          &response_buf_,
-                          additional_size,
-                          /* use_cached_size */ true,
-                          header_size);
+  status = SerializeMessage(response,
+                            &response_buf_,
+                            additional_size,
+                            /* use_cached_size */ true,
+                            header_size);
+  if (!status.ok() || !compression_supported || !header_.compression_supported() ||
+      message_size + additional_size < static_cast<size_t>(FLAGS_rpc_compression_min_size)) {
+    return status;
+  }
+
+  // The response is serialized on a service thread, so compress it here instead of the reactor.
+  faststring body;
+  body.reserve(message_size + additional_size);
+  body.append(response_buf_.udata() + header_size, message_size);
+  for (const auto& car : sidecars_) {
+    body.append(car.udata(), car.size());
+  }
+  faststring compressed;
+  if (!serialization::Compress(Slice(body.data(), body.size()), &compressed)) {
+    return Status::OK();
+  }
+  resp_hdr.set_uncompressed_size(body.size());
+  RETURN_NOT_OK(SerializeHeader(
+      resp_hdr, compressed.size(), &response_buf_, compressed.size(), &header_size));
+  memcpy(response_buf_.udata() + header_size, compressed.data(), compressed.size());
+  sidecars_.clear();
+  return Status::OK();
 }
 
 string YBInboundCall::ToString() const {
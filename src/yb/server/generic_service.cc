@@ -168,5 +168,9 @@ void GenericServiceImpl::Ping(
   rpc.RespondSuccess();
 }
 
+bool GenericServiceImpl::IsInlineSafe(const std::string& method_name) const {
+  return method_name == "Ping";
+}
+
 } // namespace server
 } // namespace yb
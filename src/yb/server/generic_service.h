@@ -67,6 +67,8 @@ class GenericServiceImpl : public GenericServiceIf {
 
   void Ping(const PingRequestPB* req, PingResponsePB* resp, rpc::RpcContext rpc) override;
 
+  bool IsInlineSafe(const std::string& method_name) const override;
+
  private:
   RpcServerBase* server_;
 
@@ -49,6 +49,7 @@
 #include <sys/stat.h>
 
 #include <fstream>
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -60,6 +61,7 @@
 #include "yb/gutil/strings/substitute.h"
 #include "yb/gutil/sysinfo.h"
 #include "yb/server/webserver.h"
+#include "yb/util/continuous_profiler.h"
 #include "yb/util/env.h"
 #include "yb/util/logging.h"
 #include "yb/util/monotime.h"
@@ -204,6 +206,32 @@ static void PprofContentionHandler(const Webserver::WebRequest& req, stringstrea
 #endif // defined(__linux__)
 }
 
+// Profile collected by the continuous profiler, in the folded format accepted by flame graph tools,
+// e.g. /profilez?type=contention&windows=5.
+// Arguments:
+//   type - cpu (default) or contention.
+//   windows - number of the latest windows to aggregate, all kept windows by default.
+static void ContinuousProfileHandler(const Webserver::WebRequest& req, stringstream* output) {
+  string type_str = FindWithDefault(req.parsed_args, "type", "cpu");
+  ProfileType type;
+  if (type_str == "cpu") {
+    type = ProfileType::kCpu;
+  } else if (type_str == "contention") {
+    type = ProfileType::kContention;
+  } else {
+    *output << "Unknown profile type: " << type_str << endl;
+    return;
+  }
+  string windows_str = FindWithDefault(req.parsed_args, "windows", "");
+  int32_t windows =
+      ParseLeadingInt32Value(windows_str.c_str(), std::numeric_limits<int32_t>::max());
+  if (windows <= 0) {
+    *output << "Invalid number of windows: " << windows_str << endl;
+    return;
+  }
+
+  WriteFoldedProfile(type, windows, output);
+}
 
 // pprof asks for the url /pprof/symbol to map from hex addresses to variable names.
 // When the server receives a GET request for /pprof/symbol, it should return a line
@@ -267,6 +295,8 @@ void AddPprofPathHandlers(Webserver* webserver) {
   webserver->RegisterPathHandler("/pprof/profile", "", PprofCpuProfileHandler, false, false);
   webserver->RegisterPathHandler("/pprof/symbol", "", PprofSymbolHandler, false, false);
   webserver->RegisterPathHandler("/pprof/contention", "", PprofContentionHandler, false, false);
+
+  webserver->RegisterPathHandler("/profilez", "", ContinuousProfileHandler, false, false);
 }
 
 } // namespace yb
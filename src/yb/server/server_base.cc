@@ -58,6 +58,7 @@
 #include "yb/server/tracing-path-handlers.h"
 #include "yb/server/webserver.h"
 #include "yb/util/atomic.h"
+#include "yb/util/continuous_profiler.h"
 #include "yb/util/env.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/jsonwriter.h"
@@ -76,6 +77,7 @@ DEFINE_int32(num_reactor_threads, -1,
 TAG_FLAG(num_reactor_threads, advanced);
 
 DECLARE_bool(use_hybrid_clock);
+DECLARE_bool(enable_continuous_profiling);
 
 DEFINE_int32(generic_svc_num_threads, 10,
              "Number of RPC worker threads to run for the generic service");
@@ -161,6 +163,10 @@ Status RpcServerBase::Init() {
 
   SetStackTraceSignal(SIGUSR2);
 
+  if (FLAGS_enable_continuous_profiling) {
+    WARN_NOT_OK(StartContinuousProfiling(), "Failed to start continuous profiling");
+  }
+
   // Initialize the clock immediately. This checks that the clock is synchronized
   // so we're less likely to get into a partially initialized state on disk during startup
   // if we're having clock problems.
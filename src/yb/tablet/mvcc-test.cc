@@ -30,6 +30,8 @@
 // under the License.
 //
 
+#include <thread>
+
 #include <gtest/gtest.h>
 #include <glog/logging.h>
 
@@ -116,6 +118,39 @@ TEST_F(MvccTest, Abort) {
   ASSERT_EQ(now, manager_.SafeTimestampToRead(now));
 }
 
+TEST_F(MvccTest, SafeTimeForFollower) {
+  // Hybrid times of operations on a follower are assigned by the leader.
+  auto ht1 = AddLogical(clock_->Now(), 10);
+  auto ht2 = AddLogical(ht1, 10);
+  auto propagated = AddLogical(ht2, 5);
+  const auto no_wait = MonoTime::Now();
+  ASSERT_EQ(HybridTime::kMin, manager_.SafeTimeForFollower(HybridTime::kMin, no_wait));
+
+  // Propagated safe time is not used until the operation with ht2 is added.
+  HybridTime ht = ht1;
+  manager_.AddPending(&ht);
+  manager_.SetPropagatedSafeTime(propagated, ht2);
+  ASSERT_EQ(HybridTime::kMin, manager_.SafeTimeForFollower(HybridTime::kMin, no_wait));
+
+  ht = ht2;
+  manager_.AddPending(&ht);
+  ASSERT_EQ(ht1.Decremented(), manager_.SafeTimeForFollower(HybridTime::kMin, no_wait));
+  manager_.Replicated(ht1);
+  ASSERT_EQ(ht2.Decremented(), manager_.SafeTimeForFollower(HybridTime::kMin, no_wait));
+
+  std::thread replicator([this, ht2] {
+    SleepFor(MonoDelta::FromMilliseconds(50));
+    manager_.Replicated(ht2);
+  });
+  ASSERT_EQ(propagated, manager_.SafeTimeForFollower(
+      propagated, MonoTime::Now() + MonoDelta::FromSeconds(10)));
+  replicator.join();
+
+  // Safe time does not reach the required one before the deadline.
+  ASSERT_EQ(propagated, manager_.SafeTimeForFollower(
+      AddLogical(propagated, 1), MonoTime::Now() + MonoDelta::FromMilliseconds(10)));
+}
+
 TEST_F(MvccTest, Random) {
   constexpr size_t kTotalOperations = 10000;
   enum class Op { kAdd, kReplicated, kAborted };
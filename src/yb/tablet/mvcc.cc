@@ -32,6 +32,8 @@
 
 #include "yb/tablet/mvcc.h"
 
+#include <chrono>
+
 #include "yb/util/debug-util.h"
 #include "yb/util/logging.h"
 
@@ -49,6 +51,7 @@ void MvccManager::Replicated(HybridTime ht) {
   CHECK_EQ(queue_.front(), ht);
   PopFront(&lock);
   last_replicated_ = ht;
+  safe_time_cond_.notify_all();
 }
 
 void MvccManager::Aborted(HybridTime ht) {
@@ -58,6 +61,7 @@ void MvccManager::Aborted(HybridTime ht) {
   CHECK(!queue_.empty());
   if (queue_.front() == ht) {
     PopFront(&lock);
+    safe_time_cond_.notify_all();
   } else {
     aborted_.push(ht);
   }
@@ -92,6 +96,7 @@ void MvccManager::AddPending(HybridTime* ht) {
   }
   CHECK_GT(*ht, last_replicated_);
   queue_.push_back(*ht);
+  UpdatePropagatedSafeTime(&lock);
 }
 
 void MvccManager::SetLastReplicated(HybridTime ht) {
@@ -99,6 +104,40 @@ void MvccManager::SetLastReplicated(HybridTime ht) {
 
   std::lock_guard<std::mutex> lock(mutex_);
   last_replicated_ = ht;
+  UpdatePropagatedSafeTime(&lock);
+}
+
+void MvccManager::SetPropagatedSafeTime(HybridTime ht, HybridTime last_received_ht) {
+  VLOG_WITH_PREFIX(1) << "SetPropagatedSafeTime(" << ht << ", " << last_received_ht << ")";
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (ht <= propagated_safe_time_ ||
+      (!pending_propagated_safe_times_.empty() &&
+       ht <= pending_propagated_safe_times_.back().safe_time)) {
+    return;
+  }
+  pending_propagated_safe_times_.push_back({ht, last_received_ht});
+  UpdatePropagatedSafeTime(&lock);
+}
+
+void MvccManager::UpdatePropagatedSafeTime(std::lock_guard<std::mutex>* lock) {
+  // Operations are added in order, so all operations up to the last added one were added.
+  HybridTime last_added = queue_.empty() ? last_replicated_ : queue_.back();
+  bool updated = false;
+  while (!pending_propagated_safe_times_.empty()) {
+    const auto& front = pending_propagated_safe_times_.front();
+    // Operations covered by the safe time have hybrid times not greater than both the safe time
+    // and the last received hybrid time.
+    if (last_added < std::min(front.safe_time, front.last_received_ht)) {
+      break;
+    }
+    propagated_safe_time_ = front.safe_time;
+    pending_propagated_safe_times_.pop_front();
+    updated = true;
+  }
+  if (updated) {
+    safe_time_cond_.notify_all();
+  }
 }
 
 HybridTime MvccManager::SafeTimestampToRead(HybridTime limit) const {
@@ -112,6 +151,31 @@ HybridTime MvccManager::SafeTimestampToRead(HybridTime limit) const {
   return result;
 }
 
+HybridTime MvccManager::DoGetSafeTimeForFollower(std::unique_lock<std::mutex>* lock) const {
+  HybridTime result = propagated_safe_time_;
+  if (!queue_.empty()) {
+    result = std::min(result, queue_.front().Decremented());
+  }
+  // Operations are received in order, so nothing could be added before the last replicated one.
+  return std::max(result, last_replicated_);
+}
+
+HybridTime MvccManager::SafeTimeForFollower(HybridTime min_allowed, MonoTime deadline) const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  HybridTime result = DoGetSafeTimeForFollower(&lock);
+  while (result < min_allowed) {
+    auto now = MonoTime::Now();
+    if (!now.ComesBefore(deadline)) {
+      break;
+    }
+    safe_time_cond_.wait_for(
+        lock, std::chrono::microseconds(deadline.GetDeltaSince(now).ToMicroseconds()));
+    result = DoGetSafeTimeForFollower(&lock);
+  }
+  VLOG_WITH_PREFIX(1) << "SafeTimeForFollower(" << min_allowed << "), result = " << result;
+  return result;
+}
+
 HybridTime MvccManager::LastReplicatedHybridTime() const {
   std::lock_guard<std::mutex> lock(mutex_);
   VLOG_WITH_PREFIX(1) << "LastReplicatedHybridTime(), result = " << last_replicated_;
@@ -32,12 +32,14 @@
 #ifndef YB_TABLET_MVCC_H_
 #define YB_TABLET_MVCC_H_
 
+#include <condition_variable>
 #include <mutex>
 #include <deque>
 #include <queue>
 #include <vector>
 
 #include "yb/server/clock.h"
+#include "yb/util/monotime.h"
 
 namespace yb {
 namespace tablet {
@@ -78,9 +80,28 @@ class MvccManager {
   // Returns time of last replicated operation.
   HybridTime LastReplicatedHybridTime() const;
 
+  // Sets safe time propagated by the leader to this follower. All operations with hybrid time
+  // not greater than `ht` have hybrid time not greater than `last_received_ht`, i.e. were already
+  // received by this follower, so `ht` becomes safe once operations up to `last_received_ht` were
+  // added.
+  void SetPropagatedSafeTime(HybridTime ht, HybridTime last_received_ht);
+
+  // Returns maximal timestamp to read at on a follower, i.e. no operation with hybrid time not
+  // greater than it will be added or is still pending. Unlike SafeTimestampToRead it does not use
+  // the local clock, so it could lag behind the leader by the propagation delay.
+  // Waits until the result is at least `min_allowed` or the deadline passes.
+  HybridTime SafeTimeForFollower(HybridTime min_allowed, MonoTime deadline) const;
+
  private:
   const std::string& LogPrefix() const { return prefix_; }
   void PopFront(std::lock_guard<std::mutex>* lock);
+  void UpdatePropagatedSafeTime(std::lock_guard<std::mutex>* lock);
+  HybridTime DoGetSafeTimeForFollower(std::unique_lock<std::mutex>* lock) const;
+
+  struct PropagatedSafeTime {
+    HybridTime safe_time;
+    HybridTime last_received_ht;
+  };
 
   std::string prefix_;
   server::ClockPtr clock_;
@@ -92,6 +113,13 @@ class MvccManager {
   std::priority_queue<HybridTime, std::vector<HybridTime>, std::greater<>> aborted_;
   HybridTime last_replicated_ = HybridTime::kMin;
   mutable HybridTime max_safe_time_returned_ = HybridTime::kMin;
+
+  // Safe times propagated by the leader, waiting for the operations they cover to be added.
+  std::deque<PropagatedSafeTime> pending_propagated_safe_times_;
+  // Latest propagated safe time whose operations were all added.
+  HybridTime propagated_safe_time_ = HybridTime::kMin;
+  // Notified when the safe time for follower could have changed.
+  mutable std::condition_variable safe_time_cond_;
 };
 
 }  // namespace tablet
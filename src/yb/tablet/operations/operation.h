@@ -43,6 +43,7 @@
 #include "yb/consensus/consensus.h"
 #include "yb/util/auto_release_pool.h"
 #include "yb/util/locks.h"
+#include "yb/util/sampled_trace.h"
 #include "yb/util/status.h"
 #include "yb/util/memory/arena.h"
 
@@ -66,6 +67,7 @@ class Operation {
     ALTER_SCHEMA_TXN,
     UPDATE_TRANSACTION_TXN,
     SNAPSHOT_TXN,
+    SPLIT_TXN,
 
     kOperationTypes // Must be the last one (number of types above).
   };
@@ -184,6 +186,16 @@ class OperationState {
     return DCHECK_NOTNULL(completion_clbk_.get());
   }
 
+  // Sets the compact trace of the sampled call that initiated this operation, to record
+  // the operation phases to it.
+  void set_sampled_trace(SampledTrace* sampled_trace) {
+    sampled_trace_ = sampled_trace;
+  }
+
+  SampledTrace* sampled_trace() const {
+    return sampled_trace_.get();
+  }
+
   // Sets a heap object to be managed by this transaction's AutoReleasePool.
   template<class T>
   T* AddToAutoReleasePool(T* t) {
@@ -259,6 +271,8 @@ class OperationState {
 
   scoped_refptr<consensus::ConsensusRound> consensus_round_;
 
+  SampledTracePtr sampled_trace_;
+
   // Lock that protects access to operation state.
   mutable simple_spinlock mutex_;
 };
@@ -39,6 +39,7 @@
 #include "yb/gutil/strings/strcat.h"
 #include "yb/tablet/tablet_peer.h"
 #include "yb/tablet/operations/operation_tracker.h"
+#include "yb/util/continuous_profiler.h"
 #include "yb/util/debug-util.h"
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/logging.h"
@@ -186,9 +187,11 @@ Status OperationDriver::PrepareAndStart() {
   ADOPT_TRACE(trace());
   TRACE_EVENT1("operation", "PrepareAndStart", "operation", this);
   VLOG_WITH_PREFIX(4) << "PrepareAndStart()";
+  ScopedProfilingTag tablet_tag(ProfilingTag::kTablet, operation_->state()->tablet()->tablet_id());
   // Actually prepare and start the operation.
   prepare_physical_hybrid_time_ = GetMonoTimeMicros();
   RETURN_NOT_OK(operation_->Prepare());
+  RecordPhase(TracePhase::kPrepare);
 
   // Only take the lock long enough to take a local copy of the
   // replication state and set our prepare state. This ensures that
@@ -300,6 +303,7 @@ void OperationDriver::HandleFailure(const Status& s) {
 }
 
 void OperationDriver::ReplicationFinished(const Status& status) {
+  RecordPhase(TracePhase::kReplicate);
   consensus::OpId op_id_local;
   {
     std::lock_guard<simple_spinlock> op_id_lock(opid_lock_);
@@ -398,9 +402,11 @@ void OperationDriver::ApplyTask() {
   // We need to ref-count ourself, since Commit() may run very quickly
   // and end up calling Finalize() while we're still in this code.
   scoped_refptr<OperationDriver> ref(this);
+  ScopedProfilingTag tablet_tag(ProfilingTag::kTablet, operation_->state()->tablet()->tablet_id());
 
   {
     CHECK_OK(operation_->Apply());
+    RecordPhase(TracePhase::kApply);
 
     operation_->PreCommit();
 
@@ -420,6 +426,13 @@ void OperationDriver::Finalize() {
 }
 
 
+void OperationDriver::RecordPhase(TracePhase phase) {
+  auto* sampled_trace = mutable_state()->sampled_trace();
+  if (sampled_trace) {
+    sampled_trace->RecordPhase(phase);
+  }
+}
+
 std::string OperationDriver::StateString(ReplicationState repl_state,
                                            PrepareState prep_state) {
   string state_str;
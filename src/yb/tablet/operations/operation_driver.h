@@ -236,6 +236,10 @@ class OperationDriver : public RefCountedThreadSafe<OperationDriver>,
   // appended to the WAL.
   void Finalize();
 
+  // Records the end of the phase to the sampled trace of the call that initiated this operation,
+  // if any.
+  void RecordPhase(TracePhase phase);
+
   // Returns the mutable state of the operation being executed by
   // this driver.
   OperationState* mutable_state();
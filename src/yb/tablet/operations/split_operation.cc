@@ -0,0 +1,129 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tablet/operations/split_operation.h"
+
+#include <glog/logging.h>
+
+#include "yb/server/hybrid_clock.h"
+#include "yb/tablet/tablet.h"
+#include "yb/tablet/tablet_splitter.h"
+#include "yb/tserver/tserver_admin.pb.h"
+#include "yb/util/trace.h"
+
+namespace yb {
+namespace tablet {
+
+using consensus::ReplicateMsg;
+using consensus::SPLIT_OP;
+using consensus::DriverType;
+using strings::Substitute;
+using tserver::TabletServerErrorPB;
+using tserver::SplitTabletRequestPB;
+
+Status ValidateSplitRequest(const Tablet& tablet, const SplitTabletRequestPB& request) {
+  if (request.tablet_id() != tablet.tablet_id()) {
+    return STATUS_SUBSTITUTE(InvalidArgument, "Split request for tablet $0 sent to tablet $1",
+                             request.tablet_id(), tablet.tablet_id());
+  }
+  if (request.new_tablet1_id() == request.new_tablet2_id()) {
+    return STATUS(InvalidArgument, "The new tablets of a split must have different ids",
+                  request.new_tablet1_id());
+  }
+  const Partition& partition = tablet.metadata()->partition();
+  const std::string& split_key = request.split_partition_key();
+  if (split_key <= partition.partition_key_start() ||
+      (!partition.partition_key_end().empty() && split_key >= partition.partition_key_end())) {
+    return STATUS_SUBSTITUTE(InvalidArgument,
+                             "Split key $0 is not strictly inside of the partition [$1, $2)",
+                             Slice(split_key).ToDebugHexString(),
+                             Slice(partition.partition_key_start()).ToDebugHexString(),
+                             Slice(partition.partition_key_end()).ToDebugHexString());
+  }
+  return Status::OK();
+}
+
+string SplitOperationState::ToString() const {
+  return Substitute("SplitOperationState [hybrid_time=$0, request=$1]",
+                    hybrid_time_even_if_unset().ToString(),
+                    request_ == nullptr ? "(none)" : request_->ShortDebugString());
+}
+
+SplitOperation::SplitOperation(std::unique_ptr<SplitOperationState> state, DriverType type)
+    : Operation(std::move(state), type, Operation::SPLIT_TXN) {}
+
+consensus::ReplicateMsgPtr SplitOperation::NewReplicateMsg() {
+  auto result = std::make_shared<ReplicateMsg>();
+  result->set_op_type(SPLIT_OP);
+  result->mutable_split_request()->CopyFrom(*state()->request());
+  return result;
+}
+
+Status SplitOperation::Prepare() {
+  TRACE("PREPARE SPLIT: Starting");
+
+  Tablet* tablet = state()->tablet();
+  if (state()->request()->tablet_id() != tablet->tablet_id()) {
+    // See Apply().
+    return Status::OK();
+  }
+  Status s = ValidateSplitRequest(*tablet, *state()->request());
+  if (!s.ok()) {
+    state()->completion_callback()->set_error(s, TabletServerErrorPB::UNKNOWN_ERROR);
+    return s;
+  }
+
+  TRACE("PREPARE SPLIT: finished");
+  return Status::OK();
+}
+
+void SplitOperation::Start() {
+  state()->TrySetHybridTimeFromClock();
+  TRACE("START. HybridTime: $0",
+      server::HybridClock::GetPhysicalValueMicros(state()->hybrid_time()));
+}
+
+Status SplitOperation::Apply() {
+  TRACE("APPLY SPLIT: Starting");
+
+  Tablet* tablet = state()->tablet();
+  if (state()->request()->tablet_id() != tablet->tablet_id()) {
+    // The log of a tablet created by a split starts with the split operation of its parent, so
+    // that its operations are ordered after the data inherited from the parent. There is nothing
+    // to apply for it.
+    return Status::OK();
+  }
+
+  TabletSplitter* splitter = tablet->tablet_splitter();
+  if (splitter == nullptr) {
+    return STATUS(NotSupported, "Tablet splitting is not supported", tablet->tablet_id());
+  }
+  RETURN_NOT_OK(splitter->ApplyTabletSplit(tablet, *state()->consensus_round()->replicate_msg()));
+
+  TRACE("APPLY SPLIT: finished");
+  return Status::OK();
+}
+
+void SplitOperation::Finish(OperationResult result) {
+  if (PREDICT_FALSE(result == Operation::ABORTED)) {
+    TRACE("SplitCommitCallback: operation aborted");
+  }
+  state()->Finish();
+}
+
+string SplitOperation::ToString() const {
+  return Substitute("SplitOperation [state=$0]", state()->ToString());
+}
+
+}  // namespace tablet
+}  // namespace yb
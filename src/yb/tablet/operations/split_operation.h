@@ -0,0 +1,95 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_TABLET_OPERATIONS_SPLIT_OPERATION_H
+#define YB_TABLET_OPERATIONS_SPLIT_OPERATION_H
+
+#include <string>
+
+#include "yb/gutil/macros.h"
+#include "yb/tablet/operations/operation.h"
+
+namespace yb {
+namespace tablet {
+
+// Operation Context for the Split operation.
+// Keeps track of the Operation states (request, result, ...)
+class SplitOperationState : public OperationState {
+ public:
+  explicit SplitOperationState(Tablet* tablet,
+                               const tserver::SplitTabletRequestPB* request = nullptr)
+      : OperationState(tablet), request_(request) {
+  }
+
+  const tserver::SplitTabletRequestPB* request() const override { return request_; }
+
+  void UpdateRequestFromConsensusRound() override {
+    request_ = consensus_round()->replicate_msg()->mutable_split_request();
+  }
+
+  // Note: request_ is set to NULL after this method returns.
+  void Finish() {
+    request_ = nullptr;
+  }
+
+  std::string ToString() const override;
+
+ private:
+  // The original RPC request.
+  const tserver::SplitTabletRequestPB* request_;
+
+  DISALLOW_COPY_AND_ASSIGN(SplitOperationState);
+};
+
+// Executes the split of a tablet. Every replica creates the new tablets when it applies the
+// operation, so all of them contain exactly the data written to the split tablet before it.
+class SplitOperation : public Operation {
+ public:
+  SplitOperation(std::unique_ptr<SplitOperationState> operation_state,
+                 consensus::DriverType type);
+
+  SplitOperationState* state() override {
+    return down_cast<SplitOperationState*>(Operation::state());
+  }
+
+  const SplitOperationState* state() const override {
+    return down_cast<const SplitOperationState*>(Operation::state());
+  }
+
+  consensus::ReplicateMsgPtr NewReplicateMsg() override;
+
+  // Verifies that the split key is within the partition of the tablet.
+  CHECKED_STATUS Prepare() override;
+
+  // Starts the SplitOperation by assigning it a timestamp.
+  void Start() override;
+
+  // Creates the new tablets, unless this is the first operation of a tablet created by the split.
+  CHECKED_STATUS Apply() override;
+
+  void Finish(OperationResult result) override;
+
+  std::string ToString() const override;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(SplitOperation);
+};
+
+// Checks that 'request' splits 'tablet' at a key strictly inside of its partition.
+CHECKED_STATUS ValidateSplitRequest(const Tablet& tablet,
+                                    const tserver::SplitTabletRequestPB& request);
+
+}  // namespace tablet
+}  // namespace yb
+
+#endif  // YB_TABLET_OPERATIONS_SPLIT_OPERATION_H
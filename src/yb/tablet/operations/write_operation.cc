@@ -107,6 +107,15 @@ Status WriteOperation::Apply() {
 
   Tablet* tablet = state()->tablet();
 
+  if (PREDICT_FALSE(tablet->metadata()->has_been_split())) {
+    // The write was replicated after the split operation, so the tablets created by the split do
+    // not contain it. No replica applies it, and the client retries it on the new tablets.
+    state()->completion_callback()->set_error(
+        STATUS(IllegalState, "Tablet has been split", tablet->tablet_id()),
+        TabletServerErrorPB::TABLET_SPLIT);
+    return Status::OK();
+  }
+
   tablet->ApplyRowOperations(state());
 
   return Status::OK();
@@ -0,0 +1,130 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <gtest/gtest.h>
+
+#include "yb/common/ql_protocol_util.h"
+#include "yb/common/ql_rowblock.h"
+#include "yb/common/schema.h"
+#include "yb/docdb/doc_key.h"
+#include "yb/docdb/row_cache.h"
+#include "yb/docdb/value.h"
+#include "yb/tablet/local_tablet_writer.h"
+#include "yb/tablet/tablet.h"
+#include "yb/tablet/tablet-test-util.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+DECLARE_int64(tablet_row_cache_size_bytes);
+
+namespace yb {
+namespace tablet {
+
+class TabletRowCacheTest : public YBTabletTest {
+ public:
+  TabletRowCacheTest()
+      : YBTabletTest(Schema({ ColumnSchema("h", INT32, false, true),
+                              ColumnSchema("r", INT32, false, false),
+                              ColumnSchema("v", INT32) },
+                            2)) {
+  }
+
+  void SetUp() override {
+    FLAGS_tablet_row_cache_size_bytes = 16 * 1024 * 1024;
+    YBTabletTest::SetUp();
+    ASSERT_NE(nullptr, tablet()->RowCacheForTest());
+  }
+
+  void WriteRow(int32_t h, int32_t r, int32_t v) {
+    LocalTabletWriter writer(tablet().get());
+    QLWriteRequestPB req;
+    QLAddInt32HashValue(&req, h);
+    QLSetHashCode(&req);
+    QLAddInt32RangeValue(&req, r);
+    QLAddInt32ColumnValue(&req, kFirstColumnId + 2, v);
+    ASSERT_OK(writer.Write(&req));
+  }
+
+  // Writes a tombstone to the doc key that consists of the hashed part of the row keys only.
+  void WriteHashKeyTombstone(int32_t h) {
+    QLWriteRequestPB req;
+    QLAddInt32HashValue(&req, h);
+    QLSetHashCode(&req);
+    docdb::KeyValueWriteBatchPB put_batch;
+    auto* kv_pair = put_batch.add_kv_pairs();
+    kv_pair->set_key(docdb::DocKey(
+        req.hash_code(), { docdb::PrimitiveValue::Int32(h) }).Encode().AsStringRef());
+    kv_pair->set_value(docdb::Value(docdb::PrimitiveValue::kTombstone).Encode());
+    consensus::OpId op_id;
+    op_id.set_term(0);
+    // Above the op ids used by LocalTabletWriter.
+    op_id.set_index(1 << 30);
+    tablet()->ApplyKeyValueRowOperations(put_batch, op_id, clock()->Now());
+  }
+
+  // Returns the value of the row read with a point read, or -1 if there is no such row.
+  int32_t ReadRow(int32_t h, int32_t r) {
+    QLReadRequestPB req;
+    QLAddInt32HashValue(&req, h);
+    QLSetHashCode(&req);
+    QLAddInt32Condition(req.mutable_where_expr()->mutable_condition(), kFirstColumnId + 1,
+                        QL_OP_EQUAL, r);
+    QLAddColumns(schema_, {}, &req);
+    QLReadRequestResult result;
+    TransactionMetadataPB transaction;
+    EXPECT_OK(tablet()->HandleQLReadRequest(
+        ReadHybridTime::SingleTime(clock()->Now()), req, transaction, &result));
+    EXPECT_EQ(QLResponsePB::YQL_STATUS_OK, result.response.status())
+        << result.response.error_message();
+    auto row_block = CreateRowBlock(QLClient::YQL_CLIENT_CQL, schema_, result.rows_data);
+    if (row_block->row_count() == 0) {
+      return -1;
+    }
+    EXPECT_EQ(1U, row_block->row_count());
+    return row_block->row(0).column(2).int32_value();
+  }
+
+  size_t NumCachedRows() {
+    return tablet()->RowCacheForTest()->size();
+  }
+};
+
+TEST_F(TabletRowCacheTest, InvalidateWrittenRows) {
+  for (int32_t h = 1; h <= 2; ++h) {
+    for (int32_t r = 1; r <= 2; ++r) {
+      ASSERT_NO_FATALS(WriteRow(h, r, h * 10 + r));
+    }
+  }
+  for (int32_t h = 1; h <= 2; ++h) {
+    for (int32_t r = 1; r <= 2; ++r) {
+      ASSERT_EQ(h * 10 + r, ReadRow(h, r));
+    }
+  }
+  ASSERT_EQ(4U, NumCachedRows());
+
+  // A row write erases just that row.
+  ASSERT_NO_FATALS(WriteRow(1, 1, 100));
+  ASSERT_EQ(3U, NumCachedRows());
+  ASSERT_EQ(100, ReadRow(1, 1));
+  ASSERT_EQ(4U, NumCachedRows());
+
+  // A write to a prefix of the keys erases the rows under it only.
+  ASSERT_NO_FATALS(WriteHashKeyTombstone(1));
+  ASSERT_EQ(2U, NumCachedRows());
+  ASSERT_EQ(21, ReadRow(2, 1));
+  ASSERT_EQ(22, ReadRow(2, 2));
+  ASSERT_EQ(2U, NumCachedRows());
+}
+
+} // namespace tablet
+} // namespace yb
@@ -70,6 +70,7 @@
 #include "yb/docdb/intent.h"
 #include "yb/docdb/primitive_value.h"
 #include "yb/docdb/lock_batch.h"
+#include "yb/docdb/row_cache.h"
 
 #include "yb/gutil/atomicops.h"
 #include "yb/gutil/map-util.h"
@@ -120,6 +121,11 @@ DEFINE_double(tablet_bloom_target_fp_rate, 0.01f,
               "required for bloom filters.");
 TAG_FLAG(tablet_bloom_target_fp_rate, advanced);
 
+DEFINE_int64(tablet_row_cache_size_bytes, 0,
+             "Size of the cache of recently read rows of a non-transactional YQL tablet, used to "
+             "serve repeated point reads of the same rows. 0 disables the cache.");
+TAG_FLAG(tablet_row_cache_size_bytes, advanced);
+
 METRIC_DEFINE_entity(tablet);
 
 using namespace std::placeholders;
@@ -372,6 +378,19 @@ Tablet::Tablet(
         transaction_coordinator_context, transaction_participant_.get());
   }
 
+  if (!metadata_->split_parent_tablet_id().empty()) {
+    // The DocDB keys of hashed documents start with their 2 bytes hash, like the partition keys.
+    const Partition& partition = metadata_->partition();
+    if (!partition.partition_key_start().empty()) {
+      key_bounds_.lower.AppendValueType(ValueType::kUInt16Hash);
+      key_bounds_.lower.AppendRawBytes(partition.partition_key_start());
+    }
+    if (!partition.partition_key_end().empty()) {
+      key_bounds_.upper.AppendValueType(ValueType::kUInt16Hash);
+      key_bounds_.upper.AppendRawBytes(partition.partition_key_end());
+    }
+  }
+
   flush_stats_ = make_shared<TabletFlushStats>();
   tablet_options_.listeners.emplace_back(flush_stats_);
 }
@@ -409,7 +428,8 @@ Status Tablet::OpenKeyValueTablet() {
   // Install the history cleanup handler. Note that TabletRetentionPolicy is going to hold a raw ptr
   // to this tablet. So, we ensure that rocksdb_ is reset before this tablet gets destroyed.
   rocksdb_options.compaction_filter_factory = make_shared<DocDBCompactionFilterFactory>(
-      make_shared<TabletRetentionPolicy>(this));
+      make_shared<TabletRetentionPolicy>(this),
+      key_bounds_.IsInitialized() ? &key_bounds_ : nullptr);
 
   const string db_dir = metadata()->rocksdb_dir();
   LOG(INFO) << "Creating RocksDB database in dir " << db_dir;
@@ -435,7 +455,13 @@ Status Tablet::OpenKeyValueTablet() {
     return STATUS(IllegalState, rocksdb_open_status.ToString());
   }
   rocksdb_.reset(db);
-  ql_storage_.reset(new docdb::QLRocksDBStorage(rocksdb_.get()));
+  // Intents of transactional tables are applied after they are read, so their rows are not cached.
+  if (FLAGS_tablet_row_cache_size_bytes > 0 && table_type_ == TableType::YQL_TABLE_TYPE &&
+      !metadata_->schema().table_properties().is_transactional()) {
+    row_cache_.reset(new docdb::RowCache(
+        FLAGS_tablet_row_cache_size_bytes, clock_->Now(), mem_tracker_));
+  }
+  ql_storage_.reset(new docdb::QLRocksDBStorage(rocksdb_.get(), row_cache_.get()));
   if (transaction_participant_) {
     transaction_participant_->SetDB(db);
   }
@@ -612,6 +638,38 @@ void Tablet::ApplyKeyValueRowOperations(const KeyValueWriteBatchPB& put_batch,
     LOG(FATAL) << "Failed to write a batch with " << rocksdb_write_batch->Count() << " operations"
                << " into RocksDB: " << rocksdb_write_status.ToString();
   }
+
+  if (row_cache_ && !put_batch.has_transaction()) {
+    InvalidateRowCache(put_batch, hybrid_time);
+  }
+}
+
+void Tablet::InvalidateRowCache(const KeyValueWriteBatchPB& put_batch, HybridTime hybrid_time) {
+  const size_t num_range_key_columns = metadata_->schema().num_range_key_columns();
+  for (const auto& kv_pair : put_batch.kv_pairs()) {
+    const Slice key(kv_pair.key());
+    auto doc_key_size = docdb::DocKey::EncodedSize(key, docdb::DocKeyPart::WHOLE_DOC_KEY);
+    if (!doc_key_size.ok()) {
+      LOG(DFATAL) << "T " << tablet_id() << ": Failed to decode written key "
+                  << key.ToDebugHexString() << ": " << doc_key_size.status();
+      row_cache_->Clear();
+      return;
+    }
+    // A write to a prefix of the primary key, e.g. a range delete, affects all the rows having it.
+    if (*doc_key_size == key.size() && num_range_key_columns > 0) {
+      docdb::DocKey doc_key;
+      if (!doc_key.FullyDecodeFrom(key).ok()) {
+        row_cache_->Clear();
+        return;
+      }
+      if (doc_key.range_group().size() < num_range_key_columns) {
+        // The keys of the rows having the prefix continue where its closing group end is.
+        row_cache_->InvalidatePrefix(Slice(key.data(), key.size() - 1), hybrid_time);
+        continue;
+      }
+    }
+    row_cache_->Invalidate(Slice(key.data(), *doc_key_size), hybrid_time);
+  }
 }
 
 namespace {
@@ -690,10 +748,37 @@ Status Tablet::HandleQLReadRequest(
   Result<TransactionOperationContextOpt> txn_op_ctx =
       CreateTransactionOperationContext(transaction_metadata);
   RETURN_NOT_OK(txn_op_ctx);
+  if (key_bounds_.IsInitialized() && ql_read_request.hashed_column_values().empty()) {
+    // Until compactions drop them, this tablet still contains the rows of the other tablet of the
+    // split it was created by, so a scan must not go past the hash range of this tablet.
+    QLReadRequestPB bounded_request(ql_read_request);
+    RestrictToPartitionHashRange(&bounded_request);
+    return AbstractTablet::HandleQLReadRequest(
+        read_time, bounded_request, *txn_op_ctx, result);
+  }
   return AbstractTablet::HandleQLReadRequest(
       read_time, ql_read_request, *txn_op_ctx, result);
 }
 
+void Tablet::RestrictToPartitionHashRange(QLReadRequestPB* ql_read_request) const {
+  const Partition& partition = metadata_->partition();
+  if (!partition.partition_key_start().empty()) {
+    const int32_t first_hash_code =
+        PartitionSchema::DecodeMultiColumnHashValue(partition.partition_key_start());
+    if (!ql_read_request->has_hash_code() || ql_read_request->hash_code() < first_hash_code) {
+      ql_read_request->set_hash_code(first_hash_code);
+    }
+  }
+  if (!partition.partition_key_end().empty()) {
+    const int32_t last_hash_code =
+        PartitionSchema::DecodeMultiColumnHashValue(partition.partition_key_end()) - 1;
+    if (!ql_read_request->has_max_hash_code() ||
+        ql_read_request->max_hash_code() > last_hash_code) {
+      ql_read_request->set_max_hash_code(last_hash_code);
+    }
+  }
+}
+
 CHECKED_STATUS Tablet::CreatePagingStateForRead(const QLReadRequestPB& ql_read_request,
                                                 const size_t row_count,
                                                 QLResponsePB* response) const {
@@ -824,8 +909,22 @@ Status Tablet::FlushUnlocked(FlushMode mode) {
   return Status::OK();
 }
 
+void Tablet::GetMemTableMemoryUsage(uint64_t* mutable_bytes, uint64_t* total_bytes) const {
+  *mutable_bytes = 0;
+  *total_bytes = 0;
+  if (!rocksdb_) {
+    return;
+  }
+  rocksdb_->GetIntProperty(rocksdb::DB::Properties::kCurSizeActiveMemTable, mutable_bytes);
+  rocksdb_->GetIntProperty(rocksdb::DB::Properties::kCurSizeAllMemTables, total_bytes);
+}
+
 Status Tablet::ImportData(const std::string& source_dir) {
-  return rocksdb_->Import(source_dir);
+  auto status = rocksdb_->Import(source_dir);
+  if (row_cache_) {
+    row_cache_->Clear();
+  }
+  return status;
 }
 
 #define INTENT_VALUE_SCHECK(lhs, op, rhs, msg) \
@@ -111,6 +111,7 @@ struct TransactionApplyData;
 class TransactionCoordinator;
 class TransactionCoordinatorContext;
 class TransactionParticipant;
+class TabletSplitter;
 class WriteOperationState;
 
 using docdb::LockBatch;
@@ -367,6 +368,10 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // The HybridTime of the oldest write that is still not scheduled to be flushed in RocksDB.
   TabletFlushStats* flush_stats() const { return flush_stats_.get(); }
 
+  // Returns the memory used by the mutable memtable, i.e. the memory a flush would release, in
+  // 'mutable_bytes', and by all the memtables, including the ones being flushed, in 'total_bytes'.
+  void GetMemTableMemoryUsage(uint64_t* mutable_bytes, uint64_t* total_bytes) const;
+
   const scoped_refptr<server::Clock> &clock() const {
     return clock_;
   }
@@ -392,10 +397,18 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
     return transaction_participant_.get();
   }
 
+  // Returns the splitter that applies the splits of this tablet, or null if it cannot be split.
+  TabletSplitter* tablet_splitter() const {
+    return tablet_options_.tablet_splitter;
+  }
+
   void ForceRocksDBCompactInTest();
 
   std::string DocDBDumpStrInTest();
 
+  // Returns the row cache of the tablet, or null if it has none. Used for tests only.
+  docdb::RowCache* RowCacheForTest() const { return row_cache_.get(); }
+
   // Returns last committed write index.
   // The main purpose of this method is to make correct log cleanup when tablet does not have
   // writes.
@@ -453,6 +466,12 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   CHECKED_STATUS OpenKeyValueTablet();
 
+  // Erases the cached rows written by the given non-transactional write batch.
+  void InvalidateRowCache(const docdb::KeyValueWriteBatchPB& put_batch, HybridTime hybrid_time);
+
+  // Restricts a scan of the table to the hash range of the partition of this tablet.
+  void RestrictToPartitionHashRange(QLReadRequestPB* ql_read_request) const;
+
   void DocDBDebugDump(std::vector<std::string> *lines);
 
   // Register/Unregister a read operation, with an associated timestamp, for the purpose of
@@ -562,6 +581,9 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // RocksDB database for key-value tables.
   std::unique_ptr<rocksdb::DB> rocksdb_;
 
+  // Cache of recently read rows, if enabled for this tablet. Must outlive ql_storage_.
+  std::unique_ptr<docdb::RowCache> row_cache_;
+
   std::unique_ptr<common::QLStorageIf> ql_storage_;
 
   // This is for docdb fine-grained locking.
@@ -591,6 +613,10 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   std::shared_ptr<yb::docdb::HistoryRetentionPolicy> retention_policy_;
 
+  // Bounds of the keys of this tablet, only initialized for a tablet created by a split, which may
+  // still contain keys of the other tablet of the split.
+  docdb::KeyBounds key_bounds_;
+
   std::unique_ptr<TransactionCoordinator> transaction_coordinator_;
 
   std::unique_ptr<TransactionParticipant> transaction_participant_;
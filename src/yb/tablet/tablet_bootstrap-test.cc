@@ -44,6 +44,7 @@
 #include "yb/tablet/tablet_bootstrap_if.h"
 #include "yb/tablet/tablet-test-util.h"
 #include "yb/tablet/tablet_metadata.h"
+#include "yb/tablet/tablet_splitter.h"
 #include "yb/util/tostring.h"
 #include "yb/tablet/tablet_options.h"
 
@@ -77,6 +78,33 @@ using server::Clock;
 using server::LogicalClock;
 using tserver::WriteRequestPB;
 
+namespace {
+
+const char* const kNewTablet1Id = "test-tablet-child1";
+const char* const kNewTablet2Id = "test-tablet-child2";
+
+// Records the applied splits, and marks the tablet as split like the tablet server does.
+class TestTabletSplitter : public TabletSplitter {
+ public:
+  CHECKED_STATUS ApplyTabletSplit(
+      Tablet* tablet, const consensus::ReplicateMsg& replicate_msg) override {
+    const auto& split_request = replicate_msg.split_request();
+    applied_splits_.push_back(split_request.tablet_id());
+    tablet->metadata()->set_split_child_tablet_ids(
+        {split_request.new_tablet1_id(), split_request.new_tablet2_id()});
+    return tablet->metadata()->Flush();
+  }
+
+  const vector<string>& applied_splits() const {
+    return applied_splits_;
+  }
+
+ private:
+  vector<string> applied_splits_;
+};
+
+} // namespace
+
 class BootstrapTest : public LogTestBase {
  protected:
 
@@ -119,6 +147,7 @@ class BootstrapTest : public LogTestBase {
     scoped_refptr<LogAnchorRegistry> log_anchor_registry(new LogAnchorRegistry());
     // Now attempt to recover the log
     TabletOptions tablet_options;
+    tablet_options.tablet_splitter = tablet_splitter_;
     BootstrapTabletData data = {
         meta,
         scoped_refptr<Clock>(LogicalClock::CreateStartingAt(HybridTime::kInitialHybridTime)),
@@ -172,6 +201,31 @@ class BootstrapTest : public LogTestBase {
       VLOG(1) << result;
     }
   }
+
+  // Appends a committed SPLIT_OP of 'tablet_id' with the given id to the log.
+  void AppendSplitReplicate(const OpId& opid, const string& tablet_id) {
+    auto split_replicate = std::make_shared<ReplicateMsg>();
+    split_replicate->set_op_type(consensus::SPLIT_OP);
+    *split_replicate->mutable_id() = opid;
+    split_replicate->set_hybrid_time(clock_->Now().ToUint64());
+    *split_replicate->mutable_committed_op_id() = MakeOpId(0, 0);
+    auto* split_request = split_replicate->mutable_split_request();
+    split_request->set_tablet_id(tablet_id);
+    split_request->set_new_tablet1_id(kNewTablet1Id);
+    split_request->set_new_tablet2_id(kNewTablet2Id);
+    split_request->set_split_partition_key(PartitionSchema::EncodeMultiColumnHashValue(0x8000));
+    AppendReplicateBatch(split_replicate, true /* sync */);
+
+    // The NO_OP commits the split operation.
+    auto noop_replicate = std::make_shared<ReplicateMsg>();
+    noop_replicate->set_op_type(consensus::NO_OP);
+    *noop_replicate->mutable_id() = MakeOpId(opid.term(), opid.index() + 1);
+    noop_replicate->set_hybrid_time(clock_->Now().ToUint64());
+    *noop_replicate->mutable_committed_op_id() = opid;
+    AppendReplicateBatch(noop_replicate, true /* sync */);
+  }
+
+  TabletSplitter* tablet_splitter_ = nullptr;
 };
 
 // Tests a normal bootstrap scenario
@@ -341,5 +395,75 @@ TEST_F(BootstrapTest, TestConsensusOnlyOperationOutOfOrderHybridTime) {
   ASSERT_EQ(1, results.size());
 }
 
+// Tests that a committed split operation is applied by the bootstrap when the split was not
+// recorded in the tablet metadata.
+TEST_F(BootstrapTest, TestReplaySplitOperation) {
+  BuildLog();
+  TestTabletSplitter splitter;
+  tablet_splitter_ = &splitter;
+
+  const auto split_opid = MakeOpId(1, 1);
+  AppendSplitReplicate(split_opid, log::kTestTablet);
+
+  ConsensusBootstrapInfo boot_info;
+  shared_ptr<TabletClass> tablet;
+  ASSERT_OK(BootstrapTestTablet(-1, -1, &tablet, &boot_info));
+  ASSERT_EQ(0, boot_info.orphaned_replicates.size());
+  ASSERT_OPID_EQ(split_opid, boot_info.last_committed_id);
+  ASSERT_EQ(vector<string>{log::kTestTablet}, splitter.applied_splits());
+  ASSERT_TRUE(tablet->metadata()->has_been_split());
+  ASSERT_EQ((vector<string>{kNewTablet1Id, kNewTablet2Id}),
+            tablet->metadata()->split_child_tablet_ids());
+}
+
+// Tests that a split operation is not applied again when the split is already recorded in the
+// tablet metadata.
+TEST_F(BootstrapTest, TestSkipAppliedSplitOperation) {
+  BuildLog();
+  TestTabletSplitter splitter;
+  tablet_splitter_ = &splitter;
+
+  {
+    scoped_refptr<TabletMetadata> meta;
+    ASSERT_OK(LoadTestTabletMetadata(-1, -1, &meta));
+    meta->set_split_child_tablet_ids({kNewTablet1Id, kNewTablet2Id});
+    ASSERT_OK(meta->Flush());
+  }
+  AppendSplitReplicate(MakeOpId(1, 1), log::kTestTablet);
+
+  ConsensusBootstrapInfo boot_info;
+  shared_ptr<TabletClass> tablet;
+  ASSERT_OK(BootstrapTestTablet(-1, -1, &tablet, &boot_info));
+  ASSERT_TRUE(splitter.applied_splits().empty());
+  ASSERT_TRUE(tablet->metadata()->has_been_split());
+}
+
+// Tests that the split operation of the parent tablet, that the log of a tablet created by a split
+// starts with, is not applied to the new tablet.
+TEST_F(BootstrapTest, TestSkipSplitOperationOfParent) {
+  BuildLog();
+  TestTabletSplitter splitter;
+  tablet_splitter_ = &splitter;
+
+  AppendSplitReplicate(MakeOpId(1, 1), "test-tablet-parent");
+
+  ConsensusBootstrapInfo boot_info;
+  shared_ptr<TabletClass> tablet;
+  ASSERT_OK(BootstrapTestTablet(-1, -1, &tablet, &boot_info));
+  ASSERT_TRUE(splitter.applied_splits().empty());
+  ASSERT_FALSE(tablet->metadata()->has_been_split());
+}
+
+// Tests that the bootstrap fails on a split operation when tablet splitting is not supported.
+TEST_F(BootstrapTest, TestSplitOperationWithoutSplitter) {
+  BuildLog();
+  AppendSplitReplicate(MakeOpId(1, 1), log::kTestTablet);
+
+  ConsensusBootstrapInfo boot_info;
+  shared_ptr<TabletClass> tablet;
+  Status status = BootstrapTestTablet(-1, -1, &tablet, &boot_info);
+  ASSERT_TRUE(status.IsNotSupported()) << status;
+}
+
 } // namespace tablet
 } // namespace yb
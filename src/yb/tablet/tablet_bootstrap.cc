@@ -37,6 +37,7 @@
 #include "yb/server/hybrid_clock.h"
 #include "yb/tablet/tablet.h"
 #include "yb/tablet/tablet_peer.h"
+#include "yb/tablet/tablet_splitter.h"
 #include "yb/tablet/operations/alter_schema_operation.h"
 #include "yb/tablet/operations/update_txn_operation.h"
 #include "yb/tablet/operations/write_operation.h"
@@ -568,6 +569,9 @@ Status TabletBootstrap::HandleOperation(OperationType op_type,
     case consensus::UPDATE_TRANSACTION_OP:
       return PlayUpdateTransactionRequest(replicate);
 
+    case consensus::SPLIT_OP:
+      return PlaySplitRequest(replicate);
+
     // Unexpected cases:
     case consensus::SNAPSHOT_OP:
       return STATUS(IllegalState, Substitute(
@@ -818,6 +822,22 @@ Status TabletBootstrap::PlayAlterSchemaRequest(ReplicateMsg* replicate_msg) {
   return Status::OK();
 }
 
+Status TabletBootstrap::PlaySplitRequest(ReplicateMsg* replicate_msg) {
+  const auto& split_request = replicate_msg->split_request();
+
+  // The log of a tablet created by a split starts with the split operation of its parent, which
+  // was already applied to the data of the tablet.
+  if (split_request.tablet_id() != tablet_->tablet_id() ||
+      tablet_->metadata()->has_been_split()) {
+    return Status::OK();
+  }
+
+  if (!tablet_options_.tablet_splitter) {
+    return STATUS(NotSupported, "Tablet splitting is not supported", tablet_->tablet_id());
+  }
+  return tablet_options_.tablet_splitter->ApplyTabletSplit(tablet_.get(), *replicate_msg);
+}
+
 Status TabletBootstrap::PlayChangeConfigRequest(ReplicateMsg* replicate_msg) {
   ChangeConfigRecordPB* change_config = replicate_msg->mutable_change_config_record();
   RaftConfigPB config = change_config->new_config();
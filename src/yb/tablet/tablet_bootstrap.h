@@ -191,6 +191,8 @@ class TabletBootstrap {
 
   Status PlayAlterSchemaRequest(consensus::ReplicateMsg* replicate_msg);
 
+  Status PlaySplitRequest(consensus::ReplicateMsg* replicate_msg);
+
   Status PlayChangeConfigRequest(consensus::ReplicateMsg* replicate_msg);
 
   Status PlayNoOpRequest(consensus::ReplicateMsg* replicate_msg);
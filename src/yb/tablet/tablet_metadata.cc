@@ -350,6 +350,9 @@ Status TabletMetadata::LoadFromSuperBlock(const TabletSuperBlockPB& superblock)
     }
 
     tablet_data_state_ = superblock.tablet_data_state();
+    split_parent_tablet_id_ = superblock.split_parent_tablet_id();
+    split_child_tablet_ids_.assign(superblock.split_child_tablet_ids().begin(),
+                                   superblock.split_child_tablet_ids().end());
 
     deleted_cols_.clear();
     for (const DeletedColumnPB& deleted_col : superblock.deleted_cols()) {
@@ -536,6 +539,12 @@ Status TabletMetadata::ToSuperBlockUnlocked(TabletSuperBlockPB* super_block) con
                         "Couldn't serialize schema into superblock");
 
   pb.set_tablet_data_state(tablet_data_state_);
+  if (!split_parent_tablet_id_.empty()) {
+    pb.set_split_parent_tablet_id(split_parent_tablet_id_);
+  }
+  for (const auto& child_tablet_id : split_child_tablet_ids_) {
+    pb.add_split_child_tablet_ids(child_tablet_id);
+  }
   if (!consensus::OpIdEquals(tombstone_last_logged_opid_, MinimumOpId())) {
     *pb.mutable_tombstone_last_logged_opid() = tombstone_last_logged_opid_;
   }
@@ -633,5 +642,30 @@ TabletDataState TabletMetadata::tablet_data_state() const {
   return tablet_data_state_;
 }
 
+void TabletMetadata::set_split_parent_tablet_id(const std::string& tablet_id) {
+  std::lock_guard<LockType> l(data_lock_);
+  split_parent_tablet_id_ = tablet_id;
+}
+
+std::string TabletMetadata::split_parent_tablet_id() const {
+  std::lock_guard<LockType> l(data_lock_);
+  return split_parent_tablet_id_;
+}
+
+void TabletMetadata::set_split_child_tablet_ids(const std::vector<std::string>& tablet_ids) {
+  std::lock_guard<LockType> l(data_lock_);
+  split_child_tablet_ids_ = tablet_ids;
+}
+
+std::vector<std::string> TabletMetadata::split_child_tablet_ids() const {
+  std::lock_guard<LockType> l(data_lock_);
+  return split_child_tablet_ids_;
+}
+
+bool TabletMetadata::has_been_split() const {
+  std::lock_guard<LockType> l(data_lock_);
+  return !split_child_tablet_ids_.empty();
+}
+
 } // namespace tablet
 } // namespace yb
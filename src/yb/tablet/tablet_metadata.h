@@ -170,6 +170,18 @@ class TabletMetadata : public RefCountedThreadSafe<TabletMetadata> {
   void set_tablet_data_state(TabletDataState state);
   TabletDataState tablet_data_state() const;
 
+  // Set / get the id of the tablet this tablet was created from by a tablet split. Empty if this
+  // tablet was not created by a split.
+  void set_split_parent_tablet_id(const std::string& tablet_id);
+  std::string split_parent_tablet_id() const;
+
+  // Set / get the ids of the tablets this tablet was split into. Empty if this tablet has not been
+  // split.
+  void set_split_child_tablet_ids(const std::vector<std::string>& tablet_ids);
+  std::vector<std::string> split_child_tablet_ids() const;
+
+  bool has_been_split() const;
+
   // Increments flush pin count by one: if flush pin count > 0,
   // metadata will _not_ be flushed to disk during Flush().
   void PinFlush();
@@ -350,6 +362,11 @@ class TabletMetadata : public RefCountedThreadSafe<TabletMetadata> {
   // The current state of remote bootstrap for the tablet.
   TabletDataState tablet_data_state_;
 
+  // The tablet this tablet was split from, and the tablets this tablet was split into.
+  // Protected by 'data_lock_'.
+  std::string split_parent_tablet_id_;
+  std::vector<std::string> split_child_tablet_ids_;
+
   // Record of the last opid logged by the tablet before it was last
   // tombstoned. Has no meaning for non-tombstoned tablets.
   consensus::OpId tombstone_last_logged_opid_;
@@ -14,16 +14,25 @@
 #define YB_TABLET_TABLET_OPTIONS_H
 
 namespace rocksdb {
+class BackgroundWorkScheduler;
 class EventListener;
+class RateLimiter;
 }
 
 namespace yb {
 namespace tablet {
 
+class TabletSplitter;
+
 struct TabletOptions {
   std::shared_ptr<rocksdb::Cache> block_cache;
   std::shared_ptr<rocksdb::MemoryMonitor> memory_monitor;
   std::vector<std::shared_ptr<rocksdb::EventListener>> listeners;
+  // Shared by all the tablets of the tablet server, not set when each tablet uses its own.
+  std::shared_ptr<rocksdb::BackgroundWorkScheduler> background_work_scheduler;
+  std::shared_ptr<rocksdb::RateLimiter> rate_limiter;
+  // Applies the splits of the tablets, not set when tablets cannot be split.
+  TabletSplitter* tablet_splitter = nullptr;
 };
 
 } // namespace tablet
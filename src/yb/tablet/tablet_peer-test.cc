@@ -39,6 +39,7 @@
 #include "yb/common/wire_protocol-test-util.h"
 #include "yb/consensus/consensus_meta.h"
 #include "yb/consensus/log.h"
+#include "yb/consensus/log_anchor_registry.h"
 #include "yb/consensus/log_reader.h"
 #include "yb/consensus/log_util.h"
 #include "yb/consensus/opid_util.h"
@@ -63,6 +64,7 @@
 METRIC_DECLARE_entity(tablet);
 
 DECLARE_int32(log_min_seconds_to_retain);
+DECLARE_int32(log_min_segments_to_retain);
 
 namespace yb {
 namespace tablet {
@@ -435,6 +437,50 @@ TEST_P(TabletPeerTest, TestActiveOperationPreventsLogGC) {
   ASSERT_EQ(5, segments.size());
 }
 
+// Ensure that only the segments retained because of the unflushed writes are counted as flushable.
+TEST_P(TabletPeerTest, TestFlushableLogSize) {
+  FLAGS_log_min_seconds_to_retain = 0;
+  FLAGS_log_min_segments_to_retain = 1;
+  ConsensusBootstrapInfo info;
+  ASSERT_OK(StartPeer(info));
+
+  Log* log = tablet_peer_->log();
+  int64_t flushable_size = -1;
+  ASSERT_OK(tablet_peer_->GetFlushableLogSize(&flushable_size));
+  ASSERT_EQ(0, flushable_size);
+
+  ASSERT_OK(ExecuteInsertsAndRollLogs(3));
+  AssertLogAnchorEarlierThanLogLatest();
+
+  // Nothing can be GCed before the flush, and the retained segments are flushable.
+  int64_t gcable_size = -1;
+  ASSERT_OK(tablet_peer_->GetGCableDataSize(&gcable_size));
+  ASSERT_EQ(0, gcable_size);
+  ASSERT_OK(tablet_peer_->GetFlushableLogSize(&flushable_size));
+  ASSERT_GT(flushable_size, 0);
+
+  // An anchor before the unflushed writes keeps the segments after the flush, so they are not
+  // flushable.
+  log::LogAnchor anchor;
+  tablet_peer_->log_anchor_registry()->Register(1, "test", &anchor);
+  int64_t anchored_flushable_size = -1;
+  ASSERT_OK(tablet_peer_->GetFlushableLogSize(&anchored_flushable_size));
+  ASSERT_EQ(0, anchored_flushable_size);
+  ASSERT_OK(tablet_peer_->log_anchor_registry()->Unregister(&anchor));
+
+  // After the flush exactly the flushable segments become GCable.
+  ASSERT_OK(tablet_peer_->tablet()->Flush(tablet::FlushMode::kSync));
+  ASSERT_OK(tablet_peer_->GetGCableDataSize(&gcable_size));
+  ASSERT_EQ(flushable_size, gcable_size);
+  ASSERT_OK(tablet_peer_->GetFlushableLogSize(&flushable_size));
+  ASSERT_EQ(0, flushable_size);
+  int32_t num_gced = 0;
+  int64_t min_log_index = -1;
+  ASSERT_OK(tablet_peer_->GetEarliestNeededLogIndex(&min_log_index));
+  ASSERT_OK(log->GC(min_log_index, &num_gced));
+  ASSERT_GT(num_gced, 0);
+}
+
 TEST_P(TabletPeerTest, TestGCEmptyLog) {
   ConsensusBootstrapInfo info;
   ASSERT_OK(tablet_peer_->Start(info));
@@ -62,6 +62,7 @@
 
 #include "yb/tablet/operations/alter_schema_operation.h"
 #include "yb/tablet/operations/operation_driver.h"
+#include "yb/tablet/operations/split_operation.h"
 #include "yb/tablet/operations/write_operation.h"
 #include "yb/tablet/operations/update_txn_operation.h"
 
@@ -482,6 +483,9 @@ void TabletPeer::GetInFlightOperations(Operation::TraceType trace_type,
         case Operation::SNAPSHOT_TXN:
           status_pb.set_operation_type(consensus::SNAPSHOT_OP);
           break;
+        case Operation::SPLIT_TXN:
+          status_pb.set_operation_type(consensus::SPLIT_OP);
+          break;
 
         default:
           FATAL_INVALID_ENUM_VALUE(Operation::OperationType, driver->operation_type());
@@ -498,7 +502,8 @@ void TabletPeer::GetInFlightOperations(Operation::TraceType trace_type,
   }
 }
 
-Status TabletPeer::GetEarliestNeededLogIndex(int64_t* min_index) const {
+Status TabletPeer::GetEarliestNeededLogIndex(int64_t* min_index,
+                                             int64_t* min_index_after_flush) const {
   // First, we anchor on the last OpId in the Log to establish a lower bound
   // and avoid racing with the other checks. This limits the Log GC candidate
   // segments before we check the anchors.
@@ -510,6 +515,9 @@ Status TabletPeer::GetEarliestNeededLogIndex(int64_t* min_index) const {
 
   // If we never have written to the log, no need to proceed.
   if (*min_index == 0) {
+    if (min_index_after_flush) {
+      *min_index_after_flush = *min_index;
+    }
     return Status::OK();
   }
 
@@ -540,17 +548,6 @@ Status TabletPeer::GetEarliestNeededLogIndex(int64_t* min_index) const {
     *min_index = std::min(*min_index, transaction_coordinator->PrepareGC());
   }
 
-  int64_t last_committed_write_index = tablet_->last_committed_write_index();
-  Result<yb::OpId> max_persistent_op_id = tablet_->MaxPersistentOpId();
-  RETURN_NOT_OK(max_persistent_op_id);
-  int64_t max_persistent_index = max_persistent_op_id.get_ptr()->index;
-  // Check whether we had writes after last persistent entry.
-  // Note that last_committed_write_index could be zero if logs were cleaned before restart.
-  // So correct check is 'less', and NOT 'not equals to'.
-  if (max_persistent_index < last_committed_write_index) {
-    *min_index = std::min(*min_index, max_persistent_index);
-  }
-
   // We keep at least one committed operation in the log so that we can always recover safe time
   // during bootstrap.
   OpId committed_op_id;
@@ -563,6 +560,22 @@ Status TabletPeer::GetEarliestNeededLogIndex(int64_t* min_index) const {
     *min_index = std::min(*min_index, static_cast<int64_t>(committed_op_id.index()));
   }
 
+  // Everything above still holds after a flush, only the unflushed writes stop anchoring the log.
+  if (min_index_after_flush) {
+    *min_index_after_flush = *min_index;
+  }
+
+  int64_t last_committed_write_index = tablet_->last_committed_write_index();
+  Result<yb::OpId> max_persistent_op_id = tablet_->MaxPersistentOpId();
+  RETURN_NOT_OK(max_persistent_op_id);
+  int64_t max_persistent_index = max_persistent_op_id.get_ptr()->index;
+  // Check whether we had writes after last persistent entry.
+  // Note that last_committed_write_index could be zero if logs were cleaned before restart.
+  // So correct check is 'less', and NOT 'not equals to'.
+  if (max_persistent_index < last_committed_write_index) {
+    *min_index = std::min(*min_index, max_persistent_index);
+  }
+
   return Status::OK();
 }
 
@@ -582,6 +595,27 @@ Status TabletPeer::GetGCableDataSize(int64_t* retention_size) const {
   return Status::OK();
 }
 
+Status TabletPeer::GetFlushableLogSize(int64_t* flushable_size) const {
+  RETURN_NOT_OK(CheckRunning());
+  int64_t min_op_idx;
+  int64_t min_op_idx_after_flush;
+  RETURN_NOT_OK(GetEarliestNeededLogIndex(&min_op_idx, &min_op_idx_after_flush));
+  *flushable_size = 0;
+  if (min_op_idx_after_flush <= min_op_idx) {
+    return Status::OK();
+  }
+  // Segments that are retained now, but would be GCable with the index needed after the flush.
+  MaxIdxToSegmentSizeMap idx_size_map;
+  log_->GetMaxIndexesToSegmentSizeMap(min_op_idx, &idx_size_map);
+  for (const auto& entry : idx_size_map) {
+    if (entry.first >= min_op_idx_after_flush) {
+      break;
+    }
+    *flushable_size += entry.second;
+  }
+  return Status::OK();
+}
+
 std::unique_ptr<Operation> TabletPeer::CreateOperation(consensus::ReplicateMsg* replicate_msg) {
   switch (replicate_msg->op_type()) {
     case consensus::WRITE_OP:
@@ -602,6 +636,12 @@ std::unique_ptr<Operation> TabletPeer::CreateOperation(consensus::ReplicateMsg*
       return std::make_unique<UpdateTxnOperation>(
           std::make_unique<UpdateTxnOperationState>(tablet()), consensus::REPLICA);
 
+    case consensus::SPLIT_OP:
+      DCHECK(replicate_msg->has_split_request()) << "SPLIT_OP replica"
+          " operation must receive a SplitTabletRequestPB";
+      return std::make_unique<SplitOperation>(
+          std::make_unique<SplitOperationState>(tablet()), consensus::REPLICA);
+
     case consensus::SNAPSHOT_OP: FALLTHROUGH_INTENDED;
     case consensus::UNKNOWN_OP: FALLTHROUGH_INTENDED;
     case consensus::NO_OP: FALLTHROUGH_INTENDED;
@@ -631,6 +671,9 @@ Status TabletPeer::StartReplicaOperation(const scoped_refptr<ConsensusRound>& ro
   HybridTime ht(replicate_msg->hybrid_time());
   state->set_hybrid_time(ht);
   clock_->Update(ht);
+  if (replicate_msg->op_type() == consensus::WRITE_OP) {
+    last_received_write_ht_.store(ht.ToUint64(), std::memory_order_release);
+  }
 
   // This sets the monotonic counter to at least replicate_msg.monotonic_counter() atomically.
   tablet_->UpdateMonotonicCounter(replicate_msg->monotonic_counter());
@@ -646,6 +689,20 @@ Status TabletPeer::StartReplicaOperation(const scoped_refptr<ConsensusRound>& ro
   return Status::OK();
 }
 
+HybridTime TabletPeer::PropagatedSafeTime() {
+  auto tablet = shared_tablet();
+  return tablet ? tablet->SafeTimestampToRead() : HybridTime::kInvalidHybridTime;
+}
+
+void TabletPeer::SetPropagatedSafeTime(HybridTime ht) {
+  auto tablet = shared_tablet();
+  if (!tablet) {
+    return;
+  }
+  tablet->mvcc_manager()->SetPropagatedSafeTime(
+      ht, HybridTime(last_received_write_ht_.load(std::memory_order_acquire)));
+}
+
 string TabletPeer::permanent_uuid() const {
   if (cached_permanent_uuid_initialized_.load(std::memory_order_acquire)) {
     return cached_permanent_uuid_;
@@ -33,6 +33,7 @@
 #ifndef YB_TABLET_TABLET_PEER_H_
 #define YB_TABLET_TABLET_PEER_H_
 
+#include <atomic>
 #include <future>
 #include <map>
 #include <memory>
@@ -150,6 +151,10 @@ class TabletPeer : public RefCountedThreadSafe<TabletPeer>,
   virtual CHECKED_STATUS StartReplicaOperation(
       const scoped_refptr<consensus::ConsensusRound>& round) override;
 
+  HybridTime PropagatedSafeTime() override;
+
+  void SetPropagatedSafeTime(HybridTime ht) override;
+
   consensus::Consensus* consensus() const {
     std::lock_guard<simple_spinlock> lock(lock_);
     return consensus_.get();
@@ -216,7 +221,10 @@ class TabletPeer : public RefCountedThreadSafe<TabletPeer>,
 
   // Returns the minimum known log index that is in-memory or in-flight.
   // Used for selection of log segments to delete during Log GC.
-  CHECKED_STATUS GetEarliestNeededLogIndex(int64_t* log_index) const;
+  // If 'log_index_after_flush' is not null, it is set to the minimum index that would still be
+  // needed once the writes that are not flushed yet were flushed.
+  CHECKED_STATUS GetEarliestNeededLogIndex(int64_t* log_index,
+                                           int64_t* log_index_after_flush = nullptr) const;
 
   // Returns a map of log index -> segment size, of all the segments that currently cannot be GCed
   // because in-memory structures have anchors in them.
@@ -229,6 +237,12 @@ class TabletPeer : public RefCountedThreadSafe<TabletPeer>,
   // Returns a non-ok status if the tablet isn't running.
   CHECKED_STATUS GetGCableDataSize(int64_t* retention_size) const;
 
+  // Returns the amount of bytes that would become GCable if the tablet was flushed, i.e. the size
+  // of the segments that are retained only because of the writes that are not flushed yet.
+  //
+  // Returns a non-ok status if the tablet isn't running.
+  CHECKED_STATUS GetFlushableLogSize(int64_t* flushable_size) const;
+
   // Return a pointer to the Log.
   // TabletPeer keeps a reference to Log after Init().
   log::Log* log() const {
@@ -373,6 +387,9 @@ class TabletPeer : public RefCountedThreadSafe<TabletPeer>,
   mutable std::atomic<bool> cached_permanent_uuid_initialized_ { false };
   mutable std::string cached_permanent_uuid_;
 
+  // Hybrid time of the latest write operation received from the leader.
+  std::atomic<uint64_t> last_received_write_ht_{kMinHybridTimeValue};
+
  private:
   std::shared_future<client::YBClientPtr> client_future_;
 
@@ -0,0 +1,44 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+#ifndef YB_TABLET_TABLET_SPLITTER_H
+#define YB_TABLET_TABLET_SPLITTER_H
+
+#include "yb/util/status.h"
+
+namespace yb {
+
+namespace consensus {
+class ReplicateMsg;
+}
+
+namespace tablet {
+
+class Tablet;
+
+// Creates the tablets a tablet is split into. Implemented by the tablet server, which owns the
+// tablets hosted on it.
+class TabletSplitter {
+ public:
+  virtual ~TabletSplitter() {}
+
+  // Applies the committed SPLIT_OP 'replicate_msg' to 'tablet': creates the new tablets from a
+  // checkpoint of 'tablet' and marks 'tablet' as split. Must be idempotent, since the operation is
+  // applied again when it is replayed by the tablet bootstrap.
+  virtual CHECKED_STATUS ApplyTabletSplit(
+      Tablet* tablet, const consensus::ReplicateMsg& replicate_msg) = 0;
+};
+
+} // namespace tablet
+} // namespace yb
+
+#endif // YB_TABLET_TABLET_SPLITTER_H
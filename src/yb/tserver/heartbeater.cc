@@ -35,6 +35,7 @@
 #include <memory>
 #include <vector>
 #include <mutex>
+#include <unordered_map>
 
 #include <gflags/gflags.h>
 #include <glog/logging.h>
@@ -47,10 +48,12 @@
 #include "yb/master/master_rpc.h"
 #include "yb/server/server_base.proxy.h"
 #include "yb/server/webserver.h"
+#include "yb/tablet/tablet_metrics.h"
 #include "yb/tserver/tablet_server.h"
 #include "yb/tserver/tablet_server_options.h"
 #include "yb/tserver/ts_tablet_manager.h"
 #include "yb/util/flag_tags.h"
+#include "yb/util/metrics.h"
 #include "yb/util/monotime.h"
 #include "yb/util/net/net_util.h"
 #include "yb/util/status.h"
@@ -70,6 +73,12 @@ DEFINE_int32(heartbeat_max_failures_before_backoff, 3,
              "rather than retrying.");
 TAG_FLAG(heartbeat_max_failures_before_backoff, advanced);
 
+DEFINE_bool(heartbeat_report_tablet_load_metrics, true,
+            "Whether to include per-tablet SST sizes and read/write rates in the periodic "
+            "tserver metrics sent to the master. These are used by the load-aware mode of the "
+            "master load balancer.");
+TAG_FLAG(heartbeat_report_tablet_load_metrics, advanced);
+
 using google::protobuf::RepeatedPtrField;
 using yb::HostPortPB;
 using yb::consensus::RaftPeerPB;
@@ -134,6 +143,9 @@ class Heartbeater::Thread {
   CHECKED_STATUS TryHeartbeat();
   CHECKED_STATUS SetupRegistration(master::TSRegistrationPB* reg);
   void SetupCommonField(master::TSToMasterCommonPB* common);
+  void SetupTabletLoadMetrics(
+      const std::vector<scoped_refptr<tablet::TabletPeer>>& tablet_peers, double elapsed_sec,
+      master::TServerMetricsPB* metrics);
   bool IsCurrentThread() const;
 
   shared_ptr<const vector<HostPort>> get_master_addresses() {
@@ -196,6 +208,9 @@ class Heartbeater::Thread {
   uint64_t prev_reads_;
   uint64_t prev_writes_;
 
+  // Per-tablet total read and write ops at the last metrics submission, keyed by tablet id.
+  std::unordered_map<std::string, std::pair<uint64_t, uint64_t>> prev_tablet_ops_;
+
   DISALLOW_COPY_AND_ASSIGN(Thread);
 };
 
@@ -361,6 +376,42 @@ int Heartbeater::Thread::GetMillisUntilNextHeartbeat() const {
   return FLAGS_heartbeat_interval_ms;
 }
 
+void Heartbeater::Thread::SetupTabletLoadMetrics(
+    const std::vector<scoped_refptr<tablet::TabletPeer>>& tablet_peers, double elapsed_sec,
+    master::TServerMetricsPB* metrics) {
+  std::unordered_map<std::string, std::pair<uint64_t, uint64_t>> current_tablet_ops;
+  for (const auto& tablet_peer : tablet_peers) {
+    if (!tablet_peer) {
+      continue;
+    }
+    shared_ptr<tablet::TabletClass> tablet = tablet_peer->shared_tablet();
+    if (!tablet || !tablet->metrics()) {
+      continue;
+    }
+    const auto* tablet_metrics = tablet->metrics();
+    const uint64_t num_reads = tablet_metrics->ql_read_latency->TotalCount() +
+                               tablet_metrics->redis_read_latency->TotalCount();
+    const uint64_t num_writes =
+        tablet_metrics->write_op_duration_client_propagated_consistency->TotalCount() +
+        tablet_metrics->write_op_duration_commit_wait_consistency->TotalCount();
+
+    auto* tablet_load = metrics->add_tablet_metrics();
+    tablet_load->set_tablet_id(tablet_peer->tablet_id());
+    tablet_load->set_sst_file_size(tablet->GetTotalSSTFileSizes());
+
+    // Counters only grow, unless the tablet was re-opened, in which case we start over.
+    auto prev = prev_tablet_ops_.find(tablet_peer->tablet_id());
+    if (prev != prev_tablet_ops_.end() && elapsed_sec > 0 &&
+        num_reads >= prev->second.first && num_writes >= prev->second.second) {
+      tablet_load->set_read_ops_per_sec((num_reads - prev->second.first) / elapsed_sec);
+      tablet_load->set_write_ops_per_sec((num_writes - prev->second.second) / elapsed_sec);
+    }
+    current_tablet_ops.emplace(tablet_peer->tablet_id(), std::make_pair(num_reads, num_writes));
+  }
+  // Drops tablets that are no longer hosted here.
+  prev_tablet_ops_ = std::move(current_tablet_ops);
+}
+
 Status Heartbeater::Thread::TryHeartbeat() {
   master::TSHeartbeatRequestPB req;
 
@@ -430,6 +481,9 @@ Status Heartbeater::Thread::TryHeartbeat() {
     prev_writes_ = num_writes;
     req.mutable_metrics()->set_read_ops_per_sec(rops_per_sec);
     req.mutable_metrics()->set_write_ops_per_sec(wops_per_sec);
+    if (FLAGS_heartbeat_report_tablet_load_metrics) {
+      SetupTabletLoadMetrics(tablet_peers, div, req.mutable_metrics());
+    }
     prev_tserver_metrics_submission_ = MonoTime::Now();
 
     VLOG(4) << "Read Ops per second: " << rops_per_sec;
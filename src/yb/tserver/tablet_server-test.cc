@@ -32,6 +32,10 @@
 
 #include "yb/tserver/tablet_server-test-base.h"
 
+#include <atomic>
+#include <thread>
+
+#include "yb/common/ql_rowblock.h"
 #include "yb/consensus/log-test-base.h"
 #include "yb/gutil/strings/escaping.h"
 #include "yb/gutil/strings/substitute.h"
@@ -69,6 +73,11 @@ DECLARE_int32(metrics_retirement_age_ms);
 DECLARE_string(block_manager);
 DECLARE_string(rpc_bind_addresses);
 DECLARE_bool(disable_clock_sync_error);
+DECLARE_int32(read_pool_max_threads);
+DECLARE_int32(read_pool_max_queue_size);
+DECLARE_int32(read_pool_inject_latency_ms);
+DECLARE_int32(read_batch_parallelism);
+DECLARE_int32(read_batch_inject_latency_ms);
 
 // Declare these metrics prototypes for simpler unit testing of their behavior.
 METRIC_DECLARE_counter(rows_inserted);
@@ -1020,6 +1029,203 @@ TEST_F(TabletServerTest, TestDeleteTablet) {
   ASSERT_FALSE(mini_server_->server()->tablet_manager()->LookupTablet(kTabletId, &tablet));
 }
 
+TEST_F(TabletServerTest, TestSplitTablet) {
+  const char* const kNewTablet1Id = "test-tablet-child1";
+  const char* const kNewTablet2Id = "test-tablet-child2";
+
+  ASSERT_NO_FATALS(InsertTestRowsRemote(0, 1, 10));
+  const auto parent_data = tablet_peer_->tablet()->DocDBDumpStrInTest();
+
+  SplitTabletRequestPB req;
+  SplitTabletResponsePB resp;
+  RpcController rpc;
+
+  req.set_dest_uuid(mini_server_->server()->fs_manager()->uuid());
+  req.set_tablet_id(kTabletId);
+  req.set_new_tablet1_id(kNewTablet1Id);
+  req.set_new_tablet2_id(kNewTablet2Id);
+  req.set_split_partition_key(PartitionSchema::EncodeMultiColumnHashValue(0x8000));
+
+  {
+    SCOPED_TRACE(req.DebugString());
+    ASSERT_OK(admin_proxy_->SplitTablet(req, &resp, &rpc));
+    SCOPED_TRACE(resp.DebugString());
+    ASSERT_FALSE(resp.has_error());
+  }
+
+  ASSERT_TRUE(tablet_peer_->tablet_metadata()->has_been_split());
+  ASSERT_EQ((std::vector<string>{kNewTablet1Id, kNewTablet2Id}),
+            tablet_peer_->tablet_metadata()->split_child_tablet_ids());
+
+  // The new tablets are created from a checkpoint of the split tablet.
+  for (const char* tablet_id : {kNewTablet1Id, kNewTablet2Id}) {
+    ASSERT_OK(WaitForTabletRunning(tablet_id));
+    scoped_refptr<TabletPeer> tablet_peer;
+    ASSERT_TRUE(mini_server_->server()->tablet_manager()->LookupTablet(tablet_id, &tablet_peer));
+    ASSERT_EQ(kTabletId, tablet_peer->tablet_metadata()->split_parent_tablet_id());
+    ASSERT_EQ(parent_data, tablet_peer->tablet()->DocDBDumpStrInTest());
+  }
+
+  // Writes to the split tablet are rejected, so that the client sends them to the new tablets.
+  {
+    WriteRequestPB write_req;
+    WriteResponsePB write_resp;
+    RpcController controller;
+    write_req.set_tablet_id(kTabletId);
+    AddTestRowInsert(1234, 5678, "written after split", &write_req);
+    SCOPED_TRACE(write_req.DebugString());
+    ASSERT_OK(proxy_->Write(write_req, &write_resp, &controller));
+    SCOPED_TRACE(write_resp.DebugString());
+    ASSERT_TRUE(write_resp.has_error());
+    ASSERT_EQ(TabletServerErrorPB::TABLET_SPLIT, write_resp.error().code());
+  }
+
+  // The master retries the split request until it succeeds, so a repeated request succeeds as well.
+  {
+    rpc.Reset();
+    ASSERT_OK(admin_proxy_->SplitTablet(req, &resp, &rpc));
+    SCOPED_TRACE(resp.DebugString());
+    ASSERT_FALSE(resp.has_error());
+  }
+
+  // The split and the new tablets survive a restart.
+  ASSERT_OK(ShutdownAndRebuildTablet());
+  ASSERT_TRUE(tablet_peer_->tablet_metadata()->has_been_split());
+  for (const char* tablet_id : {kNewTablet1Id, kNewTablet2Id}) {
+    ASSERT_OK(WaitForTabletRunning(tablet_id));
+    scoped_refptr<TabletPeer> tablet_peer;
+    ASSERT_TRUE(mini_server_->server()->tablet_manager()->LookupTablet(tablet_id, &tablet_peer));
+    ASSERT_EQ(parent_data, tablet_peer->tablet()->DocDBDumpStrInTest());
+  }
+}
+
+TEST_F(TabletServerTest, TestReadPoolOverflow) {
+  constexpr int kNumReads = 5;
+
+  // A single read is served at a time, and two reads wait for it.
+  FLAGS_read_pool_max_threads = 1;
+  FLAGS_read_pool_max_queue_size = 2;
+  ASSERT_OK(ShutdownAndRebuildTablet());
+  FLAGS_read_pool_inject_latency_ms = 1000;
+
+  std::atomic<int> num_succeeded(0);
+  std::atomic<int> num_rejected(0);
+  std::vector<std::thread> threads;
+  for (int i = 0; i != kNumReads; ++i) {
+    threads.emplace_back([this, &num_succeeded, &num_rejected] {
+      ReadRequestPB req;
+      ReadResponsePB resp;
+      RpcController controller;
+      controller.set_timeout(MonoDelta::FromSeconds(30));
+      req.set_tablet_id(kTabletId);
+      Status s = proxy_->Read(req, &resp, &controller);
+      if (s.ok()) {
+        ASSERT_FALSE(resp.has_error()) << resp.ShortDebugString();
+        ++num_succeeded;
+      } else {
+        ASSERT_TRUE(s.IsRemoteError()) << s;
+        ASSERT_NE(nullptr, controller.error_response());
+        ASSERT_EQ(rpc::ErrorStatusPB::ERROR_SERVER_TOO_BUSY, controller.error_response()->code());
+        ++num_rejected;
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // The reads arrive faster than they are served, so the reads that do not fit into the queue are
+  // rejected.
+  ASSERT_EQ(kNumReads, num_succeeded + num_rejected);
+  ASSERT_GE(num_succeeded, 1);
+  ASSERT_GE(num_rejected, kNumReads - 3);
+}
+
+TEST_F(TabletServerTest, TestReadPoolSkipsExpiredRead) {
+  FLAGS_read_pool_max_threads = 1;
+  ASSERT_OK(ShutdownAndRebuildTablet());
+  FLAGS_read_pool_inject_latency_ms = 1000;
+
+  auto read = [this](MonoDelta timeout) {
+    ReadRequestPB req;
+    ReadResponsePB resp;
+    RpcController controller;
+    controller.set_timeout(timeout);
+    req.set_tablet_id(kTabletId);
+    return proxy_->Read(req, &resp, &controller);
+  };
+
+  // The first read occupies the only thread of the read pool, so the second one waits in the queue
+  // past its deadline.
+  std::thread slow_read([&read] {
+    ASSERT_OK(read(MonoDelta::FromSeconds(30)));
+  });
+  SleepFor(MonoDelta::FromMilliseconds(100));
+  ASSERT_TRUE(read(MonoDelta::FromMilliseconds(500)).IsTimedOut());
+
+  // The expired read is skipped, so the next read only waits for the first one.
+  const MonoTime start = MonoTime::Now();
+  ASSERT_OK(read(MonoDelta::FromSeconds(30)));
+  ASSERT_LT(MonoTime::Now().GetDeltaSince(start).ToMilliseconds(), 2000);
+  slow_read.join();
+}
+
+TEST_F(TabletServerTest, TestParallelBatchRead) {
+  constexpr int kNumReads = 8;
+  constexpr int kLatencyMs = 500;
+
+  InsertTestRowsDirect(0, kNumReads);
+  FLAGS_read_batch_parallelism = 4;
+  FLAGS_read_batch_inject_latency_ms = kLatencyMs;
+
+  // Each sub-request selects a single row by its value, in reverse order of keys.
+  ReadRequestPB req;
+  req.set_tablet_id(kTabletId);
+  for (int i = 0; i != kNumReads; ++i) {
+    auto* ql_req = req.add_ql_batch();
+    auto* condition = ql_req->mutable_where_expr()->mutable_condition();
+    condition->set_op(QLOperator::QL_OP_EQUAL);
+    condition->add_operands()->set_column_id(kFirstColumnId + 1);
+    condition->add_operands()->mutable_value()->set_int32_value((kNumReads - 1 - i) * 2);
+    auto* rsrow_desc = ql_req->mutable_rsrow_desc();
+    for (int idx = 0; idx != 2; ++idx) {
+      ql_req->mutable_column_refs()->add_ids(kFirstColumnId + idx);
+      ql_req->add_selected_exprs()->set_column_id(kFirstColumnId + idx);
+      const ColumnSchema& col = schema_.column(idx);
+      auto* rscol_desc = rsrow_desc->add_rscol_descs();
+      rscol_desc->set_name(col.name());
+      col.type()->ToQLTypePB(rscol_desc->mutable_ql_type());
+    }
+  }
+
+  ReadResponsePB resp;
+  RpcController controller;
+  controller.set_timeout(MonoDelta::FromSeconds(30));
+  const MonoTime start = MonoTime::Now();
+  ASSERT_OK(proxy_->Read(req, &resp, &controller));
+  const auto elapsed_ms = MonoTime::Now().GetDeltaSince(start).ToMilliseconds();
+  ASSERT_FALSE(resp.has_error()) << resp.ShortDebugString();
+
+  // Executed one after another, the sub-requests would take kNumReads * kLatencyMs.
+  ASSERT_LT(elapsed_ms, kNumReads * kLatencyMs / 2);
+
+  // The responses follow the order of the sub-requests.
+  ASSERT_EQ(kNumReads, resp.ql_batch_size());
+  const Schema projection({ schema_.column(0), schema_.column(1) }, 1);
+  for (int i = 0; i != kNumReads; ++i) {
+    const auto& ql_resp = resp.ql_batch(i);
+    ASSERT_EQ(QLResponsePB::YQL_STATUS_OK, ql_resp.status()) << ql_resp.ShortDebugString();
+    Slice data;
+    ASSERT_OK(controller.GetSidecar(ql_resp.rows_data_sidecar(), &data));
+    QLRowBlock rows(projection);
+    ASSERT_OK(rows.Deserialize(QLClient::YQL_CLIENT_CQL, &data));
+    ASSERT_EQ(1, rows.row_count()) << "Sub-request " << i;
+    const int key = kNumReads - 1 - i;
+    ASSERT_EQ(key, rows.row(0).column(0).int32_value());
+    ASSERT_EQ(key * 2, rows.row(0).column(1).int32_value());
+  }
+}
+
 TEST_F(TabletServerTest, TestDeleteTablet_TabletNotCreated) {
   DeleteTabletRequestPB req;
   DeleteTabletResponsePB resp;
@@ -33,6 +33,8 @@
 #include "yb/tserver/tablet_service.h"
 
 #include <algorithm>
+#include <atomic>
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -57,6 +59,7 @@
 #include "yb/tablet/tablet_metrics.h"
 
 #include "yb/tablet/operations/alter_schema_operation.h"
+#include "yb/tablet/operations/split_operation.h"
 #include "yb/tablet/operations/update_txn_operation.h"
 #include "yb/tablet/operations/write_operation.h"
 
@@ -64,6 +67,8 @@
 #include "yb/tserver/tablet_server.h"
 #include "yb/tserver/ts_tablet_manager.h"
 #include "yb/tserver/tserver.pb.h"
+#include "yb/util/continuous_profiler.h"
+#include "yb/util/countdown_latch.h"
 #include "yb/util/crc.h"
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/faststring.h"
@@ -107,6 +112,36 @@ DEFINE_int32(max_wait_for_safe_time_ms, 5000,
              "Maximum time in milliseconds to wait for the safe time to advance when trying to "
              "scan at the given hybrid_time.");
 
+DEFINE_int32(max_wait_for_follower_safe_time_ms, 100,
+             "Maximum time in milliseconds a follower waits for its safe time to catch up with the "
+             "staleness allowed by a bounded staleness read, before redirecting it to the leader.");
+TAG_FLAG(max_wait_for_follower_safe_time_ms, advanced);
+TAG_FLAG(max_wait_for_follower_safe_time_ms, runtime);
+
+DEFINE_int32(read_pool_max_threads, 128,
+             "Maximal number of threads serving tablet reads, which are created as needed. "
+             "0 - serve reads on the RPC service threads.");
+TAG_FLAG(read_pool_max_threads, advanced);
+
+DEFINE_int32(read_pool_max_queue_size, 5000,
+             "Maximal number of reads waiting for a thread of the read pool. Reads beyond it are "
+             "rejected as the server being too busy, so that the clients retry them later.");
+TAG_FLAG(read_pool_max_queue_size, advanced);
+
+DEFINE_test_flag(int32, read_pool_inject_latency_ms, 0,
+                 "How much latency to inject into each read served by the read pool.");
+TAG_FLAG(read_pool_inject_latency_ms, runtime);
+
+DEFINE_int32(read_batch_parallelism, 4,
+             "Maximal number of threads executing the sub-requests of a single batched read, "
+             "including the thread serving the read. 1 - execute them one after another.");
+TAG_FLAG(read_batch_parallelism, advanced);
+TAG_FLAG(read_batch_parallelism, runtime);
+
+DEFINE_test_flag(int32, read_batch_inject_latency_ms, 0,
+                 "How much latency to inject into each sub-request of a batched read.");
+TAG_FLAG(read_batch_inject_latency_ms, runtime);
+
 DEFINE_bool(tserver_noop_read_write, false, "Respond NOOP to read/write.");
 TAG_FLAG(tserver_noop_read_write, unsafe);
 TAG_FLAG(tserver_noop_read_write, hidden);
@@ -175,9 +210,55 @@ Status GetTabletRef(const scoped_refptr<TabletPeer>& tablet_peer,
     *error_code = TabletServerErrorPB::TABLET_NOT_RUNNING;
     return STATUS(IllegalState, "Tablet is not running");
   }
+  if (PREDICT_FALSE(tablet_peer->tablet_metadata()->has_been_split())) {
+    *error_code = TabletServerErrorPB::TABLET_SPLIT;
+    return STATUS(IllegalState, "Tablet has been split", tablet_peer->tablet_id());
+  }
   return Status::OK();
 }
 
+// Calls func(i) for every i in [0, count), on up to parallelism threads: the calling one and
+// helpers submitted to pool. The calling thread also picks items, so the call completes even when
+// the pool has no free thread, e.g. when it is itself running on a thread of the same pool.
+// Items are executed under the trace of the calling thread and tagged with tablet_id.
+void ParallelFor(ThreadPool* pool, size_t count, size_t parallelism, const std::string& tablet_id,
+                 const std::function<void(size_t)>& func) {
+  struct State {
+    explicit State(size_t count) : latch(count) {}
+
+    std::atomic<size_t> next_index{0};
+    CountDownLatch latch;
+  };
+  auto state = std::make_shared<State>(count);
+  Trace* trace = Trace::CurrentTrace();
+  // Helpers that start after all items were picked return without touching func, trace or
+  // tablet_id, which may already be destroyed by then.
+  auto worker = [state, count, &func, trace, &tablet_id]() {
+    for (;;) {
+      size_t index = state->next_index.fetch_add(1, std::memory_order_acq_rel);
+      if (index >= count) {
+        return;
+      }
+      {
+        ADOPT_TRACE(trace);
+        ScopedProfilingTag tablet_tag(ProfilingTag::kTablet, tablet_id);
+        if (PREDICT_FALSE(FLAGS_read_batch_inject_latency_ms > 0)) {
+          SleepFor(MonoDelta::FromMilliseconds(FLAGS_read_batch_inject_latency_ms));
+        }
+        func(index);
+      }
+      state->latch.CountDown();
+    }
+  };
+  for (size_t i = 1; i < std::min(parallelism, count); ++i) {
+    if (!pool->SubmitFunc(worker).ok()) {
+      break;
+    }
+  }
+  worker();
+  state->latch.Wait();
+}
+
 } // namespace
 
 // Prepares modification operation, checks limits, fetches tablet_peer and tablet etc.
@@ -486,6 +567,11 @@ static size_t GetMaxBatchSizeBytesHint(const ScanRequestPB* req) {
 TabletServiceImpl::TabletServiceImpl(TabletServerIf* server)
     : TabletServerServiceIf(server->MetricEnt()),
       server_(server) {
+  if (FLAGS_read_pool_max_threads > 0) {
+    CHECK_OK(ThreadPoolBuilder("read").set_max_threads(FLAGS_read_pool_max_threads)
+                                      .set_max_queue_size(FLAGS_read_pool_max_queue_size)
+                                      .Build(&read_pool_));
+  }
 }
 
 TabletServiceAdminImpl::TabletServiceAdminImpl(TabletServer* server)
@@ -562,6 +648,55 @@ void TabletServiceAdminImpl::AlterSchema(const AlterSchemaRequestPB* req,
       std::move(operation_state), consensus::LEADER));
 }
 
+void TabletServiceAdminImpl::SplitTablet(const SplitTabletRequestPB* req,
+                                         SplitTabletResponsePB* resp,
+                                         rpc::RpcContext context) {
+  if (!CheckUuidMatchOrRespond(server_->tablet_manager(), "SplitTablet", req, resp, &context)) {
+    return;
+  }
+  DVLOG(3) << "Received Split Tablet RPC: " << req->DebugString();
+
+  server::UpdateClock(*req, server_->Clock());
+
+  scoped_refptr<TabletPeer> tablet_peer;
+  if (!LookupTabletPeerOrRespond(server_->tablet_manager(), req->tablet_id(), resp, &context,
+                                 &tablet_peer)) {
+    return;
+  }
+
+  // If the split was already applied with the same new tablets, respond as succeeded, so that the
+  // master can retry the request.
+  const auto child_tablet_ids = tablet_peer->tablet_metadata()->split_child_tablet_ids();
+  if (!child_tablet_ids.empty()) {
+    if (child_tablet_ids.size() == 2 &&
+        child_tablet_ids[0] == req->new_tablet1_id() &&
+        child_tablet_ids[1] == req->new_tablet2_id()) {
+      context.RespondSuccess();
+    } else {
+      SetupErrorAndRespond(resp->mutable_error(),
+                           STATUS(IllegalState, "Tablet was split into different tablets"),
+                           TabletServerErrorPB::TABLET_SPLIT, &context);
+    }
+    return;
+  }
+
+  Status s = tablet::ValidateSplitRequest(*tablet_peer->tablet(), *req);
+  if (!s.ok()) {
+    SetupErrorAndRespond(resp->mutable_error(), s, TabletServerErrorPB::UNKNOWN_ERROR, &context);
+    return;
+  }
+
+  auto operation_state = std::make_unique<tablet::SplitOperationState>(
+      tablet_peer->tablet(), req);
+
+  operation_state->set_completion_callback(
+      MakeRpcOperationCompletionCallback(std::move(context), resp, server_->Clock()));
+
+  // Submit the split op. The RPC will be responded to asynchronously.
+  tablet_peer->Submit(std::make_unique<tablet::SplitOperation>(
+      std::move(operation_state), consensus::LEADER));
+}
+
 void TabletServiceImpl::UpdateTransaction(const UpdateTransactionRequestPB* req,
                                           UpdateTransactionResponsePB* resp,
                                           rpc::RpcContext context) {
@@ -793,6 +928,7 @@ void TabletServiceImpl::Write(const WriteRequestPB* req,
   operation_state->set_completion_callback(
       std::make_unique<WriteOperationCompletionCallback>(
           context_ptr, resp, operation_state.get(), server_->Clock(), req->include_trace()));
+  operation_state->set_sampled_trace(context_ptr->sampled_trace());
 
   auto status = tablet_peer->SubmitWrite(std::move(operation_state));
 
@@ -885,9 +1021,73 @@ bool TabletServiceImpl::GetTabletOrRespond(const ReadRequestPB* req,
   return true;
 }
 
+bool TabletServiceImpl::GetFollowerReadTimeOrRespond(const ReadRequestPB* req,
+                                                     ReadResponsePB* resp,
+                                                     rpc::RpcContext* context,
+                                                     ReadHybridTime* read_time) {
+  scoped_refptr<TabletPeer> tablet_peer;
+  if (!LookupTabletPeerOrRespond(server_->tablet_manager(), req->tablet_id(), resp, context,
+                                 &tablet_peer)) {
+    return false;
+  }
+  auto consensus = tablet_peer->shared_consensus();
+  auto tablet = tablet_peer->shared_tablet();
+  if (!consensus || !tablet ||
+      consensus->leader_status() == Consensus::LeaderStatus::LEADER_AND_READY) {
+    // The leader reads at its own safe time, that is always fresh enough.
+    return true;
+  }
+
+  auto now = server_->Clock()->Now().GetPhysicalValueMicros();
+  auto min_allowed = HybridTime::FromMicros(
+      now > req->max_staleness_us() ? now - req->max_staleness_us() : 0);
+  auto deadline = std::min(
+      context->GetClientDeadline(),
+      MonoTime::Now() + MonoDelta::FromMilliseconds(FLAGS_max_wait_for_follower_safe_time_ms));
+  auto safe_time = tablet->mvcc_manager()->SafeTimeForFollower(min_allowed, deadline);
+  if (safe_time < min_allowed) {
+    SetupErrorAndRespond(
+        resp->mutable_error(),
+        STATUS_FORMAT(TryAgain, "Follower safe time $0 is older than allowed $1",
+                      safe_time, min_allowed),
+        TabletServerErrorPB::STALE_FOLLOWER, context);
+    return false;
+  }
+  *read_time = ReadHybridTime::SingleTime(safe_time);
+  return true;
+}
+
 void TabletServiceImpl::Read(const ReadRequestPB* req,
                              ReadResponsePB* resp,
                              rpc::RpcContext context) {
+  if (read_pool_) {
+    auto context_ptr = std::make_shared<rpc::RpcContext>(std::move(context));
+    auto status = read_pool_->SubmitFunc([this, req, resp, context_ptr]() {
+      ADOPT_TRACE(context_ptr->trace());
+      if (context_ptr->GetClientDeadline() < MonoTime::Now()) {
+        TRACE("Skipping read since client already timed out");
+        context_ptr->RespondRpcFailure(
+            rpc::ErrorStatusPB::ERROR_SERVER_TOO_BUSY,
+            STATUS(TimedOut, "Read waited in the read pool queue past client deadline"));
+        return;
+      }
+      if (PREDICT_FALSE(FLAGS_read_pool_inject_latency_ms > 0)) {
+        SleepFor(MonoDelta::FromMilliseconds(FLAGS_read_pool_inject_latency_ms));
+      }
+      DoRead(req, resp, std::move(*context_ptr));
+    });
+    if (!status.ok()) {
+      // The queue of the pool is full or the pool is shut down, so the client retries the read.
+      context_ptr->RespondRpcFailure(rpc::ErrorStatusPB::ERROR_SERVER_TOO_BUSY, status);
+    }
+    return;
+  }
+  DoRead(req, resp, std::move(context));
+}
+
+void TabletServiceImpl::DoRead(const ReadRequestPB* req,
+                               ReadResponsePB* resp,
+                               rpc::RpcContext context) {
   if (FLAGS_tserver_noop_read_write) {
     context.RespondSuccess();
     return;
@@ -901,47 +1101,72 @@ void TabletServiceImpl::Read(const ReadRequestPB* req,
   if (!GetTabletOrRespond(req, resp, &context, &tablet)) {
     return;
   }
+  ScopedProfilingTag tablet_tag(ProfilingTag::kTablet, tablet->tablet_id());
+
+  auto read_time = ReadHybridTime::FromReadTimePB(*req);
+  if (req->consistency_level() == YBConsistencyLevel::CONSISTENT_PREFIX &&
+      req->has_max_staleness_us() && !req->has_read_time()) {
+    if (!GetFollowerReadTimeOrRespond(req, resp, &context, &read_time)) {
+      return;
+    }
+  }
 
   Status s;
-  tablet::ScopedReadOperation read_tx(tablet.get(), ReadHybridTime::FromReadTimePB(*req));
+  tablet::ScopedReadOperation read_tx(tablet.get(), read_time);
+  // Sub-requests of a batch are independent and all read at read_tx.read_time(), so they could be
+  // executed in parallel. Their results are then added to the response in the request order.
+  size_t parallelism = read_pool_ ? std::max(FLAGS_read_batch_parallelism, 1) : 1;
   switch (tablet->table_type()) {
     case TableType::REDIS_TABLE_TYPE: {
-      for (const RedisReadRequestPB& redis_read_req : req->redis_batch()) {
-        RedisResponsePB redis_response;
-        s = tablet->HandleRedisReadRequest(
+      const auto& redis_batch = req->redis_batch();
+      vector<Status> statuses(redis_batch.size());
+      vector<RedisResponsePB> redis_responses(redis_batch.size());
+      ParallelFor(
+          read_pool_.get(), redis_batch.size(), parallelism, tablet->tablet_id(), [&](size_t i) {
+        statuses[i] = tablet->HandleRedisReadRequest(
             read_tx.read_time(),
-            redis_read_req,
-            &redis_response);
-        RETURN_UNKNOWN_ERROR_IF_NOT_OK(s, resp, &context);
-        resp->add_redis_batch()->Swap(&redis_response);
+            redis_batch.Get(i),
+            &redis_responses[i]);
+      });
+      for (size_t i = 0; i != redis_responses.size(); ++i) {
+        RETURN_UNKNOWN_ERROR_IF_NOT_OK(statuses[i], resp, &context);
+        resp->add_redis_batch()->Swap(&redis_responses[i]);
       }
       break;
     }
     case TableType::YQL_TABLE_TYPE: {
-      for (const QLReadRequestPB& ql_read_req : req->ql_batch()) {
+      const auto& ql_batch = req->ql_batch();
+      const auto& remote_address = context.remote_address();
+      const auto remote_host = remote_address.address().to_string();
+      vector<Status> statuses(ql_batch.size());
+      vector<tablet::QLReadRequestResult> results(ql_batch.size());
+      TRACE("Start HandleQLReadRequest");
+      ParallelFor(
+          read_pool_.get(), ql_batch.size(), parallelism, tablet->tablet_id(), [&](size_t i) {
+        const QLReadRequestPB& ql_read_req = ql_batch.Get(i);
         // Update the remote endpoint.
-        const auto& remote_address = context.remote_address();
         HostPortPB *hostPortPB =
             const_cast<QLReadRequestPB&>(ql_read_req).mutable_remote_endpoint();
-        hostPortPB->set_host(remote_address.address().to_string());
+        hostPortPB->set_host(remote_host);
         hostPortPB->set_port(remote_address.port());
 
-        tablet::QLReadRequestResult result;
-        int rows_data_sidecar_idx = 0;
-        TRACE("Start HandleQLReadRequest");
-        s = tablet->HandleQLReadRequest(
+        statuses[i] = tablet->HandleQLReadRequest(
             read_tx.read_time(),
             ql_read_req,
             req->transaction(),
-            &result);
-        TRACE("Done HandleQLReadRequest");
-        RETURN_UNKNOWN_ERROR_IF_NOT_OK(s, resp, &context);
+            &results[i]);
+      });
+      TRACE("Done HandleQLReadRequest");
+      for (size_t i = 0; i != results.size(); ++i) {
+        RETURN_UNKNOWN_ERROR_IF_NOT_OK(statuses[i], resp, &context);
+        auto& result = results[i];
         if (result.restart_read_ht.is_valid()) {
           auto restart_read_time = resp->mutable_restart_read_time();
           restart_read_time->set_read_ht(result.restart_read_ht.ToUint64());
           restart_read_time->set_local_limit_ht(tablet->SafeTimestampToRead().ToUint64());
           // Global limit is ignored by caller, so we don't set it.
         } else {
+          int rows_data_sidecar_idx = 0;
           s = context.AddRpcSidecar(RefCntBuffer(result.rows_data), &rows_data_sidecar_idx);
           RETURN_UNKNOWN_ERROR_IF_NOT_OK(s, resp, &context);
           result.response.set_rows_data_sidecar(rows_data_sidecar_idx);
@@ -1232,6 +1457,29 @@ void ConsensusServiceImpl::StartRemoteBootstrap(const StartRemoteBootstrapReques
   context.RespondSuccess();
 }
 
+rpc::RpcPriority TabletServiceImpl::MethodPriority(const std::string& method_name) const {
+  // Transaction status resolution blocks reads and writes of other transactions.
+  if (method_name == "UpdateTransaction" || method_name == "GetTransactionStatus" ||
+      method_name == "AbortTransaction") {
+    return rpc::RpcPriority::kHigh;
+  }
+  // Scans and checksums are long running bulk work, that could wait for interactive requests.
+  if (method_name == "Scan" || method_name == "ScannerKeepAlive" || method_name == "Checksum") {
+    return rpc::RpcPriority::kLow;
+  }
+  return rpc::RpcPriority::kNormal;
+}
+
+rpc::RpcPriority ConsensusServiceImpl::MethodPriority(const std::string& method_name) const {
+  // Replication, leader leases and elections should keep going while the server is overloaded.
+  if (method_name == "UpdateConsensus" || method_name == "RequestConsensusVote" ||
+      method_name == "RunLeaderElection" || method_name == "LeaderElectionLost" ||
+      method_name == "LeaderStepDown") {
+    return rpc::RpcPriority::kHigh;
+  }
+  return rpc::RpcPriority::kNormal;
+}
+
 void TabletServiceImpl::ScannerKeepAlive(const ScannerKeepAliveRequestPB *req,
                                          ScannerKeepAliveResponsePB *resp,
                                          rpc::RpcContext context) {
@@ -1256,6 +1504,11 @@ void TabletServiceImpl::NoOp(const NoOpRequestPB *req,
   context.RespondSuccess();
 }
 
+bool TabletServiceImpl::IsInlineSafe(const std::string& method_name) const {
+  // The transaction status is served from the memory of the coordinator.
+  return method_name == "NoOp" || method_name == "GetTransactionStatus";
+}
+
 void TabletServiceImpl::Scan(const ScanRequestPB* req,
                              ScanResponsePB* resp,
                              rpc::RpcContext context) {
@@ -1474,6 +1727,11 @@ void TabletServiceImpl::ImportData(const ImportDataRequestPB* req,
 }
 
 void TabletServiceImpl::Shutdown() {
+  if (read_pool_) {
+    // Queued reads hold RPC contexts that have to be responded to, so they are not dropped.
+    read_pool_->Wait();
+    read_pool_->Shutdown();
+  }
 }
 
 // Extract a void* pointer suitable for use in a ColumnRangePredicate from the
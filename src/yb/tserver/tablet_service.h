@@ -42,6 +42,7 @@
 #include "yb/tserver/tablet_server_interface.h"
 #include "yb/tserver/tserver_admin.service.h"
 #include "yb/tserver/tserver_service.service.h"
+#include "yb/util/threadpool.h"
 
 namespace yb {
 class RowwiseIterator;
@@ -73,6 +74,10 @@ class TabletServiceImpl : public TabletServerServiceIf {
 
   void NoOp(const NoOpRequestPB* req, NoOpResponsePB* resp, rpc::RpcContext context) override;
 
+  bool IsInlineSafe(const std::string& method_name) const override;
+
+  rpc::RpcPriority MethodPriority(const std::string& method_name) const override;
+
   void ScannerKeepAlive(const ScannerKeepAliveRequestPB *req,
                         ScannerKeepAliveResponsePB *resp,
                         rpc::RpcContext context) override;
@@ -137,11 +142,22 @@ class TabletServiceImpl : public TabletServerServiceIf {
   CHECKED_STATUS CheckPeerIsReady(const tablet::TabletPeer& tablet_peer,
                                   TabletServerErrorPB::Code* error_code);
 
+  // Serves a read request, on a thread of read_pool_ if it is set.
+  void DoRead(const ReadRequestPB* req, ReadResponsePB* resp, rpc::RpcContext context);
+
   virtual bool GetTabletOrRespond(const ReadRequestPB* req,
                                   ReadResponsePB* resp,
                                   rpc::RpcContext* context,
                                   std::shared_ptr<tablet::AbstractTablet>* tablet);
 
+  // Picks the time to serve a bounded staleness read at, when this replica is a follower. Waits for
+  // the follower safe time to catch up with the allowed staleness for a bounded time, and responds
+  // with STALE_FOLLOWER if it does not. Leaves read_time unchanged on the leader.
+  virtual bool GetFollowerReadTimeOrRespond(const ReadRequestPB* req,
+                                            ReadResponsePB* resp,
+                                            rpc::RpcContext* context,
+                                            ReadHybridTime* read_time);
+
   template<class Req, class Resp>
   bool PrepareModify(const Req& req,
                      Resp* resp,
@@ -150,6 +166,10 @@ class TabletServiceImpl : public TabletServerServiceIf {
                      tablet::TabletPtr* tablet);
 
   TabletServerIf *const server_;
+
+  // Reads can block on disk I/O and on transaction status resolution, so they do not run on the
+  // RPC service threads, where they would delay the reads that are served from memory.
+  std::unique_ptr<ThreadPool> read_pool_;
 };
 
 class TabletServiceAdminImpl : public TabletServerAdminServiceIf {
@@ -167,6 +187,10 @@ class TabletServiceAdminImpl : public TabletServerAdminServiceIf {
                            AlterSchemaResponsePB* resp,
                            rpc::RpcContext context) override;
 
+  virtual void SplitTablet(const SplitTabletRequestPB* req,
+                           SplitTabletResponsePB* resp,
+                           rpc::RpcContext context) override;
+
  private:
   TabletServer* server_;
 };
@@ -218,6 +242,8 @@ class ConsensusServiceImpl : public consensus::ConsensusServiceIf {
                                     consensus::StartRemoteBootstrapResponsePB* resp,
                                     rpc::RpcContext context) override;
 
+  rpc::RpcPriority MethodPriority(const std::string& method_name) const override;
+
  private:
   TabletPeerLookupIf* tablet_manager_;
 };
@@ -32,6 +32,7 @@
 
 #include "yb/tserver/ts_tablet_manager.h"
 
+#include <algorithm>
 #include <string>
 
 #include <gtest/gtest.h>
@@ -43,6 +44,7 @@
 #include "yb/consensus/consensus.pb.h"
 #include "yb/fs/fs_manager.h"
 #include "yb/master/master.pb.h"
+#include "yb/tablet/local_tablet_writer.h"
 #include "yb/tablet/tablet_peer.h"
 #include "yb/tablet/tablet-test-util.h"
 #include "yb/tserver/mini_tablet_server.h"
@@ -57,6 +59,7 @@
   ASSERT_NO_FATALS(AssertMonotonicReportSeqno(report_seqno, tablet_report))
 
 DECLARE_bool(pretend_memory_exceeded_enforce_flush);
+DECLARE_int64(memstore_flush_age_weight_bytes_per_sec);
 
 namespace yb {
 namespace tserver {
@@ -95,14 +98,15 @@ class TsTabletManagerTest : public YBTest {
 
   Status CreateNewTablet(const std::string& tablet_id,
                          const Schema& schema,
-                         scoped_refptr<tablet::TabletPeer>* out_tablet_peer) {
+                         scoped_refptr<tablet::TabletPeer>* out_tablet_peer,
+                         TableType table_type = TableType::DEFAULT_TABLE_TYPE) {
     Schema full_schema = SchemaBuilder(schema).Build();
     std::pair<PartitionSchema, Partition> partition = tablet::CreateDefaultPartition(full_schema);
 
     scoped_refptr<tablet::TabletPeer> tablet_peer;
     RETURN_NOT_OK(
       tablet_manager_->CreateNewTablet(tablet_id, tablet_id, partition.second, tablet_id,
-        TableType::DEFAULT_TABLE_TYPE, full_schema, partition.first, config_, &tablet_peer));
+        table_type, full_schema, partition.first, config_, &tablet_peer));
     if (out_tablet_peer) {
       (*out_tablet_peer) = tablet_peer;
     }
@@ -187,6 +191,54 @@ TEST_F(TsTabletManagerTest, TestProperBackgroundFlushOnStartup) {
   }
 }
 
+TEST_F(TsTabletManagerTest, TestFlushPicksLargestMemTable) {
+  FlagSaver flag_saver;
+
+  const Schema schema({ ColumnSchema("key", INT32, false, true), ColumnSchema("val", INT32) }, 1);
+  const std::vector<std::pair<std::string, int>> tablets_rows = {
+      {"small-tablet", 10}, {"large-tablet", 1000}, {"medium-tablet", 100}};
+  std::vector<scoped_refptr<TabletPeer>> peers;
+  for (const auto& tablet_rows : tablets_rows) {
+    scoped_refptr<TabletPeer> peer;
+    ASSERT_OK(CreateNewTablet(tablet_rows.first, schema, &peer, TableType::YQL_TABLE_TYPE));
+    tablet::LocalTabletWriter writer(peer->tablet());
+    for (int i = 0; i != tablet_rows.second; ++i) {
+      QLWriteRequestPB req;
+      req.set_type(QLWriteRequestPB::QL_STMT_INSERT);
+      req.add_hashed_column_values()->mutable_value()->set_int32_value(i);
+      auto* column_value = req.add_column_values();
+      column_value->set_column_id(kFirstColumnId + 1);
+      column_value->mutable_expr()->mutable_value()->set_int32_value(i);
+      ASSERT_OK(writer.Write(&req));
+    }
+    peers.push_back(peer);
+  }
+
+  // Only the age of the memtables could outweigh their size, so it is not taken into account.
+  FLAGS_memstore_flush_age_weight_bytes_per_sec = 0;
+  uint64_t flushing_bytes = 0;
+  auto candidates = tablet_manager_->GetFlushCandidates(&flushing_bytes);
+  ASSERT_EQ(tablets_rows.size(), candidates.size());
+  auto best = std::max_element(
+      candidates.begin(), candidates.end(),
+      [](const TSTabletManager::FlushCandidate& lhs, const TSTabletManager::FlushCandidate& rhs) {
+        return lhs.score < rhs.score;
+      });
+  ASSERT_EQ("large-tablet", best->tablet->tablet_id());
+
+  // When the memory is pretended to be exceeded, a single flush is enough, and it should be the
+  // flush of the tablet with the largest memtable.
+  FLAGS_pretend_memory_exceeded_enforce_flush = true;
+  tablet_manager_->MaybeFlushTablet();
+  auto is_flushed = [](const scoped_refptr<TabletPeer>& peer) {
+    return peer->tablet()->flush_stats()->oldest_write_in_memstore() == HybridTime::kMax;
+  };
+  ASSERT_OK(WaitFor([&peers, &is_flushed] { return is_flushed(peers[1]); },
+                    MonoDelta::FromSeconds(10), "Flush large tablet"));
+  ASSERT_FALSE(is_flushed(peers[0]));
+  ASSERT_FALSE(is_flushed(peers[2]));
+}
+
 static void AssertMonotonicReportSeqno(int64_t* report_seqno,
                                        const TabletReportPB &report) {
   ASSERT_LT(*report_seqno, report.sequence_number());
@@ -265,6 +317,18 @@ TEST_F(TsTabletManagerTest, TestTabletReports) {
   ASSERT_MONOTONIC_REPORT_SEQNO(&seqno, report);
   tablet_manager_->MarkTabletReportAcknowledged(report);
 
+  // The master now knows the consensus state of tablet-1, so incremental reports leave it out
+  // until it changes.
+  tablet_manager_->MarkTabletDirty("tablet-1", std::make_shared<consensus::StateChangeContext>(
+      consensus::StateChangeReason::TABLET_PEER_STARTED));
+  tablet_manager_->GenerateIncrementalTabletReport(&report);
+  ASSERT_EQ(1, report.updated_tablets().size());
+  ASSERT_EQ("tablet-1", report.updated_tablets(0).tablet_id());
+  ASSERT_FALSE(report.updated_tablets(0).has_committed_consensus_state())
+      << report.ShortDebugString();
+  ASSERT_MONOTONIC_REPORT_SEQNO(&seqno, report);
+  tablet_manager_->MarkTabletReportAcknowledged(report);
+
   // Create a second tablet, and ensure the incremental report shows it.
   ASSERT_OK(CreateNewTablet("tablet-2", schema_, nullptr));
 
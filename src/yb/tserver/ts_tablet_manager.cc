@@ -56,11 +56,14 @@
 
 #include "yb/gutil/strings/substitute.h"
 #include "yb/gutil/strings/util.h"
+#include "yb/gutil/walltime.h"
 
 #include "yb/master/master.pb.h"
 #include "yb/master/sys_catalog.h"
 
+#include "yb/rocksdb/background_work_scheduler.h"
 #include "yb/rocksdb/memory_monitor.h"
+#include "yb/rocksdb/rate_limiter.h"
 
 #include "yb/rpc/messenger.h"
 
@@ -155,6 +158,38 @@ DEFINE_int32(db_block_cache_size_percentage, 50,
              "Default percentage of total available memory to use as block cache size, if not "
              "asking for a raw number, through FLAGS_db_block_cache_size_bytes.");
 
+DEFINE_int32(memstore_proactive_flush_percentage, 90,
+             "Percentage of the global memstore size at which tablets start being flushed, so "
+             "that the memstore does not fill up.");
+TAG_FLAG(memstore_proactive_flush_percentage, advanced);
+DEFINE_int32(memstore_flush_target_percentage, 75,
+             "Percentage of the global memstore size that memstore usage is brought down to, by "
+             "flushing as many tablets at once as needed.");
+TAG_FLAG(memstore_flush_target_percentage, advanced);
+DEFINE_int32(memstore_flush_log_retention_weight, 25,
+             "Weight, in percent of the memtable size, of the WAL bytes retained by a tablet when "
+             "choosing the tablets to flush.");
+TAG_FLAG(memstore_flush_log_retention_weight, advanced);
+DEFINE_int64(memstore_flush_age_weight_bytes_per_sec, 64 * 1024,
+             "Bytes added to the flush score of a tablet per second of age of the oldest write in "
+             "its memtable, so that small memtables are flushed eventually as well.");
+TAG_FLAG(memstore_flush_age_weight_bytes_per_sec, advanced);
+
+DEFINE_bool(use_priority_background_work_scheduler, true,
+            "Run the flushes and compactions of all the tablets on shared threads, the work of "
+            "the tablets closest to stalling writes first, instead of in the order it was "
+            "requested.");
+TAG_FLAG(use_priority_background_work_scheduler, advanced);
+
+DEFINE_int64(node_compact_flush_rate_limit_bytes_per_sec, 0,
+             "Limit of the total write rate of the flushes and compactions of all the tablets. "
+             "0 - no node-wide limit, each tablet is limited by "
+             "rocksdb_compact_flush_rate_limit_bytes_per_sec instead.");
+TAG_FLAG(node_compact_flush_rate_limit_bytes_per_sec, advanced);
+
+DECLARE_int32(rocksdb_max_background_flushes);
+DECLARE_int32(rocksdb_max_background_compactions);
+
 DEFINE_test_flag(int32, sleep_after_tombstoning_tablet_secs, 0,
                  "Whether we sleep in LogAndTombstone after calling DeleteTabletData.");
 
@@ -167,6 +202,22 @@ DEFINE_int32(tserver_yb_client_default_timeout_ms, kTServerYbClientDefaultTimeou
 namespace yb {
 namespace tserver {
 
+METRIC_DEFINE_counter(server, memstore_flushes_scheduled, "Memstore Flushes Scheduled",
+                      MetricUnit::kOperations,
+                      "Number of tablet flushes scheduled to keep the global memstore size under "
+                      "its limit.");
+
+METRIC_DEFINE_counter(server, memstore_flushes_over_limit, "Memstore Flushes Over Limit",
+                      MetricUnit::kOperations,
+                      "Number of times tablets were chosen to flush when the global memstore was "
+                      "already full, i.e. proactive flushes did not keep up with writes.");
+
+METRIC_DEFINE_histogram(server, memstore_flush_batch_size, "Memstore Flush Batch Size",
+                        MetricUnit::kUnits,
+                        "Number of tablets flushed at once to keep the global memstore size under "
+                        "its limit.",
+                        10000, 2);
+
 METRIC_DEFINE_histogram(server, op_apply_queue_length, "Operation Apply Queue Length",
                         MetricUnit::kTasks,
                         "Number of operations waiting to be applied to the tablet. "
@@ -217,37 +268,86 @@ using tserver::RemoteBootstrapClient;
 
 // Only called from the background task to ensure it's synchronized
 void TSTabletManager::MaybeFlushTablet() {
-  int iteration = 0;
-  while (memory_monitor()->Exceeded() ||
-         (iteration++ == 0 && FLAGS_pretend_memory_exceeded_enforce_flush)) {
-    scoped_refptr<TabletPeer> tablet_to_flush = TabletToFlush();
-    // TODO(bojanserafimov): If tablet_to_flush flushes now because of other reasons,
-    // we will schedule a second flush, which will unnecessarily stall writes for a short time. This
-    // will not happen often, but should be fixed.
-    if (tablet_to_flush) {
-      WARN_NOT_OK(tablet_to_flush->tablet()->Flush(tablet::FlushMode::kAsync),
-          Substitute("Flush failed on $0", tablet_to_flush->tablet_id()));
+  if (!memory_monitor()->Exceeded() && !FLAGS_pretend_memory_exceeded_enforce_flush) {
+    return;
+  }
+  const size_t memory_usage = memory_monitor()->memory_usage();
+  const bool over_limit = memory_usage >= memstore_limit_bytes_;
+
+  uint64_t flushing_bytes = 0;
+  std::vector<FlushCandidate> candidates = GetFlushCandidates(&flushing_bytes);
+  // Memtables that are being flushed are still counted by the memory monitor, but they will be
+  // released without flushing more tablets.
+  const uint64_t target_bytes =
+      memstore_limit_bytes_ * FLAGS_memstore_flush_target_percentage / 100;
+  int64_t bytes_to_release = static_cast<int64_t>(memory_usage) -
+                             static_cast<int64_t>(flushing_bytes + target_bytes);
+  if (FLAGS_pretend_memory_exceeded_enforce_flush) {
+    bytes_to_release = std::max<int64_t>(bytes_to_release, 1);
+  }
+  if (bytes_to_release <= 0 || candidates.empty()) {
+    return;
+  }
+
+  std::sort(candidates.begin(), candidates.end(),
+            [](const FlushCandidate& lhs, const FlushCandidate& rhs) {
+              return lhs.score > rhs.score;
+            });
+  size_t num_flushes = 0;
+  for (const auto& candidate : candidates) {
+    if (bytes_to_release <= 0) {
+      break;
     }
+    WARN_NOT_OK(candidate.tablet->Flush(tablet::FlushMode::kAsync),
+                Substitute("Flush failed on $0", candidate.tablet->tablet_id()));
+    bytes_to_release -= candidate.mutable_bytes;
+    ++num_flushes;
+  }
+
+  memstore_flushes_scheduled_->IncrementBy(num_flushes);
+  memstore_flush_batch_size_->Increment(num_flushes);
+  if (over_limit) {
+    memstore_flushes_over_limit_->Increment();
   }
+  VLOG(1) << Format("Memstore uses $0 of $1 bytes, $2 bytes are being flushed, flushing $3 of "
+                    "$4 tablets", memory_usage, memstore_limit_bytes_, flushing_bytes, num_flushes,
+                    candidates.size());
 }
 
-// Return the tablet with the oldest write in memstore, or nullptr if all
-// tablet memstores are empty or about to flush.
-scoped_refptr<TabletPeer> TSTabletManager::TabletToFlush() {
-  boost::shared_lock<rw_spinlock> lock(lock_); // For using the tablet map
-  HybridTime oldest_write_in_memstores = HybridTime::kMax;
-  scoped_refptr<TabletPeer> tablet_to_flush;
-  for (const TabletMap::value_type& entry : tablet_map_) {
-    const auto tablet = entry.second->shared_tablet();
-    if (tablet) {
-      const HybridTime oldest_write_in_memstore = tablet->flush_stats()->oldest_write_in_memstore();
-      if (oldest_write_in_memstore < oldest_write_in_memstores) {
-        oldest_write_in_memstores = oldest_write_in_memstore;
-        tablet_to_flush = entry.second;
-      }
+std::vector<TSTabletManager::FlushCandidate> TSTabletManager::GetFlushCandidates(
+    uint64_t* flushing_bytes) {
+  std::vector<scoped_refptr<TabletPeer>> peers;
+  GetTabletPeers(&peers);
+  const MicrosecondsInt64 now = GetCurrentTimeMicros();
+  std::vector<FlushCandidate> result;
+  *flushing_bytes = 0;
+  for (const auto& peer : peers) {
+    auto tablet = peer->shared_tablet();
+    if (!tablet) {
+      continue;
     }
-  }
-  return tablet_to_flush;
+    uint64_t mutable_bytes = 0;
+    uint64_t total_bytes = 0;
+    tablet->GetMemTableMemoryUsage(&mutable_bytes, &total_bytes);
+    *flushing_bytes += total_bytes - std::min(mutable_bytes, total_bytes);
+    const HybridTime oldest_write = tablet->flush_stats()->oldest_write_in_memstore();
+    if (oldest_write == HybridTime::kMax || mutable_bytes == 0) {
+      continue;
+    }
+
+    // A flush also lets the WAL segments retained only for the memtable be garbage collected.
+    int64_t flushable_log_bytes = 0;
+    if (!peer->GetFlushableLogSize(&flushable_log_bytes).ok()) {
+      flushable_log_bytes = 0;
+    }
+    const double age_sec =
+        std::max<MicrosecondsInt64>(now - oldest_write.GetPhysicalValueMicros(), 0) / 1e6;
+    const double score = mutable_bytes +
+                         flushable_log_bytes * FLAGS_memstore_flush_log_retention_weight / 100.0 +
+                         age_sec * FLAGS_memstore_flush_age_weight_bytes_per_sec;
+    result.push_back(FlushCandidate{std::move(tablet), mutable_bytes, score});
+  }
+  return result;
 }
 
 TSTabletManager::TSTabletManager(FsManager* fs_manager,
@@ -263,6 +363,8 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
         FLAGS_tserver_yb_client_default_timeout_ms / 1000, "" /* tserver_uuid */,
         &server->options(), server->metric_entity()) {
 
+  tablet_options_.tablet_splitter = this;
+
   CHECK_OK(ThreadPoolBuilder("apply").Build(&apply_pool_));
   apply_pool_->SetQueueLengthHistogram(
       METRIC_op_apply_queue_length.Instantiate(server_->metric_entity()));
@@ -289,6 +391,15 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
     tablet_options_.block_cache->SetMetrics(server_->metric_entity());
   }
 
+  if (FLAGS_use_priority_background_work_scheduler) {
+    tablet_options_.background_work_scheduler.reset(rocksdb::NewBackgroundWorkScheduler(
+        FLAGS_rocksdb_max_background_flushes, FLAGS_rocksdb_max_background_compactions));
+  }
+  if (FLAGS_node_compact_flush_rate_limit_bytes_per_sec > 0) {
+    tablet_options_.rate_limiter.reset(
+        rocksdb::NewGenericRateLimiter(FLAGS_node_compact_flush_rate_limit_bytes_per_sec));
+  }
+
   // Calculate memstore_size_bytes
   bool should_count_memory = FLAGS_global_memstore_size_percentage > 0;
   CHECK(FLAGS_global_memstore_size_percentage > 0 && FLAGS_global_memstore_size_percentage <= 100)
@@ -303,6 +414,19 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
                                    static_cast<size_t>(FLAGS_global_memstore_size_mb_max << 20));
   }
 
+  CHECK(FLAGS_memstore_proactive_flush_percentage > 0 &&
+        FLAGS_memstore_proactive_flush_percentage <= 100)
+      << "Flag memstore_proactive_flush_percentage must be between 0 and 100. Current value: "
+      << FLAGS_memstore_proactive_flush_percentage;
+  memstore_limit_bytes_ = memstore_size_bytes;
+
+  memstore_flushes_scheduled_ =
+      METRIC_memstore_flushes_scheduled.Instantiate(server_->metric_entity());
+  memstore_flushes_over_limit_ =
+      METRIC_memstore_flushes_over_limit.Instantiate(server_->metric_entity());
+  memstore_flush_batch_size_ =
+      METRIC_memstore_flush_batch_size.Instantiate(server_->metric_entity());
+
   // Add memory monitor and background thread for flushing
   if (should_count_memory) {
     background_task_.reset(new BackgroundTask(
@@ -310,8 +434,9 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
       "tablet manager",
       "flush scheduler bgtask",
       std::chrono::milliseconds(FLAGS_flush_background_task_interval_msec)));
+    // The monitor calls back at the proactive flush threshold, before the memstore is full.
     tablet_options_.memory_monitor = std::make_shared<rocksdb::MemoryMonitor>(
-        memstore_size_bytes,
+        memstore_size_bytes * FLAGS_memstore_proactive_flush_percentage / 100,
         std::function<void()>([this](){
                                 YB_WARN_NOT_OK(background_task_->Wake(), "Wakeup error"); }));
   }
@@ -667,6 +792,151 @@ Status TSTabletManager::StartRemoteBootstrap(const StartRemoteBootstrapRequestPB
   return Status::OK();
 }
 
+// Splits the tablet into the two tablets listed in the split request. The split could be applied
+// again after a restart, either during bootstrap or because it was interrupted, so the tablets that
+// were already created are kept and a split recorded in the metadata is not repeated.
+Status TSTabletManager::ApplyTabletSplit(tablet::Tablet* tablet,
+                                         const consensus::ReplicateMsg& replicate_msg) {
+  const auto& request = replicate_msg.split_request();
+  scoped_refptr<TabletMetadata> meta = tablet->metadata();
+  const string kLogPrefix = LogPrefix(meta->tablet_id(), fs_manager_->uuid());
+
+  if (meta->has_been_split()) {
+    LOG(INFO) << kLogPrefix << "Tablet has already been split";
+    return Status::OK();
+  }
+
+  LOG(INFO) << kLogPrefix << "Splitting tablet: " << request.ShortDebugString();
+
+  // The new tablets are created from a checkpoint, so all the data written before the split has to
+  // be flushed first.
+  RETURN_NOT_OK_PREPEND(tablet->Flush(tablet::FlushMode::kSync),
+                        "Unable to flush tablet before splitting it");
+
+  gscoped_ptr<ConsensusMetadata> cmeta;
+  RETURN_NOT_OK(ConsensusMetadata::Load(fs_manager_, meta->tablet_id(), fs_manager_->uuid(),
+                                        &cmeta));
+
+  PartitionPB partition_pb;
+  meta->partition().ToPB(&partition_pb);
+  Partition partition1, partition2;
+  partition_pb.set_partition_key_end(request.split_partition_key());
+  Partition::FromPB(partition_pb, &partition1);
+  meta->partition().ToPB(&partition_pb);
+  partition_pb.set_partition_key_start(request.split_partition_key());
+  Partition::FromPB(partition_pb, &partition2);
+
+  RETURN_NOT_OK(CreateTabletFromSplit(tablet, request.new_tablet1_id(), partition1,
+                                      cmeta->committed_config(), cmeta->current_term(),
+                                      replicate_msg));
+  RETURN_NOT_OK(CreateTabletFromSplit(tablet, request.new_tablet2_id(), partition2,
+                                      cmeta->committed_config(), cmeta->current_term(),
+                                      replicate_msg));
+
+  meta->set_split_child_tablet_ids({request.new_tablet1_id(), request.new_tablet2_id()});
+  RETURN_NOT_OK(meta->Flush());
+
+  MarkTabletDirty(meta->tablet_id(), std::make_shared<consensus::StateChangeContext>(
+      consensus::StateChangeReason::TABLET_SPLIT));
+  LOG(INFO) << kLogPrefix << "Tablet split into " << request.new_tablet1_id() << " and "
+            << request.new_tablet2_id();
+  return Status::OK();
+}
+
+Status TSTabletManager::CreateTabletFromSplit(tablet::Tablet* parent,
+                                              const string& tablet_id,
+                                              const Partition& partition,
+                                              const RaftConfigPB& config,
+                                              int64_t current_term,
+                                              const consensus::ReplicateMsg& replicate_msg) {
+  scoped_refptr<TabletMetadata> parent_meta = parent->metadata();
+  const string kLogPrefix = LogPrefix(tablet_id, fs_manager_->uuid());
+
+  scoped_refptr<TabletPeer> existing_peer;
+  if (LookupTablet(tablet_id, &existing_peer)) {
+    if (existing_peer->tablet_metadata()->tablet_data_state() == TABLET_DATA_READY) {
+      // The split was interrupted after this tablet was created.
+      return Status::OK();
+    }
+    // The split was interrupted while this tablet was created, so it was tombstoned on startup.
+    // Remove it completely, so that it can be created again.
+    LOG(INFO) << kLogPrefix << "Deleting incomplete tablet left by an interrupted split";
+    boost::optional<TabletServerErrorPB::Code> error_code;
+    RETURN_NOT_OK(DeleteTablet(tablet_id, TABLET_DATA_DELETED, boost::none, &error_code));
+    RETURN_NOT_OK(existing_peer->tablet_metadata()->DeleteSuperBlock());
+  }
+
+  scoped_refptr<TransitionInProgressDeleter> deleter;
+  {
+    std::lock_guard<rw_spinlock> lock(lock_);
+    RETURN_NOT_OK(StartTabletStateTransitionUnlocked(tablet_id, "splitting tablet", &deleter));
+  }
+
+  // The checkpoint consists of hard links, so the new tablet has to use the same data directory as
+  // the split one.
+  const string data_root_dir = parent_meta->data_root_dir();
+  const string wal_root_dir = parent_meta->wal_root_dir();
+  RegisterDataAndWalDir(fs_manager_, parent_meta->table_id(), tablet_id,
+                        parent_meta->table_type(), data_root_dir, wal_root_dir);
+
+  // The tablet stays in TABLET_DATA_COPYING state until it is complete, so that it is tombstoned on
+  // startup if the tablet server crashes in the meantime.
+  scoped_refptr<TabletMetadata> meta;
+  Status s = TabletMetadata::CreateNew(fs_manager_,
+                                       parent_meta->table_id(),
+                                       tablet_id,
+                                       parent_meta->table_name(),
+                                       parent_meta->table_type(),
+                                       parent_meta->schema(),
+                                       parent_meta->partition_schema(),
+                                       partition,
+                                       TABLET_DATA_COPYING,
+                                       &meta,
+                                       data_root_dir,
+                                       wal_root_dir);
+  if (!s.ok()) {
+    UnregisterDataWalDir(parent_meta->table_id(), tablet_id, parent_meta->table_type(),
+                         data_root_dir, wal_root_dir);
+  }
+  RETURN_NOT_OK_PREPEND(s, "Couldn't create tablet metadata");
+  meta->SetSchema(parent_meta->schema(), parent_meta->schema_version());
+  meta->set_split_parent_tablet_id(parent_meta->tablet_id());
+  RETURN_NOT_OK(meta->Flush());
+
+  RETURN_NOT_OK(parent->CreateCheckpoint(meta->rocksdb_dir()));
+
+  // The log of the new tablet starts with the split operation, so that the first operation
+  // replicated to the new tablet follows the last one applied to the data of the split tablet.
+  {
+    scoped_refptr<Log> log;
+    RETURN_NOT_OK(Log::Open(log::LogOptions(), fs_manager_, tablet_id, meta->wal_dir(),
+                            meta->schema(), meta->schema_version(), nullptr /* metric_entity */,
+                            &log));
+    log::LogEntryPB entry;
+    entry.set_type(log::REPLICATE);
+    auto* replicate = entry.mutable_replicate();
+    replicate->CopyFrom(replicate_msg);
+    *replicate->mutable_committed_op_id() = replicate_msg.id();
+    RETURN_NOT_OK(log->Append(&entry));
+    RETURN_NOT_OK(log->Close());
+  }
+
+  gscoped_ptr<ConsensusMetadata> cmeta;
+  RETURN_NOT_OK_PREPEND(ConsensusMetadata::Create(fs_manager_, tablet_id, fs_manager_->uuid(),
+                                                  config, current_term, &cmeta),
+                        "Unable to create new ConsensusMeta for tablet " + tablet_id);
+
+  meta->set_tablet_data_state(TABLET_DATA_READY);
+  RETURN_NOT_OK(meta->Flush());
+  LOG(INFO) << kLogPrefix << "Created tablet from split of " << parent_meta->tablet_id()
+            << ", partition: "
+            << meta->partition_schema().PartitionDebugString(partition, meta->schema());
+
+  CreateAndRegisterTabletPeer(meta, NEW_PEER);
+  return open_tablet_pool_->SubmitFunc(
+      std::bind(&TSTabletManager::OpenTablet, this, meta, deleter));
+}
+
 // Create and register a new TabletPeer, given tablet metadata.
 scoped_refptr<TabletPeer> TSTabletManager::CreateAndRegisterTabletPeer(
     const scoped_refptr<TabletMetadata>& meta, RegisterTabletPeerMode mode) {
@@ -1082,6 +1352,7 @@ void TSTabletManager::InitLocalRaftPeerPB() {
 
 void TSTabletManager::CreateReportedTabletPB(const string& tablet_id,
                                              const scoped_refptr<TabletPeer>& tablet_peer,
+                                             const ReportedConsensusState* last_reported,
                                              ReportedTabletPB* reported_tablet) {
   reported_tablet->set_tablet_id(tablet_id);
   reported_tablet->set_state(tablet_peer->state());
@@ -1095,8 +1366,14 @@ void TSTabletManager::CreateReportedTabletPB(const string& tablet_id,
   // We cannot get consensus state information unless the TabletPeer is running.
   scoped_refptr<consensus::Consensus> consensus = tablet_peer->shared_consensus();
   if (consensus) {
-    *reported_tablet->mutable_committed_consensus_state() =
-        consensus->ConsensusState(consensus::CONSENSUS_CONFIG_COMMITTED);
+    auto* cstate = reported_tablet->mutable_committed_consensus_state();
+    *cstate = consensus->ConsensusState(consensus::CONSENSUS_CONFIG_COMMITTED);
+    if (last_reported != nullptr && reported_tablet->state() == tablet::RUNNING &&
+        cstate->current_term() == last_reported->current_term &&
+        cstate->config().opid_index() == last_reported->config_opid_index &&
+        cstate->leader_uuid() == last_reported->leader_uuid) {
+      reported_tablet->clear_committed_consensus_state();
+    }
   }
 }
 
@@ -1110,7 +1387,9 @@ void TSTabletManager::GenerateIncrementalTabletReport(TabletReportPB* report) {
     scoped_refptr<TabletPeer>* tablet_peer = FindOrNull(tablet_map_, tablet_id);
     if (tablet_peer) {
       // Dirty entry, report on it.
-      CreateReportedTabletPB(tablet_id, *tablet_peer, report->add_updated_tablets());
+      CreateReportedTabletPB(tablet_id, *tablet_peer,
+                             FindOrNull(reported_consensus_states_, tablet_id),
+                             report->add_updated_tablets());
     } else {
       // Removed.
       report->add_removed_tablet_ids(tablet_id);
@@ -1124,7 +1403,8 @@ void TSTabletManager::GenerateFullTabletReport(TabletReportPB* report) {
   report->set_is_incremental(false);
   report->set_sequence_number(next_report_seq_++);
   for (const TabletMap::value_type& entry : tablet_map_) {
-    CreateReportedTabletPB(entry.first, entry.second, report->add_updated_tablets());
+    CreateReportedTabletPB(entry.first, entry.second, nullptr /* last_reported */,
+                           report->add_updated_tablets());
   }
   dirty_tablets_.clear();
 }
@@ -1149,6 +1429,23 @@ void TSTabletManager::MarkTabletReportAcknowledged(const TabletReportPB& report)
       ++it;
     }
   }
+
+  // Remember what the master now knows about the consensus state of the reported tablets.
+  if (!report.is_incremental()) {
+    reported_consensus_states_.clear();
+  }
+  for (const ReportedTabletPB& reported_tablet : report.updated_tablets()) {
+    if (reported_tablet.state() != tablet::RUNNING) {
+      reported_consensus_states_.erase(reported_tablet.tablet_id());
+    } else if (reported_tablet.has_committed_consensus_state()) {
+      const auto& cstate = reported_tablet.committed_consensus_state();
+      reported_consensus_states_[reported_tablet.tablet_id()] = ReportedConsensusState{
+          cstate.current_term(), cstate.config().opid_index(), cstate.leader_uuid()};
+    }
+  }
+  for (const string& tablet_id : report.removed_tablet_ids()) {
+    reported_consensus_states_.erase(tablet_id);
+  }
 }
 
 Status TSTabletManager::HandleNonReadyTabletOnStartup(const scoped_refptr<TabletMetadata>& meta) {
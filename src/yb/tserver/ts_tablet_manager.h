@@ -57,7 +57,9 @@
 #include "yb/util/metrics.h"
 #include "yb/util/status.h"
 #include "yb/util/threadpool.h"
+#include "yb/tablet/tablet_fwd.h"
 #include "yb/tablet/tablet_options.h"
+#include "yb/tablet/tablet_splitter.h"
 
 namespace yb {
 
@@ -124,7 +126,7 @@ class TransitionInProgressDeleter;
 // TODO: will also be responsible for keeping the local metadata about
 // which tablets are hosted on this server persistent on disk, as well
 // as re-opening all the tablets at startup, etc.
-class TSTabletManager : public tserver::TabletPeerLookupIf {
+class TSTabletManager : public tserver::TabletPeerLookupIf, public tablet::TabletSplitter {
  public:
   // Construct the tablet manager.
   // 'fs_manager' must remain valid until this object is destructed.
@@ -204,7 +206,9 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
   // Generate an incremental tablet report.
   //
   // This will report any tablets which have changed since the last acknowleged
-  // tablet report. Once the report is successfully transferred, call
+  // tablet report. The committed consensus state of a running tablet is only
+  // included if it changed since it was last acknowledged, as the master already
+  // knows it otherwise. Once the report is successfully transferred, call
   // MarkTabletReportAcknowledged() to clear the incremental state. Otherwise, the
   // next tablet report will continue to include the same tablets until one
   // is acknowleged.
@@ -273,11 +277,21 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
 
   MemoryMonitor* memory_monitor() { return tablet_options_.memory_monitor.get(); }
 
+  rocksdb::BackgroundWorkScheduler* background_work_scheduler() {
+    return tablet_options_.background_work_scheduler.get();
+  }
+
   // Flush some tablet if the memstore memory limit is exceeded
   void MaybeFlushTablet();
 
+  // Creates the tablets 'tablet' is split into, using a checkpoint of its RocksDB, and registers
+  // and opens them. Called when the split operation is applied, on every replica of 'tablet'.
+  CHECKED_STATUS ApplyTabletSplit(
+      tablet::Tablet* tablet, const consensus::ReplicateMsg& replicate_msg) override;
+
  private:
   FRIEND_TEST(TsTabletManagerTest, TestPersistBlocks);
+  FRIEND_TEST(TsTabletManagerTest, TestFlushPicksLargestMemTable);
 
   // Flag specified when registering a TabletPeer.
   enum RegisterTabletPeerMode {
@@ -294,6 +308,15 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
   };
   typedef std::unordered_map<std::string, TabletReportState> DirtyMap;
 
+  // The parts of the committed consensus state of a tablet that the master acts upon, as last
+  // acknowledged by the master.
+  struct ReportedConsensusState {
+    int64_t current_term;
+    int64_t config_opid_index;
+    std::string leader_uuid;
+  };
+  typedef std::unordered_map<std::string, ReportedConsensusState> ReportedConsensusStateMap;
+
   // Returns Status::OK() iff state_ == MANAGER_RUNNING.
   CHECKED_STATUS CheckRunningUnlocked(boost::optional<TabletServerErrorPB::Code>* error_code) const;
 
@@ -350,9 +373,12 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
       const scoped_refptr<tablet::TabletMetadata>& meta,
       RegisterTabletPeerMode mode);
 
-  // Helper to generate the report for a single tablet.
+  // Helper to generate the report for a single tablet. If 'last_reported' is not null, the
+  // committed consensus state is left out of the report if the tablet is running and its state
+  // matches 'last_reported'.
   void CreateReportedTabletPB(const std::string& tablet_id,
                               const scoped_refptr<tablet::TabletPeer>& tablet_peer,
+                              const ReportedConsensusState* last_reported,
                               master::ReportedTabletPB* reported_tablet);
 
   // Mark that the provided TabletPeer's state has changed. That should be taken into
@@ -366,8 +392,27 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
   // TABLET_DATA_READY state. Generally, we tombstone the replica.
   CHECKED_STATUS HandleNonReadyTabletOnStartup(const scoped_refptr<tablet::TabletMetadata>& meta);
 
-  // Return the tablet with oldest write still in its memstore
-  scoped_refptr<tablet::TabletPeer> TabletToFlush();
+  // Creates one of the tablets 'parent' is split into, covering 'partition'. The new tablet
+  // starts with a checkpoint of the data of 'parent' and a log that contains only the split
+  // operation 'replicate_msg', and uses the same Raft config as 'parent'.
+  CHECKED_STATUS CreateTabletFromSplit(tablet::Tablet* parent,
+                                       const std::string& tablet_id,
+                                       const Partition& partition,
+                                       const consensus::RaftConfigPB& config,
+                                       int64_t current_term,
+                                       const consensus::ReplicateMsg& replicate_msg);
+
+  struct FlushCandidate {
+    std::shared_ptr<tablet::TabletClass> tablet;
+    uint64_t mutable_bytes;
+    // The higher the score, the sooner the tablet should be flushed. Weighs the memory the flush
+    // would release, the WAL retention it would end, and the age of the memtable.
+    double score;
+  };
+
+  // Returns the tablets that have writes in their mutable memtable, and the memory of the
+  // memtables that are already being flushed in 'flushing_bytes'.
+  std::vector<FlushCandidate> GetFlushCandidates(uint64_t* flushing_bytes);
 
   TSTabletManagerStatePB state() const {
     boost::shared_lock<rw_spinlock> lock(lock_);
@@ -393,7 +438,7 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
                              std::unordered_map<std::string, std::unordered_set<std::string>>>
     TableDiskAssignmentMap;
 
-  // Lock protecting tablet_map_, dirty_tablets_, state_, and
+  // Lock protecting tablet_map_, dirty_tablets_, reported_consensus_states_, state_, and
   // transition_in_progress_.
   mutable rw_spinlock lock_;
 
@@ -414,6 +459,10 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
   // reported to the master, an entry is added to this map.
   DirtyMap dirty_tablets_;
 
+  // Consensus state of the running tablets as of the last acknowledged tablet report, used to
+  // leave unchanged consensus states out of incremental reports.
+  ReportedConsensusStateMap reported_consensus_states_;
+
   // Next tablet report seqno.
   int32_t next_report_seq_;
 
@@ -430,6 +479,12 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
   // Used for scheduling flushes
   std::unique_ptr<BackgroundTask> background_task_;
 
+  // Size of the global memstore, flushes start at memstore_proactive_flush_percentage of it.
+  size_t memstore_limit_bytes_ = 0;
+  scoped_refptr<Counter> memstore_flushes_scheduled_;
+  scoped_refptr<Counter> memstore_flushes_over_limit_;
+  scoped_refptr<Histogram> memstore_flush_batch_size_;
+
   // For block cache and memory monitor shared across tablets
   tablet::TabletOptions tablet_options_;
 
@@ -46,6 +46,7 @@
 #include "yb/gutil/strings/join.h"
 #include "yb/gutil/strings/numbers.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/rocksdb/background_work_scheduler.h"
 #include "yb/server/webui_util.h"
 #include "yb/tablet/maintenance_manager.h"
 #include "yb/tablet/tablet.pb.h"
@@ -114,6 +115,10 @@ Status TabletServerPathHandlers::Register(Webserver* server) {
       "/maintenance-manager", "",
       std::bind(&TabletServerPathHandlers::HandleMaintenanceManagerPage, this, _1, _2),
       true /* styled */, false /* is_on_nav_bar */);
+  server->RegisterPathHandler(
+      "/background-work", "",
+      std::bind(&TabletServerPathHandlers::HandleBackgroundWorkPage, this, _1, _2),
+      true /* styled */, false /* is_on_nav_bar */);
 
   return Status::OK();
 }
@@ -498,6 +503,9 @@ void TabletServerPathHandlers::HandleDashboardsPage(const Webserver::WebRequest&
   *output << GetDashboardLine("maintenance-manager", "Maintenance Manager",
                               "List of operations that are currently running and those "
                               "that are registered.");
+  *output << GetDashboardLine("background-work", "Flushes and Compactions",
+                              "List of flushes and compactions that are currently running and "
+                              "those that are queued, in the order they will run.");
 }
 
 string TabletServerPathHandlers::GetDashboardLine(const std::string& link,
@@ -509,6 +517,28 @@ string TabletServerPathHandlers::GetDashboardLine(const std::string& link,
                     EscapeForHtmlToString(desc));
 }
 
+void TabletServerPathHandlers::HandleBackgroundWorkPage(const Webserver::WebRequest& req,
+                                                        std::stringstream* output) {
+  auto* scheduler = tserver_->tablet_manager()->background_work_scheduler();
+  *output << "<h1>Flushes and compactions</h1>\n";
+  if (scheduler == nullptr) {
+    *output << "Each tablet schedules its own flushes and compactions, see "
+            << "--use_priority_background_work_scheduler.\n";
+    return;
+  }
+  *output << "<table class='table table-striped'>\n";
+  *output << "  <tr><th>State</th><th>Type</th><th>Priority</th><th>RocksDB</th></tr>\n";
+  for (const auto& info : scheduler->GetWorkInfos()) {
+    *output << Substitute("  <tr><td>$0</td><td>$1</td><td>$2</td><td>$3</td></tr>\n",
+                          info.running ? "running" : "queued",
+                          info.type == rocksdb::BackgroundWorkType::kFlush ? "flush"
+                                                                           : "compaction",
+                          info.priority,
+                          EscapeForHtmlToString(info.description));
+  }
+  *output << "</table>\n";
+}
+
 void TabletServerPathHandlers::HandleMaintenanceManagerPage(const Webserver::WebRequest& req,
                                                             std::stringstream* output) {
   MaintenanceManager* manager = tserver_->maintenance_manager();
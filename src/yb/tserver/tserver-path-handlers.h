@@ -79,6 +79,8 @@ class TabletServerPathHandlers {
                                  std::stringstream* output);
   void HandleDashboardsPage(const Webserver::WebRequest& req,
                             std::stringstream* output);
+  void HandleBackgroundWorkPage(const Webserver::WebRequest& req,
+                                std::stringstream* output);
   void HandleMaintenanceManagerPage(const Webserver::WebRequest& req,
                                     std::stringstream* output);
   std::string ConsensusStatePBToHtml(const consensus::ConsensusStatePB& cstate) const;
@@ -0,0 +1,154 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/continuous_profiler.h"
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include "yb/gutil/strings/util.h"
+#include "yb/util/countdown_latch.h"
+#include "yb/util/debug-util.h"
+#include "yb/util/test_util.h"
+
+DECLARE_int32(continuous_profiling_frequency_hz);
+DECLARE_int32(continuous_profiling_contention_sample_interval);
+
+namespace yb {
+
+class ContinuousProfilerTest : public YBTest {
+ protected:
+  void TearDown() override {
+    StopContinuousProfiling();
+    YBTest::TearDown();
+  }
+
+  std::vector<std::string> FoldedProfile(ProfileType type) {
+    std::stringstream out;
+    WriteFoldedProfile(type, 1, &out);
+    std::vector<std::string> result;
+    std::string line;
+    while (std::getline(out, line)) {
+      result.push_back(line);
+    }
+    return result;
+  }
+
+  int64_t TaggedCpuSamples(const std::string& method) {
+    int64_t result = 0;
+    for (const auto& line : FoldedProfile(ProfileType::kCpu)) {
+      if (HasPrefixString(line, "method:" + method + ";")) {
+        result += std::stoll(line.substr(line.rfind(' ') + 1));
+      }
+    }
+    return result;
+  }
+};
+
+void BusyLoop(MonoDelta duration) {
+  auto deadline = MonoTime::Now() + duration;
+  while (MonoTime::Now() < deadline) {
+  }
+}
+
+#if defined(__linux__)
+
+TEST_F(ContinuousProfilerTest, Cpu) {
+  FLAGS_continuous_profiling_frequency_hz = 100;
+  ASSERT_OK(StartContinuousProfiling());
+
+  const std::string method = "CpuTestMethod";
+  {
+    ScopedProfilingTag method_tag(ProfilingTag::kMethod, method);
+    BusyLoop(MonoDelta::FromSeconds(1));
+  }
+  RotateContinuousProfile();
+
+  ASSERT_GT(TaggedCpuSamples(method), 0);
+}
+
+// Samples should be taken on the thread that uses CPU, not on the idle main thread.
+TEST_F(ContinuousProfilerTest, CpuOfBusyThread) {
+  FLAGS_continuous_profiling_frequency_hz = 100;
+
+  const std::string busy_method = "BusyThreadMethod";
+  const std::string idle_method = "IdleMainThreadMethod";
+  CountDownLatch started(1);
+  CountDownLatch profiling(1);
+  std::thread busy_thread([&] {
+    ScopedProfilingTag method_tag(ProfilingTag::kMethod, busy_method);
+    started.CountDown();
+    profiling.Wait();
+    BusyLoop(MonoDelta::FromSeconds(1));
+  });
+  started.Wait();
+  ASSERT_OK(StartContinuousProfiling());
+  {
+    ScopedProfilingTag method_tag(ProfilingTag::kMethod, idle_method);
+    profiling.CountDown();
+    busy_thread.join();
+  }
+  RotateContinuousProfile();
+
+  ASSERT_GT(TaggedCpuSamples(busy_method), 10);
+  ASSERT_EQ(0, TaggedCpuSamples(idle_method));
+}
+
+TEST_F(ContinuousProfilerTest, Contention) {
+  FLAGS_continuous_profiling_contention_sample_interval = 1;
+  ASSERT_OK(StartContinuousProfiling());
+
+  const std::string method = "ContentionTestMethod";
+  const std::string tablet = "test-tablet";
+  {
+    ScopedProfilingTag method_tag(ProfilingTag::kMethod, method);
+    ASSERT_TRUE(ShouldSampleContention());
+    StackTrace stack;
+    stack.Collect();
+    AddContentionSample(stack, 1000);
+    {
+      ScopedProfilingTag tablet_tag(ProfilingTag::kTablet, tablet);
+      AddContentionSample(stack, 2000);
+    }
+    AddContentionSample(stack, 3000);
+  }
+  RotateContinuousProfile();
+
+  int method_lines = 0;
+  int tablet_lines = 0;
+  for (const auto& line : FoldedProfile(ProfileType::kContention)) {
+    if (HasPrefixString(line, "method:" + method + ";tablet:" + tablet + ";")) {
+      ASSERT_TRUE(HasSuffixString(line, " 2000")) << line;
+      ++tablet_lines;
+    } else if (HasPrefixString(line, "method:" + method + ";")) {
+      ASSERT_TRUE(HasSuffixString(line, " 4000")) << line;
+      ++method_lines;
+    }
+  }
+  ASSERT_EQ(1, method_lines);
+  ASSERT_EQ(1, tablet_lines);
+
+  // The latest window only contains samples added after the previous rotation.
+  RotateContinuousProfile();
+  for (const auto& line : FoldedProfile(ProfileType::kContention)) {
+    ASSERT_FALSE(HasPrefixString(line, "method:" + method + ";")) << line;
+  }
+}
+
+#endif // defined(__linux__)
+
+} // namespace yb
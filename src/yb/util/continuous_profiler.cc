@@ -0,0 +1,588 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/continuous_profiler.h"
+
+#include <dirent.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <time.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "yb/gutil/hash/city.h"
+#include "yb/gutil/macros.h"
+#include "yb/gutil/spinlock.h"
+#include "yb/gutil/stringprintf.h"
+#include "yb/util/countdown_latch.h"
+#include "yb/util/debug-util.h"
+#include "yb/util/errno.h"
+#include "yb/util/flag_tags.h"
+#include "yb/util/logging.h"
+#include "yb/util/monotime.h"
+#include "yb/util/thread.h"
+
+DEFINE_bool(enable_continuous_profiling, true,
+            "Continuously sample CPU and lock contention stacks of the server and keep the latest "
+            "windows of samples for /profilez.");
+TAG_FLAG(enable_continuous_profiling, advanced);
+
+DEFINE_int32(continuous_profiling_frequency_hz, 19,
+             "Number of CPU samples taken by the continuous profiler per second of CPU time of "
+             "each thread. An odd value avoids sampling in lockstep with periodic activity.");
+TAG_FLAG(continuous_profiling_frequency_hz, advanced);
+
+DEFINE_int32(continuous_profiling_window_secs, 60,
+             "Duration of a window of samples kept by the continuous profiler.");
+TAG_FLAG(continuous_profiling_window_secs, advanced);
+
+DEFINE_int32(continuous_profiling_max_windows, 10,
+             "Number of the latest windows of samples kept by the continuous profiler.");
+TAG_FLAG(continuous_profiling_max_windows, advanced);
+TAG_FLAG(continuous_profiling_max_windows, runtime);
+
+DEFINE_int32(continuous_profiling_contention_sample_interval, 16,
+             "The continuous profiler samples one of every this number of lock contention events "
+             "of a thread.");
+TAG_FLAG(continuous_profiling_contention_sample_interval, advanced);
+TAG_FLAG(continuous_profiling_contention_sample_interval, runtime);
+
+// GLog already implements symbolization. Just import their hidden symbol.
+namespace google {
+// Symbolizes a program counter.  On success, returns true and write the
+// symbol name to "out".  The symbol name is demangled if possible
+// (supports symbols generated by GCC 3.x or newer).  Otherwise,
+// returns false.
+bool Symbolize(void *pc, char *out, int out_size);
+}
+
+namespace yb {
+
+namespace {
+
+const char* const kProfilingTagNames[] = {"method", "tablet"};
+static_assert(arraysize(kProfilingTagNames) == kProfilingTagMapSize,
+              "Each profiling tag should have a name");
+
+__thread const std::string* profiling_tags[kProfilingTagMapSize];
+
+// Set while the current thread adds a sample, so a CPU sample signal delivered meanwhile does not
+// reenter the unwinder and the sample table.
+__thread bool adding_sample = false;
+
+__thread uint32_t contention_events = 0;
+
+// Linear-probing hashtable of samples with a fixed number of entries, similar to ContentionStacks
+// in spinlock_profiling.cc. Entries are only try-locked by writers, so samples could be added from
+// a signal handler, and a sample is dropped instead of waiting when its entries are busy.
+class SampleTable {
+ public:
+  struct Sample {
+    StackTrace trace;
+    std::array<std::string, kProfilingTagMapSize> tags;
+    std::array<int64_t, kProfileTypeMapSize> values;
+  };
+
+  // Adds a sample of the current thread attributed to its current profiling tags.
+  void Add(const StackTrace& trace, ProfileType type, int64_t value);
+
+  // Moves samples collected so far to 'out' and returns the number of dropped samples.
+  int64_t Flush(std::vector<Sample>* out);
+
+ private:
+  enum {
+    kNumEntries = 1024,
+    kNumLinearProbeAttempts = 4,
+    // Longer tag values are truncated.
+    kMaxTagSize = 64
+  };
+
+  struct Entry {
+    // Protects all other fields.
+    base::SpinLock lock;
+
+    // If false, the entry is unclaimed and the other fields are not valid.
+    bool used = false;
+
+    // A cached hashcode of the trace and tags.
+    uint64_t hash;
+
+    StackTrace trace;
+    char tags[kProfilingTagMapSize][kMaxTagSize];
+    size_t tag_sizes[kProfilingTagMapSize];
+    int64_t values[kProfileTypeMapSize];
+  };
+
+  Entry entries_[kNumEntries];
+
+  std::atomic<int64_t> dropped_samples_{0};
+};
+
+void SampleTable::Add(const StackTrace& trace, ProfileType type, int64_t value) {
+  const char* tags[kProfilingTagMapSize];
+  size_t tag_sizes[kProfilingTagMapSize];
+  uint64_t hash = trace.HashCode();
+  for (size_t i = 0; i != kProfilingTagMapSize; ++i) {
+    const std::string* tag = profiling_tags[i];
+    tags[i] = tag ? tag->data() : "";
+    tag_sizes[i] = tag ? std::min<size_t>(tag->size(), kMaxTagSize) : 0;
+    hash = util_hash::CityHash64WithSeed(tags[i], tag_sizes[i], hash);
+  }
+
+  for (size_t attempt = 0; attempt != kNumLinearProbeAttempts; ++attempt) {
+    Entry& entry = entries_[(hash + attempt) % kNumEntries];
+    if (!entry.lock.TryLock()) {
+      continue;
+    }
+
+    if (!entry.used) {
+      entry.used = true;
+      entry.hash = hash;
+      entry.trace.CopyFrom(trace);
+      for (size_t i = 0; i != kProfilingTagMapSize; ++i) {
+        memcpy(entry.tags[i], tags[i], tag_sizes[i]);
+        entry.tag_sizes[i] = tag_sizes[i];
+      }
+      std::fill_n(entry.values, kProfileTypeMapSize, 0);
+    } else {
+      bool same = entry.hash == hash && entry.trace.Equals(trace);
+      for (size_t i = 0; same && i != kProfilingTagMapSize; ++i) {
+        same = entry.tag_sizes[i] == tag_sizes[i] &&
+               memcmp(entry.tags[i], tags[i], tag_sizes[i]) == 0;
+      }
+      if (!same) {
+        entry.lock.Unlock();
+        continue;
+      }
+    }
+
+    entry.values[util::to_underlying(type)] += value;
+    entry.lock.Unlock();
+    return;
+  }
+
+  dropped_samples_.fetch_add(1, std::memory_order_relaxed);
+}
+
+int64_t SampleTable::Flush(std::vector<Sample>* out) {
+  for (auto& entry : entries_) {
+    base::SpinLockHolder lock(&entry.lock);
+    if (!entry.used) {
+      continue;
+    }
+
+    out->emplace_back();
+    auto& sample = out->back();
+    sample.trace.CopyFrom(entry.trace);
+    for (size_t i = 0; i != kProfilingTagMapSize; ++i) {
+      sample.tags[i].assign(entry.tags[i], entry.tag_sizes[i]);
+    }
+    std::copy_n(entry.values, kProfileTypeMapSize, sample.values.begin());
+    entry.used = false;
+  }
+  return dropped_samples_.exchange(0, std::memory_order_relaxed);
+}
+
+class ContinuousProfiler {
+ public:
+  CHECKED_STATUS Start();
+  void Stop();
+  void Rotate();
+  void Write(ProfileType type, size_t num_windows, std::ostream* out);
+
+  SampleTable& table() {
+    return table_;
+  }
+
+ private:
+  struct Window {
+    MonoTime end;
+    std::vector<SampleTable::Sample> samples;
+    int64_t dropped_samples;
+  };
+
+  void RunThread();
+
+#if defined(__linux__)
+  // Arms a CPU timer for each thread of the process that does not have one yet, and deletes timers
+  // of exited threads.
+  void UpdateThreadTimersUnlocked();
+#endif
+
+  SampleTable table_;
+
+  // Protects all fields below.
+  std::mutex mutex_;
+  std::deque<Window> windows_;
+  scoped_refptr<Thread> thread_;
+  std::unique_ptr<CountDownLatch> stop_latch_;
+#if defined(__linux__)
+  struct itimerspec timer_spec_;
+  // CPU timers of threads, by thread id.
+  std::unordered_map<pid_t, timer_t> timers_;
+#endif
+};
+
+ContinuousProfiler* Profiler() {
+  static ContinuousProfiler* profiler = new ContinuousProfiler();
+  return profiler;
+}
+
+// Profiler which samples are submitted to, null while the profiler is not running.
+std::atomic<ContinuousProfiler*> g_running_profiler{nullptr};
+
+#if defined(__linux__)
+
+// Older glibc does not name the thread id field of sigevent.
+#ifndef sigev_notify_thread_id
+#define sigev_notify_thread_id _sigev_un._tid
+#endif
+
+// Realtime signal used for CPU samples. SIGPROF is left to the gperftools profiler behind
+// /pprof/profile.
+int ProfilingSignal() {
+  return SIGRTMIN + 2;
+}
+
+// Returns the CPU time clock of the thread with the given id, encoded the same way as by
+// pthread_getcpuclockid. That function needs a pthread_t, which is not known for threads listed in
+// /proc.
+clockid_t ThreadCpuClock(pid_t tid) {
+  // CPUCLOCK_PERTHREAD_MASK | CPUCLOCK_SCHED in the low bits, the inverted thread id above them.
+  return static_cast<clockid_t>((~static_cast<uint32_t>(tid) << 3) | 6);
+}
+
+void HandleProfilingSignal(int signum, siginfo_t* info, void* context) {
+  auto* profiler = g_running_profiler.load(std::memory_order_acquire);
+  if (!profiler || adding_sample) {
+    return;
+  }
+  int old_errno = errno;
+  adding_sample = true;
+  StackTrace stack;
+  // Skip Collect() and this handler.
+  stack.Collect(2);
+  profiler->table().Add(stack, ProfileType::kCpu, 1);
+  adding_sample = false;
+  errno = old_errno;
+}
+
+// The handler stays installed once the profiler was started, so a signal delivered after the timer
+// was deleted does not terminate the process. Since the timers only expire while their threads use
+// CPU, the signal rarely arrives during a blocking system call, and with SA_RESTART most of those
+// are restarted. The calls that are not, e.g. epoll_wait in libev and nanosleep in SleepFor, are
+// retried on EINTR by their callers, as are the file reads and writes of Env.
+CHECKED_STATUS InstallSignalHandler() {
+  struct sigaction old_act;
+  if (sigaction(ProfilingSignal(), nullptr, &old_act) != 0) {
+    return STATUS(RuntimeError, "Failed to read profiling signal handler", ErrnoToString(errno),
+                  errno);
+  }
+  if (old_act.sa_sigaction == &HandleProfilingSignal) {
+    return Status::OK();
+  }
+  if (old_act.sa_handler != SIG_DFL && old_act.sa_handler != SIG_IGN) {
+    return STATUS_FORMAT(IllegalState, "Signal $0 is already in use", ProfilingSignal());
+  }
+
+  struct sigaction act;
+  memset(&act, 0, sizeof(act));
+  act.sa_sigaction = &HandleProfilingSignal;
+  act.sa_flags = SA_SIGINFO | SA_RESTART;
+  sigemptyset(&act.sa_mask);
+  if (sigaction(ProfilingSignal(), &act, nullptr) != 0) {
+    return STATUS(RuntimeError, "Failed to install profiling signal handler",
+                  ErrnoToString(errno), errno);
+  }
+  return Status::OK();
+}
+
+#endif // defined(__linux__)
+
+Status ContinuousProfiler::Start() {
+#if defined(__linux__)
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (thread_) {
+    return Status::OK();
+  }
+  if (FLAGS_continuous_profiling_frequency_hz <= 0) {
+    return STATUS_FORMAT(InvalidArgument, "Invalid continuous profiling frequency: $0",
+                         FLAGS_continuous_profiling_frequency_hz);
+  }
+
+  RETURN_NOT_OK(InstallSignalHandler());
+
+  const int64_t period_nanos =
+      MonoTime::kNanosecondsPerSecond / FLAGS_continuous_profiling_frequency_hz;
+  timer_spec_.it_interval.tv_sec = period_nanos / MonoTime::kNanosecondsPerSecond;
+  timer_spec_.it_interval.tv_nsec = period_nanos % MonoTime::kNanosecondsPerSecond;
+  timer_spec_.it_value = timer_spec_.it_interval;
+
+  stop_latch_.reset(new CountDownLatch(1));
+  g_running_profiler.store(this, std::memory_order_release);
+  UpdateThreadTimersUnlocked();
+  if (timers_.empty()) {
+    g_running_profiler.store(nullptr, std::memory_order_release);
+    return STATUS(RuntimeError, "Failed to create profiling timers");
+  }
+
+  Status status = Thread::Create("profiler", "continuous_profiler",
+                                 &ContinuousProfiler::RunThread, this, &thread_);
+  if (!status.ok()) {
+    g_running_profiler.store(nullptr, std::memory_order_release);
+    for (const auto& tid_and_timer : timers_) {
+      timer_delete(tid_and_timer.second);
+    }
+    timers_.clear();
+    return status;
+  }
+
+  LOG(INFO) << "Started continuous profiling at " << FLAGS_continuous_profiling_frequency_hz
+            << " Hz";
+  return Status::OK();
+#else
+  return STATUS(NotSupported, "Continuous profiling is only supported on Linux");
+#endif // defined(__linux__)
+}
+
+#if defined(__linux__)
+
+void ContinuousProfiler::UpdateThreadTimersUnlocked() {
+  // The kernel disarms the CPU timer of a thread when the thread exits, so a disarmed timer belongs
+  // to an exited thread, even if its id was reused by a new thread since then.
+  for (auto it = timers_.begin(); it != timers_.end();) {
+    struct itimerspec current;
+    if (timer_gettime(it->second, &current) == 0 &&
+        (current.it_value.tv_sec != 0 || current.it_value.tv_nsec != 0)) {
+      ++it;
+      continue;
+    }
+    timer_delete(it->second);
+    it = timers_.erase(it);
+  }
+
+  DIR* dir = opendir("/proc/self/task");
+  if (!dir) {
+    YB_LOG_EVERY_N_SECS(WARNING, 60) << "Failed to list threads: " << ErrnoToString(errno);
+    return;
+  }
+  while (struct dirent* entry = readdir(dir)) {
+    if (entry->d_name[0] == '.') {
+      continue;
+    }
+    const pid_t tid = atoi(entry->d_name);
+    if (timers_.count(tid)) {
+      continue;
+    }
+    // Each thread is signalled when it used a period of its own CPU time, so threads are sampled
+    // proportionally to the CPU they use. A process-wide CPU timer would signal an arbitrary
+    // thread, on older kernels usually the main thread, instead of the running one.
+    struct sigevent event;
+    memset(&event, 0, sizeof(event));
+    event.sigev_notify = SIGEV_THREAD_ID;
+    event.sigev_signo = ProfilingSignal();
+    event.sigev_notify_thread_id = tid;
+    timer_t timer;
+    // The thread could exit meanwhile, it is not sampled then.
+    if (timer_create(ThreadCpuClock(tid), &event, &timer) != 0) {
+      continue;
+    }
+    if (timer_settime(timer, 0, &timer_spec_, nullptr) != 0) {
+      timer_delete(timer);
+      continue;
+    }
+    timers_.emplace(tid, timer);
+  }
+  closedir(dir);
+}
+
+#endif // defined(__linux__)
+
+void ContinuousProfiler::Stop() {
+  scoped_refptr<Thread> thread;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!thread_) {
+      return;
+    }
+    g_running_profiler.store(nullptr, std::memory_order_release);
+#if defined(__linux__)
+    for (const auto& tid_and_timer : timers_) {
+      timer_delete(tid_and_timer.second);
+    }
+    timers_.clear();
+#endif
+    stop_latch_->CountDown();
+    thread.swap(thread_);
+  }
+  CHECK_OK(ThreadJoiner(thread.get()).Join());
+}
+
+void ContinuousProfiler::RunThread() {
+  auto next_rotation =
+      MonoTime::Now() + MonoDelta::FromSeconds(FLAGS_continuous_profiling_window_secs);
+  // Threads started after the profiler get their timers within this interval.
+  const auto thread_scan_interval = MonoDelta::FromSeconds(1);
+  while (!stop_latch_->WaitFor(thread_scan_interval)) {
+#if defined(__linux__)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      UpdateThreadTimersUnlocked();
+    }
+#endif
+    auto now = MonoTime::Now();
+    if (!now.ComesBefore(next_rotation)) {
+      Rotate();
+      next_rotation = now + MonoDelta::FromSeconds(FLAGS_continuous_profiling_window_secs);
+    }
+  }
+}
+
+void ContinuousProfiler::Rotate() {
+  Window window;
+  window.end = MonoTime::Now();
+  window.dropped_samples = table_.Flush(&window.samples);
+  if (window.dropped_samples != 0) {
+    VLOG(1) << "Continuous profiler dropped " << window.dropped_samples << " samples";
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  windows_.push_back(std::move(window));
+  const size_t max_windows = std::max(FLAGS_continuous_profiling_max_windows, 1);
+  while (windows_.size() > max_windows) {
+    windows_.pop_front();
+  }
+}
+
+void ContinuousProfiler::Write(ProfileType type, size_t num_windows, std::ostream* out) {
+  const auto value_index = util::to_underlying(type);
+  std::vector<SampleTable::Sample> samples;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t first = windows_.size() > num_windows ? windows_.size() - num_windows : 0;
+    for (size_t i = first; i != windows_.size(); ++i) {
+      for (const auto& sample : windows_[i].samples) {
+        if (sample.values[value_index] != 0) {
+          samples.push_back(sample);
+        }
+      }
+    }
+  }
+
+  // Symbolization is relatively expensive, so each address is symbolized once.
+  std::unordered_map<void*, std::string> symbols;
+  auto symbolize = [&symbols](void* pc) -> const std::string& {
+    auto it = symbols.find(pc);
+    if (it == symbols.end()) {
+      // See StackTrace::Symbolize() about why we subtract 1 from each address here.
+      void* adjusted_pc = reinterpret_cast<void*>(reinterpret_cast<size_t>(pc) - 1);
+      char buf[1024];
+      std::string symbol = google::Symbolize(adjusted_pc, buf, sizeof(buf))
+          ? std::string(buf) : StringPrintf("%p", pc);
+      // ';' separates frames in the folded format.
+      std::replace(symbol.begin(), symbol.end(), ';', ':');
+      it = symbols.emplace(pc, std::move(symbol)).first;
+    }
+    return it->second;
+  };
+
+  std::map<std::string, int64_t> folded;
+  for (const auto& sample : samples) {
+    std::string line;
+    for (auto tag : kProfilingTagList) {
+      const auto& value = sample.tags[util::to_underlying(tag)];
+      if (!value.empty()) {
+        line += kProfilingTagNames[util::to_underlying(tag)];
+        line += ':';
+        line += value;
+        line += ';';
+      }
+    }
+    for (int i = sample.trace.num_frames(); i-- > 0;) {
+      line += symbolize(sample.trace.frame(i));
+      line += ';';
+    }
+    if (!line.empty()) {
+      line.pop_back();
+    }
+    folded[line] += sample.values[value_index];
+  }
+
+  for (const auto& line_and_value : folded) {
+    *out << line_and_value.first << ' ' << line_and_value.second << '\n';
+  }
+}
+
+} // namespace
+
+ScopedProfilingTag::ScopedProfilingTag(ProfilingTag tag, const std::string& value)
+    : tag_(tag), previous_value_(profiling_tags[util::to_underlying(tag)]) {
+  profiling_tags[util::to_underlying(tag_)] = &value;
+}
+
+ScopedProfilingTag::~ScopedProfilingTag() {
+  profiling_tags[util::to_underlying(tag_)] = previous_value_;
+}
+
+Status StartContinuousProfiling() {
+  return Profiler()->Start();
+}
+
+void StopContinuousProfiling() {
+  Profiler()->Stop();
+}
+
+bool ShouldSampleContention() {
+  if (PREDICT_TRUE(g_running_profiler.load(std::memory_order_relaxed) == nullptr) ||
+      adding_sample) {
+    return false;
+  }
+  const uint32_t interval = std::max(FLAGS_continuous_profiling_contention_sample_interval, 1);
+  return ++contention_events % interval == 0;
+}
+
+void AddContentionSample(const StackTrace& stack, int64_t wait_cycles) {
+  auto* profiler = g_running_profiler.load(std::memory_order_acquire);
+  if (!profiler || adding_sample) {
+    return;
+  }
+  adding_sample = true;
+  // Only a fraction of contention events is sampled, so scale the sample to estimate all of them.
+  profiler->table().Add(
+      stack, ProfileType::kContention,
+      wait_cycles * std::max(FLAGS_continuous_profiling_contention_sample_interval, 1));
+  adding_sample = false;
+}
+
+void RotateContinuousProfile() {
+  Profiler()->Rotate();
+}
+
+void WriteFoldedProfile(ProfileType type, size_t num_windows, std::ostream* out) {
+  Profiler()->Write(type, num_windows, out);
+}
+
+} // namespace yb
@@ -0,0 +1,81 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+// Always-on, low frequency sampling profiler.
+//
+// While running, the profiler samples stacks of threads consuming CPU and, via the spinlock
+// contention hook, stacks of threads waiting on contended locks. Samples are attributed to the
+// tags (RPC method, tablet) set by ScopedProfilingTag on the sampled thread and aggregated into
+// rolling windows, so a profile of the recent past could be fetched after a hotspot has passed.
+
+#ifndef YB_UTIL_CONTINUOUS_PROFILER_H
+#define YB_UTIL_CONTINUOUS_PROFILER_H
+
+#include <iosfwd>
+#include <string>
+
+#include "yb/gutil/macros.h"
+
+#include "yb/util/enums.h"
+#include "yb/util/status.h"
+
+namespace yb {
+
+class StackTrace;
+
+// Context of the current thread that samples are attributed to.
+YB_DEFINE_ENUM(ProfilingTag, (kMethod)(kTablet));
+
+YB_DEFINE_ENUM(ProfileType, (kCpu)(kContention));
+
+// Sets the tag of the current thread for the lifetime of this object, restoring the previous value
+// on destruction. The value is referenced, not copied, so it should outlive this object.
+class ScopedProfilingTag {
+ public:
+  ScopedProfilingTag(ProfilingTag tag, const std::string& value);
+  ~ScopedProfilingTag();
+
+ private:
+  const ProfilingTag tag_;
+  const std::string* const previous_value_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedProfilingTag);
+};
+
+// Starts sampling the process at --continuous_profiling_frequency_hz, closing a window of samples
+// every --continuous_profiling_window_secs. Does nothing if the profiler is already running.
+// Only supported on Linux.
+CHECKED_STATUS StartContinuousProfiling();
+
+void StopContinuousProfiling();
+
+// Whether the next lock contention event of the current thread should be submitted with
+// AddContentionSample. Only a fraction of contention events is sampled.
+bool ShouldSampleContention();
+
+// Adds a sample of waiting for the given number of cycles on a contended lock.
+void AddContentionSample(const StackTrace& stack, int64_t wait_cycles);
+
+// Moves samples collected since the previous call into a new window, dropping the oldest windows
+// above --continuous_profiling_max_windows. Called periodically by the profiler thread.
+void RotateContinuousProfile();
+
+// Writes samples of the given type from the latest num_windows windows in the folded format
+// accepted by flame graph tools, one stack per line:
+//   method:<method>;tablet:<tablet>;<outermost frame>;...;<innermost frame> <value>
+// The value is the number of samples for CPU profile and the number of cycles for contention.
+void WriteFoldedProfile(ProfileType type, size_t num_windows, std::ostream* out);
+
+} // namespace yb
+
+#endif // YB_UTIL_CONTINUOUS_PROFILER_H
@@ -169,6 +169,15 @@ class StackTrace {
 
   uint64_t HashCode() const;
 
+  int num_frames() const {
+    return num_frames_;
+  }
+
+  // Return the return address of the given frame, the innermost frame first.
+  void* frame(int i) const {
+    return frames_[i];
+  }
+
  private:
   enum {
     // The maximum number of stack frames to collect.
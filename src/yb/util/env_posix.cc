@@ -294,7 +294,8 @@ class PosixRandomAccessFile: public RandomAccessFile {
                       uint8_t *scratch) const override {
     ThreadRestrictions::AssertIOAllowed();
     Status s;
-    ssize_t r = pread(fd_, scratch, n, static_cast<off_t>(offset));
+    ssize_t r;
+    RETRY_ON_EINTR(r, pread(fd_, scratch, n, static_cast<off_t>(offset)));
     *result = Slice(scratch, (r < 0) ? 0 : r);
     if (r < 0) {
       // An error: return a non-ok status.
@@ -478,7 +479,8 @@ class PosixWritableFile : public WritableFile {
       ++j;
     }
 
-    ssize_t written = pwritev(fd_, iov, n, filesize_);
+    ssize_t written;
+    RETRY_ON_EINTR(written, pwritev(fd_, iov, n, filesize_));
 
     if (PREDICT_FALSE(written == -1)) {
       int err = errno;
@@ -495,7 +497,8 @@ class PosixWritableFile : public WritableFile {
 #else
     for (size_t i = offset; i < offset + n; i++) {
       const Slice& data = data_vector[i];
-      ssize_t written = pwrite(fd_, data.data(), data.size(), filesize_);
+      ssize_t written;
+      RETRY_ON_EINTR(written, pwrite(fd_, data.data(), data.size(), filesize_));
       if (PREDICT_FALSE(written == -1)) {
         int err = errno;
         return IOError("pwrite error", err);
@@ -679,7 +682,8 @@ class PosixDirectIOWritableFile : public PosixWritableFile {
       iov[j].iov_len = block_size_;
     }
     auto bytes_to_write = blocks_to_write * block_size_;
-    ssize_t written = pwritev(fd_, iov, blocks_to_write, next_write_offset_);
+    ssize_t written;
+    RETRY_ON_EINTR(written, pwritev(fd_, iov, blocks_to_write, next_write_offset_));
 
     if (PREDICT_FALSE(written == -1)) {
       int err = errno;
@@ -770,7 +774,8 @@ class PosixRWFile : public RWFile {
     int rem = length;
     uint8_t* dst = scratch;
     while (rem > 0) {
-      ssize_t r = pread(fd_, dst, rem, offset);
+      ssize_t r;
+      RETRY_ON_EINTR(r, pread(fd_, dst, rem, offset));
       if (r < 0) {
         // An error: return a non-ok status.
         return IOError(filename_, errno);
@@ -793,7 +798,8 @@ class PosixRWFile : public RWFile {
 
   Status Write(uint64_t offset, const Slice& data) override {
     ThreadRestrictions::AssertIOAllowed();
-    ssize_t written = pwrite(fd_, data.data(), data.size(), offset);
+    ssize_t written;
+    RETRY_ON_EINTR(written, pwrite(fd_, data.data(), data.size(), offset));
 
     if (PREDICT_FALSE(written == -1)) {
       int err = errno;
@@ -32,8 +32,16 @@
 #ifndef YB_ERRNO_H
 #define YB_ERRNO_H
 
+#include <errno.h>
+
 #include <string>
 
+// Repeats a system call while it fails with EINTR, i.e. was interrupted by a signal, such as the
+// one of the continuous profiler, before doing anything.
+#define RETRY_ON_EINTR(ret, expr) do { \
+  ret = expr; \
+} while ((ret == -1) && (errno == EINTR))
+
 namespace yb {
 
 void ErrnoToCString(int err, char *buf, size_t buf_len);
@@ -125,4 +125,24 @@ TEST_F(HdrHistogramTest, PercentileAndCopyTest) {
   ASSERT_EQ(hist.TotalSum(), copy.TotalSum());
 }
 
+TEST_F(HdrHistogramTest, MergeTest) {
+  uint64_t specified_max = 10000;
+  HdrHistogram first(specified_max, kSigDigits);
+  first.IncrementBy(10, 80);
+  first.IncrementBy(100000, 1);
+  HdrHistogram second(specified_max, kSigDigits);
+  second.IncrementBy(100, 10);
+  second.IncrementBy(1000, 5);
+  second.IncrementBy(10000, 3);
+  second.IncrementBy(1000000, 1);
+
+  HdrHistogram merged(first);
+  merged.MergeFrom(second);
+  ASSERT_NO_FATALS(validate_percentiles(&merged, specified_max));
+
+  // Merging an empty histogram keeps min and max.
+  merged.MergeFrom(HdrHistogram(specified_max, kSigDigits));
+  ASSERT_NO_FATALS(validate_percentiles(&merged, specified_max));
+}
+
 } // namespace yb
@@ -100,6 +100,26 @@ HdrHistogram::HdrHistogram(const HdrHistogram& other)
   NoBarrier_Store(&total_count_, total_copied_count);
 }
 
+void HdrHistogram::MergeFrom(const HdrHistogram& other) {
+  DCHECK_EQ(highest_trackable_value_, other.highest_trackable_value_);
+  DCHECK_EQ(num_significant_digits_, other.num_significant_digits_);
+
+  // Same order as in the copy constructor: sum and min, counts in ascending magnitude, then max.
+  NoBarrier_Store(&total_sum_, NoBarrier_Load(&total_sum_) + NoBarrier_Load(&other.total_sum_));
+  NoBarrier_Store(&min_value_, std::min(NoBarrier_Load(&min_value_),
+                                        NoBarrier_Load(&other.min_value_)));
+
+  uint64_t total_copied_count = 0;
+  for (int i = 0; i < counts_array_length_; i++) {
+    uint64_t count = NoBarrier_Load(&other.counts_[i]);
+    NoBarrier_Store(&counts_[i], NoBarrier_Load(&counts_[i]) + count);
+    total_copied_count += count;
+  }
+  NoBarrier_Store(&max_value_, std::max(NoBarrier_Load(&max_value_),
+                                        NoBarrier_Load(&other.max_value_)));
+  NoBarrier_Store(&total_count_, NoBarrier_Load(&total_count_) + total_copied_count);
+}
+
 bool HdrHistogram::IsValidHighestTrackableValue(uint64_t highest_trackable_value) {
   return highest_trackable_value >= kMinHighestTrackableValue;
 }
@@ -89,6 +89,11 @@ class HdrHistogram {
   // Copy-construct a (non-consistent) snapshot of other.
   explicit HdrHistogram(const HdrHistogram& other);
 
+  // Add a (non-consistent) snapshot of other to this histogram. Both histograms must have the same
+  // highest trackable value and number of significant digits. This histogram must not be updated
+  // concurrently.
+  void MergeFrom(const HdrHistogram& other);
+
   // Validate your params before trying to construct the object.
   static bool IsValidHighestTrackableValue(uint64_t highest_trackable_value);
   static bool IsValidNumSignificantDigits(int num_significant_digits);
@@ -31,9 +31,12 @@
 //
 #include "yb/util/metrics.h"
 
+#include <sched.h>
+
 #include <iostream>
 #include <map>
 #include <set>
+#include <thread>
 
 #include <gflags/gflags.h>
 
@@ -43,6 +46,7 @@
 #include "yb/gutil/singleton.h"
 #include "yb/gutil/stl_util.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/gutil/sysinfo.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/hdr_histogram.h"
 #include "yb/util/histogram.pb.h"
@@ -56,6 +60,12 @@ DEFINE_int32(metrics_retirement_age_ms, 120 * 1000,
 TAG_FLAG(metrics_retirement_age_ms, runtime);
 TAG_FLAG(metrics_retirement_age_ms, advanced);
 
+DEFINE_int32(metrics_histogram_max_shards, 0,
+             "Maximum number of shards of a histogram defined as sharded. Shards are allocated "
+             "when a thread running on one of the corresponding CPUs first records into the "
+             "histogram. 0 - one shard per 4 CPUs, 1 - disables sharding.");
+TAG_FLAG(metrics_histogram_max_shards, advanced);
+
 // TODO: changed to empty string and add logic to get this from cluster_uuid in case empty.
 DEFINE_string(metric_node_name, "DEFAULT_NODE_NAME",
               "Value to use as node name for metrics reporting");
@@ -707,17 +717,86 @@ scoped_refptr<Histogram> HistogramPrototype::Instantiate(
 // Histogram
 /////////////////////////////////////////////////
 
+namespace {
+
+// A shard of a histogram tracking up to 60 seconds in microseconds takes 20KB with 2 significant
+// digits, and 140KB with 3. So by default a shard is shared by a few CPUs, which is enough to
+// spread the contention, while a sharded histogram takes at most 320KB or 2.2MB on a 64 CPU
+// machine.
+const int kCpusPerHistogramShard = 4;
+
+size_t HistogramShards(const HistogramPrototype* proto) {
+  if (!(proto->flags() & SHARDED_HISTOGRAM)) {
+    return 0;
+  }
+  const int num_cpus = base::NumCPUs();
+  const int max_shards = FLAGS_metrics_histogram_max_shards > 0
+      ? FLAGS_metrics_histogram_max_shards
+      : (num_cpus + kCpusPerHistogramShard - 1) / kCpusPerHistogramShard;
+  auto result = std::min(num_cpus, max_shards);
+  return result > 1 ? result : 0;
+}
+
+} // namespace
+
 Histogram::Histogram(const HistogramPrototype* proto)
   : Metric(proto),
-    histogram_(new HdrHistogram(proto->max_trackable_value(), proto->num_sig_digits())) {
+    histogram_(new HdrHistogram(proto->max_trackable_value(), proto->num_sig_digits())),
+    num_shards_(HistogramShards(proto)) {
+  if (num_shards_) {
+    shards_.reset(new std::atomic<HdrHistogram*>[num_shards_]);
+    shards_[0].store(histogram_.get(), std::memory_order_relaxed);
+    for (size_t i = 1; i != num_shards_; ++i) {
+      shards_[i].store(nullptr, std::memory_order_relaxed);
+    }
+  }
+}
+
+Histogram::~Histogram() {
+  for (size_t i = 1; i < num_shards_; ++i) {
+    delete shards_[i].load(std::memory_order_acquire);
+  }
+}
+
+HdrHistogram* Histogram::Shard() {
+  if (!num_shards_) {
+    return histogram_.get();
+  }
+#if defined(__APPLE__)
+  // OSX doesn't have a way to get the CPU, so we pick a shard by thread.
+  size_t index = std::hash<std::thread::id>()(std::this_thread::get_id()) % num_shards_;
+#else
+  size_t index = static_cast<size_t>(sched_getcpu()) % num_shards_;
+#endif // defined(__APPLE__)
+  auto& shard = shards_[index];
+  auto result = shard.load(std::memory_order_acquire);
+  if (PREDICT_TRUE(result != nullptr)) {
+    return result;
+  }
+  std::unique_ptr<HdrHistogram> new_shard(new HdrHistogram(
+      histogram_->highest_trackable_value(), histogram_->num_significant_digits()));
+  if (shard.compare_exchange_strong(result, new_shard.get(), std::memory_order_acq_rel)) {
+    return new_shard.release();
+  }
+  // Other thread has installed the shard concurrently, result contains it.
+  return result;
+}
+
+void Histogram::MergeShards(HdrHistogram* snapshot) const {
+  for (size_t i = 1; i < num_shards_; ++i) {
+    auto shard = shards_[i].load(std::memory_order_acquire);
+    if (shard) {
+      snapshot->MergeFrom(*shard);
+    }
+  }
 }
 
 void Histogram::Increment(int64_t value) {
-  histogram_->Increment(value);
+  Shard()->Increment(value);
 }
 
 void Histogram::IncrementBy(int64_t value, int64_t amount) {
-  histogram_->IncrementBy(value, amount);
+  Shard()->IncrementBy(value, amount);
 }
 
 Status Histogram::WriteAsJson(JsonWriter* writer,
@@ -732,6 +811,7 @@ Status Histogram::WriteAsJson(JsonWriter* writer,
 CHECKED_STATUS Histogram::WriteForPrometheus(
     PrometheusWriter* writer, const MetricEntity::AttributeMap& attr) const {
   HdrHistogram snapshot(*histogram_);
+  MergeShards(&snapshot);
 
   // Representing the sum and count require suffixed names.
   std::string hist_name = prototype_->name();
@@ -765,6 +845,7 @@ CHECKED_STATUS Histogram::WriteForPrometheus(
 Status Histogram::GetHistogramSnapshotPB(HistogramSnapshotPB* snapshot_pb,
                                          const MetricJsonOptions& opts) const {
   HdrHistogram snapshot(*histogram_);
+  MergeShards(&snapshot);
   snapshot_pb->set_name(prototype_->name());
   if (opts.include_schema_info) {
     snapshot_pb->set_type(MetricType::Name(prototype_->type()));
@@ -797,23 +878,57 @@ Status Histogram::GetHistogramSnapshotPB(HistogramSnapshotPB* snapshot_pb,
   return Status::OK();
 }
 
+uint64_t Histogram::CachedValueAtPercentile(double percentile) const {
+  static constexpr uint64_t kRefreshIntervalNanos = 1000000000;
+
+  auto now = MonoTime::Now().ToUint64();
+  auto refresh_time = cached_percentile_time_.load(std::memory_order_acquire);
+  if (refresh_time != 0 && now < refresh_time + kRefreshIntervalNanos) {
+    return cached_percentile_value_.load(std::memory_order_relaxed);
+  }
+  // Only one thread recomputes the value, others use the previous one meanwhile.
+  if (!cached_percentile_time_.compare_exchange_strong(refresh_time, now)) {
+    return cached_percentile_value_.load(std::memory_order_relaxed);
+  }
+  HdrHistogram snapshot(*histogram_);
+  MergeShards(&snapshot);
+  auto result = snapshot.ValueAtPercentile(percentile);
+  cached_percentile_value_.store(result, std::memory_order_relaxed);
+  return result;
+}
+
 uint64_t Histogram::CountInBucketForValueForTests(uint64_t value) const {
-  return histogram_->CountInBucketForValue(value);
+  HdrHistogram snapshot(*histogram_);
+  MergeShards(&snapshot);
+  return snapshot.CountInBucketForValue(value);
 }
 
 uint64_t Histogram::TotalCount() const {
-  return histogram_->TotalCount();
+  uint64_t result = histogram_->TotalCount();
+  for (size_t i = 1; i < num_shards_; ++i) {
+    auto shard = shards_[i].load(std::memory_order_acquire);
+    if (shard) {
+      result += shard->TotalCount();
+    }
+  }
+  return result;
 }
 
 uint64_t Histogram::MinValueForTests() const {
-  return histogram_->MinValue();
+  HdrHistogram snapshot(*histogram_);
+  MergeShards(&snapshot);
+  return snapshot.MinValue();
 }
 
 uint64_t Histogram::MaxValueForTests() const {
-  return histogram_->MaxValue();
+  HdrHistogram snapshot(*histogram_);
+  MergeShards(&snapshot);
+  return snapshot.MaxValue();
 }
 double Histogram::MeanValueForTests() const {
-  return histogram_->MeanValue();
+  HdrHistogram snapshot(*histogram_);
+  MergeShards(&snapshot);
+  return snapshot.MeanValue();
 }
 
 ScopedLatencyMetric::ScopedLatencyMetric(Histogram* latency_hist)
@@ -119,6 +119,18 @@
 //                            "Total number of threads started on this server",
 //                            yb::EXPOSE_AS_COUNTER);
 //
+// Histograms updated from many threads at high rates, e.g. per-RPC latencies, should be defined
+// with the 'SHARDED_HISTOGRAM' flag. Such a histogram records into shards, each used by a few CPUs,
+// which are merged when the histogram is read, at the cost of the memory of a histogram per shard
+// in use. So per-tablet histograms should not be sharded:
+//
+// METRIC_DEFINE_histogram(server, handler_latency,
+//                         "Handler Latency",
+//                         yb::MetricUnit::kMicroseconds,
+//                         "Time spent handling requests",
+//                         60000000LU, 2,
+//                         yb::SHARDED_HISTOGRAM);
+//
 //
 // Metrics ownership
 // ------------------------------------------------------------
@@ -239,6 +251,8 @@
 /////////////////////////////////////////////////////
 
 #include <algorithm>
+#include <atomic>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <sstream>
@@ -303,13 +317,14 @@
 #define METRIC_DEFINE_gauge_double(entity, name, label, unit, desc, ...) \
     METRIC_DEFINE_gauge(double, entity, name, label, unit, desc, ## __VA_ARGS__)
 
-#define METRIC_DEFINE_histogram(entity, name, label, unit, desc, max_val, num_sig_digits) \
-  ::yb::HistogramPrototype BOOST_PP_CAT(METRIC_, name)(                                   \
+#define METRIC_DEFINE_histogram(entity, name, label, unit, desc, max_val, num_sig_digits, ...) \
+  ::yb::HistogramPrototype BOOST_PP_CAT(METRIC_, name)(                                        \
       ::yb::MetricPrototype::CtorArgs(BOOST_PP_STRINGIZE(entity), \
                                       BOOST_PP_STRINGIZE(name), \
                                       label, \
                                       unit, \
-                                      desc), \
+                                      desc, \
+                                      ## __VA_ARGS__), \
       max_val, \
       num_sig_digits)
 
@@ -768,7 +783,10 @@ class MetricPrototypeRegistry {
 enum PrototypeFlags {
   // Flag which causes a Gauge prototype to expose itself as if it
   // were a counter.
-  EXPOSE_AS_COUNTER = 1 << 0
+  EXPOSE_AS_COUNTER = 1 << 0,
+
+  // Flag which causes a Histogram to record into per-CPU shards, merged when it is read.
+  SHARDED_HISTOGRAM = 1 << 1
 };
 
 class MetricPrototype {
@@ -803,6 +821,7 @@ class MetricPrototype {
   const char* label() const { return args_.label_; }
   MetricUnit::Type unit() const { return args_.unit_; }
   const char* description() const { return args_.description_; }
+  uint32_t flags() const { return args_.flags_; }
   virtual MetricType::Type type() const = 0;
 
   // Writes the fields of this prototype to the given JSON writer.
@@ -1114,6 +1133,8 @@ class HistogramPrototype : public MetricPrototype {
 
 class Histogram : public Metric {
  public:
+  ~Histogram();
+
   // Increment the histogram for the given value.
   // 'value' must be non-negative.
   void Increment(int64_t value);
@@ -1132,6 +1153,11 @@ class Histogram : public Metric {
   CHECKED_STATUS WriteForPrometheus(
       PrometheusWriter* writer, const MetricEntity::AttributeMap& attr) const override;
 
+  // Returns the value at the given percentile, computed from a snapshot of this histogram that is
+  // refreshed at most once per second. Cheap enough to be called per request. All callers should
+  // pass the same percentile.
+  uint64_t CachedValueAtPercentile(double percentile) const;
+
   // Returns a snapshot of this histogram including the bucketed values and counts.
   CHECKED_STATUS GetHistogramSnapshotPB(HistogramSnapshotPB* snapshot,
                                 const MetricJsonOptions& opts) const;
@@ -1146,7 +1172,23 @@ class Histogram : public Metric {
   friend class MetricEntity;
   explicit Histogram(const HistogramPrototype* proto);
 
+  // Returns the histogram the calling thread should record into.
+  HdrHistogram* Shard();
+
+  // Adds the content of all shards except histogram_ to 'snapshot'.
+  void MergeShards(HdrHistogram* snapshot) const;
+
   const gscoped_ptr<HdrHistogram> histogram_;
+
+  // Shards of a SHARDED_HISTOGRAM indexed by CPU, allocated on first use. The first shard is
+  // histogram_.
+  // num_shards_ is 0 when the histogram is not sharded.
+  const size_t num_shards_;
+  std::unique_ptr<std::atomic<HdrHistogram*>[]> shards_;
+
+  // Result of CachedValueAtPercentile and the MonoTime when it was computed.
+  mutable std::atomic<uint64_t> cached_percentile_value_{0};
+  mutable std::atomic<uint64_t> cached_percentile_time_{0};
   DISALLOW_COPY_AND_ASSIGN(Histogram);
 };
 
@@ -98,6 +98,38 @@ TEST_F(MultiThreadedMetricsTest, CounterIncrementTest) {
   ASSERT_EQ(num_threads * num_increments, counter->value());
 }
 
+METRIC_DEFINE_histogram(test_entity, test_hist, "Test Histogram",
+                        MetricUnit::kMicroseconds, "Test histogram", 60000000LU, 2);
+METRIC_DEFINE_histogram(test_entity, test_sharded_hist, "Test Sharded Histogram",
+                        MetricUnit::kMicroseconds, "Test sharded histogram", 60000000LU, 2,
+                        SHARDED_HISTOGRAM);
+
+// Record into a Histogram a bunch of times.
+static void RecordWithHistogram(scoped_refptr<Histogram> histogram, int num_increments) {
+  for (int i = 0; i < num_increments; i++) {
+    histogram->Increment(i % 1000);
+  }
+}
+
+// Ensure that recording into a histogram is thread-safe, and compare the throughput of sharded
+// and unsharded histograms.
+TEST_F(MultiThreadedMetricsTest, HistogramIncrementTest) {
+  scoped_refptr<MetricEntity> entity = METRIC_ENTITY_test_entity.Instantiate(&registry_, "my-test");
+  int num_threads = FLAGS_mt_metrics_test_num_threads;
+  int num_increments = 100000;
+  for (auto* proto : {&METRIC_test_hist, &METRIC_test_sharded_hist}) {
+    scoped_refptr<Histogram> histogram = proto->Instantiate(entity);
+    std::function<void()> f = std::bind(RecordWithHistogram, histogram, num_increments);
+    auto start = MonoTime::Now();
+    RunWithManyThreads(&f, num_threads);
+    LOG(INFO) << proto->name() << ": " << num_threads * num_increments << " increments took "
+              << MonoTime::Now().GetDeltaSince(start);
+    ASSERT_EQ(num_threads * num_increments, histogram->TotalCount());
+    ASSERT_EQ(0, histogram->MinValueForTests());
+    ASSERT_EQ(999, histogram->MaxValueForTests());
+  }
+}
+
 // Helper function to register a bunch of counters in a loop.
 void MultiThreadedMetricsTest::RegisterCounters(
     const scoped_refptr<MetricEntity>& metric_entity,
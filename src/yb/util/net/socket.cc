@@ -40,8 +40,10 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <limits>
 #include <string>
+#include <vector>
 
 #include <glog/logging.h>
 
@@ -70,6 +72,12 @@ DEFINE_bool(socket_inject_short_recvs, false,
 TAG_FLAG(socket_inject_short_recvs, hidden);
 TAG_FLAG(socket_inject_short_recvs, unsafe);
 
+DEFINE_bool(socket_inject_short_writes, false,
+            "Inject short writev() responses which write less data than "
+            "requested");
+TAG_FLAG(socket_inject_short_writes, hidden);
+TAG_FLAG(socket_inject_short_writes, unsafe);
+
 namespace yb {
 
 Socket::Socket()
@@ -442,6 +450,27 @@ Status Socket::Writev(const struct ::iovec *iov, int iov_len,
   }
   DCHECK_GE(fd_, 0);
 
+  // Like short recvs, partial writes are unlikely in unit tests, so we provide an injection hook
+  // which writes only a random prefix of the data.
+  std::vector<iovec> short_iov;
+  if (PREDICT_FALSE(FLAGS_socket_inject_short_writes)) {
+    size_t total = 0;
+    for (int i = 0; i != iov_len; ++i) {
+      total += iov[i].iov_len;
+    }
+    if (total > 1) {
+      Random r(GetRandomSeed32());
+      size_t amt = 1 + r.Uniform64(total - 1);
+      for (int i = 0; i != iov_len && amt != 0; ++i) {
+        short_iov.push_back(iov[i]);
+        short_iov.back().iov_len = std::min(amt, iov[i].iov_len);
+        amt -= short_iov.back().iov_len;
+      }
+      iov = short_iov.data();
+      iov_len = static_cast<int>(short_iov.size());
+    }
+  }
+
   struct msghdr msg;
   memset(&msg, 0, sizeof(struct msghdr));
   msg.msg_iov = const_cast<iovec *>(iov);
@@ -0,0 +1,62 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/sampled_trace.h"
+
+#include "yb/util/test_util.h"
+
+namespace yb {
+
+class SampledTraceTest : public YBTest {
+};
+
+TEST_F(SampledTraceTest, PhaseDurations) {
+  auto start = MonoTime::Now();
+  SampledTracePtr trace(new SampledTrace(start));
+  trace->RecordPhase(TracePhase::kQueue, start + MonoDelta::FromMicroseconds(10));
+  // Replication finishes before prepare.
+  trace->RecordPhase(TracePhase::kReplicate, start + MonoDelta::FromMicroseconds(50));
+  trace->RecordPhase(TracePhase::kPrepare, start + MonoDelta::FromMicroseconds(60));
+  trace->RecordPhase(TracePhase::kRespond, start + MonoDelta::FromMicroseconds(100));
+
+  ASSERT_EQ(50, trace->PhaseEnd(TracePhase::kReplicate).ToMicroseconds());
+  ASSERT_FALSE(trace->PhaseEnd(TracePhase::kApply).Initialized());
+
+  auto durations = trace->PhaseDurations();
+  ASSERT_EQ(4, durations.size());
+  ASSERT_EQ(TracePhase::kQueue, durations[0].first);
+  ASSERT_EQ(10, durations[0].second.ToMicroseconds());
+  ASSERT_EQ(TracePhase::kPrepare, durations[1].first);
+  ASSERT_EQ(50, durations[1].second.ToMicroseconds());
+  ASSERT_EQ(TracePhase::kReplicate, durations[2].first);
+  ASSERT_EQ(0, durations[2].second.ToMicroseconds());
+  ASSERT_EQ(TracePhase::kRespond, durations[3].first);
+  ASSERT_EQ(40, durations[3].second.ToMicroseconds());
+}
+
+TEST_F(SampledTraceTest, Ring) {
+  const size_t kCapacity = 3;
+  SampledTraceRing ring(kCapacity);
+  auto start = MonoTime::Now();
+  for (int i = 0; i != 5; ++i) {
+    ring.Add({std::to_string(i), MonoDelta::FromMicroseconds(1), MonoDelta::FromMicroseconds(i),
+              SampledTracePtr(new SampledTrace(start))});
+    auto entries = ring.Entries();
+    ASSERT_EQ(std::min<size_t>(i + 1, kCapacity), entries.size());
+    ASSERT_EQ(std::to_string(i), entries.back().name);
+  }
+  auto entries = ring.Entries();
+  ASSERT_EQ("2", entries.front().name);
+}
+
+} // namespace yb
@@ -0,0 +1,94 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/sampled_trace.h"
+
+#include <algorithm>
+#include <mutex>
+
+#include "yb/util/format.h"
+
+namespace yb {
+
+SampledTrace::SampledTrace(MonoTime start) : start_(start) {
+  for (auto& phase_end : phase_end_nanos_) {
+    phase_end.store(kNotRecorded, std::memory_order_relaxed);
+  }
+}
+
+void SampledTrace::RecordPhase(TracePhase phase, MonoTime time) {
+  phase_end_nanos_[util::to_underlying(phase)].store(
+      time.GetDeltaSince(start_).ToNanoseconds(), std::memory_order_relaxed);
+}
+
+MonoDelta SampledTrace::PhaseEnd(TracePhase phase) const {
+  auto nanos = phase_end_nanos_[util::to_underlying(phase)].load(std::memory_order_relaxed);
+  return nanos == kNotRecorded ? MonoDelta() : MonoDelta::FromNanoseconds(nanos);
+}
+
+std::vector<std::pair<TracePhase, MonoDelta>> SampledTrace::PhaseDurations() const {
+  std::vector<std::pair<TracePhase, MonoDelta>> result;
+  int64_t previous_end = 0;
+  for (auto phase : kTracePhaseList) {
+    auto end = phase_end_nanos_[util::to_underlying(phase)].load(std::memory_order_relaxed);
+    if (end == kNotRecorded) {
+      continue;
+    }
+    // Phases executed concurrently, e.g. prepare and replicate, could finish out of order.
+    result.emplace_back(
+        phase, MonoDelta::FromNanoseconds(std::max<int64_t>(end - previous_end, 0)));
+    previous_end = std::max(previous_end, end);
+  }
+  return result;
+}
+
+std::string SampledTrace::ToString() const {
+  std::string result = "{";
+  for (const auto& phase_and_duration : PhaseDurations()) {
+    if (result.size() > 1) {
+      result += ", ";
+    }
+    result += Format("$0: $1us", phase_and_duration.first,
+                     phase_and_duration.second.ToMicroseconds());
+  }
+  result += "}";
+  return result;
+}
+
+SampledTraceRing::SampledTraceRing(size_t capacity) : capacity_(capacity) {
+  entries_.reserve(capacity_);
+}
+
+void SampledTraceRing::Add(Entry entry) {
+  if (capacity_ == 0) {
+    return;
+  }
+  std::lock_guard<simple_spinlock> lock(lock_);
+  if (entries_.size() < capacity_) {
+    entries_.push_back(std::move(entry));
+    return;
+  }
+  entries_[next_] = std::move(entry);
+  next_ = (next_ + 1) % capacity_;
+}
+
+std::vector<SampledTraceRing::Entry> SampledTraceRing::Entries() const {
+  std::vector<Entry> result;
+  std::lock_guard<simple_spinlock> lock(lock_);
+  result.reserve(entries_.size());
+  result.insert(result.end(), entries_.begin() + next_, entries_.end());
+  result.insert(result.end(), entries_.begin(), entries_.begin() + next_);
+  return result;
+}
+
+} // namespace yb
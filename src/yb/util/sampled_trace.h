@@ -0,0 +1,102 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_SAMPLED_TRACE_H
+#define YB_UTIL_SAMPLED_TRACE_H
+
+#include <array>
+#include <atomic>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "yb/gutil/ref_counted.h"
+
+#include "yb/util/enums.h"
+#include "yb/util/locks.h"
+#include "yb/util/monotime.h"
+
+namespace yb {
+
+// Phases of a call, in the order they are normally passed. A phase is recorded when it finishes.
+YB_DEFINE_ENUM(TracePhase, (kQueue)(kPrepare)(kReplicate)(kApply)(kRespond));
+
+// Compact trace of a sampled call. Unlike Trace, it does not format anything and only keeps
+// the time at which each phase of the call finished, so it could be recorded for a fraction of
+// all calls in production.
+class SampledTrace : public RefCountedThreadSafe<SampledTrace> {
+ public:
+  explicit SampledTrace(MonoTime start);
+
+  // Records that the phase has finished at the given time. Could be called from any thread.
+  void RecordPhase(TracePhase phase, MonoTime time = MonoTime::Now());
+
+  MonoTime start() const { return start_; }
+
+  // Returns time since start at which the phase has finished, uninitialized if it was not recorded.
+  MonoDelta PhaseEnd(TracePhase phase) const;
+
+  // Returns time spent in each recorded phase, i.e. time between the end of the latest preceding
+  // recorded phase (or the start of the call) and the end of this phase.
+  std::vector<std::pair<TracePhase, MonoDelta>> PhaseDurations() const;
+
+  std::string ToString() const;
+
+ private:
+  friend class RefCountedThreadSafe<SampledTrace>;
+  ~SampledTrace() {}
+
+  static constexpr int64_t kNotRecorded = -1;
+
+  const MonoTime start_;
+  // Nanoseconds since start_ at which each phase has finished.
+  std::array<std::atomic<int64_t>, kTracePhaseMapSize> phase_end_nanos_;
+
+  DISALLOW_COPY_AND_ASSIGN(SampledTrace);
+};
+
+typedef scoped_refptr<SampledTrace> SampledTracePtr;
+
+// Bounded buffer of the latest captured traces. Older traces are overwritten by newer ones.
+class SampledTraceRing {
+ public:
+  struct Entry {
+    // What was traced, e.g. the RPC method.
+    std::string name;
+    // Threshold which the call has exceeded to be captured.
+    MonoDelta threshold;
+    // Total time of the call.
+    MonoDelta elapsed;
+    SampledTracePtr trace;
+  };
+
+  explicit SampledTraceRing(size_t capacity);
+
+  void Add(Entry entry);
+
+  // Returns captured traces, the oldest first.
+  std::vector<Entry> Entries() const;
+
+ private:
+  const size_t capacity_;
+  mutable simple_spinlock lock_;
+  std::vector<Entry> entries_;
+  // Position of the oldest entry once entries_ reached capacity_.
+  size_t next_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(SampledTraceRing);
+};
+
+} // namespace yb
+
+#endif // YB_UTIL_SAMPLED_TRACE_H
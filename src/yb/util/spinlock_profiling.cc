@@ -41,6 +41,7 @@
 #include "yb/gutil/spinlock.h"
 #include "yb/gutil/strings/human_readable.h"
 #include "yb/gutil/sysinfo.h"
+#include "yb/util/continuous_profiler.h"
 #include "yb/util/debug-util.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/metrics.h"
@@ -225,8 +226,9 @@ ATTRIBUTE_NO_SANITIZE_THREAD
 void SubmitSpinLockProfileData(const void *contendedlock, int64 wait_cycles) {
   bool profiling_enabled = base::subtle::Acquire_Load(&g_profiling_enabled);
   bool long_wait_time = wait_cycles > FLAGS_lock_contention_trace_threshold_cycles;
+  bool continuous_sample = ShouldSampleContention();
   // Short circuit this function quickly in the common case.
-  if (PREDICT_TRUE(!profiling_enabled && !long_wait_time)) {
+  if (PREDICT_TRUE(!profiling_enabled && !long_wait_time && !continuous_sample)) {
     return;
   }
 
@@ -241,6 +243,10 @@ void SubmitSpinLockProfileData(const void *contendedlock, int64 wait_cycles) {
     DCHECK_NOTNULL(g_contention_stacks)->AddStack(stack, wait_cycles);
   }
 
+  if (continuous_sample) {
+    AddContentionSample(stack, wait_cycles);
+  }
+
   if (PREDICT_FALSE(long_wait_time)) {
     Trace* t = Trace::CurrentTrace();
     if (t) {
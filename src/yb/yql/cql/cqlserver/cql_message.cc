@@ -913,9 +913,11 @@ void CQLResponse::Serialize(const CompressionScheme compression_scheme, faststri
   const size_t start_pos = mesg->size(); // save the start position
   const bool compress = (compression_scheme != CQLMessage::CompressionScheme::NONE);
   SerializeHeader(compress, mesg);
+  const Slice trailer = BodyTrailer();
   if (compress) {
     faststring body;
     SerializeBody(&body);
+    body.append(trailer.data(), trailer.size());
     switch (compression_scheme) {
       case CQLMessage::CompressionScheme::LZ4: {
         SerializeInt(static_cast<int32_t>(body.size()), mesg);
@@ -946,11 +948,31 @@ void CQLResponse::Serialize(const CompressionScheme compression_scheme, faststri
     }
   } else {
     SerializeBody(mesg);
+    mesg->append(trailer.data(), trailer.size());
   }
   SERIALIZE_INT(
       mesg->data(), start_pos + kHeaderPosLength, mesg->size() - start_pos - kMessageHeaderLength);
 }
 
+RefCntBuffer CQLResponse::Serialize(const CompressionScheme compression_scheme) const {
+  faststring mesg;
+  const Slice trailer = BodyTrailer();
+  if (compression_scheme != CQLMessage::CompressionScheme::NONE || trailer.empty()) {
+    Serialize(compression_scheme, &mesg);
+    return RefCntBuffer(mesg);
+  }
+
+  // Serialize the header and the body, and copy them and the body trailer into the response buffer
+  // so that the trailer (e.g. the rows of a large result) is copied only once.
+  SerializeHeader(false /* compress */, &mesg);
+  SerializeBody(&mesg);
+  RefCntBuffer buffer(mesg.size() + trailer.size());
+  memcpy(buffer.data(), mesg.data(), mesg.size());
+  memcpy(buffer.data() + mesg.size(), trailer.data(), trailer.size());
+  SERIALIZE_INT(buffer.udata(), kHeaderPosLength, buffer.size() - kMessageHeaderLength);
+  return buffer;
+}
+
 void CQLResponse::SerializeHeader(const bool compress, faststring* mesg) const {
   uint8_t buffer[kMessageHeaderLength];
   SERIALIZE_BYTE(buffer, kHeaderPosVersion, version());
@@ -1484,7 +1506,10 @@ void RowsResultResponse::SerializeResultBody(faststring* mesg) const {
   SerializeRowsMetadata(
       RowsMetadata(result_->table_name(), result_->column_schemas(),
                    result_->paging_state(), skip_metadata_), mesg);
-  mesg->append(result_->rows_data());
+}
+
+Slice RowsResultResponse::BodyTrailer() const {
+  return result_->rows_data();
 }
 
 //----------------------------------------------------------------------------------------
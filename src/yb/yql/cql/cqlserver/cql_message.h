@@ -29,6 +29,7 @@
 #include "yb/rpc/server_event.h"
 #include "yb/yql/cql/ql/util/statement_params.h"
 #include "yb/yql/cql/ql/util/statement_result.h"
+#include "yb/util/ref_cnt_buffer.h"
 #include "yb/util/slice.h"
 #include "yb/util/status.h"
 #include "yb/util/net/sockaddr.h"
@@ -465,6 +466,9 @@ class CQLResponse : public CQLMessage {
   virtual ~CQLResponse();
   virtual void Serialize(CompressionScheme compression_scheme, faststring* mesg) const;
 
+  // Serialize the response into a buffer to be sent to the client.
+  RefCntBuffer Serialize(CompressionScheme compression_scheme) const;
+
  protected:
   CQLResponse(const CQLRequest& request, Opcode opcode);
   CQLResponse(StreamId stream_id, Opcode opcode);
@@ -472,6 +476,10 @@ class CQLResponse : public CQLMessage {
 
   // Function to serialize a response body that all CQLResponse subclasses need to implement
   virtual void SerializeBody(faststring* mesg) const = 0;
+
+  // Already serialized bytes that follow the body serialized by SerializeBody(). An uncompressed
+  // response copies them into the response buffer directly.
+  virtual Slice BodyTrailer() const { return Slice(); }
 };
 
 // ------------------------------ Individual CQL responses -----------------------------------
@@ -727,6 +735,9 @@ class RowsResultResponse : public ResultResponse {
  protected:
   virtual void SerializeResultBody(faststring* mesg) const override;
 
+  // The rows are already in CQL wire format as returned by the tablet servers.
+  virtual Slice BodyTrailer() const override;
+
  private:
   const ql::RowsResult::SharedPtr result_;
   const bool skip_metadata_;
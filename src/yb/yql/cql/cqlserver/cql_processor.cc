@@ -18,6 +18,7 @@
 #include "yb/gutil/strings/escaping.h"
 #include "yb/rpc/rpc_context.h"
 #include "yb/util/crypt.h"
+#include "yb/util/flag_tags.h"
 
 METRIC_DEFINE_histogram(
     server, handler_latency_yb_cqlserver_CQLServerService_GetProcessor,
@@ -57,6 +58,11 @@ namespace yb {
 namespace cqlserver {
 
 DEFINE_bool(use_cassandra_authentication, false, "If to require authentication on startup.");
+DEFINE_bool(cql_cache_normalized_statements, true,
+            "Whether to cache the parse trees of unprepared DML queries, keyed by the query text "
+            "with its literals replaced by bind markers.");
+TAG_FLAG(cql_cache_normalized_statements, advanced);
+TAG_FLAG(cql_cache_normalized_statements, runtime);
 
 const unordered_map<string, vector<string>> kSupportedOptions = {
   {CQLMessage::kCQLVersionOption, {"3.0.0" /* minimum */, "3.4.2" /* current */} },
@@ -165,9 +171,7 @@ void CQLProcessor::SendResponse(const CQLResponse& response) {
   MonoTime response_begin = MonoTime::Now();
   const auto& context = static_cast<const CQLConnectionContext&>(call_->connection()->context());
   const auto compression_scheme = context.compression_scheme();
-  faststring msg;
-  response.Serialize(compression_scheme, &msg);
-  call_->RespondSuccess(RefCntBuffer(msg), cql_metrics_->rpc_method_metrics_);
+  call_->RespondSuccess(response.Serialize(compression_scheme), cql_metrics_->rpc_method_metrics_);
 
   MonoTime response_done = MonoTime::Now();
   cql_metrics_->time_to_process_request_->Increment(
@@ -184,6 +188,8 @@ void CQLProcessor::SendResponse(const CQLResponse& response) {
   request_ = nullptr;
   stmts_.clear();
   parse_trees_.clear();
+  normalized_stmt_ = nullptr;
+  normalized_params_ = nullptr;
   SetCurrentCall(nullptr);
   Return();
 }
@@ -297,10 +303,70 @@ CQLResponse* CQLProcessor::ProcessRequest(const ExecuteRequest& req) {
 
 CQLResponse* CQLProcessor::ProcessRequest(const QueryRequest& req) {
   VLOG(1) << "QUERY " << req.query();
+  if (FLAGS_cql_cache_normalized_statements && ExecuteNormalizedQuery(req)) {
+    return nullptr;
+  }
   RunAsync(req.query(), req.params(), statement_executed_cb_);
   return nullptr;
 }
 
+bool CQLProcessor::ExecuteNormalizedQuery(const QueryRequest& req) {
+  // Queries with bind values are not normalized since their literals cannot be lifted after the
+  // existing bind markers.
+  if (!req.params().values.empty()) {
+    return false;
+  }
+  string text;
+  vector<CQLLiteral> literals;
+  if (!NormalizeStatement(req.query(), &text, &literals)) {
+    return false;
+  }
+
+  // A query that failed to execute as a normalized statement before is not normalized again.
+  const CQLMessage::QueryId failure_id =
+      CQLStatement::GetQueryId(ql_env_.CurrentKeyspace(), req.query());
+  if (service_impl_->IsNormalizationFailure(failure_id)) {
+    return false;
+  }
+
+  // Prepare the normalized query the same way a PREPARE request does.
+  const CQLMessage::QueryId query_id = CQLStatement::GetQueryId(ql_env_.CurrentKeyspace(), text);
+  shared_ptr<CQLStatement> stmt = service_impl_->AllocateNormalizedStatement(
+      query_id, ql_env_.CurrentKeyspace(), text);
+  PreparedResult::UniPtr result;
+  if (!stmt->Prepare(this, service_impl_->normalized_stmts_mem_tracker(), &result).ok()) {
+    // Let the original query report the error.
+    service_impl_->DeleteNormalizedStatement(stmt);
+    service_impl_->AddNormalizationFailure(failure_id);
+    return false;
+  }
+  if (result == nullptr || result->bind_variable_schemas().size() != literals.size()) {
+    service_impl_->AddNormalizationFailure(failure_id);
+    return false;
+  }
+
+  // Convert the literals to the types of their bind markers. If a literal cannot be converted,
+  // execute the original query to report the error against it.
+  const auto& schemas = result->bind_variable_schemas();
+  vector<QLValue> values(literals.size());
+  for (size_t i = 0; i < literals.size(); i++) {
+    if (!LiteralToQLValue(literals[i], schemas[i].type(), &values[i]).ok()) {
+      service_impl_->AddNormalizationFailure(failure_id);
+      return false;
+    }
+  }
+
+  VLOG(2) << "QUERY normalized to " << text;
+  stmt->clear_reparsed();
+  normalized_stmt_ = stmt;
+  normalized_params_.reset(new NormalizedQueryParameters(req.params(), std::move(values)));
+  const Status s = stmt->ExecuteAsync(this, *normalized_params_, statement_executed_cb_);
+  if (PREDICT_FALSE(!s.ok())) {
+    StatementExecuted(s);
+  }
+  return true;
+}
+
 CQLResponse* CQLProcessor::ProcessRequest(const BatchRequest& req) {
   VLOG(1) << "BATCH " << req.queries().size();
 
@@ -407,6 +473,10 @@ CQLResponse* CQLProcessor::ProcessResult(Status s, const ExecutedResult::SharedP
             unprepared_id_ = stmt->query_id();
           }
         }
+        // A stale normalized query is deleted from the cache and retried below as a query.
+        if (normalized_stmt_ != nullptr && normalized_stmt_->stale()) {
+          service_impl_->DeleteNormalizedStatement(normalized_stmt_);
+        }
         if (!unprepared_id_.empty()) {
           return new UnpreparedErrorResponse(*request_, unprepared_id_);
         }
@@ -76,6 +76,11 @@ class CQLProcessor : public ql::QLProcessor {
   CQLResponse* ProcessRequest(const AuthResponseRequest& req);
   CQLResponse* ProcessRequest(const RegisterRequest& req);
 
+  // Execute an unprepared query through the normalized statement cache, keyed by the normalized
+  // query text with its literals replaced by bind markers. Return false if the query cannot be
+  // executed this way and should be parsed and executed as is.
+  bool ExecuteNormalizedQuery(const QueryRequest& req);
+
   // Get a prepared statement and adds it to the set of statements currently being executed.
   std::shared_ptr<const CQLStatement> GetPreparedStatement(const CQLMessage::QueryId& id);
 
@@ -108,6 +113,10 @@ class CQLProcessor : public ql::QLProcessor {
   std::unordered_set<std::shared_ptr<const CQLStatement>> stmts_;
   std::unordered_set<ql::ParseTree::UniPtr> parse_trees_;
 
+  // Cached statement and parameters of the normalized query being executed.
+  std::shared_ptr<const CQLStatement> normalized_stmt_;
+  std::unique_ptr<NormalizedQueryParameters> normalized_params_;
+
   // Current retry count.
   int retry_count_ = 0;
 
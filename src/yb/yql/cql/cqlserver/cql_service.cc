@@ -32,6 +32,12 @@
 DEFINE_int64(cql_service_max_prepared_statement_size_bytes, 0,
              "The maximum amount of memory the CQL proxy should use to maintain prepared "
              "statements. 0 or negative means unlimited.");
+DEFINE_int64(cql_service_max_normalized_statement_size_bytes, 64LL << 20,
+             "The maximum amount of memory the CQL proxy should use to cache the statements of "
+             "normalized unprepared queries. 0 or negative means unlimited.");
+DEFINE_uint64(cql_normalization_failures_cache_size, 10000,
+              "The maximum number of unprepared queries remembered as failing to execute as "
+              "normalized statements, which are executed as written.");
 DEFINE_int32(cql_ybclient_reactor_threads, 24,
              "The number of reactor threads to be used for processing ybclient "
              "requests originating in the cql layer");
@@ -60,21 +66,20 @@ CQLServiceImpl::CQLServiceImpl(CQLServer* server, const CQLServerOptions& opts)
           server->tserver() ? server->tserver()->permanent_uuid() : "",
           &opts, server->metric_entity()),
       next_available_processor_(processors_.end()),
+      prepared_stmts_("CQL prepared statements' memory usage",
+                      FLAGS_cql_service_max_prepared_statement_size_bytes > 0 ?
+                      FLAGS_cql_service_max_prepared_statement_size_bytes : -1,
+                      server->mem_tracker()),
+      normalized_stmts_("CQL normalized statements' memory usage",
+                        FLAGS_cql_service_max_normalized_statement_size_bytes > 0 ?
+                        FLAGS_cql_service_max_normalized_statement_size_bytes : -1,
+                        server->mem_tracker()),
       messenger_(server->messenger()),
       cql_rpcserver_env_(new CQLRpcServerEnv(server->first_rpc_address().address().to_string(),
                                              opts.broadcast_rpc_address)) {
   // TODO(ENG-446): Handle metrics for all the methods individually.
   cql_metrics_ = std::make_shared<CQLMetrics>(server->metric_entity());
 
-  // Setup prepared statements' memory tracker. Add garbage-collect function to delete least
-  // recently used statements when limit is hit.
-  prepared_stmts_mem_tracker_ = MemTracker::CreateTracker(
-      FLAGS_cql_service_max_prepared_statement_size_bytes > 0 ?
-      FLAGS_cql_service_max_prepared_statement_size_bytes : -1,
-      "CQL prepared statements' memory usage", server->mem_tracker());
-  prepared_stmts_mem_tracker_->AddGcFunction(
-      std::bind(&CQLServiceImpl::DeleteLruPreparedStatement, this));
-
   auth_prepared_stmt_ = std::make_shared<ql::Statement>(
       "",
       // TODO: enhance this once we need the other fields to create an AuthenticatedUser.
@@ -153,41 +158,63 @@ void CQLServiceImpl::ReturnProcessor(const CQLProcessorListPos& pos) {
   next_available_processor_ = pos;
 }
 
-shared_ptr<CQLStatement> CQLServiceImpl::AllocatePreparedStatement(
+void CQLServiceImpl::AddNormalizationFailure(const CQLMessage::QueryId& id) {
+  std::lock_guard<std::mutex> guard(normalization_failures_mutex_);
+  // The failures are forgotten all at once when there are too many of them, so that the queries
+  // that fail only for a while, e.g. until their table is created, are normalized again later.
+  if (normalization_failures_.size() >= FLAGS_cql_normalization_failures_cache_size) {
+    normalization_failures_.clear();
+  }
+  normalization_failures_.insert(id);
+}
+
+bool CQLServiceImpl::IsNormalizationFailure(const CQLMessage::QueryId& id) {
+  std::lock_guard<std::mutex> guard(normalization_failures_mutex_);
+  return normalization_failures_.count(id) != 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+CQLStatementCache::CQLStatementCache(const string& mem_tracker_id, const int64_t mem_limit,
+                                     const shared_ptr<MemTracker>& parent_mem_tracker)
+    : mem_tracker_(MemTracker::CreateTracker(mem_limit, mem_tracker_id, parent_mem_tracker)) {
+  // Add garbage-collect function to delete least recently used statements when limit is hit.
+  mem_tracker_->AddGcFunction(std::bind(&CQLStatementCache::DeleteLru, this));
+}
+
+shared_ptr<CQLStatement> CQLStatementCache::Allocate(
     const CQLMessage::QueryId& query_id, const string& keyspace, const string& ql_stmt) {
-  // Get exclusive lock before allocating a prepared statement and updating the LRU list.
-  std::lock_guard<std::mutex> guard(prepared_stmts_mutex_);
+  // Get exclusive lock before allocating a statement and updating the LRU list.
+  std::lock_guard<std::mutex> guard(mutex_);
 
   shared_ptr<CQLStatement> stmt;
-  const auto itr = prepared_stmts_map_.find(query_id);
-  if (itr == prepared_stmts_map_.end()) {
+  const auto itr = stmts_map_.find(query_id);
+  if (itr == stmts_map_.end()) {
     // Allocate the prepared statement placeholder that multiple clients trying to prepare the same
     // statement to contend on. The statement will then be prepared by one client while the rest
     // wait for the results.
-    stmt = prepared_stmts_map_.emplace(
+    stmt = stmts_map_.emplace(
         query_id, std::make_shared<CQLStatement>(
-            keyspace, ql_stmt, prepared_stmts_list_.end())).first->second;
-    InsertLruPreparedStatementUnlocked(stmt);
+            keyspace, ql_stmt, stmts_list_.end())).first->second;
+    InsertLruUnlocked(stmt);
   } else {
     // Return existing statement if found.
     stmt = itr->second;
-    MoveLruPreparedStatementUnlocked(stmt);
+    MoveLruUnlocked(stmt);
   }
 
-  VLOG(1) << "InsertPreparedStatement: CQL prepared statement cache count = "
-          << prepared_stmts_map_.size() << "/" << prepared_stmts_list_.size()
-          << ", memory usage = " << prepared_stmts_mem_tracker_->consumption();
+  VLOG(1) << "InsertPreparedStatement: " << mem_tracker_->id() << " count = "
+          << stmts_map_.size() << "/" << stmts_list_.size()
+          << ", memory usage = " << mem_tracker_->consumption();
 
   return stmt;
 }
 
-shared_ptr<const CQLStatement> CQLServiceImpl::GetPreparedStatement(
-    const CQLMessage::QueryId& query_id) {
-  // Get exclusive lock before looking up a prepared statement and updating the LRU list.
-  std::lock_guard<std::mutex> guard(prepared_stmts_mutex_);
+shared_ptr<const CQLStatement> CQLStatementCache::Get(const CQLMessage::QueryId& query_id) {
+  // Get exclusive lock before looking up a statement and updating the LRU list.
+  std::lock_guard<std::mutex> guard(mutex_);
 
-  const auto itr = prepared_stmts_map_.find(query_id);
-  if (itr == prepared_stmts_map_.end()) {
+  const auto itr = stmts_map_.find(query_id);
+  if (itr == stmts_map_.end()) {
     return nullptr;
   }
 
@@ -199,64 +226,63 @@ shared_ptr<const CQLStatement> CQLServiceImpl::GetPreparedStatement(
   }
   // If the statement is stale, delete it.
   if (stmt->stale()) {
-    DeletePreparedStatementUnlocked(stmt);
+    DeleteUnlocked(stmt);
     return nullptr;
   }
 
-  MoveLruPreparedStatementUnlocked(stmt);
+  MoveLruUnlocked(stmt);
   return stmt;
 }
 
-void CQLServiceImpl::DeletePreparedStatement(const shared_ptr<const CQLStatement>& stmt) {
-  // Get exclusive lock before deleting the prepared statement.
-  std::lock_guard<std::mutex> guard(prepared_stmts_mutex_);
+void CQLStatementCache::Delete(const shared_ptr<const CQLStatement>& stmt) {
+  // Get exclusive lock before deleting the statement.
+  std::lock_guard<std::mutex> guard(mutex_);
 
-  DeletePreparedStatementUnlocked(stmt);
+  DeleteUnlocked(stmt);
 
-  VLOG(1) << "DeletePreparedStatement: CQL prepared statement cache count = "
-          << prepared_stmts_map_.size() << "/" << prepared_stmts_list_.size()
-          << ", memory usage = " << prepared_stmts_mem_tracker_->consumption();
+  VLOG(1) << "DeletePreparedStatement: " << mem_tracker_->id() << " count = "
+          << stmts_map_.size() << "/" << stmts_list_.size()
+          << ", memory usage = " << mem_tracker_->consumption();
 }
 
-void CQLServiceImpl::InsertLruPreparedStatementUnlocked(const shared_ptr<CQLStatement>& stmt) {
+void CQLStatementCache::InsertLruUnlocked(const shared_ptr<CQLStatement>& stmt) {
   // Insert the statement at the front of the LRU list.
-  stmt->set_pos(prepared_stmts_list_.insert(prepared_stmts_list_.begin(), stmt));
+  stmt->set_pos(stmts_list_.insert(stmts_list_.begin(), stmt));
 }
 
-void CQLServiceImpl::MoveLruPreparedStatementUnlocked(const shared_ptr<CQLStatement>& stmt) {
+void CQLStatementCache::MoveLruUnlocked(const shared_ptr<CQLStatement>& stmt) {
   // Move the statement to the front of the LRU list.
-  prepared_stmts_list_.splice(prepared_stmts_list_.begin(), prepared_stmts_list_, stmt->pos());
+  stmts_list_.splice(stmts_list_.begin(), stmts_list_, stmt->pos());
 }
 
-void CQLServiceImpl::DeletePreparedStatementUnlocked(
-    const std::shared_ptr<const CQLStatement> stmt) {
+void CQLStatementCache::DeleteUnlocked(const std::shared_ptr<const CQLStatement> stmt) {
   // Remove statement from cache by looking it up by query ID and only when it is same statement
   // object. Note that the "stmt" parameter above is not a ref ("&") intentionally so that we have
-  // a separate copy of the shared_ptr and not the very shared_ptr in prepared_stmts_map_ or
-  // prepared_stmt_list_ we are deleting.
-  const auto itr = prepared_stmts_map_.find(stmt->query_id());
-  if (itr != prepared_stmts_map_.end() && itr->second == stmt) {
-    prepared_stmts_map_.erase(itr);
+  // a separate copy of the shared_ptr and not the very shared_ptr in stmts_map_ or stmts_list_ we
+  // are deleting.
+  const auto itr = stmts_map_.find(stmt->query_id());
+  if (itr != stmts_map_.end() && itr->second == stmt) {
+    stmts_map_.erase(itr);
   }
   // Remove statement from LRU list only when it is in the list, i.e. pos() != end().
-  if (stmt->pos() != prepared_stmts_list_.end()) {
-    prepared_stmts_list_.erase(stmt->pos());
-    stmt->set_pos(prepared_stmts_list_.end());
+  if (stmt->pos() != stmts_list_.end()) {
+    stmts_list_.erase(stmt->pos());
+    stmt->set_pos(stmts_list_.end());
   }
 }
 
-void CQLServiceImpl::DeleteLruPreparedStatement() {
+void CQLStatementCache::DeleteLru() {
   // Get exclusive lock before deleting the least recently used statement at the end of the LRU
   // list from the cache.
-  std::lock_guard<std::mutex> guard(prepared_stmts_mutex_);
+  std::lock_guard<std::mutex> guard(mutex_);
 
-  if (!prepared_stmts_list_.empty()) {
-    DeletePreparedStatementUnlocked(prepared_stmts_list_.back());
+  if (!stmts_list_.empty()) {
+    DeleteUnlocked(stmts_list_.back());
   }
 
-  VLOG(1) << "DeleteLruPreparedStatement: CQL prepared statement cache count = "
-          << prepared_stmts_map_.size() << "/" << prepared_stmts_list_.size()
-          << ", memory usage = " << prepared_stmts_mem_tracker_->consumption();
+  VLOG(1) << "DeleteLruPreparedStatement: " << mem_tracker_->id() << " count = "
+          << stmts_map_.size() << "/" << stmts_list_.size()
+          << ", memory usage = " << mem_tracker_->consumption();
 }
 
 }  // namespace cqlserver
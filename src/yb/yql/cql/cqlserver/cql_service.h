@@ -17,6 +17,8 @@
 #ifndef YB_YQL_CQL_CQLSERVER_CQL_SERVICE_H_
 #define YB_YQL_CQL_CQLSERVER_CQL_SERVICE_H_
 
+#include <mutex>
+#include <unordered_set>
 #include <vector>
 
 #include "yb/yql/cql/cqlserver/cql_message.h"
@@ -47,6 +49,54 @@ class CQLMetrics;
 class CQLProcessor;
 class CQLServer;
 
+// A cache of prepared statements with a LRU list. The memory used by the statements is consumed
+// from a memory tracker, which deletes the least recently used statements when its limit is hit.
+class CQLStatementCache {
+ public:
+  // Create the cache with a memory tracker of the given id and limit (negative means unlimited).
+  CQLStatementCache(const std::string& mem_tracker_id, int64_t mem_limit,
+                    const std::shared_ptr<MemTracker>& parent_mem_tracker);
+
+  // Allocate a statement. If the statement already exists, return it instead.
+  std::shared_ptr<CQLStatement> Allocate(
+      const CQLMessage::QueryId& id, const std::string& keyspace, const std::string& ql_stmt);
+
+  // Look up a prepared statement by its id. Nullptr will be returned if the statement is not found.
+  std::shared_ptr<const CQLStatement> Get(const CQLMessage::QueryId& id);
+
+  // Delete the statement from the cache.
+  void Delete(const std::shared_ptr<const CQLStatement>& stmt);
+
+  // Return the memory tracker of the statements.
+  const std::shared_ptr<MemTracker>& mem_tracker() const { return mem_tracker_; }
+
+ private:
+  // Insert a statement at the front of the LRU list. "mutex_" needs to be locked before this call.
+  void InsertLruUnlocked(const std::shared_ptr<CQLStatement>& stmt);
+
+  // Move a statement to the front of the LRU list. "mutex_" needs to be locked before this call.
+  void MoveLruUnlocked(const std::shared_ptr<CQLStatement>& stmt);
+
+  // Delete a statement from the cache and the LRU list. "mutex_" needs to be locked before this
+  // call.
+  void DeleteUnlocked(const std::shared_ptr<const CQLStatement> stmt);
+
+  // Delete the least recently used statement from the cache to free up memory.
+  void DeleteLru();
+
+  // Statements cache.
+  CQLStatementMap stmts_map_;
+
+  // Statements LRU list (least recently used one at the end).
+  CQLStatementList stmts_list_;
+
+  // Mutex that protects the statements and the LRU list.
+  std::mutex mutex_;
+
+  // Tracker to measure and limit memory usage of the statements.
+  std::shared_ptr<MemTracker> mem_tracker_;
+};
+
 class CQLServiceImpl : public CQLServerServiceIf {
  public:
   // Constructor.
@@ -62,21 +112,54 @@ class CQLServiceImpl : public CQLServerServiceIf {
 
   // Allocate a prepared statement. If the statement already exists, return it instead.
   std::shared_ptr<CQLStatement> AllocatePreparedStatement(
-      const CQLMessage::QueryId& id, const std::string& keyspace, const std::string& ql_stmt);
+      const CQLMessage::QueryId& id, const std::string& keyspace, const std::string& ql_stmt) {
+    return prepared_stmts_.Allocate(id, keyspace, ql_stmt);
+  }
 
   // Look up a prepared statement by its id. Nullptr will be returned if the statement is not found.
-  std::shared_ptr<const CQLStatement> GetPreparedStatement(const CQLMessage::QueryId& id);
+  std::shared_ptr<const CQLStatement> GetPreparedStatement(const CQLMessage::QueryId& id) {
+    return prepared_stmts_.Get(id);
+  }
 
   std::shared_ptr<ql::Statement> GetAuthPreparedStatement() const { return auth_prepared_stmt_; }
 
   // Delete the prepared statement from the cache.
-  void DeletePreparedStatement(const std::shared_ptr<const CQLStatement>& stmt);
+  void DeletePreparedStatement(const std::shared_ptr<const CQLStatement>& stmt) {
+    prepared_stmts_.Delete(stmt);
+  }
 
   // Return the memory tracker for prepared statements.
   std::shared_ptr<MemTracker> prepared_stmts_mem_tracker() const {
-    return prepared_stmts_mem_tracker_;
+    return prepared_stmts_.mem_tracker();
+  }
+
+  // Allocate the statement of a normalized unprepared query. The statements of normalized queries
+  // are cached apart from the ones prepared by the clients, so that many distinct unprepared
+  // queries do not evict the statements the clients prepared.
+  std::shared_ptr<CQLStatement> AllocateNormalizedStatement(
+      const CQLMessage::QueryId& id, const std::string& keyspace, const std::string& ql_stmt) {
+    return normalized_stmts_.Allocate(id, keyspace, ql_stmt);
+  }
+
+  // Delete the statement of a normalized query from the cache.
+  void DeleteNormalizedStatement(const std::shared_ptr<const CQLStatement>& stmt) {
+    normalized_stmts_.Delete(stmt);
+  }
+
+  // Return the memory tracker for the statements of normalized queries.
+  std::shared_ptr<MemTracker> normalized_stmts_mem_tracker() const {
+    return normalized_stmts_.mem_tracker();
   }
 
+  // Record that the unprepared query with the given id could not be executed as a normalized
+  // statement, e.g. because a literal does not match the type of its column. Such a query is
+  // executed as written without normalizing it again.
+  void AddNormalizationFailure(const CQLMessage::QueryId& id);
+
+  // Return true if the unprepared query with the given id could not be executed as a normalized
+  // statement.
+  bool IsNormalizationFailure(const CQLMessage::QueryId& id);
+
   // Return the YBClient to communicate with either master or tserver.
   const std::shared_ptr<client::YBClient>& client() const;
 
@@ -98,21 +181,6 @@ class CQLServiceImpl : public CQLServerServiceIf {
   // Either gets an available processor or creates a new one.
   CQLProcessor *GetProcessor();
 
-  // Insert a prepared statement at the front of the LRU list. "prepared_stmts_mutex_" needs to be
-  // locked before this call.
-  void InsertLruPreparedStatementUnlocked(const std::shared_ptr<CQLStatement>& stmt);
-
-  // Move a prepared statement to the front of the LRU list. "prepared_stmts_mutex_" needs to be
-  // locked before this call.
-  void MoveLruPreparedStatementUnlocked(const std::shared_ptr<CQLStatement>& stmt);
-
-  // Delete a prepared statement from the cache and the LRU list. "prepared_stmts_mutex_" needs to
-  // be locked before this call.
-  void DeletePreparedStatementUnlocked(const std::shared_ptr<const CQLStatement> stmt);
-
-  // Delete the least recently used prepared statement from the cache to free up memory.
-  void DeleteLruPreparedStatement();
-
   // CQLServer of this service.
   CQLServer* const server_;
 
@@ -134,19 +202,19 @@ class CQLServiceImpl : public CQLServerServiceIf {
   // Mutex that protects access to processors_.
   std::mutex processors_mutex_;
 
-  // Prepared statements cache.
-  CQLStatementMap prepared_stmts_map_;
+  // Statements prepared by the clients.
+  CQLStatementCache prepared_stmts_;
 
-  // Prepared statements LRU list (least recently used one at the end).
-  CQLStatementList prepared_stmts_list_;
+  // Statements of normalized unprepared queries.
+  CQLStatementCache normalized_stmts_;
 
-  // Mutex that protects the prepared statements and the LRU list.
-  std::mutex prepared_stmts_mutex_;
+  // Ids of the unprepared queries that could not be executed as normalized statements.
+  std::unordered_set<CQLMessage::QueryId> normalization_failures_;
 
-  std::shared_ptr<ql::Statement> auth_prepared_stmt_;
+  // Mutex that protects normalization_failures_.
+  std::mutex normalization_failures_mutex_;
 
-  // Tracker to measure and limit memory usage of prepared statements.
-  std::shared_ptr<MemTracker> prepared_stmts_mem_tracker_;
+  std::shared_ptr<ql::Statement> auth_prepared_stmt_;
 
   // Metrics to be collected and reported.
   yb::rpc::RpcMethodMetrics metrics_;
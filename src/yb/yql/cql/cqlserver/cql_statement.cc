@@ -15,8 +15,21 @@
 
 #include "yb/yql/cql/cqlserver/cql_statement.h"
 
+#include <strings.h>
+
+#include <algorithm>
+
 #include <openssl/md5.h>
 
+#include "yb/gutil/strings/ascii_ctype.h"
+#include "yb/gutil/strings/escaping.h"
+#include "yb/util/date_time.h"
+#include "yb/util/decimal.h"
+#include "yb/util/net/inetaddress.h"
+#include "yb/util/stol_utils.h"
+#include "yb/util/uuid.h"
+#include "yb/util/varint.h"
+
 namespace yb {
 namespace cqlserver {
 
@@ -39,5 +52,338 @@ CQLMessage::QueryId CQLStatement::GetQueryId(const string& keyspace, const strin
   return CQLMessage::QueryId(util::to_char_ptr(md5), sizeof(md5));
 }
 
+//------------------------------------------------------------------------------------------------
+namespace {
+
+bool IsIdentifierChar(const char c) {
+  return ascii_isalnum(c) || c == '_';
+}
+
+size_t SkipDigits(const std::string& text, size_t pos) {
+  while (pos < text.size() && ascii_isdigit(text[pos])) {
+    pos++;
+  }
+  return pos;
+}
+
+// Return the length of the UUID literal at "pos" of "text", or 0 if there is none.
+size_t UuidLiteralLength(const std::string& text, const size_t pos) {
+  static constexpr size_t kUuidLength = 36;
+  if (text.size() - pos < kUuidLength) {
+    return 0;
+  }
+  for (size_t i = 0; i < kUuidLength; i++) {
+    const char c = text[pos + i];
+    if (i == 8 || i == 13 || i == 18 || i == 23) {
+      if (c != '-') {
+        return 0;
+      }
+    } else if (!ascii_isxdigit(c)) {
+      return 0;
+    }
+  }
+  if (pos + kUuidLength < text.size() && IsIdentifierChar(text[pos + kUuidLength])) {
+    return 0;
+  }
+  return kUuidLength;
+}
+
+} // namespace
+
+bool NormalizeStatement(const std::string& text, std::string* normalized,
+                        std::vector<CQLLiteral>* literals) {
+  normalized->clear();
+  literals->clear();
+
+  // Only DML statements are normalized.
+  static const char* const kDmlKeywords[] = { "SELECT", "INSERT", "UPDATE", "DELETE" };
+  size_t pos = 0;
+  while (pos < text.size() && ascii_isspace(text[pos])) {
+    pos++;
+  }
+  size_t end = pos;
+  while (end < text.size() && IsIdentifierChar(text[end])) {
+    end++;
+  }
+  if (std::none_of(std::begin(kDmlKeywords), std::end(kDmlKeywords),
+                   [&text, pos, end](const char* keyword) {
+                     return strlen(keyword) == end - pos &&
+                            strncasecmp(text.data() + pos, keyword, end - pos) == 0;
+                   })) {
+    return false;
+  }
+
+  normalized->reserve(text.size());
+  int collection_depth = 0;
+  bool space = false;
+  while (pos < text.size()) {
+    const char c = text[pos];
+    const char next = pos + 1 < text.size() ? text[pos + 1] : '\0';
+
+    // Collapse whitespaces and comments into one space.
+    if (ascii_isspace(c)) {
+      space = true;
+      pos++;
+      continue;
+    }
+    if ((c == '-' && next == '-') || (c == '/' && next == '/')) {
+      pos = text.find('\n', pos);
+      if (pos == std::string::npos) {
+        break;
+      }
+      space = true;
+      continue;
+    }
+    if (c == '/' && next == '*') {
+      pos = text.find("*/", pos + 2);
+      if (pos == std::string::npos) {
+        return false;
+      }
+      pos += 2;
+      space = true;
+      continue;
+    }
+
+    // Bind markers and literals following a sign or a dot are not lifted.
+    const char prev = normalized->empty() ? '\0' : normalized->back();
+    const bool liftable = collection_depth == 0 && prev != '-' && prev != '+' && prev != '.';
+    if (space && !normalized->empty()) {
+      normalized->push_back(' ');
+    }
+    space = false;
+
+    // Replace the literal at [pos, end) with a bind marker, or keep it in place.
+    const auto add_literal = [&](const CQLLiteral::Kind kind, std::string value) {
+      if (liftable) {
+        normalized->push_back('?');
+        literals->push_back(CQLLiteral{kind, std::move(value)});
+      } else {
+        normalized->append(text, pos, end - pos);
+      }
+      pos = end;
+    };
+
+    if (c == '\'') {
+      std::string value;
+      for (end = pos + 1; ; end++) {
+        if (end == text.size()) {
+          return false;
+        }
+        if (text[end] == '\'') {
+          if (end + 1 < text.size() && text[end + 1] == '\'') {
+            end++;
+          } else {
+            break;
+          }
+        }
+        value.push_back(text[end]);
+      }
+      end++;
+      add_literal(CQLLiteral::Kind::kString, std::move(value));
+    } else if (c == '"') {
+      // Quoted identifiers are kept verbatim.
+      for (end = pos + 1; ; end++) {
+        if (end == text.size()) {
+          return false;
+        }
+        if (text[end] == '"') {
+          if (end + 1 < text.size() && text[end + 1] == '"') {
+            end++;
+          } else {
+            break;
+          }
+        }
+      }
+      end++;
+      normalized->append(text, pos, end - pos);
+      pos = end;
+    } else if (c == '?' || (c == '$' && next == '$') || (c == ':' && collection_depth == 0)) {
+      // Statements with bind markers or $$ strings are not normalized.
+      return false;
+    } else if (ascii_isxdigit(c) && (end = pos + UuidLiteralLength(text, pos)) > pos) {
+      add_literal(CQLLiteral::Kind::kUuid, text.substr(pos, end - pos));
+    } else if (c == '0' && (next == 'x' || next == 'X')) {
+      for (end = pos + 2; end < text.size() && ascii_isxdigit(text[end]); end++) {}
+      if (end < text.size() && IsIdentifierChar(text[end])) {
+        return false;
+      }
+      add_literal(CQLLiteral::Kind::kBlob, text.substr(pos + 2, end - pos - 2));
+    } else if (ascii_isdigit(c)) {
+      CQLLiteral::Kind kind = CQLLiteral::Kind::kInteger;
+      end = SkipDigits(text, pos);
+      if (end < text.size() && text[end] == '.') {
+        kind = CQLLiteral::Kind::kFloat;
+        end = SkipDigits(text, end + 1);
+      }
+      if (end < text.size() && (text[end] == 'e' || text[end] == 'E')) {
+        size_t exponent = end + 1;
+        if (exponent < text.size() && (text[exponent] == '+' || text[exponent] == '-')) {
+          exponent++;
+        }
+        if (exponent < text.size() && ascii_isdigit(text[exponent])) {
+          kind = CQLLiteral::Kind::kFloat;
+          end = SkipDigits(text, exponent);
+        }
+      }
+      if (end < text.size() && IsIdentifierChar(text[end])) {
+        return false;
+      }
+      add_literal(kind, text.substr(pos, end - pos));
+    } else if (ascii_isalpha(c) || c == '_') {
+      for (end = pos; end < text.size() && IsIdentifierChar(text[end]); end++) {}
+      if (end - pos == 4 && strncasecmp(text.data() + pos, "true", 4) == 0) {
+        add_literal(CQLLiteral::Kind::kBoolean, "true");
+      } else if (end - pos == 5 && strncasecmp(text.data() + pos, "false", 5) == 0) {
+        add_literal(CQLLiteral::Kind::kBoolean, "false");
+      } else {
+        normalized->append(text, pos, end - pos);
+        pos = end;
+      }
+    } else {
+      if (c == '{' || c == '[') {
+        collection_depth++;
+      } else if ((c == '}' || c == ']') && collection_depth > 0) {
+        collection_depth--;
+      }
+      normalized->push_back(c);
+      pos++;
+    }
+  }
+  return true;
+}
+
+Status LiteralToQLValue(const CQLLiteral& literal, const std::shared_ptr<QLType>& type,
+                        QLValue* value) {
+  const DataType data_type = type->main();
+  switch (literal.kind) {
+    case CQLLiteral::Kind::kString:
+      switch (data_type) {
+        case DataType::STRING:
+          value->set_string_value(literal.value);
+          return Status::OK();
+        case DataType::TIMESTAMP: {
+          auto timestamp = DateTime::TimestampFromString(literal.value);
+          RETURN_NOT_OK(timestamp);
+          value->set_timestamp_value(*timestamp);
+          return Status::OK();
+        }
+        case DataType::INET: {
+          InetAddress addr;
+          RETURN_NOT_OK(addr.FromString(literal.value));
+          value->set_inetaddress_value(addr);
+          return Status::OK();
+        }
+        default:
+          break;
+      }
+      break;
+    case CQLLiteral::Kind::kInteger:
+      switch (data_type) {
+        case DataType::INT8: {
+          auto int_value = util::CheckedStoInt<int8_t>(literal.value);
+          RETURN_NOT_OK(int_value);
+          value->set_int8_value(*int_value);
+          return Status::OK();
+        }
+        case DataType::INT16: {
+          auto int_value = util::CheckedStoInt<int16_t>(literal.value);
+          RETURN_NOT_OK(int_value);
+          value->set_int16_value(*int_value);
+          return Status::OK();
+        }
+        case DataType::INT32: {
+          auto int_value = util::CheckedStoInt<int32_t>(literal.value);
+          RETURN_NOT_OK(int_value);
+          value->set_int32_value(*int_value);
+          return Status::OK();
+        }
+        case DataType::INT64: {
+          auto int_value = util::CheckedStoll(literal.value);
+          RETURN_NOT_OK(int_value);
+          value->set_int64_value(*int_value);
+          return Status::OK();
+        }
+        case DataType::TIMESTAMP: {
+          auto int_value = util::CheckedStoll(literal.value);
+          RETURN_NOT_OK(int_value);
+          value->set_timestamp_value(DateTime::TimestampFromInt(*int_value));
+          return Status::OK();
+        }
+        case DataType::VARINT: {
+          util::VarInt varint;
+          RETURN_NOT_OK(varint.FromString(literal.value));
+          value->set_varint_value(varint);
+          return Status::OK();
+        }
+        default:
+          break;
+      }
+      FALLTHROUGH_INTENDED;
+    case CQLLiteral::Kind::kFloat:
+      switch (data_type) {
+        case DataType::FLOAT: {
+          auto double_value = util::CheckedStold(literal.value);
+          RETURN_NOT_OK(double_value);
+          value->set_float_value(*double_value);
+          return Status::OK();
+        }
+        case DataType::DOUBLE: {
+          auto double_value = util::CheckedStold(literal.value);
+          RETURN_NOT_OK(double_value);
+          value->set_double_value(*double_value);
+          return Status::OK();
+        }
+        case DataType::DECIMAL: {
+          util::Decimal decimal;
+          RETURN_NOT_OK(decimal.FromString(literal.value));
+          value->set_decimal_value(decimal.EncodeToComparable());
+          return Status::OK();
+        }
+        default:
+          break;
+      }
+      break;
+    case CQLLiteral::Kind::kBoolean:
+      if (data_type == DataType::BOOL) {
+        value->set_bool_value(literal.value == "true");
+        return Status::OK();
+      }
+      break;
+    case CQLLiteral::Kind::kUuid:
+      if (data_type == DataType::UUID || data_type == DataType::TIMEUUID) {
+        Uuid uuid;
+        RETURN_NOT_OK(uuid.FromString(literal.value));
+        if (data_type == DataType::UUID) {
+          value->set_uuid_value(uuid);
+        } else {
+          RETURN_NOT_OK(uuid.IsTimeUuid());
+          value->set_timeuuid_value(uuid);
+        }
+        return Status::OK();
+      }
+      break;
+    case CQLLiteral::Kind::kBlob:
+      if (data_type == DataType::BINARY && literal.value.size() % 2 == 0) {
+        value->set_binary_value(a2b_hex(literal.value));
+        return Status::OK();
+      }
+      break;
+  }
+  return STATUS_SUBSTITUTE(InvalidArgument, "Cannot convert literal $0 to $1",
+                           literal.value, type->ToString());
+}
+
+//------------------------------------------------------------------------------------------------
+Status NormalizedQueryParameters::GetBindVariable(const std::string& name,
+                                                  const int64_t pos,
+                                                  const std::shared_ptr<QLType>& type,
+                                                  QLValue* value) const {
+  if (pos < 0 || static_cast<size_t>(pos) >= literal_values_.size()) {
+    return STATUS_SUBSTITUTE(RuntimeError, "Bind variable position $0 out of range", pos);
+  }
+  *value = literal_values_[pos];
+  return Status::OK();
+}
+
 }  // namespace cqlserver
 }  // namespace yb
@@ -20,6 +20,7 @@
 #define YB_YQL_CQL_CQLSERVER_CQL_STATEMENT_H_
 
 #include <list>
+#include <vector>
 
 #include "yb/yql/cql/cqlserver/cql_message.h"
 #include "yb/yql/cql/ql/statement.h"
@@ -59,6 +60,51 @@ class CQLStatement : public ql::Statement {
   mutable CQLStatementListPos pos_;
 };
 
+// A literal lifted out of an unprepared CQL statement by NormalizeStatement().
+struct CQLLiteral {
+  enum class Kind {
+    kString,   // 'text', with quotes removed and '' unescaped.
+    kInteger,  // 123
+    kFloat,    // 1.5, 1e10
+    kBoolean,  // true / false, in lower case.
+    kUuid,     // 123e4567-e89b-12d3-a456-426655440000
+    kBlob      // 0xcafe, with the 0x prefix removed.
+  };
+
+  Kind kind;
+  std::string value;
+};
+
+// Normalize the text of an unprepared DML statement so that statements differing only in their
+// literals share the same text, and hence the same cached parse tree. Comments are removed,
+// whitespaces are collapsed and the literals are replaced with '?' bind markers and returned in
+// "literals" in the order of the markers. Literals in collection values and signed numbers are
+// kept in place. Return false if the statement is not a DML or cannot be normalized safely (e.g.
+// it already has bind markers).
+bool NormalizeStatement(const std::string& text, std::string* normalized,
+                        std::vector<CQLLiteral>* literals);
+
+// Convert a lifted literal to the value of the given type, the same way the analyzer converts
+// literals in the statement text.
+CHECKED_STATUS LiteralToQLValue(const CQLLiteral& literal, const std::shared_ptr<QLType>& type,
+                                QLValue* value);
+
+// Parameters for executing a normalized statement with the lifted literals as its bind values.
+class NormalizedQueryParameters : public CQLMessage::QueryParameters {
+ public:
+  NormalizedQueryParameters(const CQLMessage::QueryParameters& params,
+                            std::vector<QLValue>&& values)
+      : CQLMessage::QueryParameters(params), literal_values_(std::move(values)) {}
+
+  CHECKED_STATUS GetBindVariable(const std::string& name,
+                                 int64_t pos,
+                                 const std::shared_ptr<QLType>& type,
+                                 QLValue* value) const override;
+
+ private:
+  const std::vector<QLValue> literal_values_;
+};
+
 }  // namespace cqlserver
 }  // namespace yb
 
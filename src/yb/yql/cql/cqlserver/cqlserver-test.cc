@@ -20,12 +20,17 @@
 
 #include "yb/yql/cql/cqlserver/cql_message.h"
 #include "yb/yql/cql/cqlserver/cql_server.h"
+#include "yb/yql/cql/cqlserver/cql_statement.h"
 
 #include "yb/gutil/strings/join.h"
+#include "yb/gutil/strings/util.h"
 #include "yb/util/cast.h"
+#include "yb/util/metrics.h"
 #include "yb/util/net/net_util.h"
 #include "yb/util/test_util.h"
 
+METRIC_DECLARE_histogram(handler_latency_yb_cqlserver_SQLProcessor_ParseRequest);
+
 namespace yb {
 namespace cqlserver {
 
@@ -45,6 +50,12 @@ class TestCQLService : public YBTableTestBase {
 
   void SendRequestAndExpectResponse(const string& cmd, const string& resp);
 
+  // Send an unprepared QUERY request and return the opcode and the body of the response.
+  void ExecuteQuery(const string& query, uint8_t* opcode, string* body);
+
+  // Number of statements parsed by the CQL server.
+  int64_t NumParsedStatements();
+
   int server_port() { return cql_server_port_; }
  private:
   Status SendRequestAndGetResponse(
@@ -132,6 +143,47 @@ void TestCQLService::SendRequestAndExpectResponse(const string& cmd, const strin
   CHECK_EQ(resp, string(reinterpret_cast<char*>(resp_), resp.length()));
 }
 
+namespace {
+
+void AppendInt32(const uint32_t value, string* out) {
+  for (int shift = 24; shift >= 0; shift -= 8) {
+    out->push_back(static_cast<char>((value >> shift) & 0xff));
+  }
+}
+
+} // namespace
+
+void TestCQLService::ExecuteQuery(const string& query, uint8_t* opcode, string* body) {
+  // QUERY request using version V4 with consistency ONE and no flags.
+  string request_body;
+  AppendInt32(query.length(), &request_body);
+  request_body += query;
+  request_body += BINARY_STRING("\x00\x01" "\x00");
+  string cmd = BINARY_STRING("\x04\x00\x00\x00\x07");
+  AppendInt32(request_body.length(), &cmd);
+  cmd += request_body;
+
+  int32_t bytes_written = 0;
+  ASSERT_OK(client_sock_.Write(util::to_uchar_ptr(cmd.c_str()), cmd.length(), &bytes_written));
+  ASSERT_EQ(cmd.length(), bytes_written);
+
+  const MonoTime deadline = MonoTime::Now() + MonoDelta::FromSeconds(60);
+  constexpr size_t kHeaderLength = 9;
+  size_t bytes_read = 0;
+  ASSERT_OK(client_sock_.BlockingRecv(resp_, kHeaderLength, &bytes_read, deadline));
+  *opcode = resp_[4];
+  const size_t body_length =
+      (resp_[5] << 24) | (resp_[6] << 16) | (resp_[7] << 8) | resp_[8];
+  body->resize(body_length);
+  ASSERT_OK(client_sock_.BlockingRecv(
+      util::to_uchar_ptr(&(*body)[0]), body_length, &bytes_read, deadline));
+}
+
+int64_t TestCQLService::NumParsedStatements() {
+  return METRIC_handler_latency_yb_cqlserver_SQLProcessor_ParseRequest.Instantiate(
+      server_->metric_entity())->TotalCount();
+}
+
 // The following test cases test the CQL protocol marshalling/unmarshalling with hand-coded
 // request messages and expected responses. They are good as basic and error-handling tests.
 // These are expected to be few.
@@ -233,6 +285,59 @@ TEST_F(TestCQLService, InvalidRequest) {
                     "\x00\x00\x00\x0a" "\x00\x17" "Request length too long"));
 }
 
+TEST_F(TestCQLService, NormalizedQueries) {
+  constexpr uint8_t kResultOpcode = 0x08;
+  uint8_t opcode = 0;
+  string body;
+
+  SendRequestAndExpectResponse(
+      BINARY_STRING("\x04\x00\x00\x00\x01" "\x00\x00\x00\x16"
+                    "\x00\x01" "\x00\x0b" "CQL_VERSION"
+                               "\x00\x05" "3.0.0"),
+      BINARY_STRING("\x84\x00\x00\x00\x02" "\x00\x00\x00\x00"));
+  ASSERT_NO_FATALS(ExecuteQuery("CREATE KEYSPACE test_ks", &opcode, &body));
+  ASSERT_EQ(kResultOpcode, opcode) << body;
+  ASSERT_NO_FATALS(ExecuteQuery(
+      "CREATE TABLE test_ks.t (h INT PRIMARY KEY, v INT)", &opcode, &body));
+  ASSERT_EQ(kResultOpcode, opcode) << body;
+
+  // The value of the single row of a result, i.e. the row count and the cell with an INT value.
+  auto expected_row = [](int32_t value) {
+    string row;
+    AppendInt32(1, &row);
+    AppendInt32(4, &row);
+    AppendInt32(value, &row);
+    return row;
+  };
+
+  int64_t num_parsed = 0;
+  for (int i = 1; i <= 10; ++i) {
+    ASSERT_NO_FATALS(ExecuteQuery(
+        Substitute("INSERT INTO test_ks.t (h, v) VALUES ($0, $1)", i, i * 10), &opcode, &body));
+    ASSERT_EQ(kResultOpcode, opcode) << body;
+    ASSERT_NO_FATALS(ExecuteQuery(
+        Substitute("SELECT v FROM   test_ks.t WHERE h = $0 -- comment", i), &opcode, &body));
+    ASSERT_EQ(kResultOpcode, opcode) << body;
+    ASSERT_TRUE(HasSuffixString(body, expected_row(i * 10))) << i;
+
+    // Only the first insert and select are parsed, the following ones differ in their literals
+    // only, so they use the cached statements.
+    if (i == 1) {
+      num_parsed = NumParsedStatements();
+    } else {
+      ASSERT_EQ(num_parsed, NumParsedStatements()) << i;
+    }
+  }
+
+  // A literal that does not match the type of its column is reported against the query.
+  ASSERT_NO_FATALS(ExecuteQuery(
+      "INSERT INTO test_ks.t (h, v) VALUES (11, 'text')", &opcode, &body));
+  ASSERT_NE(kResultOpcode, opcode) << body;
+  ASSERT_NO_FATALS(ExecuteQuery("SELECT v FROM test_ks.t WHERE h = 11", &opcode, &body));
+  ASSERT_EQ(kResultOpcode, opcode) << body;
+  ASSERT_TRUE(HasSuffixString(body, BINARY_STRING("\x00\x00\x00\x00"))) << body;
+}
+
 TEST_F(TestCQLService, TestCQLServerEventConst) {
   std::unique_ptr<SchemaChangeEventResponse> response(
       new SchemaChangeEventResponse("", "", "", "", {}));
@@ -250,5 +355,41 @@ TEST_F(TestCQLService, TestCQLServerEventConst) {
   ASSERT_EQ(0, memcmp(buffer, ptr, kSize));
 }
 
+TEST(TestCQLStatement, NormalizeStatement) {
+  string text;
+  vector<CQLLiteral> literals;
+
+  ASSERT_TRUE(NormalizeStatement(
+      "  select v FROM t  -- comment\n WHERE h = 1 AND r = 'it''s' /* comment */ LIMIT 10",
+      &text, &literals));
+  ASSERT_EQ("select v FROM t WHERE h = ? AND r = ? LIMIT ?", text);
+  ASSERT_EQ(3, literals.size());
+  ASSERT_EQ(CQLLiteral::Kind::kInteger, literals[0].kind);
+  ASSERT_EQ("1", literals[0].value);
+  ASSERT_EQ(CQLLiteral::Kind::kString, literals[1].kind);
+  ASSERT_EQ("it's", literals[1].value);
+  ASSERT_EQ("10", literals[2].value);
+
+  ASSERT_TRUE(NormalizeStatement(
+      "INSERT INTO \"T\" (a, b, c, d, e, f) VALUES "
+      "(1.5e3, -2, TRUE, 0xCAFE, 123e4567-e89b-12d3-a456-426655440000, {1, 'x'})",
+      &text, &literals));
+  ASSERT_EQ("INSERT INTO \"T\" (a, b, c, d, e, f) VALUES (?, -2, ?, ?, ?, {1, 'x'})", text);
+  ASSERT_EQ(4, literals.size());
+  ASSERT_EQ(CQLLiteral::Kind::kFloat, literals[0].kind);
+  ASSERT_EQ("1.5e3", literals[0].value);
+  ASSERT_EQ(CQLLiteral::Kind::kBoolean, literals[1].kind);
+  ASSERT_EQ("true", literals[1].value);
+  ASSERT_EQ(CQLLiteral::Kind::kBlob, literals[2].kind);
+  ASSERT_EQ("CAFE", literals[2].value);
+  ASSERT_EQ(CQLLiteral::Kind::kUuid, literals[3].kind);
+
+  // Statements that are not normalized.
+  ASSERT_FALSE(NormalizeStatement("CREATE TABLE t (h INT PRIMARY KEY)", &text, &literals));
+  ASSERT_FALSE(NormalizeStatement("SELECT * FROM t WHERE h = ?", &text, &literals));
+  ASSERT_FALSE(NormalizeStatement("SELECT * FROM t WHERE h = :h", &text, &literals));
+  ASSERT_FALSE(NormalizeStatement("SELECT * FROM t WHERE h = 'unterminated", &text, &literals));
+}
+
 }  // namespace cqlserver
 }  // namespace yb
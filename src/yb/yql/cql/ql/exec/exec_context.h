@@ -20,6 +20,7 @@
 #ifndef YB_YQL_CQL_QL_EXEC_EXEC_CONTEXT_H_
 #define YB_YQL_CQL_QL_EXEC_EXEC_CONTEXT_H_
 
+#include "yb/client/yb_op.h"
 #include "yb/yql/cql/ql/ptree/process_context.h"
 #include "yb/yql/cql/ql/util/ql_env.h"
 #include "yb/yql/cql/ql/util/statement_result.h"
@@ -145,6 +146,14 @@ class ExecContext : public ProcessContextBase {
   // this will do, index: 2 -> 3 and hashed_column_values: [1, 3, 4, 6] -> [1, 3, 5, 6].
   void AdvanceToNextPartition(QLReadRequestPB *req);
 
+  // Used for multi-partition selects (i.e. with 'IN' conditions on hash columns).
+  // Sets the hashed column values in the request so that it references the given partition. The
+  // request must already have values for all hash columns, e.g. from InitializePartition.
+  // Called from Executor when reading several partitions in parallel.
+  // E.g. for a query "h1 = 1 and h2 in (2,3) and h3 in (4,5) and h4 = 6" partition index 2:
+  // this will set req->hashed_column_values() to [1, 3, 4, 6].
+  void SetPartitionHashValues(uint64_t partition_index, QLReadRequestPB *req) const;
+
   std::unique_ptr<std::vector<std::vector<QLExpressionPB>>>& hash_values_options() {
     if (hash_values_options_ == nullptr) {
       hash_values_options_ = std::make_unique<std::vector<std::vector<QLExpressionPB>>>();
@@ -156,6 +165,10 @@ class ExecContext : public ProcessContextBase {
     return current_partition_index_;
   }
 
+  void set_current_partition_index(uint64_t index) {
+    current_partition_index_ = index;
+  }
+
   void set_partitions_count(uint64_t count) {
     partitions_count_ = count;
   }
@@ -171,6 +184,28 @@ class ExecContext : public ProcessContextBase {
     return ql_env_->Apply(op);
   }
 
+  // Apply a read of one partition of a multi-partition select. The reads applied before the next
+  // flush are executed in parallel: the first one reads the current partition and each following
+  // one the partition after.
+  CHECKED_STATUS ApplyPartitionRead(std::shared_ptr<client::YBqlReadOp> op) {
+    if (partition_reads_.empty()) {
+      op_ = op;
+    }
+    partition_reads_.push_back(op);
+    return ql_env_->Apply(std::move(op));
+  }
+
+  // Access function for the partition reads applied since the last TakePartitionReads().
+  const std::vector<std::shared_ptr<client::YBqlReadOp>>& partition_reads() const {
+    return partition_reads_;
+  }
+
+  // Moves the applied partition reads to 'reads', so that the next ones can be applied.
+  void TakePartitionReads(std::vector<std::shared_ptr<client::YBqlReadOp>>* reads) {
+    reads->clear();
+    reads->swap(partition_reads_);
+  }
+
   bool SelectingAggregate();
 
   // Variants of ProcessContextBase::Error() that report location of statement tnode as the error
@@ -190,6 +225,10 @@ class ExecContext : public ProcessContextBase {
   // Read/write operation to execute.
   std::shared_ptr<client::YBqlOp> op_;
 
+  // Reads of the partitions of a multi-partition select being executed in parallel, in partition
+  // order. op_ is the first one.
+  std::vector<std::shared_ptr<client::YBqlReadOp>> partition_reads_;
+
   // Execution start time.
   const MonoTime start_time_;
 
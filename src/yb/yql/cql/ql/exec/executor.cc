@@ -20,6 +20,14 @@
 #include "yb/client/yb_op.h"
 #include "yb/yql/cql/ql/ql_processor.h"
 #include "yb/util/decimal.h"
+#include "yb/util/flag_tags.h"
+
+DEFINE_int32(cql_select_partition_read_fanout, 32,
+             "Maximum number of partitions that a SELECT with IN conditions on the hash columns "
+             "reads in parallel. Each combination of the hash column values is a partition. "
+             "1 reads the partitions one after another.");
+TAG_FLAG(cql_select_partition_read_fanout, advanced);
+TAG_FLAG(cql_select_partition_read_fanout, runtime);
 
 namespace yb {
 namespace ql {
@@ -549,8 +557,9 @@ Status Executor::ExecPTNode(const PTSelectStmt *tnode) {
   }
 
   // If we have several hash partitions (i.e. IN condition on hash columns) we initialize the
-  // start partition here, and then iteratively scan the rest in FetchMoreRowsIfNeeded.
-  // Otherwise, the request will already have the right hashed column values set.
+  // start partition here, and then scan the rest in FetchMoreRowsIfNeeded, either one after another
+  // or several in parallel. Otherwise, the request will already have the right hashed column values
+  // set.
   if (exec_context_->UnreadPartitionsRemaining() > 0) {
     if (continue_select) {
       exec_context_->InitializePartition(select_op->mutable_request(),
@@ -558,13 +567,35 @@ Status Executor::ExecPTNode(const PTSelectStmt *tnode) {
     } else {
       exec_context_->InitializePartition(select_op->mutable_request(), 0);
     }
+    if (exec_context_->UnreadPartitionsRemaining() > 1 &&
+        FLAGS_cql_select_partition_read_fanout > 1) {
+      return ApplyPartitionReads(select_op);
+    }
   }
 
   // Apply the operator.
   return exec_context_->Apply(select_op);
 }
 
+Status Executor::GetFetchLimit(const PTSelectStmt *tnode, uint64_t *fetch_limit) {
+  // The limit for this select: min of page size and result limit (if set).
+  *fetch_limit = exec_context_->params()->page_size(); // default;
+  if (tnode->has_limit()) {
+    QLExpressionPB limit_pb;
+    RETURN_NOT_OK(PTExprToPB(tnode->limit(), &limit_pb));
+    int64_t limit = limit_pb.value().int32_value() - exec_context_->params()->total_num_rows_read();
+    if (limit < *fetch_limit) {
+      *fetch_limit = limit;
+    }
+  }
+  return Status::OK();
+}
+
 Status Executor::FetchMoreRowsIfNeeded() {
+  if (!exec_context_->partition_reads().empty()) {
+    return FetchMorePartitionsIfNeeded();
+  }
+
   if (result_ == nullptr) {
     return Status::OK();
   }
@@ -587,15 +618,8 @@ Status Executor::FetchMoreRowsIfNeeded() {
   RETURN_NOT_OK(current_params.set_paging_state(current_result->paging_state()));
 
   // The limit for this select: min of page size and result limit (if set).
-  uint64_t fetch_limit = exec_context_->params()->page_size(); // default;
-  if (tnode->has_limit()) {
-    QLExpressionPB limit_pb;
-    RETURN_NOT_OK(PTExprToPB(tnode->limit(), &limit_pb));
-    int64_t limit = limit_pb.value().int32_value() - previous_fetches_row_count;
-    if (limit < fetch_limit) {
-      fetch_limit = limit;
-    }
-  }
+  uint64_t fetch_limit = 0;
+  RETURN_NOT_OK(GetFetchLimit(tnode, &fetch_limit));
 
   // The current read operation.
   std::shared_ptr<YBqlReadOp> op = std::static_pointer_cast<YBqlReadOp>(exec_context_->op());
@@ -630,6 +654,12 @@ Status Executor::FetchMoreRowsIfNeeded() {
       paging_state.set_table_id(tnode->table()->id());
       paging_state.set_next_partition_index(exec_context_->current_partition_index());
       current_result->set_paging_state(paging_state);
+    } else if (!finished_current_read_partition && exec_context_->UnreadPartitionsRemaining() > 0) {
+      // If we reached the paging limit within a partition of a multi-partition select, the next
+      // fetch should continue from the same partition, so record it in the paging state too.
+      QLPagingStatePB paging_state(op->response().paging_state());
+      paging_state.set_next_partition_index(exec_context_->current_partition_index());
+      current_result->set_paging_state(paging_state);
     }
 
     return Status::OK();
@@ -649,6 +679,144 @@ Status Executor::FetchMoreRowsIfNeeded() {
   return exec_context_->Apply(op);
 }
 
+Status Executor::ApplyPartitionReads(const std::shared_ptr<YBqlReadOp>& op) {
+  const PTSelectStmt *tnode = static_cast<const PTSelectStmt *>(exec_context_->tnode());
+  const uint64_t partition_index = exec_context_->current_partition_index();
+  const uint64_t fanout = std::min<uint64_t>(std::max(FLAGS_cql_select_partition_read_fanout, 1),
+                                             exec_context_->UnreadPartitionsRemaining());
+
+  // The next partitions are read from their start with the same limit as the current one, because
+  // the number of rows that the partitions before them return is not known yet.
+  RETURN_NOT_OK(exec_context_->ApplyPartitionRead(op));
+  for (uint64_t i = 1; i < fanout; i++) {
+    std::shared_ptr<YBqlReadOp> read(tnode->table()->NewQLSelect());
+    read->mutable_request()->CopyFrom(op->request());
+    read->set_yb_consistency_level(op->yb_consistency_level());
+    SetPartitionRead(partition_index + i, op->request().limit(),
+                     op->request().paging_state().total_num_rows_read(), read.get());
+    RETURN_NOT_OK(exec_context_->ApplyPartitionRead(read));
+  }
+  return Status::OK();
+}
+
+void Executor::SetPartitionRead(uint64_t partition_index, uint64_t limit,
+                                uint64_t total_num_rows_read, YBqlReadOp *op) {
+  QLReadRequestPB *req = op->mutable_request();
+  exec_context_->SetPartitionHashValues(partition_index, req);
+  req->clear_hash_code();
+  req->clear_max_hash_code();
+  req->set_limit(limit);
+  QLPagingStatePB *paging_state = req->mutable_paging_state();
+  paging_state->clear_next_partition_key();
+  paging_state->clear_next_row_key();
+  paging_state->set_total_num_rows_read(total_num_rows_read);
+}
+
+Status Executor::FetchMorePartitionsIfNeeded() {
+  // The current select statement.
+  const PTSelectStmt *tnode = static_cast<const PTSelectStmt *>(exec_context_->tnode());
+
+  // The reads of this fetch, in partition order starting from the current partition.
+  std::vector<std::shared_ptr<YBqlReadOp>> reads;
+  exec_context_->TakePartitionReads(&reads);
+  const uint64_t first_partition_index = exec_context_->current_partition_index();
+
+  // Rows read so far: in this fetch, and in previous fetches (for paging selects).
+  size_t current_fetch_row_count = 0;
+  if (result_ != nullptr) {
+    RowsResult::SharedPtr current_result = std::static_pointer_cast<RowsResult>(result_);
+    RETURN_NOT_OK(QLRowBlock::GetRowCount(current_result->client(),
+                                          current_result->rows_data(),
+                                          &current_fetch_row_count));
+  }
+  const size_t previous_fetches_row_count = exec_context_->params()->total_num_rows_read();
+
+  uint64_t fetch_limit = 0;
+  RETURN_NOT_OK(GetFetchLimit(tnode, &fetch_limit));
+
+  // Merge the results in partition order, so that the rows are returned in the same order and with
+  // the same paging state as when the partitions are read one after another.
+  for (size_t i = 0; i < reads.size(); i++) {
+    const std::shared_ptr<YBqlReadOp>& read = reads[i];
+    const uint64_t partition_index = first_partition_index + i;
+    size_t read_row_count = 0;
+    if (!read->rows_data().empty()) {
+      RETURN_NOT_OK(QLRowBlock::GetRowCount(read->request().client(), read->rows_data(),
+                                            &read_row_count));
+    }
+
+    // A partition after the first one may return more rows than remain to be fetched, since the
+    // partitions before it returned rows too. Its rows are dropped and the partition is read again
+    // with the remaining limit, together with the partitions after it.
+    if (current_fetch_row_count + read_row_count > fetch_limit) {
+      DCHECK_GT(i, 0U);
+      exec_context_->set_current_partition_index(partition_index);
+      SetPartitionRead(partition_index, fetch_limit - current_fetch_row_count,
+                       previous_fetches_row_count + current_fetch_row_count, read.get());
+      return ApplyPartitionReads(read);
+    }
+
+    if (!read->rows_data().empty()) {
+      RETURN_NOT_OK(AppendResult(std::make_shared<RowsResult>(read.get())));
+    }
+    current_fetch_row_count += read_row_count;
+    const size_t total_row_count = previous_fetches_row_count + current_fetch_row_count;
+
+    // If there is a paging state, the read of this partition stopped before its end.
+    if (read->response().has_paging_state()) {
+      const QLPagingStatePB& read_paging_state = read->response().paging_state();
+
+      // If we reached the fetch limit we are done. The next fetch continues from this partition.
+      if (current_fetch_row_count >= fetch_limit) {
+        if (result_ != nullptr) {
+          QLPagingStatePB paging_state(read_paging_state);
+          paging_state.set_total_num_rows_read(total_row_count);
+          paging_state.set_table_id(tnode->table()->id());
+          paging_state.set_next_partition_index(partition_index);
+          std::static_pointer_cast<RowsResult>(result_)->set_paging_state(paging_state);
+        }
+        return Status::OK();
+      }
+
+      // Otherwise continue reading this partition, and the partitions after it, in parallel.
+      exec_context_->set_current_partition_index(partition_index);
+      QLReadRequestPB *req = read->mutable_request();
+      req->set_limit(fetch_limit - current_fetch_row_count);
+      QLPagingStatePB *paging_state = req->mutable_paging_state();
+      paging_state->set_next_partition_key(read_paging_state.next_partition_key());
+      paging_state->set_next_row_key(read_paging_state.next_row_key());
+      paging_state->set_total_num_rows_read(total_row_count);
+      return ApplyPartitionReads(read);
+    }
+
+    // If we reached the fetch limit at the end of this partition we are done. If there are more
+    // partitions to read, create a paging state so that the next fetch resumes from the next one.
+    if (current_fetch_row_count >= fetch_limit) {
+      exec_context_->set_current_partition_index(partition_index + 1);
+      if (exec_context_->UnreadPartitionsRemaining() > 0 && read->request().return_paging_state() &&
+          result_ != nullptr) {
+        QLPagingStatePB paging_state;
+        paging_state.set_total_num_rows_read(total_row_count);
+        paging_state.set_table_id(tnode->table()->id());
+        paging_state.set_next_partition_index(partition_index + 1);
+        std::static_pointer_cast<RowsResult>(result_)->set_paging_state(paging_state);
+      }
+      return Status::OK();
+    }
+  }
+
+  // All the partitions read were finished without reaching the fetch limit. Continue with the
+  // partitions after them, if there are any left.
+  exec_context_->set_current_partition_index(first_partition_index + reads.size());
+  if (exec_context_->UnreadPartitionsRemaining() == 0) {
+    return Status::OK();
+  }
+  const std::shared_ptr<YBqlReadOp>& op = reads.front();
+  SetPartitionRead(exec_context_->current_partition_index(), fetch_limit - current_fetch_row_count,
+                   previous_fetches_row_count + current_fetch_row_count, op.get());
+  return ApplyPartitionReads(op);
+}
+
 //--------------------------------------------------------------------------------------------------
 
 Status Executor::ExecPTNode(const PTInsertStmt *tnode) {
@@ -860,12 +1028,24 @@ Status Executor::ProcessStatementStatus(const ParseTree &parse_tree, const Statu
   return s;
 }
 
-Status Executor::ProcessOpResponse(client::YBqlOp* op, ExecContext* exec_context) {
+Status Executor::ProcessOpStatus(const client::YBqlOp* op, ExecContext* exec_context) {
+  const Status s = ql_env_->GetOpError(op);
+  if (PREDICT_FALSE(!s.ok())) {
+    // YBOperation returns not-found error when the tablet is not found.
+    const auto error_code =
+        s.IsNotFound() ? ErrorCode::TABLET_NOT_FOUND : ErrorCode::SQL_STATEMENT_INVALID;
+    return exec_context->Error(s, error_code);
+  }
   const QLResponsePB &resp = op->response();
   CHECK(resp.has_status()) << "QLResponsePB status missing";
   if (resp.status() != QLResponsePB::YQL_STATUS_OK) {
     return exec_context->Error(resp.error_message().c_str(), QLStatusToErrorCode(resp.status()));
   }
+  return Status::OK();
+}
+
+Status Executor::ProcessOpResponse(client::YBqlOp* op, ExecContext* exec_context) {
+  RETURN_NOT_OK(ProcessOpStatus(op, exec_context));
   return op->rows_data().empty() ? Status::OK() : AppendResult(std::make_shared<RowsResult>(op));
 }
 
@@ -875,16 +1055,16 @@ Status Executor::ProcessAsyncResults() {
     if (exec_context.tnode() == nullptr) {
       continue; // Skip empty statement.
     }
-    client::YBqlOp* op = exec_context.op().get();
-    ss = ql_env_->GetOpError(op);
-    if (PREDICT_FALSE(!ss.ok())) {
-      // YBOperation returns not-found error when the tablet is not found.
-      const auto error_code =
-          ss.IsNotFound() ? ErrorCode::TABLET_NOT_FOUND : ErrorCode::SQL_STATEMENT_INVALID;
-      ss = exec_context.Error(ss, error_code);
-    }
-    if (ss.ok()) {
-      ss = ProcessOpResponse(op, &exec_context);
+    if (exec_context.partition_reads().empty()) {
+      ss = ProcessOpResponse(exec_context.op().get(), &exec_context);
+    } else {
+      // The results of parallel partition reads are merged in FetchMoreRowsIfNeeded.
+      for (const auto& read : exec_context.partition_reads()) {
+        ss = ProcessOpStatus(read.get(), &exec_context);
+        if (PREDICT_FALSE(!ss.ok())) {
+          break;
+        }
+      }
     }
     ss = ProcessStatementStatus(*exec_context.parse_tree(), ss);
     if (PREDICT_FALSE(!ss.ok())) {
@@ -119,6 +119,9 @@ class Executor : public QLExprExecutor {
   // Process the status of executing a statement.
   CHECKED_STATUS ProcessStatementStatus(const ParseTree& parse_tree, const Status& s);
 
+  // Process the read/write op status.
+  CHECKED_STATUS ProcessOpStatus(const client::YBqlOp* op, ExecContext* exec_context);
+
   // Process the read/write op response.
   CHECKED_STATUS ProcessOpResponse(client::YBqlOp* op, ExecContext* exec_context);
 
@@ -131,6 +134,21 @@ class Executor : public QLExprExecutor {
   // Continue a multi-partition select (e.g. table scan or query with 'IN' condition on hash cols).
   CHECKED_STATUS FetchMoreRowsIfNeeded();
 
+  // Compute the number of rows to fetch for a select: min of page size and remaining LIMIT.
+  CHECKED_STATUS GetFetchLimit(const PTSelectStmt *tnode, uint64_t *fetch_limit);
+
+  // Read the partitions of a select with 'IN' condition on hash cols in parallel, starting from
+  // the current partition which 'op' reads. Up to FLAGS_cql_select_partition_read_fanout
+  // partitions are read at a time.
+  CHECKED_STATUS ApplyPartitionReads(const std::shared_ptr<client::YBqlReadOp>& op);
+
+  // Set up 'op' to read the given partition from its start.
+  void SetPartitionRead(uint64_t partition_index, uint64_t limit, uint64_t total_num_rows_read,
+                        client::YBqlReadOp *op);
+
+  // Merge the results of the parallel partition reads and continue with the next partitions.
+  CHECKED_STATUS FetchMorePartitionsIfNeeded();
+
   // Aggregate all result sets from all tablet servers to form the requested resultset.
   CHECKED_STATUS AggregateResultSets();
   CHECKED_STATUS EvalCount(const std::shared_ptr<QLRowBlock>& row_block,
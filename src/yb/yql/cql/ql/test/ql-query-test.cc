@@ -22,6 +22,8 @@
 #include "yb/master/master.h"
 #include "yb/master/ts_manager.h"
 
+DECLARE_int32(cql_select_partition_read_fanout);
+
 using std::string;
 using std::unique_ptr;
 using std::shared_ptr;
@@ -496,6 +498,56 @@ TEST_F(TestQLQuery, TestPagingState) {
   }
 }
 
+TEST_F(TestQLQuery, TestParallelPartitionReads) {
+  // Init the simulated cluster.
+  ASSERT_NO_FATALS(CreateSimulatedCluster());
+
+  // Get a processor.
+  TestQLProcessor *processor = GetQLProcessor();
+
+  // Create table and insert a different number of rows for each hash key, some with none.
+  CHECK_VALID_STMT("CREATE TABLE t (h int, r int, v int, primary key((h), r));");
+  for (int h = 1; h <= 20; h++) {
+    for (int r = 1; r <= h % 5; r++) {
+      CHECK_VALID_STMT(Substitute("INSERT INTO t (h, r, v) VALUES ($0, $1, $2);", h, r, h + r));
+    }
+  }
+
+  // Reads all pages of a select and returns them, one row block per page.
+  auto read_pages = [processor](const string& select_stmt, int page_size) {
+    StatementParameters params;
+    params.set_page_size(page_size);
+    string pages;
+    do {
+      CHECK_OK(processor->Run(select_stmt, params));
+      pages.append(processor->row_block()->ToString());
+      if (processor->rows_result()->paging_state().empty()) {
+        break;
+      }
+      CHECK_OK(params.set_paging_state(processor->rows_result()->paging_state()));
+    } while (true);
+    return pages;
+  };
+
+  // Verify that the partitions read in parallel return the same rows in the same pages as when
+  // they are read one after another.
+  const string in_list = "(3, 1, 5, 25, 14, 9, 2, 7, 20, 18, 11, 4, 16, 13, 8)";
+  for (const string& select_stmt : {
+      Substitute("SELECT h, r, v FROM t WHERE h IN $0;", in_list),
+      Substitute("SELECT h, r, v FROM t WHERE h IN $0 AND r > 1;", in_list),
+      Substitute("SELECT h, r, v FROM t WHERE h IN $0 LIMIT 11;", in_list)}) {
+    for (int page_size : {1, 2, 3, 7, 100}) {
+      FLAGS_cql_select_partition_read_fanout = 1;
+      const string expected_pages = read_pages(select_stmt, page_size);
+      for (int fanout : {2, 4, 32}) {
+        FLAGS_cql_select_partition_read_fanout = fanout;
+        EXPECT_EQ(expected_pages, read_pages(select_stmt, page_size))
+            << select_stmt << " page size " << page_size << " fanout " << fanout;
+      }
+    }
+  }
+}
+
 #define RUN_PAGINATION_WITH_DESC_TEST(processor, type, values, rows)                               \
 do {                                                                                               \
   /* Creating the table. */                                                                        \